@@ -1073,7 +1073,7 @@ static void at32can_txavail_work(void *arg)
 
   /* Ignore the notification if the interface is not yet up */
 
-  net_lock();
+  netdev_lock(&priv->dev);
   if (priv->bifup)
     {
       /* Check if there is room in the hardware to hold another outgoing
@@ -1090,7 +1090,7 @@ static void at32can_txavail_work(void *arg)
         }
     }
 
-  net_unlock();
+  netdev_unlock(&priv->dev);
 }
 
 /****************************************************************************
@@ -1516,9 +1516,9 @@ static void at32can_txdone_work(void *arg)
    * new XMIT data
    */
 
-  net_lock();
+  netdev_lock(&priv->dev);
   devif_poll(&priv->dev, at32can_txpoll);
-  net_unlock();
+  netdev_unlock(&priv->dev);
 }
 
 /****************************************************************************
@@ -1676,7 +1676,7 @@ static void at32can_sceinterrupt_work(void *arg)
 
       memcpy(frame->data, data, CAN_ERR_DLC);
 
-      net_lock();
+      netdev_lock(&priv->dev);
 
       /* Copy the buffer pointer to priv->dev..  Set amount of data
        * in priv->dev.d_len
@@ -1699,7 +1699,7 @@ static void at32can_sceinterrupt_work(void *arg)
        */
 
       priv->dev.d_buf = (uint8_t *)priv->txdesc;
-      net_unlock();
+      netdev_unlock(&priv->dev);
     }
 
   /* Re-enable CAN SCE interrupts */
@@ -1516,7 +1516,7 @@ static void c5471_interrupt_work(void *arg)
 
   /* Process pending Ethernet interrupts */
 
-  net_lock();
+  netdev_lock(&priv->c_dev);
 
   /* Get and clear interrupt status bits */
 
@@ -1569,7 +1569,7 @@ static void c5471_interrupt_work(void *arg)
       c5471_txdone(priv);
     }
 
-  net_unlock();
+  netdev_unlock(&priv->c_dev);
 
   /* Re-enable Ethernet interrupts */
 
@@ -1648,7 +1648,7 @@ static void c5471_txtimeout_work(void *arg)
 
   /* Increment statistics */
 
-  net_lock();
+  netdev_lock(&priv->c_dev);
 #ifdef CONFIG_C5471_NET_STATS
   priv->c_txtimeouts++;
   ninfo("c_txtimeouts: %d\n", priv->c_txtimeouts);
@@ -1662,7 +1662,7 @@ static void c5471_txtimeout_work(void *arg)
   /* Then poll the network for new XMIT data */
 
   devif_poll(&priv->c_dev, c5471_txpoll);
-  net_unlock();
+  netdev_unlock(&priv->c_dev);
 }
 
 /****************************************************************************
@@ -1844,7 +1844,7 @@ static void c5471_txavail_work(void *arg)
 
   /* Ignore the notification if the interface is not yet up */
 
-  net_lock();
+  netdev_lock(&priv->c_dev);
   if (priv->c_bifup)
     {
       /* Check if the ESM has let go of the RX descriptor giving us access
@@ -1859,7 +1859,7 @@ static void c5471_txavail_work(void *arg)
         }
     }
 
-  net_unlock();
+  netdev_unlock(&priv->c_dev);
 }
 
 /****************************************************************************
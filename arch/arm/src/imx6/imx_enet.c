@@ -1051,7 +1051,7 @@ static void imx_enet_interrupt_work(void *arg)
 
   /* Process pending Ethernet interrupts */
 
-  net_lock();
+  netdev_lock(&priv->dev);
 
   /* Get the set of unmasked, pending interrupt. */
 
@@ -1129,7 +1129,7 @@ static void imx_enet_interrupt_work(void *arg)
         }
     }
 
-  net_unlock();
+  netdev_unlock(&priv->dev);
 
   /* Re-enable Ethernet interrupts */
 
@@ -1196,7 +1196,7 @@ static void imx_txtimeout_work(void *arg)
 
   /* Increment statistics and dump debug info */
 
-  net_lock();
+  netdev_lock(&priv->dev);
   nerr("Resetting interface\n");
 
   NETDEV_TXTIMEOUTS(&priv->dev);
@@ -1211,7 +1211,7 @@ static void imx_txtimeout_work(void *arg)
   /* Then poll the network for new XMIT data */
 
   devif_poll(&priv->dev, imx_txpoll);
-  net_unlock();
+  netdev_unlock(&priv->dev);
 }
 
 /****************************************************************************
@@ -1487,7 +1487,7 @@ static void imx_txavail_work(void *arg)
 
   /* Ignore the notification if the interface is not yet up */
 
-  net_lock();
+  netdev_lock(&priv->dev);
   if (priv->bifup)
     {
       /* Check if there is room in the hardware to hold another outgoing
@@ -1504,7 +1504,7 @@ static void imx_txavail_work(void *arg)
         }
     }
 
-  net_unlock();
+  netdev_unlock(&priv->dev);
 }
 
 /****************************************************************************
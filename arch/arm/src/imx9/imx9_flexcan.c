@@ -1096,9 +1096,9 @@ static void imx9_txdone_work(void *arg)
    * new XMIT data
    */
 
-  net_lock();
+  netdev_lock(&priv->dev);
   devif_poll(&priv->dev, imx9_txpoll);
-  net_unlock();
+  netdev_unlock(&priv->dev);
 }
 
 /****************************************************************************
@@ -1129,9 +1129,9 @@ static void imx9_flexcan_interrupt_work(void *arg)
   flags  = getreg32(priv->base + IMX9_CAN_IFLAG1_OFFSET);
   flags &= IFLAG1_RX;
 
-  net_lock();
+  netdev_lock(&priv->dev);
   imx9_receive(priv, flags);
-  net_unlock();
+  netdev_unlock(&priv->dev);
 
   /* Mask MB again */
 
@@ -1454,7 +1454,7 @@ static void imx9_txavail_work(void *arg)
 
   /* Ignore the notification if the interface is not yet up */
 
-  net_lock();
+  netdev_lock(&priv->dev);
   if (priv->bifup)
     {
       /* Check if there is room in the hardware to hold another outgoing
@@ -1471,7 +1471,7 @@ static void imx9_txavail_work(void *arg)
         }
     }
 
-  net_unlock();
+  netdev_unlock(&priv->dev);
 }
 
 /****************************************************************************
@@ -1166,7 +1166,7 @@ static void imxrt_enet_interrupt_work(void *arg)
 
   /* Process pending Ethernet interrupts */
 
-  net_lock();
+  netdev_lock(&priv->dev);
 
   /* Get the set of unmasked, pending interrupt. */
 
@@ -1244,7 +1244,7 @@ static void imxrt_enet_interrupt_work(void *arg)
         }
     }
 
-  net_unlock();
+  netdev_unlock(&priv->dev);
 
   /* Re-enable Ethernet interrupts */
 
@@ -1311,7 +1311,7 @@ static void imxrt_txtimeout_work(void *arg)
 
   /* Increment statistics and dump debug info */
 
-  net_lock();
+  netdev_lock(&priv->dev);
   nerr("Resetting interface\n");
 
   NETDEV_TXTIMEOUTS(&priv->dev);
@@ -1326,7 +1326,7 @@ static void imxrt_txtimeout_work(void *arg)
   /* Then poll the network for new XMIT data */
 
   devif_poll(&priv->dev, imxrt_txpoll);
-  net_unlock();
+  netdev_unlock(&priv->dev);
 }
 
 /****************************************************************************
@@ -1624,7 +1624,7 @@ static void imxrt_txavail_work(void *arg)
 
   /* Ignore the notification if the interface is not yet up */
 
-  net_lock();
+  netdev_lock(&priv->dev);
   if (priv->bifup)
     {
       /* Check if there is room in the hardware to hold another outgoing
@@ -1641,7 +1641,7 @@ static void imxrt_txavail_work(void *arg)
         }
     }
 
-  net_unlock();
+  netdev_unlock(&priv->dev);
 }
 
 /****************************************************************************
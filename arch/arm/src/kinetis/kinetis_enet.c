@@ -770,7 +770,7 @@ static void kinetis_interrupt_work(void *arg)
 
   /* Process pending Ethernet interrupts */
 
-  net_lock();
+  netdev_lock(&priv->dev);
 
   /* Get the set of unmasked, pending interrupt. */
 
@@ -842,7 +842,7 @@ static void kinetis_interrupt_work(void *arg)
       putreg32(ENET_RDAR, KINETIS_ENET_RDAR);
     }
 
-  net_unlock();
+  netdev_unlock(&priv->dev);
 
   /* Re-enable Ethernet interrupts */
 
@@ -920,7 +920,7 @@ static void kinetis_txtimeout_work(void *arg)
 
   /* Increment statistics and dump debug info */
 
-  net_lock();
+  netdev_lock(&priv->dev);
   NETDEV_TXTIMEOUTS(&priv->dev);
 
   /* Take the interface down and bring it back up.  The is the most
@@ -933,7 +933,7 @@ static void kinetis_txtimeout_work(void *arg)
   /* Then poll the network for new XMIT data */
 
   devif_poll(&priv->dev, kinetis_txpoll);
-  net_unlock();
+  netdev_unlock(&priv->dev);
 }
 
 /****************************************************************************
@@ -1193,7 +1193,7 @@ static void kinetis_txavail_work(void *arg)
 
   /* Ignore the notification if the interface is not yet up */
 
-  net_lock();
+  netdev_lock(&priv->dev);
   if (priv->bifup)
     {
       /* Check if there is room in the hardware to hold another outgoing
@@ -1210,7 +1210,7 @@ static void kinetis_txavail_work(void *arg)
         }
     }
 
-  net_unlock();
+  netdev_unlock(&priv->dev);
 }
 
 /****************************************************************************
@@ -1710,7 +1710,7 @@ static int lpc17can_txavail(struct net_driver_s *dev)
 
   /* Ignore the notification if the interface is not yet up */
 
-  net_lock();
+  netdev_lock(&priv->dev);
   if (priv->bifup)
     {
       /* Check if there is room in the hardware to hold another outgoing
@@ -1727,7 +1727,7 @@ static int lpc17can_txavail(struct net_driver_s *dev)
         }
     }
 
-  net_unlock();
+  netdev_unlock(&priv->dev);
 
   return OK;
 }
@@ -920,7 +920,7 @@ static void s32k1xx_enet_interrupt_work(void *arg)
 
   /* Process pending Ethernet interrupts */
 
-  net_lock();
+  netdev_lock(&priv->dev);
 
   /* Get the set of unmasked, pending interrupt. */
 
@@ -999,7 +999,7 @@ static void s32k1xx_enet_interrupt_work(void *arg)
         }
     }
 
-  net_unlock();
+  netdev_unlock(&priv->dev);
 
   /* Re-enable Ethernet interrupts */
 
@@ -1070,7 +1070,7 @@ static void s32k1xx_txtimeout_work(void *arg)
 
   /* Increment statistics and dump debug info */
 
-  net_lock();
+  netdev_lock(&priv->dev);
   nerr("Resetting interface\n");
 
   NETDEV_TXTIMEOUTS(&priv->dev);
@@ -1085,7 +1085,7 @@ static void s32k1xx_txtimeout_work(void *arg)
   /* Then poll the network for new XMIT data */
 
   devif_poll(&priv->dev, s32k1xx_txpoll);
-  net_unlock();
+  netdev_unlock(&priv->dev);
 }
 
 /****************************************************************************
@@ -1356,7 +1356,7 @@ static void s32k1xx_txavail_work(void *arg)
 
   /* Ignore the notification if the interface is not yet up */
 
-  net_lock();
+  netdev_lock(&priv->dev);
   if (priv->bifup)
     {
       /* Check if there is room in the hardware to hold another outgoing
@@ -1373,7 +1373,7 @@ static void s32k1xx_txavail_work(void *arg)
         }
     }
 
-  net_unlock();
+  netdev_unlock(&priv->dev);
 }
 
 /****************************************************************************
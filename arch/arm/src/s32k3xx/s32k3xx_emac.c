@@ -1701,7 +1701,7 @@ static void s32k3xx_interrupt_work(void *arg)
 
   /* Process pending Ethernet interrupts */
 
-  net_lock();
+  netdev_lock(&priv->dev);
 
   /* Get the DMA interrupt status bits (no MAC interrupts are expected) */
 
@@ -1772,7 +1772,7 @@ static void s32k3xx_interrupt_work(void *arg)
     }
 #endif
 
-  net_unlock();
+  netdev_unlock(&priv->dev);
 
   /* Re-enable Ethernet interrupts at the NVIC */
 
@@ -1862,7 +1862,7 @@ static void s32k3xx_txtimeout_work(void *arg)
 
   /* Increment statistics and dump debug info */
 
-  net_lock();
+  netdev_lock(&priv->dev);
   nerr("Resetting interface\n");
 
   NETDEV_TXTIMEOUTS(&priv->dev);
@@ -1877,7 +1877,7 @@ static void s32k3xx_txtimeout_work(void *arg)
   /* Then poll the network for new XMIT data */
 
   s32k3xx_dopoll(priv);
-  net_unlock();
+  netdev_unlock(&priv->dev);
 }
 
 /****************************************************************************
@@ -2123,7 +2123,7 @@ static void s32k3xx_txavail_work(void *arg)
 
   /* Ignore the notification if the interface is not yet up */
 
-  net_lock();
+  netdev_lock(&priv->dev);
   if (priv->bifup)
     {
       /* Poll the network for new XMIT data */
@@ -2131,7 +2131,7 @@ static void s32k3xx_txavail_work(void *arg)
       s32k3xx_dopoll(priv);
     }
 
-  net_unlock();
+  netdev_unlock(&priv->dev);
 }
 
 /****************************************************************************
@@ -1362,7 +1362,7 @@ static void sam_interrupt_work(void *arg)
 
   /* Process pending Ethernet interrupts */
 
-  net_lock();
+  netdev_lock(&priv->dev);
   isr = sam_getreg(priv, SAM_EMAC_ISR);
   rsr = sam_getreg(priv, SAM_EMAC_RSR);
   tsr = sam_getreg(priv, SAM_EMAC_TSR);
@@ -1521,7 +1521,7 @@ static void sam_interrupt_work(void *arg)
     }
 #endif
 
-  net_unlock();
+  netdev_unlock(&priv->dev);
 
   /* Re-enable Ethernet interrupts */
 
@@ -1610,14 +1610,14 @@ static void sam_txtimeout_work(void *arg)
    * up again.
    */
 
-  net_lock();
+  netdev_lock(&priv->dev);
   sam_ifdown(&priv->dev);
   sam_ifup(&priv->dev);
 
   /* Then poll the network for new XMIT data */
 
   sam_dopoll(priv);
-  net_unlock();
+  netdev_unlock(&priv->dev);
 }
 
 /****************************************************************************
@@ -1798,7 +1798,7 @@ static void sam_txavail_work(void *arg)
 
   /* Ignore the notification if the interface is not yet up */
 
-  net_lock();
+  netdev_lock(&priv->dev);
   if (priv->ifup)
     {
       /* Poll the network for new XMIT data */
@@ -1806,7 +1806,7 @@ static void sam_txavail_work(void *arg)
       sam_dopoll(priv);
     }
 
-  net_unlock();
+  netdev_unlock(&priv->dev);
 }
 
 /****************************************************************************
@@ -1762,7 +1762,7 @@ static void sam_interrupt_work(void *arg)
 
   /* Process pending Ethernet interrupts */
 
-  net_lock();
+  netdev_lock(&priv->dev);
   isr = sam_getreg(priv, SAM_EMAC_ISR_OFFSET);
   rsr = sam_getreg(priv, SAM_EMAC_RSR_OFFSET);
   tsr = sam_getreg(priv, SAM_EMAC_TSR_OFFSET);
@@ -1921,7 +1921,7 @@ static void sam_interrupt_work(void *arg)
     }
 #endif
 
-  net_unlock();
+  netdev_unlock(&priv->dev);
 
   /* Re-enable Ethernet interrupts */
 
@@ -2008,14 +2008,14 @@ static void sam_txtimeout_work(void *arg)
 
   /* Reset the hardware.  Just take the interface down, then back up again. */
 
-  net_lock();
+  netdev_lock(&priv->dev);
   sam_ifdown(&priv->dev);
   sam_ifup(&priv->dev);
 
   /* Then poll the network for new XMIT data */
 
   sam_dopoll(priv);
-  net_unlock();
+  netdev_unlock(&priv->dev);
 }
 
 /****************************************************************************
@@ -2204,7 +2204,7 @@ static void sam_txavail_work(void *arg)
 
   /* Ignore the notification if the interface is not yet up */
 
-  net_lock();
+  netdev_lock(&priv->dev);
   if (priv->ifup)
     {
       /* Poll the network for new XMIT data */
@@ -2212,7 +2212,7 @@ static void sam_txavail_work(void *arg)
       sam_dopoll(priv);
     }
 
-  net_unlock();
+  netdev_unlock(&priv->dev);
 }
 
 /****************************************************************************
@@ -1071,7 +1071,7 @@ static void stm32can_txavail_work(void *arg)
 
   /* Ignore the notification if the interface is not yet up */
 
-  net_lock();
+  netdev_lock(&priv->dev);
   if (priv->bifup)
     {
       /* Check if there is room in the hardware to hold another outgoing
@@ -1088,7 +1088,7 @@ static void stm32can_txavail_work(void *arg)
         }
     }
 
-  net_unlock();
+  netdev_unlock(&priv->dev);
 }
 
 /****************************************************************************
@@ -1510,9 +1510,9 @@ static void stm32can_txdone_work(void *arg)
    * new XMIT data
    */
 
-  net_lock();
+  netdev_lock(&priv->dev);
   devif_poll(&priv->dev, stm32can_txpoll);
-  net_unlock();
+  netdev_unlock(&priv->dev);
 }
 
 /****************************************************************************
@@ -1670,7 +1670,7 @@ static void stm32can_sceinterrupt_work(void *arg)
 
       memcpy(frame->data, data, CAN_ERR_DLC);
 
-      net_lock();
+      netdev_lock(&priv->dev);
 
       /* Copy the buffer pointer to priv->dev..  Set amount of data
        * in priv->dev.d_len
@@ -1693,7 +1693,7 @@ static void stm32can_sceinterrupt_work(void *arg)
        */
 
       priv->dev.d_buf = (uint8_t *)priv->txdesc;
-      net_unlock();
+      netdev_unlock(&priv->dev);
     }
 
   /* Re-enable CAN SCE interrupts */
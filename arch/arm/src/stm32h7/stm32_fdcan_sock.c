@@ -1869,7 +1869,7 @@ static void fdcan_txavail_work(void *arg)
 
   /* Ignore the notification if the interface is not yet up */
 
-  net_lock();
+  netdev_lock(&priv->dev);
   if (priv->bifup)
     {
       /* Check if there is room in the hardware to hold another outgoing
@@ -1886,7 +1886,7 @@ static void fdcan_txavail_work(void *arg)
         }
     }
 
-  net_unlock();
+  netdev_unlock(&priv->dev);
 }
 
 /****************************************************************************
@@ -2703,9 +2703,9 @@ static void fdcan_error_work(void *arg)
 
   /* Report errors */
 
-  net_lock();
+  netdev_lock(&priv->dev);
   fdcan_error(priv, pending & FDCAN_ANYERR_INTS, psr);
-  net_unlock();
+  netdev_unlock(&priv->dev);
 
   /* Re-enable ERROR interrupts */
 
@@ -898,7 +898,7 @@ static void tiva_interrupt_work(void *arg)
 
   /* Process pending Ethernet interrupts */
 
-  net_lock();
+  netdev_lock(&priv->ld_dev);
 
   /* Read the raw interrupt status register */
 
@@ -955,7 +955,7 @@ static void tiva_interrupt_work(void *arg)
       tiva_txdone(priv);
     }
 
-  net_unlock();
+  netdev_unlock(&priv->ld_dev);
 
   /* Re-enable Ethernet interrupts */
 
@@ -1053,7 +1053,7 @@ static void tiva_txtimeout_work(void *arg)
 
   /* Increment statistics */
 
-  net_lock();
+  netdev_lock(&priv->ld_dev);
   nerr("ERROR: Tx timeout\n");
   NETDEV_TXTIMEOUTS(&priv->ld_dev);
 
@@ -1066,7 +1066,7 @@ static void tiva_txtimeout_work(void *arg)
   /* Then poll the network for new XMIT data */
 
   devif_poll(&priv->ld_dev, tiva_txpoll);
-  net_unlock();
+  netdev_unlock(&priv->ld_dev);
 }
 
 /****************************************************************************
@@ -1380,7 +1380,7 @@ static void tiva_txavail_work(void *arg)
    * will occur at that time.
    */
 
-  net_lock();
+  netdev_lock(&priv->ld_dev);
   if (priv->ld_bifup &&
       (tiva_ethin(priv, TIVA_MAC_TR_OFFSET) & MAC_TR_NEWTX) == 0)
     {
@@ -1391,7 +1391,7 @@ static void tiva_txavail_work(void *arg)
       devif_poll(&priv->ld_dev, tiva_txpoll);
     }
 
-  net_unlock();
+  netdev_unlock(&priv->ld_dev);
 }
 
 /****************************************************************************
@@ -1096,7 +1096,7 @@ static void imx9_enet_interrupt_work(void *arg)
 
   /* Process pending Ethernet interrupts */
 
-  net_lock();
+  netdev_lock(&priv->dev);
 
   /* Get the set of unmasked, pending interrupt. */
 
@@ -1171,7 +1171,7 @@ static void imx9_enet_interrupt_work(void *arg)
         }
     }
 
-  net_unlock();
+  netdev_unlock(&priv->dev);
 
   /* Re-enable Ethernet interrupts */
 
@@ -1246,9 +1246,9 @@ static void imx9_txtimeout_work(void *arg)
 
   /* Then poll the network for new XMIT data */
 
-  net_lock();
+  netdev_lock(&priv->dev);
   imx9_dopoll(priv);
-  net_unlock();
+  netdev_unlock(&priv->dev);
 }
 
 /****************************************************************************
@@ -1520,7 +1520,7 @@ static void imx9_txavail_work(void *arg)
 
   /* Ignore the notification if the interface is not yet up */
 
-  net_lock();
+  netdev_lock(&priv->dev);
   if (priv->bifup)
     {
       /* Poll the network for new XMIT data */
@@ -1528,7 +1528,7 @@ static void imx9_txavail_work(void *arg)
       imx9_dopoll(priv);
     }
 
-  net_unlock();
+  netdev_unlock(&priv->dev);
 }
 
 /****************************************************************************
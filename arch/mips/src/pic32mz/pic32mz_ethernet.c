@@ -1723,7 +1723,7 @@ static void pic32mz_interrupt_work(void *arg)
 
   /* Process pending Ethernet interrupts */
 
-  net_lock();
+  netdev_lock(&priv->pd_dev);
 
   /* Get the interrupt status (zero means no interrupts pending). */
 
@@ -1868,7 +1868,7 @@ static void pic32mz_interrupt_work(void *arg)
 #else
   mips_clrpend_irq(PIC32MZ_IRQ_ETH);
 #endif
-  net_unlock();
+  netdev_unlock(&priv->pd_dev);
 
   /* Re-enable Ethernet interrupts */
 
@@ -1963,7 +1963,7 @@ static void pic32mz_txtimeout_work(void *arg)
 
   /* Increment statistics and dump debug info */
 
-  net_lock();
+  netdev_lock(&priv->pd_dev);
   NETDEV_TXTIMEOUTS(&priv->pd_dev);
   if (priv->pd_ifup)
     {
@@ -1980,7 +1980,7 @@ static void pic32mz_txtimeout_work(void *arg)
       pic32mz_poll(priv);
     }
 
-  net_unlock();
+  netdev_unlock(&priv->pd_dev);
 }
 
 /****************************************************************************
@@ -2413,7 +2413,7 @@ static void pic32mz_txavail_work(void *arg)
 
   /* Ignore the notification if the interface is not yet up */
 
-  net_lock();
+  netdev_lock(&priv->pd_dev);
   if (priv->pd_ifup)
     {
       /* Check if the next Tx descriptor is available. */
@@ -2428,7 +2428,7 @@ static void pic32mz_txavail_work(void *arg)
         }
     }
 
-  net_unlock();
+  netdev_unlock(&priv->pd_dev);
 }
 
 /****************************************************************************
@@ -1797,7 +1797,7 @@ static void rx65n_interrupt_work(void *arg)
 
   /* Process pending Ethernet interrupts */
 
-  net_lock();
+  netdev_lock(&priv->dev);
 
   /* Check and clear the Link Signal Change Flag */
 
@@ -1881,7 +1881,7 @@ static void rx65n_interrupt_work(void *arg)
       rx65n_txdone(priv);
     }
 
-  net_unlock();
+  netdev_unlock(&priv->dev);
 
   /* Re-enable Ethernet interrupts */
 
@@ -1965,7 +1965,7 @@ static void rx65n_txtimeout_work(void *arg)
 
   /* Reset the hardware.Just take the interface down, then back up again. */
 
-  net_lock();
+  netdev_lock(&priv->dev);
 
   /* Increment statistics */
 
@@ -1980,7 +1980,7 @@ static void rx65n_txtimeout_work(void *arg)
   /* Then poll for new XMIT data */
 
   rx65n_dopoll(priv);
-  net_unlock();
+  netdev_unlock(&priv->dev);
 }
 
 /****************************************************************************
@@ -2162,7 +2162,7 @@ static void rx65n_txavail_work(void *arg)
 
   /* Ignore the notification if the interface is not yet up */
 
-  net_lock();
+  netdev_lock(&priv->dev);
   if (priv->ifup)
     {
       /* Poll the network for new XMIT data */
@@ -2170,7 +2170,7 @@ static void rx65n_txavail_work(void *arg)
       rx65n_dopoll(priv);
     }
 
-  net_unlock();
+  netdev_unlock(&priv->dev);
 }
 
 /****************************************************************************
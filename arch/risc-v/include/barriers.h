@@ -41,4 +41,10 @@
 
 #define UP_ISB()       __asm__ __volatile__ ("fence.i" ::: "memory")
 
+/* UP_CPU_RELAX() is the Zihintpause PAUSE hint, encoded as the FENCE it
+ * is defined as, so that it also builds and runs without the extension.
+ */
+
+#define UP_CPU_RELAX() __asm__ __volatile__ (".word 0x0100000f" ::: "memory")
+
 #endif /* __ARCH_RISCV_INCLUDE_BARRIERS_H */
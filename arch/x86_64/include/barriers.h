@@ -30,5 +30,6 @@
 #define UP_RMB() __asm__ __volatile__ ("lfence" ::: "memory")
 #define UP_WMB() __asm__ __volatile__ ("sfence" ::: "memory")
 #define UP_WFE() __asm__ __volatile__ ("pause")
+#define UP_CPU_RELAX() __asm__ __volatile__ ("pause" ::: "memory")
 
 #endif /* __ARCH_X86_64_INCLUDE_BARRIERS_H */
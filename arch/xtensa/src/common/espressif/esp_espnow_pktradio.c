@@ -906,7 +906,7 @@ static void espnow_rxwork(void *arg)
 
   /* Loop while there are frames to be processed, send them to sixlowpan */
 
-  net_lock();
+  netdev_lock(&priv->radio.r_dev);
 
   while ((iob = espnow_rxheadget(priv)))
     {
@@ -937,7 +937,7 @@ static void espnow_rxwork(void *arg)
         }
     }
 
-  net_unlock();
+  netdev_unlock(&priv->radio.r_dev);
 }
 
 /****************************************************************************
@@ -958,12 +958,12 @@ static void espnow_txtimeout_work(void *arg)
 {
   struct espnow_driver_s *priv = (struct espnow_driver_s *)arg;
 
-  net_lock();
+  netdev_lock(&priv->radio.r_dev);
 
   espnow_ifdown(&priv->radio.r_dev);
   espnow_ifup(&priv->radio.r_dev);
 
-  net_unlock();
+  netdev_unlock(&priv->radio.r_dev);
 }
 
 /****************************************************************************
@@ -1174,7 +1174,7 @@ static void espnow_txavail_work(FAR void *arg)
 
   ninfo("TX available work. IP up: %u\n", priv->bifup);
 
-  net_lock();
+  netdev_lock(&priv->radio.r_dev);
 
   /* Ignore the notification if the interface is not yet up */
 
@@ -1193,7 +1193,7 @@ static void espnow_txavail_work(FAR void *arg)
       devif_poll(&priv->radio.r_dev, espnow_txpoll_callback);
     }
 
-  net_unlock();
+  netdev_unlock(&priv->radio.r_dev);
 }
 
 /****************************************************************************
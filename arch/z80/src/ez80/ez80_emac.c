@@ -1472,7 +1472,7 @@ static void ez80emac_txinterrupt_work(FAR void *arg)
 
   /* Process pending Ethernet Tx interrupts */
 
-  net_lock();
+  netdev_lock(&priv->dev);
 
   /* EMAC Tx interrupts:
    *
@@ -1555,7 +1555,7 @@ static void ez80emac_txinterrupt_work(FAR void *arg)
       wd_cancel(&priv->txtimeout);
     }
 
-  net_unlock();
+  netdev_unlock(&priv->dev);
 
   /* Re-enable Ethernet Tx interrupts */
 
@@ -1635,7 +1635,7 @@ static void ez80emac_rxinterrupt_work(FAR void *arg)
 
   /* Process pending Ethernet Rx interrupts */
 
-  net_lock();
+  netdev_lock(&priv->dev);
 
   /* EMAC Rx interrupts:
    *
@@ -1657,7 +1657,7 @@ static void ez80emac_rxinterrupt_work(FAR void *arg)
   /* Process any RX packets pending the RX buffer */
 
   ez80emac_receive(priv);
-  net_unlock();
+  netdev_unlock(&priv->dev);
 
   /* Re-enable Ethernet Rx interrupts */
 
@@ -1722,7 +1722,7 @@ static void ez80emac_sysinterrupt_work(FAR void *arg)
 
   /* Process pending system interrupts */
 
-  net_lock();
+  netdev_lock(&priv->dev);
 
   /* EMAC system interrupts :
    *
@@ -1781,7 +1781,7 @@ static void ez80emac_sysinterrupt_work(FAR void *arg)
       EMAC_STAT(priv, rx_ovrerrors);
     }
 
-  net_unlock();
+  netdev_unlock(&priv->dev);
 
   /* Re-enable Ethernet system interrupts */
 
@@ -1846,7 +1846,7 @@ static void ez80emac_txtimeout_work(FAR void *arg)
 
   /* Process pending Ethernet interrupts */
 
-  net_lock();
+  netdev_lock(&priv->dev);
 
   /* Increment statistics and dump debug info */
 
@@ -1863,7 +1863,7 @@ static void ez80emac_txtimeout_work(FAR void *arg)
   /* Then poll the network for new XMIT data */
 
   devif_poll(&priv->dev, ez80emac_txpoll);
-  net_unlock();
+  netdev_unlock(&priv->dev);
 }
 
 /****************************************************************************
@@ -2070,7 +2070,7 @@ static void ez80emac_txavail_work(FAR void *arg)
 
   /* Ignore the notification if the interface is not yet up */
 
-  net_lock();
+  netdev_lock(&priv->dev);
   if (priv->bifup)
     {
       /* Check if there is room in the hardware to hold another packet. */
@@ -2080,7 +2080,7 @@ static void ez80emac_txavail_work(FAR void *arg)
       devif_poll(&priv->dev, ez80emac_txpoll);
     }
 
-  net_unlock();
+  netdev_unlock(&priv->dev);
 }
 
 /****************************************************************************
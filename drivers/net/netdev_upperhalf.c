@@ -35,10 +35,15 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/kthread.h>
 #include <nuttx/mm/iob.h>
+#include <nuttx/mutex.h>
 #include <nuttx/net/can.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev_lowerhalf.h>
 #include <nuttx/net/pkt.h>
+#ifdef CONFIG_NETDEV_GRO
+#  include <nuttx/net/ethernet.h>
+#  include <nuttx/net/tcp.h>
+#endif
 #include <nuttx/net/vlan.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/spinlock.h>
@@ -70,6 +75,30 @@ struct netdev_thread_s
   sem_t sem_exit;
 };
 
+#ifdef CONFIG_NETDEV_GRO
+/* A TCP segment that is a candidate for the receive coalescing */
+
+struct netdev_gro_seg_s
+{
+  FAR struct tcp_hdr_s *tcp; /* TCP header */
+  uint32_t seq;              /* Sequence number */
+  uint16_t iphdrlen;         /* Length of the IP header */
+  uint16_t hdrlen;           /* Length of the IP and TCP headers */
+  uint16_t paylen;           /* Length of the TCP payload */
+  uint16_t sum;              /* Partial checksum of the payload */
+};
+
+/* The TCP flow being coalesced in the current poll */
+
+struct netdev_gro_s
+{
+  FAR netpkt_t *pkt;         /* Coalesced packet, NULL if none */
+  struct netdev_gro_seg_s seg; /* Headers of pkt, length of all payload */
+  uint32_t nextseq;          /* Sequence number expected next */
+  uint16_t nsegs;            /* Number of segments in pkt */
+};
+#endif
+
 /* This structure describes the state of the upper half driver */
 
 struct netdev_upperhalf_s
@@ -84,10 +113,15 @@ struct netdev_upperhalf_s
 
 #ifdef CONFIG_NET_VLAN
   struct netdev_vlan_entry_s vlan[CONFIG_NET_VLAN_COUNT];
+  rmutex_t vlan_lock; /* Protects vlan[], instead of the global net lock */
 #endif
 
   bool txing;
 
+#ifdef CONFIG_NETDEV_GRO
+  struct netdev_gro_s gro;
+#endif
+
   /* Deferring process to work queue or thread */
 
   union
@@ -227,6 +261,10 @@ netdev_upper_alloc(FAR struct netdev_lowerhalf_s *dev, size_t extra_size)
   upper->lower = dev;
   dev->netdev.d_private = upper;
 
+#ifdef CONFIG_NET_VLAN
+  nxrmutex_init(&upper->vlan_lock);
+#endif
+
   return upper;
 }
 
@@ -255,6 +293,28 @@ static inline bool netdev_upper_can_tx(FAR struct netdev_upperhalf_s *upper)
   return quota > 0;
 }
 
+/****************************************************************************
+ * Name: netdev_upper_maxlen
+ *
+ * Description:
+ *   Get the largest frame that may be handed to the lower half, TCP
+ *   super-segments are larger than the MTU on devices segmenting them.
+ *
+ ****************************************************************************/
+
+static inline unsigned int netdev_upper_maxlen(FAR struct net_driver_s *dev)
+{
+#ifdef CONFIG_NET_TCP_GSO
+  if ((dev->d_features & (NETDEV_TX_TSO4 | NETDEV_TX_TSO6)) != 0 &&
+      dev->d_tso_maxsize + NET_LL_HDRLEN(dev) > NETDEV_PKTSIZE(dev))
+    {
+      return dev->d_tso_maxsize + NET_LL_HDRLEN(dev);
+    }
+#endif
+
+  return NETDEV_PKTSIZE(dev);
+}
+
 /****************************************************************************
  * Name: netdev_upper_txpoll
  *
@@ -299,7 +359,7 @@ static int netdev_upper_txpoll(FAR struct net_driver_s *dev)
 
   pkt = netpkt_get(dev, NETPKT_TX);
 
-  if (netpkt_getdatalen(lower, pkt) > NETDEV_PKTSIZE(dev))
+  if (netpkt_getdatalen(lower, pkt) > netdev_upper_maxlen(dev))
     {
       nerr("ERROR: Packet too long to send!\n");
       ret = -EMSGSIZE;
@@ -484,7 +544,7 @@ netdev_upper_vlan_foreach(FAR struct netdev_upperhalf_s *upper,
 {
   int i;
 
-  net_lock();
+  nxrmutex_lock(&upper->vlan_lock);
   for (i = 0; i < CONFIG_NET_VLAN_COUNT; i++)
     {
       if (upper->vlan[i].dev)
@@ -493,7 +553,7 @@ netdev_upper_vlan_foreach(FAR struct netdev_upperhalf_s *upper,
         }
     }
 
-  net_unlock();
+  nxrmutex_unlock(&upper->vlan_lock);
 }
 #endif
 
@@ -527,6 +587,11 @@ static void eth_input(FAR struct net_driver_s *dev)
       FAR struct eth_8021qhdr_s *vlan_hdr = NETLLBUF;
       uint16_t vid = NTOHS(vlan_hdr->tci) & VLAN_VID_MASK;
 
+      /* Keep the VLAN device from being removed while it handles the
+       * packet.
+       */
+
+      nxrmutex_lock(&upper->vlan_lock);
       vlan = netdev_upper_vlan_dev(upper, vid);
       if (vlan)
         {
@@ -557,6 +622,8 @@ static void eth_input(FAR struct net_driver_s *dev)
           NETDEV_RXDROPPED(dev);
           dev->d_len = 0;
         }
+
+      nxrmutex_unlock(&upper->vlan_lock);
     }
   else
 #endif
@@ -687,6 +754,478 @@ static void ip_input(FAR struct net_driver_s *dev)
 }
 #endif
 
+/****************************************************************************
+ * Name: netdev_upper_input
+ *
+ * Description:
+ *   Pass one received packet into the network stack.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static void netdev_upper_input(FAR struct netdev_upperhalf_s *upper,
+                               FAR netpkt_t *pkt)
+{
+  FAR struct net_driver_s *dev = &upper->lower->netdev;
+
+  netpkt_put(dev, pkt, NETPKT_RX);
+
+#ifndef CONFIG_NETDEV_GRO
+  /* With GRO, the frames were counted and tapped before being coalesced */
+
+  NETDEV_RXPACKETS(dev);
+
+#  ifdef CONFIG_NET_PKT
+  /* When packet sockets are enabled, feed the frame into the tap */
+
+  pkt_input(dev);
+#  endif
+#endif
+
+  switch (dev->d_lltype)
+    {
+#ifdef CONFIG_NET_LOOPBACK
+    case NET_LL_LOOPBACK:
+#endif
+#ifdef CONFIG_NET_ETHERNET
+    case NET_LL_ETHERNET:
+#endif
+#ifdef CONFIG_DRIVERS_IEEE80211
+    case NET_LL_IEEE80211:
+#endif
+#if defined(CONFIG_NET_LOOPBACK) || defined(CONFIG_NET_ETHERNET) || \
+    defined(CONFIG_DRIVERS_IEEE80211)
+      eth_input(dev);
+      break;
+#endif
+#ifdef CONFIG_NET_MBIM
+    case NET_LL_MBIM:
+      ip_input(dev);
+      break;
+#endif
+#ifdef CONFIG_NET_CAN
+    case NET_LL_CAN:
+      ninfo("CAN frame");
+      can_input(dev);
+      break;
+#endif
+    default:
+      nerr("Unknown link type %d\n", dev->d_lltype);
+      break;
+    }
+}
+
+#ifdef CONFIG_NETDEV_GRO
+
+/****************************************************************************
+ * Name: netdev_gro_csum_add
+ *
+ * Description:
+ *   One's complement addition of two partial checksums.
+ *
+ ****************************************************************************/
+
+static uint16_t netdev_gro_csum_add(uint16_t sum1, uint16_t sum2)
+{
+  uint32_t sum = (uint32_t)sum1 + sum2;
+
+  return (uint16_t)((sum & 0xffff) + (sum >> 16));
+}
+
+/****************************************************************************
+ * Name: netdev_gro_header_csum
+ *
+ * Description:
+ *   Return the partial checksum of the pseudo header and the TCP header of
+ *   a segment carrying paylen bytes of payload.
+ *
+ ****************************************************************************/
+
+static uint16_t netdev_gro_header_csum(FAR netpkt_t *pkt,
+                                       FAR struct netdev_gro_seg_s *seg,
+                                       uint16_t paylen)
+{
+  FAR uint8_t *l3 = IOB_DATA(pkt);
+  uint16_t tcplen = seg->hdrlen - seg->iphdrlen;
+  uint16_t sum = tcplen + paylen + IP_PROTO_TCP;
+
+#ifdef CONFIG_NET_IPv4
+  if ((l3[0] & IP_VERSION_MASK) == IPv4_VERSION)
+    {
+      FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)l3;
+
+      sum = chksum(sum, (FAR uint8_t *)ipv4->srcipaddr,
+                   2 * sizeof(in_addr_t));
+    }
+#endif
+#ifdef CONFIG_NET_IPv6
+  if ((l3[0] & IP_VERSION_MASK) == IPv6_VERSION)
+    {
+      FAR struct ipv6_hdr_s *ipv6 = (FAR struct ipv6_hdr_s *)l3;
+
+      sum = chksum(sum, (FAR uint8_t *)ipv6->srcipaddr,
+                   2 * sizeof(net_ipv6addr_t));
+    }
+#endif
+
+  return chksum(sum, (FAR uint8_t *)seg->tcp, tcplen);
+}
+
+/****************************************************************************
+ * Name: netdev_gro_parse
+ *
+ * Description:
+ *   Check whether a received frame is a TCP data segment addressed to this
+ *   device that may be coalesced, and locate its headers.  Unless the
+ *   hardware has verified them, the checksums are checked here, the stack
+ *   cannot check the merged packet against the original segments.
+ *
+ ****************************************************************************/
+
+static bool netdev_gro_parse(FAR struct net_driver_s *dev,
+                             FAR netpkt_t *pkt,
+                             FAR struct netdev_gro_seg_s *seg)
+{
+  FAR uint8_t *l3 = IOB_DATA(pkt);
+  uint16_t totlen;
+  uint16_t sum;
+  uint8_t version;
+
+  switch (dev->d_lltype)
+    {
+#ifdef CONFIG_NET_ETHERNET
+    case NET_LL_ETHERNET:
+#endif
+#ifdef CONFIG_DRIVERS_IEEE80211
+    case NET_LL_IEEE80211:
+#endif
+#if defined(CONFIG_NET_ETHERNET) || defined(CONFIG_DRIVERS_IEEE80211)
+      {
+        FAR struct eth_hdr_s *eth =
+          (FAR struct eth_hdr_s *)(l3 - NET_LL_HDRLEN(dev));
+
+        if (eth->type != HTONS(ETHTYPE_IP) && eth->type != HTONS(ETHTYPE_IP6))
+          {
+            return false;
+          }
+      }
+      break;
+#endif
+#ifdef CONFIG_NET_MBIM
+    case NET_LL_MBIM:
+      break;
+#endif
+    default:
+      return false;
+    }
+
+  if (pkt->io_len == 0)
+    {
+      return false;
+    }
+
+  version = l3[0] & IP_VERSION_MASK;
+
+#ifdef CONFIG_NET_IPv4
+  if (version == IPv4_VERSION)
+    {
+      FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)l3;
+
+      /* No options, no fragments, to one of our addresses, as a merged
+       * packet must not be forwarded.
+       */
+
+      if (pkt->io_len < IPv4_HDRLEN + TCP_HDRLEN ||
+          ipv4->vhl != 0x45 || ipv4->proto != IP_PROTO_TCP ||
+          (ipv4->ipoffset[0] & 0x3f) != 0 || ipv4->ipoffset[1] != 0 ||
+          !net_ipv4addr_cmp(net_ip4addr_conv32(ipv4->destipaddr),
+                            dev->d_ipaddr))
+        {
+          return false;
+        }
+
+      if ((dev->d_features & NETDEV_RX_CSUM) == 0 &&
+          ipv4_chksum(ipv4) != 0xffff)
+        {
+          return false;
+        }
+
+      totlen = (ipv4->len[0] << 8) + ipv4->len[1];
+      seg->iphdrlen = IPv4_HDRLEN;
+    }
+  else
+#endif
+#ifdef CONFIG_NET_IPv6
+  if (version == IPv6_VERSION)
+    {
+      FAR struct ipv6_hdr_s *ipv6 = (FAR struct ipv6_hdr_s *)l3;
+
+      if (pkt->io_len < IPv6_HDRLEN + TCP_HDRLEN ||
+          ipv6->proto != IP_PROTO_TCP ||
+          !NETDEV_IS_MY_V6ADDR(dev, ipv6->destipaddr))
+        {
+          return false;
+        }
+
+      totlen = IPv6_HDRLEN + (ipv6->len[0] << 8) + ipv6->len[1];
+      seg->iphdrlen = IPv6_HDRLEN;
+    }
+  else
+#endif
+    {
+      return false;
+    }
+
+  /* Only the plain ACK segments with data are coalesced */
+
+  seg->tcp = (FAR struct tcp_hdr_s *)(l3 + seg->iphdrlen);
+  seg->hdrlen = seg->iphdrlen + ((seg->tcp->tcpoffset >> 4) << 2);
+
+  if ((seg->tcp->flags & TCP_CTL) != TCP_ACK &&
+      (seg->tcp->flags & TCP_CTL) != (TCP_ACK | TCP_PSH))
+    {
+      return false;
+    }
+
+  if (totlen > pkt->io_pktlen || totlen <= seg->hdrlen ||
+      seg->hdrlen > pkt->io_len)
+    {
+      return false;
+    }
+
+  /* Drop the link layer padding */
+
+  if (totlen < pkt->io_pktlen)
+    {
+      iob_update_pktlen(pkt, totlen, false);
+    }
+
+  seg->seq    = ((uint32_t)seg->tcp->seqno[0] << 24) |
+                ((uint32_t)seg->tcp->seqno[1] << 16) |
+                ((uint32_t)seg->tcp->seqno[2] << 8) |
+                seg->tcp->seqno[3];
+  seg->paylen = totlen - seg->hdrlen;
+  seg->sum    = 0;
+
+  if ((dev->d_features & NETDEV_RX_CSUM) == 0)
+    {
+      seg->sum = chksum_iob(0, pkt, seg->hdrlen);
+      sum = netdev_gro_header_csum(pkt, seg, seg->paylen);
+      sum = netdev_gro_csum_add(sum, seg->sum);
+      if (sum != 0xffff && sum != 0)
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: netdev_gro_match
+ *
+ * Description:
+ *   Check whether a segment continues the flow being coalesced.
+ *
+ ****************************************************************************/
+
+static bool netdev_gro_match(FAR struct netdev_gro_s *gro,
+                             FAR netpkt_t *pkt,
+                             FAR struct netdev_gro_seg_s *seg)
+{
+  FAR struct tcp_hdr_s *tcp = gro->seg.tcp;
+  FAR uint8_t *l3 = IOB_DATA(gro->pkt);
+  FAR uint8_t *l3new = IOB_DATA(pkt);
+
+  /* Same addresses and ports, same ACK and options, the next in order and
+   * there is room for it.  The payload so far must have an even length to
+   * keep the partial checksums aligned.
+   */
+
+  if (seg->hdrlen != gro->seg.hdrlen || seg->seq != gro->nextseq ||
+      (gro->seg.paylen & 1) != 0 ||
+      gro->seg.hdrlen + gro->seg.paylen + seg->paylen >
+      CONFIG_NETDEV_GRO_MAXSIZE ||
+      (tcp->flags & TCP_PSH) != 0 ||
+      tcp->srcport != seg->tcp->srcport ||
+      tcp->destport != seg->tcp->destport ||
+      memcmp(tcp->ackno, seg->tcp->ackno, 4) != 0 ||
+      memcmp(tcp->optdata, seg->tcp->optdata,
+             seg->hdrlen - seg->iphdrlen - TCP_HDRLEN) != 0)
+    {
+      return false;
+    }
+
+#ifdef CONFIG_NET_IPv4
+  if ((l3[0] & IP_VERSION_MASK) == IPv4_VERSION)
+    {
+      FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)l3;
+      FAR struct ipv4_hdr_s *ipv4new = (FAR struct ipv4_hdr_s *)l3new;
+
+      return (l3new[0] & IP_VERSION_MASK) == IPv4_VERSION &&
+             ipv4->tos == ipv4new->tos && ipv4->ttl == ipv4new->ttl &&
+             memcmp(ipv4->srcipaddr, ipv4new->srcipaddr,
+                    sizeof(in_addr_t)) == 0;
+    }
+#endif
+#ifdef CONFIG_NET_IPv6
+  if ((l3[0] & IP_VERSION_MASK) == IPv6_VERSION)
+    {
+      FAR struct ipv6_hdr_s *ipv6 = (FAR struct ipv6_hdr_s *)l3;
+      FAR struct ipv6_hdr_s *ipv6new = (FAR struct ipv6_hdr_s *)l3new;
+
+      return memcmp(ipv6, ipv6new, 4) == 0 && ipv6->ttl == ipv6new->ttl &&
+             net_ipv6addr_cmp(ipv6->srcipaddr, ipv6new->srcipaddr) &&
+             net_ipv6addr_cmp(ipv6->destipaddr, ipv6new->destipaddr);
+    }
+#endif
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: netdev_gro_flush
+ *
+ * Description:
+ *   Fix up the headers of the coalesced packet and pass it to the stack.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static void netdev_gro_flush(FAR struct netdev_upperhalf_s *upper)
+{
+  FAR struct net_driver_s *dev = &upper->lower->netdev;
+  FAR struct netdev_gro_s *gro = &upper->gro;
+  FAR netpkt_t *pkt = gro->pkt;
+  FAR uint8_t *l3;
+  uint16_t totlen;
+  uint16_t sum;
+
+  if (pkt == NULL)
+    {
+      return;
+    }
+
+  gro->pkt = NULL;
+
+  if (gro->nsegs > 1)
+    {
+      l3 = IOB_DATA(pkt);
+      totlen = gro->seg.hdrlen + gro->seg.paylen;
+
+#ifdef CONFIG_NET_IPv4
+      if ((l3[0] & IP_VERSION_MASK) == IPv4_VERSION)
+        {
+          FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)l3;
+
+          ipv4->len[0]   = totlen >> 8;
+          ipv4->len[1]   = totlen & 0xff;
+          ipv4->ipchksum = 0;
+          ipv4->ipchksum = ~ipv4_chksum(ipv4);
+        }
+#endif
+#ifdef CONFIG_NET_IPv6
+      if ((l3[0] & IP_VERSION_MASK) == IPv6_VERSION)
+        {
+          FAR struct ipv6_hdr_s *ipv6 = (FAR struct ipv6_hdr_s *)l3;
+
+          ipv6->len[0] = (totlen - IPv6_HDRLEN) >> 8;
+          ipv6->len[1] = (totlen - IPv6_HDRLEN) & 0xff;
+        }
+#endif
+
+      if ((dev->d_features & NETDEV_RX_CSUM) == 0)
+        {
+          gro->seg.tcp->tcpchksum = 0;
+          sum = netdev_gro_header_csum(pkt, &gro->seg, gro->seg.paylen);
+          sum = netdev_gro_csum_add(sum, gro->seg.sum);
+          gro->seg.tcp->tcpchksum = ~((sum == 0) ? 0xffff : HTONS(sum));
+        }
+
+      NETDEV_RXGRO(dev, gro->nsegs);
+    }
+
+  netdev_upper_input(upper, pkt);
+}
+
+/****************************************************************************
+ * Name: netdev_gro_receive
+ *
+ * Description:
+ *   Try to coalesce a received frame into the current flow.
+ *
+ * Returned Value:
+ *   True if the frame was taken, false if it should be passed to the
+ *   stack as is (after everything coalesced before it).
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static bool netdev_gro_receive(FAR struct netdev_upperhalf_s *upper,
+                               FAR netpkt_t *pkt)
+{
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
+  FAR struct netdev_gro_s *gro = &upper->gro;
+  struct netdev_gro_seg_s seg;
+
+  if (!netdev_gro_parse(&lower->netdev, pkt, &seg))
+    {
+      netdev_gro_flush(upper);
+      return false;
+    }
+
+  if (gro->pkt != NULL && netdev_gro_match(gro, pkt, &seg))
+    {
+      FAR struct tcp_hdr_s *tcp = gro->seg.tcp;
+
+      /* Take the window and the PSH flag of the latest segment */
+
+      tcp->flags  |= seg.tcp->flags & TCP_PSH;
+      tcp->wnd[0]  = seg.tcp->wnd[0];
+      tcp->wnd[1]  = seg.tcp->wnd[1];
+
+      gro->seg.sum = netdev_gro_csum_add(gro->seg.sum, seg.sum);
+      gro->seg.paylen += seg.paylen;
+      gro->nextseq += seg.paylen;
+      gro->nsegs++;
+
+      netpkt_concat(lower, gro->pkt, iob_trimhead(pkt, seg.hdrlen),
+                    NETPKT_RX);
+
+      /* The sender flushed its buffer, so does the receive offload */
+
+      if ((tcp->flags & TCP_PSH) != 0)
+        {
+          netdev_gro_flush(upper);
+        }
+
+      return true;
+    }
+
+  /* A new flow, or a segment that cannot be merged, starts over */
+
+  netdev_gro_flush(upper);
+
+  if ((seg.tcp->flags & TCP_PSH) != 0)
+    {
+      return false;
+    }
+
+  gro->pkt     = pkt;
+  gro->seg     = seg;
+  gro->nextseq = seg.seq + seg.paylen;
+  gro->nsegs   = 1;
+  return true;
+}
+
+#endif /* CONFIG_NETDEV_GRO */
+
 /****************************************************************************
  * Function: netdev_upper_rxpoll_work
  *
@@ -723,48 +1262,37 @@ static void netdev_upper_rxpoll_work(FAR struct netdev_upperhalf_s *upper)
           continue;
         }
 
-      netpkt_put(dev, pkt, NETPKT_RX);
-      NETDEV_RXPACKETS(dev);
+#ifdef CONFIG_NETDEV_GRO
+      /* Count and tap every frame as received on the wire, so that the
+       * statistics and packet sockets do not depend on the coalescing.
+       */
 
-#ifdef CONFIG_NET_PKT
-      /* When packet sockets are enabled, feed the frame into the tap */
+      NETDEV_RXPACKETS(dev);
 
+#  ifdef CONFIG_NET_PKT
+      netpkt_put(dev, pkt, NETPKT_RX);
       pkt_input(dev);
-#endif
+      pkt = netpkt_get(dev, NETPKT_RX);
+#  endif
 
-      switch (dev->d_lltype)
+      /* Coalesce the consecutive segments of a TCP flow received in this
+       * poll, they are passed to the stack when the flow changes or there
+       * is nothing more to receive.
+       */
+
+      if (netdev_gro_receive(upper, pkt))
         {
-#ifdef CONFIG_NET_LOOPBACK
-        case NET_LL_LOOPBACK:
-#endif
-#ifdef CONFIG_NET_ETHERNET
-        case NET_LL_ETHERNET:
-#endif
-#ifdef CONFIG_DRIVERS_IEEE80211
-        case NET_LL_IEEE80211:
-#endif
-#if defined(CONFIG_NET_LOOPBACK) || defined(CONFIG_NET_ETHERNET) || \
-    defined(CONFIG_DRIVERS_IEEE80211)
-          eth_input(dev);
-          break;
-#endif
-#ifdef CONFIG_NET_MBIM
-        case NET_LL_MBIM:
-          ip_input(dev);
-          break;
-#endif
-#ifdef CONFIG_NET_CAN
-        case NET_LL_CAN:
-          ninfo("CAN frame");
-          can_input(dev);
-          break;
-#endif
-        default:
-          nerr("Unknown link type %d\n", dev->d_lltype);
-          break;
+          continue;
         }
+#endif
+
+      netdev_upper_input(upper, pkt);
     }
 
+#ifdef CONFIG_NETDEV_GRO
+  netdev_gro_flush(upper);
+#endif
+
   netdev_unlock(dev);
 }
 
@@ -1435,6 +1963,9 @@ int netdev_lower_register(FAR struct netdev_lowerhalf_s *dev,
   if (ret < 0)
     {
       nerr("ERROR: Netdev_register failed: %d\n", ret);
+#ifdef CONFIG_NET_VLAN
+      nxrmutex_destroy(&upper->vlan_lock);
+#endif
       kmm_free(upper);
       dev->netdev.d_private = NULL;
     }
@@ -1512,6 +2043,10 @@ int netdev_lower_unregister(FAR struct netdev_lowerhalf_s *dev)
   iob_free_queue(&upper->txq);
 #endif
 
+#ifdef CONFIG_NET_VLAN
+  nxrmutex_destroy(&upper->vlan_lock);
+#endif
+
   kmm_free(upper);
   dev->netdev.d_private = NULL;
 
@@ -1644,12 +2179,15 @@ int netdev_lower_vlan_add(FAR struct netdev_lowerhalf_s *dev, uint16_t vid,
 {
   FAR struct netdev_upperhalf_s  *upper = dev->netdev.d_private;
   FAR struct netdev_vlan_entry_s *entry = NULL;
+  int ret = -ENOMEM;
   int i;
 
+  nxrmutex_lock(&upper->vlan_lock);
   for (i = 0; i < CONFIG_NET_VLAN_COUNT; i++)
     {
       if (upper->vlan[i].vid == vid)
         {
+          nxrmutex_unlock(&upper->vlan_lock);
           return -EEXIST;
         }
 
@@ -1663,10 +2201,11 @@ int netdev_lower_vlan_add(FAR struct netdev_lowerhalf_s *dev, uint16_t vid,
     {
       entry->vid = vid;
       entry->dev = vlan;
-      return OK;
+      ret = OK;
     }
 
-  return -ENOMEM;
+  nxrmutex_unlock(&upper->vlan_lock);
+  return ret;
 }
 
 /****************************************************************************
@@ -1687,19 +2226,23 @@ int netdev_lower_vlan_add(FAR struct netdev_lowerhalf_s *dev, uint16_t vid,
 int netdev_lower_vlan_del(FAR struct netdev_lowerhalf_s *dev, uint16_t vid)
 {
   FAR struct netdev_upperhalf_s *upper = dev->netdev.d_private;
+  int ret = -ENOENT;
   int i;
 
+  nxrmutex_lock(&upper->vlan_lock);
   for (i = 0; i < CONFIG_NET_VLAN_COUNT; i++)
     {
       if (upper->vlan[i].vid == vid)
         {
           upper->vlan[i].vid = 0;
           upper->vlan[i].dev = NULL;
-          return OK;
+          ret = OK;
+          break;
         }
     }
 
-  return -ENOENT;
+  nxrmutex_unlock(&upper->vlan_lock);
+  return ret;
 }
 #endif
 
@@ -1770,6 +2313,28 @@ void netpkt_free(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt,
   iob_free_chain(pkt);
 }
 
+/****************************************************************************
+ * Name: netpkt_concat
+ *
+ * Description:
+ *   Append the data of pkt2 to the end of pkt1, used when one frame is
+ *   received into several netpkts.
+ *
+ * Input Parameters:
+ *   dev  - The lower half device driver structure
+ *   pkt1 - The packet to append to
+ *   pkt2 - The packet to be appended
+ *   type - Whether used for TX or RX
+ *
+ ****************************************************************************/
+
+void netpkt_concat(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt1,
+                   FAR netpkt_t *pkt2, enum netpkt_type_e type)
+{
+  atomic_fetch_add(&dev->quota_ptr[type], 1);
+  iob_concat(pkt1, pkt2);
+}
+
 /****************************************************************************
  * Name: netpkt_copyin
  *
@@ -493,9 +493,9 @@ static void oa_tc6_recovery_work(FAR void *arg)
 
       nxmutex_unlock(&priv->lock);
 
-      net_lock();
+      netdev_lock(&priv->dev.netdev);
       netdev_ifdown(&priv->dev.netdev);
-      net_unlock();
+      netdev_unlock(&priv->dev.netdev);
 
       return;
     }
@@ -535,9 +535,9 @@ static void oa_tc6_enter_recovery(FAR struct oa_tc6_driver_s *priv)
 
   priv->ifstate = OA_TC6_IFSTATE_UP_RECOVERY;
 
-  net_lock();
+  netdev_lock(&priv->dev.netdev);
   netdev_lower_carrier_off(&priv->dev);
-  net_unlock();
+  netdev_unlock(&priv->dev.netdev);
 
   work_queue(OA_TC6_WORK, &priv->recovery_work,
              oa_tc6_recovery_work, priv,
@@ -562,9 +562,9 @@ static void oa_tc6_exit_recovery(FAR struct oa_tc6_driver_s *priv)
 {
   priv->ifstate = OA_TC6_IFSTATE_UP;
 
-  net_lock();
+  netdev_lock(&priv->dev.netdev);
   netdev_lower_carrier_on(&priv->dev);
-  net_unlock();
+  netdev_unlock(&priv->dev.netdev);
 
   work_queue(OA_TC6_WORK, &priv->interrupt_work,
              oa_tc6_interrupt_work, priv, 0);
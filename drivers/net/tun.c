@@ -62,11 +62,14 @@
 #include <nuttx/spinlock.h>
 #include <nuttx/mutex.h>
 #include <nuttx/wqueue.h>
+#include <nuttx/fs/fs.h>
 #include <nuttx/mm/iob.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/ip.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/ethernet.h>
+#include <nuttx/net/tcp.h>
+#include <nuttx/net/udp.h>
 #include <nuttx/net/tun.h>
 
 #if defined(CONFIG_NET) && defined(CONFIG_NET_TUN)
@@ -110,10 +113,52 @@
 #  define ETHBUF ((FAR struct eth_hdr_s *)NETLLBUF)
 #endif
 
+#ifndef CONFIG_NET_TUN_QUEUELEN
+#  define CONFIG_NET_TUN_QUEUELEN 1
+#endif
+
+#ifndef CONFIG_NET_TUN_NQUEUES
+#  define CONFIG_NET_TUN_NQUEUES 1
+#endif
+
+/* The TUNSETIFF flags kept for the interface */
+
+#ifdef CONFIG_NET_TUN_VNET_HDR
+#  define TUN_IFF_FLAGS (IFF_MASK | IFF_NO_PI | IFF_MULTI_QUEUE | \
+                         IFF_VNET_HDR)
+#else
+#  define TUN_IFF_FLAGS (IFF_MASK | IFF_NO_PI | IFF_MULTI_QUEUE)
+#endif
+
+/* The IFF_BATCH length prefix */
+
+#define TUN_BATCH_HDRLEN sizeof(uint16_t)
+
+#define tun_queue_full(q) ((q)->count >= CONFIG_NET_TUN_QUEUELEN)
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+/* The tun_queue_s holds the outgoing packets of one file descriptor */
+
+struct tun_device_s;
+struct tun_queue_s
+{
+  FAR struct tun_device_s *priv; /* The interface of the queue */
+  FAR struct pollfd *poll_fds;
+  bool              attached;  /* A file descriptor uses the queue */
+  bool              batch;     /* IFF_BATCH framing */
+  bool              read_wait;
+  bool              write_wait;
+  sem_t             read_wait_sem;
+  sem_t             write_wait_sem;
+  uint8_t           head;      /* Index of the oldest packet */
+  uint8_t           count;     /* Number of queued packets */
+  uint16_t          len[CONFIG_NET_TUN_QUEUELEN];
+  FAR struct iob_s *pkt[CONFIG_NET_TUN_QUEUELEN];
+};
+
 /* The tun_device_s encapsulates all state information for a single hardware
  * interface
  */
@@ -121,23 +166,13 @@
 struct tun_device_s
 {
   bool              bifup;     /* true:ifup false:ifdown */
-  bool              read_wait;
-  bool              write_wait;
+  uint8_t           nqueues;   /* Number of attached queues */
+  uint16_t          flags;     /* TUNSETIFF flags */
   struct work_s     work;      /* For deferring poll work to the work queue */
-  FAR struct pollfd *poll_fds;
-  mutex_t           lock;
+  mutex_t           lock;      /* Protects the queues */
   spinlock_t        spinlock;   /* Spinlock to protect the driver state */
-  sem_t             read_wait_sem;
-  sem_t             write_wait_sem;
-  size_t            read_d_len;
-  size_t            write_d_len;
-
-  /* These packet buffer arrays required 16-bit alignment.  That alignment
-   * is assured only by the preceding wide data types.
-   */
 
-  FAR struct iob_s *read_buf;
-  FAR struct iob_s *write_buf;
+  struct tun_queue_s queue[CONFIG_NET_TUN_NQUEUES];
 
   /* This holds the information visible to the NuttX network */
 
@@ -158,10 +193,6 @@ struct tun_driver_s
 
 static void tun_fd_transmit(FAR struct tun_device_s *priv);
 static int  tun_txpoll(FAR struct net_driver_s *dev);
-#ifdef CONFIG_NET_ETHERNET
-static int  tun_txpoll_tap(FAR struct net_driver_s *dev);
-#endif
-static int  tun_txpoll_tun(FAR struct net_driver_s *dev);
 
 /* Interrupt handling */
 
@@ -185,19 +216,17 @@ static int tun_rmmac(FAR struct net_driver_s *dev, FAR const uint8_t *mac);
 
 static int tun_dev_init(FAR struct tun_device_s *priv,
                         FAR struct file *filep,
-                        FAR const char *devfmt, bool tun);
+                        FAR const char *devfmt, uint16_t flags);
 static void tun_dev_uninit(FAR struct tun_device_s *priv);
 
 /* File interface */
 
 static int tun_close(FAR struct file *filep);
-static ssize_t tun_read(FAR struct file *filep, FAR char *buffer,
-                        size_t buflen);
-static ssize_t tun_write(FAR struct file *filep, FAR const char *buffer,
-                         size_t buflen);
 static int tun_ioctl(FAR struct file *filep, int cmd, unsigned long arg);
 static int tun_poll(FAR struct file *filep, FAR struct pollfd *fds,
                     bool setup);
+static ssize_t tun_readv(FAR struct file *filep, FAR struct uio *uio);
+static ssize_t tun_writev(FAR struct file *filep, FAR struct uio *uio);
 
 /****************************************************************************
  * Private Data
@@ -214,13 +243,15 @@ static const struct file_operations g_tun_file_ops =
 {
   NULL,         /* open */
   tun_close,    /* close */
-  tun_read,     /* read */
-  tun_write,    /* write */
+  NULL,         /* read */
+  NULL,         /* write */
   NULL,         /* seek */
   tun_ioctl,    /* ioctl */
   NULL,         /* mmap */
   NULL,         /* truncate */
-  tun_poll      /* poll */
+  tun_poll,     /* poll */
+  tun_readv,    /* readv */
+  tun_writev    /* writev */
 };
 
 /****************************************************************************
@@ -231,32 +262,164 @@ static const struct file_operations g_tun_file_ops =
  * Name: tun_pollnotify
  ****************************************************************************/
 
-static void tun_pollnotify(FAR struct tun_device_s *priv,
+static void tun_pollnotify(FAR struct tun_queue_s *queue,
                            pollevent_t eventset)
 {
-  FAR struct pollfd *fds = priv->poll_fds;
+  FAR struct pollfd *fds = queue->poll_fds;
 
-  if (priv->read_wait && (eventset & POLLIN))
+  if (queue->read_wait && (eventset & POLLIN))
     {
-      priv->read_wait = false;
-      nxsem_post(&priv->read_wait_sem);
+      queue->read_wait = false;
+      nxsem_post(&queue->read_wait_sem);
     }
 
-  if (priv->write_wait && (eventset & POLLOUT))
+  if (queue->write_wait && (eventset & POLLOUT))
     {
-      priv->write_wait = false;
-      nxsem_post(&priv->write_wait_sem);
+      queue->write_wait = false;
+      nxsem_post(&queue->write_wait_sem);
     }
 
   poll_notify(&fds, 1, eventset);
 }
 
+/****************************************************************************
+ * Name: tun_full
+ *
+ * Description:
+ *   Check if no attached queue of the interface has room left.  The
+ *   network is only polled while one has.  A packet whose flow selects a
+ *   full queue is dropped, so that one slow reader does not stall the
+ *   other queues.
+ *
+ ****************************************************************************/
+
+static bool tun_full(FAR struct tun_device_s *priv)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_NET_TUN_NQUEUES; i++)
+    {
+      if (priv->queue[i].attached && !tun_queue_full(&priv->queue[i]))
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: tun_flow_hash
+ *
+ * Description:
+ *   Hash the addresses and the TCP/UDP ports of an IP packet, so that the
+ *   packets of a flow always go to the same queue.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_TUN_NQUEUES > 1
+static uint32_t tun_flow_hash(FAR struct iob_s *iob)
+{
+  FAR const uint8_t *ip = IOB_DATA(iob);
+  FAR const uint8_t *key;
+  uint32_t hash = 2166136261u;
+  unsigned int keylen;
+  unsigned int hdrlen;
+  unsigned int i;
+  uint8_t proto;
+
+#ifdef CONFIG_NET_IPv4
+  if (iob->io_len >= IPv4_HDRLEN &&
+      (ip[0] & IP_VERSION_MASK) == IPv4_VERSION)
+    {
+      FAR const struct ipv4_hdr_s *ipv4 =
+        (FAR const struct ipv4_hdr_s *)ip;
+
+      key    = (FAR const uint8_t *)ipv4->srcipaddr;
+      keylen = 2 * sizeof(in_addr_t);
+      hdrlen = (ipv4->vhl & IPv4_HLMASK) << 2;
+      proto  = (ipv4->ipoffset[0] & 0x3f) == 0 && ipv4->ipoffset[1] == 0 ?
+               ipv4->proto : 0;
+    }
+  else
+#endif
+#ifdef CONFIG_NET_IPv6
+  if (iob->io_len >= IPv6_HDRLEN &&
+      (ip[0] & IP_VERSION_MASK) == IPv6_VERSION)
+    {
+      FAR const struct ipv6_hdr_s *ipv6 =
+        (FAR const struct ipv6_hdr_s *)ip;
+
+      key    = (FAR const uint8_t *)ipv6->srcipaddr;
+      keylen = 2 * sizeof(net_ipv6addr_t);
+      hdrlen = IPv6_HDRLEN;
+      proto  = ipv6->proto;
+    }
+  else
+#endif
+    {
+      return 0;
+    }
+
+  for (i = 0; i < keylen; i++)
+    {
+      hash = (hash ^ key[i]) * 16777619u;
+    }
+
+  /* The ports lead both the TCP and the UDP header */
+
+  if ((proto == IP_PROTO_TCP || proto == IP_PROTO_UDP) &&
+      iob->io_len >= hdrlen + 4)
+    {
+      for (i = 0; i < 4; i++)
+        {
+          hash = (hash ^ ip[hdrlen + i]) * 16777619u;
+        }
+    }
+
+  return hash;
+}
+#endif
+
+/****************************************************************************
+ * Name: tun_select_queue
+ *
+ * Description:
+ *   Select the queue for the packet in dev->d_iob.
+ *
+ ****************************************************************************/
+
+static FAR struct tun_queue_s *
+tun_select_queue(FAR struct tun_device_s *priv)
+{
+  int index = 0;
+  int i;
+
+#if CONFIG_NET_TUN_NQUEUES > 1
+  if (priv->nqueues > 1)
+    {
+      index = tun_flow_hash(priv->dev.d_iob) % priv->nqueues;
+    }
+#endif
+
+  for (i = 0; i < CONFIG_NET_TUN_NQUEUES - 1; i++)
+    {
+      if (priv->queue[i].attached && index-- == 0)
+        {
+          break;
+        }
+    }
+
+  DEBUGASSERT(priv->queue[i].attached);
+  return &priv->queue[i];
+}
+
 /****************************************************************************
  * Name: tun_fd_transmit
  *
  * Description:
- *   Start hardware transmission.  Called either from the txdone interrupt
- *   handling or from watchdog based polling.
+ *   Start hardware transmission: queue the packet in dev->d_iob for the
+ *   reader of its flow, or drop it if that reader's queue is full.
  *
  * Input Parameters:
  *   priv - Reference to the driver state structure
@@ -265,15 +428,30 @@ static void tun_pollnotify(FAR struct tun_device_s *priv,
  *   None
  *
  * Assumptions:
- *   May or may not be called from an interrupt handler.  In either case,
- *   global interrupts are disabled, either explicitly or indirectly through
- *   interrupt handling logic.
+ *   Called with priv->lock held and the network locked.
  *
  ****************************************************************************/
 
 static void tun_fd_transmit(FAR struct tun_device_s *priv)
 {
-  tun_pollnotify(priv, POLLIN);
+  FAR struct tun_queue_s *queue = tun_select_queue(priv);
+  int index;
+
+  if (tun_queue_full(queue))
+    {
+      NETDEV_TXERRORS(&priv->dev);
+      netdev_iob_release(&priv->dev);
+      priv->dev.d_len = 0;
+      return;
+    }
+
+  index = (queue->head + queue->count) % CONFIG_NET_TUN_QUEUELEN;
+  queue->pkt[index] = priv->dev.d_iob;
+  queue->len[index] = priv->dev.d_len;
+  queue->count++;
+  netdev_iob_clear(&priv->dev);
+
+  tun_pollnotify(queue, POLLIN);
 }
 
 /****************************************************************************
@@ -292,7 +470,7 @@ static void tun_fd_transmit(FAR struct tun_device_s *priv)
  *   dev - Reference to the NuttX driver state structure
  *
  * Returned Value:
- *   OK on success; a negated errno on failure
+ *   Zero to continue the poll, non-zero once all queues are full
  *
  * Assumptions:
  *   May or may not be called from an interrupt handler.  In either case,
@@ -304,9 +482,6 @@ static void tun_fd_transmit(FAR struct tun_device_s *priv)
 static int tun_txpoll(FAR struct net_driver_s *dev)
 {
   FAR struct tun_device_s *priv = (FAR struct tun_device_s *)dev->d_private;
-  int ret;
-
-  DEBUGASSERT(priv->read_buf == NULL);
 
   NETDEV_TXPACKETS(dev);
 #ifdef CONFIG_NET_PKT
@@ -315,94 +490,235 @@ static int tun_txpoll(FAR struct net_driver_s *dev)
   pkt_input(dev);
 #endif
 
-  priv->read_d_len = dev->d_len;
-  priv->read_buf   = dev->d_iob;
-  netdev_iob_clear(dev);
+  /* Send the packet */
 
-#ifdef CONFIG_NET_ETHERNET
-  if (dev->d_lltype == NET_LL_ETHERNET)
+  tun_fd_transmit(priv);
+
+  return tun_full(priv);
+}
+
+/****************************************************************************
+ * Name: tun_vnet_txhdr
+ *
+ * Description:
+ *   Fill the IFF_VNET_HDR header of a queued packet.  The stack leaves the
+ *   TCP/UDP checksum to the reader with NETDEV_TX_CSUM (TUN_F_CSUM), the
+ *   reader expects the pseudo-header checksum in the checksum field.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TUN_VNET_HDR
+static void tun_vnet_txhdr(FAR struct tun_device_s *priv,
+                           FAR struct iob_s *iob, uint16_t len,
+                           FAR struct tun_vnet_hdr_s *hdr)
+{
+  FAR struct net_driver_s *dev = &priv->dev;
+  FAR uint8_t *ip = IOB_DATA(iob);
+  uint8_t llhdrlen = NET_LL_HDRLEN(dev);
+  FAR uint16_t *csum;
+  FAR uint8_t *l4;
+  uint16_t iphdrlen;
+  uint16_t l4len;
+  uint16_t sum;
+  uint8_t proto;
+  bool tcpv4 = true;
+
+  memset(hdr, 0, sizeof(*hdr));
+  if ((dev->d_features & NETDEV_TX_CSUM) == 0)
     {
-      ret = tun_txpoll_tap(dev);
+      return;
+    }
+
+#ifdef CONFIG_NET_IPv4
+  if (iob->io_len >= IPv4_HDRLEN &&
+      (ip[0] & IP_VERSION_MASK) == IPv4_VERSION)
+    {
+      FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)ip;
+
+      if ((ipv4->ipoffset[0] & 0x3f) != 0 || ipv4->ipoffset[1] != 0)
+        {
+          return;
+        }
+
+      iphdrlen = (ipv4->vhl & IPv4_HLMASK) << 2;
+      proto    = ipv4->proto;
+      l4len    = len - llhdrlen - iphdrlen;
+      sum      = chksum(proto, (FAR uint8_t *)ipv4->srcipaddr,
+                        2 * sizeof(in_addr_t));
     }
   else
 #endif
+#ifdef CONFIG_NET_IPv6
+  if (iob->io_len >= IPv6_HDRLEN &&
+      (ip[0] & IP_VERSION_MASK) == IPv6_VERSION)
     {
-      ret = tun_txpoll_tun(dev);
+      FAR struct ipv6_hdr_s *ipv6 = (FAR struct ipv6_hdr_s *)ip;
+
+      iphdrlen = IPv6_HDRLEN;
+      proto    = ipv6->proto;
+      l4len    = len - llhdrlen - iphdrlen;
+      sum      = chksum(proto, (FAR uint8_t *)ipv6->srcipaddr,
+                        2 * sizeof(net_ipv6addr_t));
+      tcpv4    = false;
+    }
+  else
+#endif
+    {
+      return;
     }
 
-  return ret;
+  l4 = ip + iphdrlen;
+  if (proto == IP_PROTO_TCP && iob->io_len >= iphdrlen + TCP_HDRLEN)
+    {
+      FAR struct tcp_hdr_s *tcp = (FAR struct tcp_hdr_s *)l4;
+
+      csum             = &tcp->tcpchksum;
+      hdr->csum_offset = offsetof(struct tcp_hdr_s, tcpchksum);
+      if (len > NETDEV_PKTSIZE(dev))
+        {
+          /* A super-segment (TUN_F_TSO4/6), the reader segments it at
+           * gso_size and fixes the length of each segment, so the
+           * pseudo-header checksum excludes the length.
+           */
+
+          hdr->gso_type = tcpv4 ? TUN_VNET_HDR_GSO_TCPV4 :
+                                  TUN_VNET_HDR_GSO_TCPV6;
+          hdr->hdr_len  = llhdrlen + iphdrlen +
+                          ((tcp->tcpoffset >> 4) << 2);
+          hdr->gso_size = NETDEV_PKTSIZE(dev) - hdr->hdr_len;
+          l4len         = 0;
+        }
+    }
+  else if (proto == IP_PROTO_UDP && iob->io_len >= iphdrlen + UDP_HDRLEN)
+    {
+      csum             = &((FAR struct udp_hdr_s *)l4)->udpchksum;
+      hdr->csum_offset = offsetof(struct udp_hdr_s, udpchksum);
+    }
+  else
+    {
+      return;
+    }
+
+  sum += l4len;
+  if (sum < l4len)
+    {
+      sum++;
+    }
+
+  *csum           = HTONS(sum);
+  hdr->flags      = TUN_VNET_HDR_F_NEEDS_CSUM;
+  hdr->csum_start = llhdrlen + iphdrlen;
 }
 
 /****************************************************************************
- * Name: tun_txpoll_tap : for tap (ethernet bridge) mode
+ * Name: tun_vnet_rxhdr
  *
  * Description:
- *   The transmitter is available, check if the network has any outgoing
- *   packets ready to send.  This is a callback from devif_poll().
- *   devif_poll() may be called:
- *
- *   1. When the preceding TX packet send is complete,
- *   2. When the preceding TX packet send timesout and the interface is reset
- *   3. During normal TX polling
- *
- * Input Parameters:
- *   dev - Reference to the NuttX driver state structure
- *
- * Returned Value:
- *   OK on success; a negated errno on failure
- *
- * Assumptions:
- *   May or may not be called from an interrupt handler.  In either case,
- *   global interrupts are disabled, either explicitly or indirectly through
- *   interrupt handling logic.
+ *   Apply the IFF_VNET_HDR header of a written packet in dev->d_iob:
+ *   complete a partial checksum.  Super-segments are not accepted.
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_ETHERNET
-static int tun_txpoll_tap(FAR struct net_driver_s *dev)
+static int tun_vnet_rxhdr(FAR struct tun_device_s *priv,
+                          FAR const struct tun_vnet_hdr_s *hdr)
 {
-  FAR struct tun_device_s *priv = (FAR struct tun_device_s *)dev->d_private;
+  FAR struct net_driver_s *dev = &priv->dev;
+  uint8_t llhdrlen = NET_LL_HDRLEN(dev);
+  uint16_t sum;
 
-  /* Send the packet */
+  if (hdr->gso_type != TUN_VNET_HDR_GSO_NONE)
+    {
+      return -EINVAL;
+    }
 
-  tun_fd_transmit(priv);
+  if ((hdr->flags & TUN_VNET_HDR_F_NEEDS_CSUM) == 0)
+    {
+      return OK;
+    }
 
-  return 1;
+  if (hdr->csum_start < llhdrlen ||
+      hdr->csum_start + hdr->csum_offset + sizeof(uint16_t) > dev->d_len)
+    {
+      return -EINVAL;
+    }
+
+  /* The checksum field holds the pseudo-header checksum */
+
+  sum = ~chksum_iob(0, dev->d_iob, hdr->csum_start - llhdrlen);
+  sum = HTONS(sum == 0 ? 0xffff : sum);
+  iob_copyin(dev->d_iob, (FAR const uint8_t *)&sum, sizeof(sum),
+             hdr->csum_start + hdr->csum_offset - llhdrlen, false);
+  return OK;
 }
 #endif
 
 /****************************************************************************
- * Name: tun_txpoll_tun : for tun (IP tunneling) mode
+ * Name: tun_copyin
  *
  * Description:
- *   The transmitter is available, check if the network has any outgoing
- *   packets ready to send.  This is a callback from devif_poll().
- *   devif_poll() may be called:
+ *   Copy len bytes from the uio to the I/O buffer chain at offset, and
+ *   advance the uio.
  *
- *   1. When the preceding TX packet send is complete,
- *   2. When the preceding TX packet send timesout and the interface is reset
- *   3. During normal TX polling
- *
- * Input Parameters:
- *   dev - Reference to the NuttX driver state structure
- *
- * Returned Value:
- *   OK on success; a negated errno on failure
+ ****************************************************************************/
+
+static int tun_copyin(FAR struct iob_s *iob, int offset,
+                      FAR struct uio *uio, size_t len)
+{
+  FAR const struct iovec *iov = uio->uio_iov;
+  size_t skip = uio->uio_offset_in_iov;
+  size_t total = len;
+  size_t ncopy;
+  int ret;
+
+  while (len > 0)
+    {
+      ncopy = MIN(iov->iov_len - skip, len);
+      ret   = iob_trycopyin(iob, (FAR const uint8_t *)iov->iov_base + skip,
+                            ncopy, offset, false);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      offset += ncopy;
+      len    -= ncopy;
+      skip    = 0;
+      iov++;
+    }
+
+  uio_advance(uio, total);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: tun_copyout
  *
- * Assumptions:
- *   May or may not be called from an interrupt handler.  In either case,
- *   global interrupts are disabled, either explicitly or indirectly through
- *   interrupt handling logic.
+ * Description:
+ *   Copy len bytes of the I/O buffer chain from offset to the uio, and
+ *   advance the uio.
  *
  ****************************************************************************/
 
-static int tun_txpoll_tun(FAR struct net_driver_s *dev)
+static void tun_copyout(FAR struct uio *uio, FAR struct iob_s *iob,
+                        int offset, size_t len)
 {
-  FAR struct tun_device_s *priv = (FAR struct tun_device_s *)dev->d_private;
+  FAR const struct iovec *iov = uio->uio_iov;
+  size_t skip = uio->uio_offset_in_iov;
+  size_t total = len;
+  size_t ncopy;
 
-  tun_fd_transmit(priv);
+  while (len > 0)
+    {
+      ncopy = MIN(iov->iov_len - skip, len);
+      iob_copyout((FAR uint8_t *)iov->iov_base + skip, iob, ncopy, offset);
+
+      offset += ncopy;
+      len    -= ncopy;
+      skip    = 0;
+      iov++;
+    }
 
-  return 1;
+  uio_advance(uio, total);
 }
 
 /****************************************************************************
@@ -518,10 +834,6 @@ static void tun_net_receive_tap(FAR struct tun_device_s *priv)
     {
       /* And send the packet */
 
-      DEBUGASSERT(priv->write_buf == NULL);
-      priv->write_d_len = priv->dev.d_len;
-      priv->write_buf   = priv->dev.d_iob;
-      netdev_iob_clear(&priv->dev);
       tun_fd_transmit(priv);
     }
 }
@@ -598,10 +910,6 @@ static void tun_net_receive_tun(FAR struct tun_device_s *priv)
 
   if (dev->d_len > 0)
     {
-      DEBUGASSERT(priv->write_buf == NULL);
-      priv->write_d_len = dev->d_len;
-      priv->write_buf   = dev->d_iob;
-      netdev_iob_clear(dev);
       tun_fd_transmit(priv);
     }
 }
@@ -625,9 +933,22 @@ static void tun_net_receive_tun(FAR struct tun_device_s *priv)
 
 static void tun_txdone(FAR struct tun_device_s *priv)
 {
-  /* Check for errors and update statistics */
+  int i;
 
-  NETDEV_TXDONE(&priv->dev);
+  if (tun_full(priv))
+    {
+      return;
+    }
+
+  /* Wake up the writers waiting for room for their replies */
+
+  for (i = 0; i < CONFIG_NET_TUN_NQUEUES; i++)
+    {
+      if (priv->queue[i].attached && !tun_queue_full(&priv->queue[i]))
+        {
+          tun_pollnotify(&priv->queue[i], POLLOUT);
+        }
+    }
 
   /* Then poll the network for new XMIT data */
 
@@ -692,6 +1013,7 @@ static int tun_ifdown(FAR struct net_driver_s *dev)
 {
   FAR struct tun_device_s *priv = (FAR struct tun_device_s *)dev->d_private;
   irqstate_t flags;
+  int i;
 
   netdev_carrier_off(dev);
 
@@ -701,8 +1023,14 @@ static int tun_ifdown(FAR struct net_driver_s *dev)
 
   priv->bifup = false;
 
-  nxsem_post(&priv->read_wait_sem);
-  nxsem_post(&priv->write_wait_sem);
+  for (i = 0; i < CONFIG_NET_TUN_NQUEUES; i++)
+    {
+      if (priv->queue[i].attached)
+        {
+          nxsem_post(&priv->queue[i].read_wait_sem);
+          nxsem_post(&priv->queue[i].write_wait_sem);
+        }
+    }
 
   spin_unlock_irqrestore_nopreempt(&priv->spinlock, flags);
   return OK;
@@ -742,7 +1070,7 @@ static void tun_txavail_work(FAR void *arg)
 
   /* Check if there is room to hold another network packet. */
 
-  if (priv->read_d_len != 0)
+  if (tun_full(priv))
     {
       nxmutex_unlock(&priv->lock);
       return;
@@ -854,6 +1182,70 @@ static int tun_rmmac(FAR struct net_driver_s *dev, FAR const uint8_t *mac)
 }
 #endif
 
+/****************************************************************************
+ * Name: tun_queue_attach
+ *
+ * Description:
+ *   Attach a free queue of the interface to the file.
+ *
+ ****************************************************************************/
+
+static int tun_queue_attach(FAR struct tun_device_s *priv,
+                            FAR struct file *filep, bool batch)
+{
+  FAR struct tun_queue_s *queue;
+  int i;
+
+  for (i = 0; i < CONFIG_NET_TUN_NQUEUES; i++)
+    {
+      if (!priv->queue[i].attached)
+        {
+          break;
+        }
+    }
+
+  if (i >= CONFIG_NET_TUN_NQUEUES)
+    {
+      return -EBUSY;
+    }
+
+  queue = &priv->queue[i];
+  memset(queue, 0, sizeof(struct tun_queue_s));
+  queue->priv     = priv;
+  queue->batch    = batch;
+  queue->attached = true;
+  nxsem_init(&queue->read_wait_sem, 0, 0);
+  nxsem_init(&queue->write_wait_sem, 0, 0);
+
+  priv->nqueues++;
+  filep->f_priv = queue;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: tun_queue_detach
+ *
+ * Description:
+ *   Detach a queue from its file, the packets still queued are dropped.
+ *
+ ****************************************************************************/
+
+static void tun_queue_detach(FAR struct tun_queue_s *queue)
+{
+  while (queue->count > 0)
+    {
+      iob_free_chain(queue->pkt[queue->head]);
+      queue->head = (queue->head + 1) % CONFIG_NET_TUN_QUEUELEN;
+      queue->count--;
+    }
+
+  nxsem_destroy(&queue->read_wait_sem);
+  nxsem_destroy(&queue->write_wait_sem);
+
+  queue->attached = false;
+  queue->priv->nqueues--;
+}
+
 /****************************************************************************
  * Name: tun_dev_init
  *
@@ -871,7 +1263,7 @@ static int tun_rmmac(FAR struct net_driver_s *dev, FAR const uint8_t *mac)
 
 static int tun_dev_init(FAR struct tun_device_s *priv,
                         FAR struct file *filep,
-                        FAR const char *devfmt, bool tun)
+                        FAR const char *devfmt, uint16_t flags)
 {
   int ret;
 
@@ -886,13 +1278,13 @@ static int tun_dev_init(FAR struct tun_device_s *priv,
   priv->dev.d_rmmac   = tun_rmmac;    /* Remove multicast MAC address */
 #endif
   priv->dev.d_private = priv;         /* Used to recover private state from dev */
+  priv->flags         = flags & TUN_IFF_FLAGS;
 
-  /* Initialize the mutual exclusion and wait semaphore */
+  /* Initialize the mutual exclusion and the first queue */
 
   nxmutex_init(&priv->lock);
   spin_lock_init(&priv->spinlock);
-  nxsem_init(&priv->read_wait_sem, 0, 0);
-  nxsem_init(&priv->write_wait_sem, 0, 0);
+  tun_queue_attach(priv, filep, (flags & IFF_BATCH) != 0);
 
   /* Assign d_ifname if specified. */
 
@@ -903,16 +1295,15 @@ static int tun_dev_init(FAR struct tun_device_s *priv,
 
   /* Register the device with the OS so that socket IOCTLs can be performed */
 
-  ret = netdev_register(&priv->dev, tun ? NET_LL_TUN : NET_LL_ETHERNET);
+  ret = netdev_register(&priv->dev, (flags & IFF_MASK) == IFF_TUN ?
+                                    NET_LL_TUN : NET_LL_ETHERNET);
   if (ret != OK)
     {
+      tun_queue_detach(&priv->queue[0]);
       nxmutex_destroy(&priv->lock);
-      nxsem_destroy(&priv->read_wait_sem);
-      nxsem_destroy(&priv->write_wait_sem);
-      return ret;
+      filep->f_priv = NULL;
     }
 
-  filep->f_priv = priv; /* Set link to TUN device */
   return ret;
 }
 
@@ -922,6 +1313,8 @@ static int tun_dev_init(FAR struct tun_device_s *priv,
 
 static void tun_dev_uninit(FAR struct tun_device_s *priv)
 {
+  int i;
+
   /* Put the interface in the down state */
 
   tun_ifdown(&priv->dev);
@@ -932,9 +1325,15 @@ static void tun_dev_uninit(FAR struct tun_device_s *priv)
 
   netdev_unregister(&priv->dev);
 
+  for (i = 0; i < CONFIG_NET_TUN_NQUEUES; i++)
+    {
+      if (priv->queue[i].attached)
+        {
+          tun_queue_detach(&priv->queue[i]);
+        }
+    }
+
   nxmutex_destroy(&priv->lock);
-  nxsem_destroy(&priv->read_wait_sem);
-  nxsem_destroy(&priv->write_wait_sem);
 }
 
 /****************************************************************************
@@ -943,23 +1342,46 @@ static void tun_dev_uninit(FAR struct tun_device_s *priv)
 
 static int tun_close(FAR struct file *filep)
 {
-  FAR struct inode *inode       = filep->f_inode;
-  FAR struct tun_driver_s *tun  = inode->i_private;
-  FAR struct tun_device_s *priv = filep->f_priv;
+  FAR struct inode *inode        = filep->f_inode;
+  FAR struct tun_driver_s *tun   = inode->i_private;
+  FAR struct tun_queue_s *queue  = filep->f_priv;
+  FAR struct tun_device_s *priv;
   int intf;
   int ret;
 
-  if (priv == NULL)
+  if (queue == NULL)
     {
       return OK;
     }
 
+  priv = queue->priv;
   intf = priv - g_tun_devices;
   ret  = nxmutex_lock(&tun->lock);
   if (ret >= 0)
     {
-      tun->free_tuns |= (1 << intf);
-      tun_dev_uninit(priv);
+      if (priv->nqueues > 1)
+        {
+          /* Other queues remain, detach this one only.  Dropping its
+           * packets may leave room to poll the network again.
+           */
+
+          nxmutex_lock(&priv->lock);
+          netdev_lock(&priv->dev);
+
+          tun_queue_detach(queue);
+          if (priv->bifup)
+            {
+              tun_txdone(priv);
+            }
+
+          netdev_unlock(&priv->dev);
+          nxmutex_unlock(&priv->lock);
+        }
+      else
+        {
+          tun->free_tuns |= (1 << intf);
+          tun_dev_uninit(priv);
+        }
 
       nxmutex_unlock(&tun->lock);
     }
@@ -968,22 +1390,98 @@ static int tun_close(FAR struct file *filep)
 }
 
 /****************************************************************************
- * Name: tun_write
+ * Name: tun_write_packet
+ *
+ * Description:
+ *   Give a packet of len bytes (with its IFF_VNET_HDR header) from the uio
+ *   to the network.
+ *
  ****************************************************************************/
 
-static ssize_t tun_write(FAR struct file *filep, FAR const char *buffer,
-                         size_t buflen)
+static int tun_write_packet(FAR struct tun_device_s *priv,
+                            FAR struct uio *uio, size_t len)
 {
-  FAR struct tun_device_s *priv = filep->f_priv;
-  uint8_t llhdrlen;
+  FAR struct net_driver_s *dev = &priv->dev;
+#ifdef CONFIG_NET_TUN_VNET_HDR
+  struct tun_vnet_hdr_s hdr;
+#endif
+  int ret;
+
+#ifdef CONFIG_NET_TUN_VNET_HDR
+  if ((priv->flags & IFF_VNET_HDR) != 0)
+    {
+      if (len < sizeof(hdr))
+        {
+          return -EINVAL;
+        }
+
+      uio_copyto(uio, 0, &hdr, sizeof(hdr));
+      len -= sizeof(hdr);
+    }
+#endif
+
+  if (len > CONFIG_NET_TUN_PKTSIZE)
+    {
+      return -EINVAL;
+    }
+
+  netdev_iob_release(dev);
+  ret = netdev_iob_prepare(dev, false, 0);
+  dev->d_buf = NULL;
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+#ifdef CONFIG_NET_TUN_VNET_HDR
+  if ((priv->flags & IFF_VNET_HDR) != 0)
+    {
+      uio_advance(uio, sizeof(hdr));
+    }
+#endif
+
+  ret = tun_copyin(dev->d_iob, -NET_LL_HDRLEN(dev), uio, len);
+  if (ret < 0)
+    {
+      netdev_iob_release(dev);
+      return ret;
+    }
+
+  dev->d_len = len;
+
+#ifdef CONFIG_NET_TUN_VNET_HDR
+  if ((priv->flags & IFF_VNET_HDR) != 0)
+    {
+      ret = tun_vnet_rxhdr(priv, &hdr);
+      if (ret < 0)
+        {
+          netdev_iob_release(dev);
+          return ret;
+        }
+    }
+#endif
+
+  tun_net_receive(priv);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: tun_writev
+ ****************************************************************************/
+
+static ssize_t tun_writev(FAR struct file *filep, FAR struct uio *uio)
+{
+  FAR struct tun_queue_s *queue = filep->f_priv;
+  FAR struct tun_device_s *priv;
+  ssize_t nwritten = 0;
   ssize_t ret;
 
-  if (priv == NULL || buflen > CONFIG_NET_TUN_PKTSIZE)
+  if (queue == NULL)
     {
       return -EINVAL;
     }
 
-  llhdrlen = NET_LL_HDRLEN(&priv->dev);
+  priv = queue->priv;
 
   for (; ; )
     {
@@ -1003,38 +1501,65 @@ static ssize_t tun_write(FAR struct file *filep, FAR const char *buffer,
           break;
         }
 
-      /* Check if there are free space to write */
+      /* Check if there is room for the replies in the queue of this file
+       * descriptor.  Replies of flows that select another, full queue are
+       * dropped.  With IFF_BATCH write the packets of the buffer while
+       * there is room.
+       */
 
-      if (priv->write_d_len == 0)
+      if (!tun_queue_full(queue))
         {
           netdev_lock(&priv->dev);
-          netdev_iob_release(&priv->dev);
-          ret = netdev_iob_prepare(&priv->dev, false, 0);
-          priv->dev.d_buf = NULL;
-          if (ret < 0)
+
+          if (!queue->batch)
             {
-              netdev_unlock(&priv->dev);
-              break;
+              nwritten = uio->uio_resid;
+              ret = tun_write_packet(priv, uio, uio->uio_resid);
             }
-
-          ret = iob_trycopyin(priv->dev.d_iob, (FAR const uint8_t *)buffer,
-                              buflen, -llhdrlen, false);
-          if (ret < 0)
+          else
             {
-              netdev_unlock(&priv->dev);
-              break;
+              while (uio->uio_resid > 0 && !tun_queue_full(queue))
+                {
+                  uint16_t framelen;
+
+                  ret = -EINVAL;
+                  if (uio->uio_resid < TUN_BATCH_HDRLEN)
+                    {
+                      break;
+                    }
+
+                  uio_copyto(uio, 0, &framelen, TUN_BATCH_HDRLEN);
+                  if (uio->uio_resid < TUN_BATCH_HDRLEN + framelen)
+                    {
+                      break;
+                    }
+
+                  uio_advance(uio, TUN_BATCH_HDRLEN);
+                  ret = tun_write_packet(priv, uio, framelen);
+                  if (ret < 0)
+                    {
+                      break;
+                    }
+
+                  nwritten += TUN_BATCH_HDRLEN + framelen;
+                }
             }
 
-          priv->dev.d_len = buflen;
-
-          tun_net_receive(priv);
           netdev_unlock(&priv->dev);
 
-          ret = buflen;
+          /* A bad packet after some good ones ends the batch, the caller
+           * gets the error when writing it again.
+           */
+
+          if (nwritten > 0 && (ret >= 0 || queue->batch))
+            {
+              ret = nwritten;
+            }
+
           break;
         }
 
-      /* Wait if there are no free space to write */
+      /* Wait if there is no room for the replies */
 
       if ((filep->f_oflags & O_NONBLOCK) != 0)
         {
@@ -1042,9 +1567,9 @@ static ssize_t tun_write(FAR struct file *filep, FAR const char *buffer,
           break;
         }
 
-      priv->write_wait = true;
+      queue->write_wait = true;
       nxmutex_unlock(&priv->lock);
-      nxsem_wait(&priv->write_wait_sem);
+      nxsem_wait(&queue->write_wait_sem);
     }
 
   nxmutex_unlock(&priv->lock);
@@ -1052,21 +1577,23 @@ static ssize_t tun_write(FAR struct file *filep, FAR const char *buffer,
 }
 
 /****************************************************************************
- * Name: tun_read
+ * Name: tun_readv
  ****************************************************************************/
 
-static ssize_t tun_read(FAR struct file *filep, FAR char *buffer,
-                        size_t buflen)
+static ssize_t tun_readv(FAR struct file *filep, FAR struct uio *uio)
 {
-  FAR struct tun_device_s *priv = filep->f_priv;
+  FAR struct tun_queue_s *queue = filep->f_priv;
+  FAR struct tun_device_s *priv;
   uint8_t llhdrlen;
+  ssize_t nread = 0;
   ssize_t ret;
 
-  if (priv == NULL)
+  if (queue == NULL)
     {
       return -EINVAL;
     }
 
+  priv     = queue->priv;
   llhdrlen = NET_LL_HDRLEN(&priv->dev);
 
   for (; ; )
@@ -1087,50 +1614,71 @@ static ssize_t tun_read(FAR struct file *filep, FAR char *buffer,
           break;
         }
 
-      /* Check if there are data to read in write buffer */
+      /* Check if there are packets to read.  With IFF_BATCH read as many
+       * as fit in the buffer.
+       */
 
-      if (priv->write_d_len > 0)
+      if (queue->count > 0)
         {
-          if (buflen < priv->write_d_len)
+          do
             {
-              ret = -EINVAL;
-              break;
-            }
+              FAR struct iob_s *iob = queue->pkt[queue->head];
+              uint16_t len = queue->len[queue->head];
+              size_t framelen = len;
+#ifdef CONFIG_NET_TUN_VNET_HDR
+              struct tun_vnet_hdr_s hdr;
+
+              if ((priv->flags & IFF_VNET_HDR) != 0)
+                {
+                  framelen += sizeof(hdr);
+                }
+#endif
 
-          iob_copyout((FAR uint8_t *)buffer, priv->write_buf,
-                      priv->write_d_len, -llhdrlen);
-          ret = priv->write_d_len;
+              if ((queue->batch ? TUN_BATCH_HDRLEN : 0) + framelen >
+                  uio->uio_resid)
+                {
+                  ret = -EINVAL;
+                  break;
+                }
+
+              if (queue->batch)
+                {
+                  uint16_t prefix = framelen;
+
+                  uio_copyfrom(uio, 0, &prefix, TUN_BATCH_HDRLEN);
+                  uio_advance(uio, TUN_BATCH_HDRLEN);
+                  nread += TUN_BATCH_HDRLEN;
+                }
+
+#ifdef CONFIG_NET_TUN_VNET_HDR
+              if ((priv->flags & IFF_VNET_HDR) != 0)
+                {
+                  tun_vnet_txhdr(priv, iob, len, &hdr);
+                  uio_copyfrom(uio, 0, &hdr, sizeof(hdr));
+                  uio_advance(uio, sizeof(hdr));
+                }
+#endif
 
-          iob_free_chain(priv->write_buf);
-          priv->write_buf   = NULL;
-          priv->write_d_len = 0;
+              tun_copyout(uio, iob, -llhdrlen, len);
+              nread += framelen;
 
-          NETDEV_TXDONE(&priv->dev);
-          tun_pollnotify(priv, POLLOUT);
-          break;
-        }
-
-      /* Check if there are data to read in read buffer */
+              iob_free_chain(iob);
+              queue->head = (queue->head + 1) % CONFIG_NET_TUN_QUEUELEN;
+              queue->count--;
 
-      if (priv->read_d_len > 0)
-        {
-          if (buflen < priv->read_d_len)
-            {
-              ret = -EINVAL;
-              break;
+              NETDEV_TXDONE(&priv->dev);
             }
+          while (queue->batch && queue->count > 0);
 
-          iob_copyout((FAR uint8_t *)buffer, priv->read_buf,
-                      priv->read_d_len, -llhdrlen);
-          ret = priv->read_d_len;
+          if (nread > 0)
+            {
+              ret = nread;
 
-          iob_free_chain(priv->read_buf);
-          priv->read_buf   = NULL;
-          priv->read_d_len = 0;
+              netdev_lock(&priv->dev);
+              tun_txdone(priv);
+              netdev_unlock(&priv->dev);
+            }
 
-          netdev_lock(&priv->dev);
-          tun_txdone(priv);
-          netdev_unlock(&priv->dev);
           break;
         }
 
@@ -1142,9 +1690,9 @@ static ssize_t tun_read(FAR struct file *filep, FAR char *buffer,
           break;
         }
 
-      priv->read_wait = true;
+      queue->read_wait = true;
       nxmutex_unlock(&priv->lock);
-      nxsem_wait(&priv->read_wait_sem);
+      nxsem_wait(&queue->read_wait_sem);
     }
 
   nxmutex_unlock(&priv->lock);
@@ -1158,18 +1706,20 @@ static ssize_t tun_read(FAR struct file *filep, FAR char *buffer,
 static int tun_poll(FAR struct file *filep,
                     FAR struct pollfd *fds, bool setup)
 {
-  FAR struct tun_device_s *priv = filep->f_priv;
+  FAR struct tun_queue_s *queue = filep->f_priv;
+  FAR struct tun_device_s *priv;
   pollevent_t eventset;
   int ret;
 
   /* Some sanity checking */
 
-  if (priv == NULL || fds == NULL)
+  if (queue == NULL || fds == NULL)
     {
       return -EINVAL;
     }
 
-  ret = nxmutex_lock(&priv->lock);
+  priv = queue->priv;
+  ret  = nxmutex_lock(&priv->lock);
   if (ret < 0)
     {
       return ret;
@@ -1177,28 +1727,24 @@ static int tun_poll(FAR struct file *filep,
 
   if (setup)
     {
-      if (priv->poll_fds)
+      if (queue->poll_fds)
         {
           ret = -EBUSY;
           goto errout;
         }
 
-      priv->poll_fds = fds;
+      queue->poll_fds = fds;
 
       eventset = 0;
 
-      /* If write buffer is empty notify App.  */
+      /* If there is room for the replies notify App. */
 
-      if (priv->write_d_len == 0)
+      if (!tun_queue_full(queue))
         {
           eventset |= POLLOUT;
         }
 
-      /* The write buffer sometimes could be used for TX.
-       * So check it too.
-       */
-
-      if (priv->read_d_len != 0 || priv->write_d_len != 0)
+      if (queue->count != 0)
         {
           eventset |= POLLIN;
         }
@@ -1207,7 +1753,7 @@ static int tun_poll(FAR struct file *filep,
     }
   else
     {
-      priv->poll_fds = NULL;
+      queue->poll_fds = NULL;
     }
 
 errout:
@@ -1223,7 +1769,8 @@ static int tun_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 {
   FAR struct inode *inode       = filep->f_inode;
   FAR struct tun_driver_s *tun  = inode->i_private;
-  FAR struct tun_device_s *priv = filep->f_priv;
+  FAR struct tun_queue_s *queue = filep->f_priv;
+  FAR struct tun_device_s *priv = queue != NULL ? queue->priv : NULL;
   int ret = OK;
 
   if (cmd == TUNSETIFF)
@@ -1239,12 +1786,50 @@ static int tun_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
           return -EINVAL;
         }
 
+#ifndef CONFIG_NET_TUN_VNET_HDR
+      if ((ifr->ifr_flags & IFF_VNET_HDR) != 0)
+        {
+          return -EINVAL;
+        }
+#endif
+
       ret = nxmutex_lock(&tun->lock);
       if (ret < 0)
         {
           return ret;
         }
 
+      /* With IFF_MULTI_QUEUE attach one more queue to an interface of the
+       * same name, if there is one.
+       */
+
+      if ((ifr->ifr_flags & IFF_MULTI_QUEUE) != 0 && *ifr->ifr_name)
+        {
+          for (intf = 0; intf < CONFIG_TUN_NINTERFACES; intf++)
+            {
+              priv = &g_tun_devices[intf];
+              if ((tun->free_tuns & (1 << intf)) == 0 &&
+                  (priv->flags & IFF_MULTI_QUEUE) != 0 &&
+                  strcmp(priv->dev.d_ifname, ifr->ifr_name) == 0)
+                {
+                  if (((priv->flags ^ ifr->ifr_flags) & TUN_IFF_FLAGS) != 0)
+                    {
+                      ret = -EINVAL;
+                    }
+                  else
+                    {
+                      nxmutex_lock(&priv->lock);
+                      ret = tun_queue_attach(priv, filep,
+                                      (ifr->ifr_flags & IFF_BATCH) != 0);
+                      nxmutex_unlock(&priv->lock);
+                    }
+
+                  nxmutex_unlock(&tun->lock);
+                  return ret;
+                }
+            }
+        }
+
       free_tuns = tun->free_tuns;
 
       if (free_tuns == 0)
@@ -1259,7 +1844,7 @@ static int tun_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
       ret = tun_dev_init(&g_tun_devices[intf], filep,
                          *ifr->ifr_name ? ifr->ifr_name : NULL,
-                         (ifr->ifr_flags & IFF_MASK) == IFF_TUN);
+                         ifr->ifr_flags);
       if (ret != OK)
         {
           nxmutex_unlock(&tun->lock);
@@ -1268,7 +1853,7 @@ static int tun_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
       tun->free_tuns &= ~(1 << intf);
 
-      priv = filep->f_priv;
+      priv = &g_tun_devices[intf];
       strlcpy(ifr->ifr_name, priv->dev.d_ifname, IFNAMSIZ);
       nxmutex_unlock(&tun->lock);
 
@@ -1283,6 +1868,7 @@ static int tun_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
 
       strlcpy(ifr->ifr_name, priv->dev.d_ifname, IFNAMSIZ);
+      ifr->ifr_flags = priv->flags | (queue->batch ? IFF_BATCH : 0);
 
       return OK;
     }
@@ -1304,6 +1890,48 @@ static int tun_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
       return OK;
     }
+#ifdef CONFIG_NET_TUN_VNET_HDR
+  else if (cmd == TUNSETOFFLOAD)
+    {
+      FAR struct net_driver_s *dev;
+
+      if (priv == NULL || (priv->flags & IFF_VNET_HDR) == 0)
+        {
+          return -EINVAL;
+        }
+
+      /* The reader completes the TCP/UDP checksums and, with TSO, splits
+       * the TCP super-segments.
+       */
+
+      dev = &priv->dev;
+      netdev_lock(dev);
+
+      dev->d_features &= ~(NETDEV_TX_CSUM | NETDEV_TX_TSO4 |
+                           NETDEV_TX_TSO6);
+      if ((arg & TUN_F_CSUM) != 0)
+        {
+          dev->d_features |= NETDEV_TX_CSUM;
+#ifdef CONFIG_NET_TCP_GSO
+          if ((arg & TUN_F_TSO4) != 0)
+            {
+              dev->d_features |= NETDEV_TX_TSO4;
+            }
+
+          if ((arg & TUN_F_TSO6) != 0)
+            {
+              dev->d_features |= NETDEV_TX_TSO6;
+            }
+
+          dev->d_tso_maxsize = UINT16_MAX - NET_LL_HDRLEN(dev) -
+                               sizeof(struct tun_vnet_hdr_s);
+#endif
+        }
+
+      netdev_unlock(dev);
+      return OK;
+    }
+#endif
 
   return -ENOTTY;
 }
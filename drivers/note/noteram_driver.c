@@ -34,8 +34,10 @@
 #include <stdio.h>
 #include <string.h>
 #include <inttypes.h>
+#include <strings.h>
 #include <poll.h>
 
+#include <nuttx/arch.h>
 #include <nuttx/spinlock.h>
 #include <nuttx/sched.h>
 #include <nuttx/sched_note.h>
@@ -79,10 +81,31 @@
 #  define TASK_NAME_SIZE 16
 #endif
 
+/* Keep the indices of each per-CPU ring in their own (assumed) cache line */
+
+#define NOTERAM_RING_ALIGN 64
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+/* In the per-CPU mode every CPU records into its own slice of ni_buffer.
+ * nr_head and nr_tail are only written by the owning CPU and nr_read only
+ * by the reader, so that noteram_add() does not share any lock or cache
+ * line with the other CPUs.  The indices run freely and are masked with
+ * the power of two ring size.
+ */
+
+struct noteram_ring_s
+{
+  volatile unsigned int nr_head;      /* Written by the owning CPU */
+  volatile unsigned int nr_tail;      /* Written by the owning CPU */
+  volatile unsigned int nr_read;      /* Written by the reader */
+  volatile unsigned long nr_dropped;  /* Notes lost before being read */
+} aligned_data(NOTERAM_RING_ALIGN);
+#endif
+
 struct noteram_driver_s
 {
   struct note_driver_s driver;
@@ -90,9 +113,14 @@ struct noteram_driver_s
   size_t ni_bufsize;
   unsigned int ni_overwrite;
   unsigned int threshold;
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+  unsigned int ni_ringsize;
+  struct noteram_ring_s ni_ring[NCPUS];
+#else
   volatile unsigned int ni_head;
   volatile unsigned int ni_tail;
   volatile unsigned int ni_read;
+#endif
   spinlock_t lock;
   FAR struct pollfd *pfd;
   struct notifier_block nb;
@@ -212,8 +240,19 @@ struct noteram_driver_s g_noteram_driver =
 
 static void noteram_buffer_clear(FAR struct noteram_driver_s *drv)
 {
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+  int cpu;
+
+  /* The tails belong to the producers, only skip what is unread */
+
+  for (cpu = 0; cpu < NCPUS; cpu++)
+    {
+      drv->ni_ring[cpu].nr_read = drv->ni_ring[cpu].nr_head;
+    }
+#else
   drv->ni_tail = drv->ni_head;
   drv->ni_read = drv->ni_head;
+#endif
 
   if (drv->ni_overwrite == NOTERAM_MODE_OVERWRITE_OVERFLOW)
     {
@@ -221,6 +260,8 @@ static void noteram_buffer_clear(FAR struct noteram_driver_s *drv)
     }
 }
 
+#ifndef CONFIG_DRIVERS_NOTERAM_PERCPU
+
 /****************************************************************************
  * Name: noteram_next
  *
@@ -429,6 +470,186 @@ static ssize_t noteram_get(FAR struct noteram_driver_s *drv,
   return notelen;
 }
 
+#else /* CONFIG_DRIVERS_NOTERAM_PERCPU */
+
+/****************************************************************************
+ * Name: noteram_ring_size
+ *
+ * Description:
+ *   Return the size of the ring of each CPU: the largest power of two that
+ *   gives every CPU an equal share of the buffer.  It is computed on first
+ *   use because g_noteram_driver records notes long before it is
+ *   registered.  All CPUs compute the same value, so the race is benign.
+ *
+ ****************************************************************************/
+
+static inline unsigned int
+noteram_ring_size(FAR struct noteram_driver_s *drv)
+{
+  if (drv->ni_ringsize == 0)
+    {
+      drv->ni_ringsize = 1u << (flsl(drv->ni_bufsize / NCPUS) - 1);
+    }
+
+  return drv->ni_ringsize;
+}
+
+/****************************************************************************
+ * Name: noteram_unread_length
+ *
+ * Description:
+ *   Length of unread data currently in all per-CPU rings.
+ *
+ ****************************************************************************/
+
+static unsigned int noteram_unread_length(FAR struct noteram_driver_s *drv)
+{
+  FAR struct noteram_ring_s *ring;
+  unsigned int length = 0;
+  unsigned int read;
+  int cpu;
+
+  for (cpu = 0; cpu < NCPUS; cpu++)
+    {
+      ring = &drv->ni_ring[cpu];
+      read = ring->nr_read;
+      if ((int)(read - ring->nr_tail) < 0)
+        {
+          read = ring->nr_tail;
+        }
+
+      length += ring->nr_head - read;
+    }
+
+  return length;
+}
+
+/****************************************************************************
+ * Name: noteram_ring_copy
+ *
+ * Description:
+ *   Copy up to buflen bytes of the note at the read index of the ring of
+ *   'cpu' without removing it.  The producer never waits for the reader:
+ *   in overwrite mode it may recycle the note while it is being copied.
+ *   That is detected by checking the tail again after the copy, in which
+ *   case the read index is moved to the oldest note left and the copy is
+ *   repeated.
+ *
+ * Returned Value:
+ *   The length of the note (which may exceed buflen) or zero if the ring
+ *   is empty.
+ *
+ ****************************************************************************/
+
+static size_t noteram_ring_copy(FAR struct noteram_driver_s *drv, int cpu,
+                                FAR uint8_t *buffer, size_t buflen)
+{
+  FAR struct noteram_ring_s *ring = &drv->ni_ring[cpu];
+  unsigned int size = noteram_ring_size(drv);
+  FAR uint8_t *base = drv->ni_buffer + cpu * size;
+  unsigned int offset;
+  unsigned int read;
+  size_t notelen;
+  size_t space;
+  size_t copy;
+
+  for (; ; )
+    {
+      read = ring->nr_read;
+      if ((int)(read - ring->nr_tail) < 0)
+        {
+          read = ring->nr_tail;
+          ring->nr_read = read;
+        }
+
+      if (read == ring->nr_head)
+        {
+          return 0;
+        }
+
+      /* Pairs with the barrier before nr_head is published */
+
+      UP_DMB();
+
+      offset  = read & (size - 1);
+      notelen = base[offset];
+      copy    = notelen < buflen ? notelen : buflen;
+      space   = size - offset;
+      space   = space < copy ? space : copy;
+      memcpy(buffer, base + offset, space);
+      memcpy(buffer + space, base, copy - space);
+
+      /* Pairs with the barrier after nr_tail is moved over old notes */
+
+      UP_DMB();
+
+      if ((int)(read - ring->nr_tail) >= 0)
+        {
+          return notelen;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: noteram_get
+ *
+ * Description:
+ *   Get the oldest note of all per-CPU rings, merging the streams of the
+ *   CPUs by timestamp.
+ *
+ * Input Parameters:
+ *   buffer - Location to return the next note
+ *   buflen - The length of the user provided buffer.
+ *
+ * Returned Value:
+ *   On success, the positive, non-zero length of the return note is
+ *   provided.  Zero is returned only if all rings are empty.  A negated
+ *   errno value is returned in the event of any failure.
+ *
+ ****************************************************************************/
+
+static ssize_t noteram_get(FAR struct noteram_driver_s *drv,
+                           FAR uint8_t *buffer, size_t buflen)
+{
+  struct note_common_s note;
+  clock_t systime = 0;
+  size_t notelen;
+  int best = -1;
+  int cpu;
+
+  DEBUGASSERT(buffer != NULL);
+
+  for (cpu = 0; cpu < NCPUS; cpu++)
+    {
+      if (noteram_ring_copy(drv, cpu, (FAR uint8_t *)&note,
+                            sizeof(note)) > 0 &&
+          (best < 0 || (sclock_t)(note.nc_systime - systime) < 0))
+        {
+          systime = note.nc_systime;
+          best    = cpu;
+        }
+    }
+
+  if (best < 0)
+    {
+      return 0;
+    }
+
+  notelen = noteram_ring_copy(drv, best, buffer, buflen);
+  if (notelen == 0)
+    {
+      return 0;
+    }
+
+  drv->ni_ring[best].nr_read += NOTE_ALIGN(notelen);
+
+  /* Skip a note that is too large so that we do not get constipated. */
+
+  return buflen < notelen ? -EFBIG : (ssize_t)notelen;
+}
+
+#endif /* CONFIG_DRIVERS_NOTERAM_PERCPU */
+
 /****************************************************************************
  * Name: noteram_open
  ****************************************************************************/
@@ -438,10 +659,20 @@ static int noteram_open(FAR struct file *filep)
   FAR struct noteram_dump_context_s *ctx;
   FAR struct noteram_driver_s *drv = (FAR struct noteram_driver_s *)
                                      filep->f_inode->i_private;
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+  int cpu;
+#endif
 
   /* Reset the read index of the circular buffer */
 
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+  for (cpu = 0; cpu < NCPUS; cpu++)
+    {
+      drv->ni_ring[cpu].nr_read = drv->ni_ring[cpu].nr_tail;
+    }
+#else
   drv->ni_read = drv->ni_tail;
+#endif
   ctx = kmm_zalloc(sizeof(*ctx));
   if (ctx == NULL)
     {
@@ -625,6 +856,32 @@ static int noteram_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         ret = OK;
         break;
 
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+      /* NOTERAM_GETDROPPED
+       *      - Get the number of notes lost on each CPU
+       *        Argument: A writable pointer to unsigned long[NCPUS]
+       */
+
+      case NOTERAM_GETDROPPED:
+        if (arg == 0)
+          {
+            ret = -EINVAL;
+          }
+        else
+          {
+            FAR unsigned long *dropped = (FAR unsigned long *)arg;
+            int cpu;
+
+            for (cpu = 0; cpu < NCPUS; cpu++)
+              {
+                dropped[cpu] = drv->ni_ring[cpu].nr_dropped;
+              }
+
+            ret = OK;
+          }
+        break;
+#endif
+
       default:
         break;
     }
@@ -717,6 +974,93 @@ errout:
  *
  ****************************************************************************/
 
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+static void noteram_add(FAR struct note_driver_s *driver,
+                        FAR const void *note, size_t notelen)
+{
+  FAR const char *buf = note;
+  FAR struct noteram_driver_s *drv = (FAR struct noteram_driver_s *)driver;
+  FAR struct noteram_ring_s *ring;
+  FAR uint8_t *base;
+  unsigned int size;
+  unsigned int head;
+  unsigned int tail;
+  unsigned int space;
+  irqstate_t flags;
+  int cpu;
+
+  /* Only this CPU writes to its ring, masking the local interrupts is
+   * enough to serialize the producers.
+   */
+
+  flags = up_irq_save();
+  cpu   = this_cpu();
+  ring  = &drv->ni_ring[cpu];
+  size  = noteram_ring_size(drv);
+  base  = drv->ni_buffer + cpu * size;
+
+  DEBUGASSERT(note != NULL && notelen < size);
+
+  if (drv->ni_overwrite == NOTERAM_MODE_OVERWRITE_OVERFLOW)
+    {
+      ring->nr_dropped++;
+      up_irq_restore(flags);
+      return;
+    }
+
+  head = ring->nr_head;
+  tail = ring->nr_tail;
+
+  if (size - (head - tail) <= NOTE_ALIGN(notelen))
+    {
+      if (drv->ni_overwrite == NOTERAM_MODE_OVERWRITE_DISABLE)
+        {
+          /* Stop recording on all CPUs if not in overwrite mode */
+
+          drv->ni_overwrite = NOTERAM_MODE_OVERWRITE_OVERFLOW;
+          ring->nr_dropped++;
+          up_irq_restore(flags);
+          return;
+        }
+
+      /* Recycle the oldest notes, make sure there is enough space */
+
+      do
+        {
+          if ((int)(ring->nr_read - tail) <= 0)
+            {
+              ring->nr_dropped++;
+            }
+
+          tail += NOTE_ALIGN(base[tail & (size - 1)]);
+        }
+      while (size - (head - tail) <= NOTE_ALIGN(notelen));
+
+      /* Let the reader see that the old notes are gone before they are
+       * overwritten.
+       */
+
+      ring->nr_tail = tail;
+      UP_DMB();
+    }
+
+  space = size - (head & (size - 1));
+  space = space < notelen ? space : notelen;
+  memcpy(base + (head & (size - 1)), note, space);
+  memcpy(base, buf + space, notelen - space);
+
+  /* The note must be complete before the reader can see it */
+
+  UP_DMB();
+  ring->nr_head = head + NOTE_ALIGN(notelen);
+  up_irq_restore(flags);
+
+  if (drv->pfd && (noteram_unread_length(drv) >= drv->threshold))
+    {
+      poll_notify(&drv->pfd, 1, POLLIN);
+    }
+}
+#else
 static void noteram_add(FAR struct note_driver_s *driver,
                         FAR const void *note, size_t notelen)
 {
@@ -773,6 +1117,7 @@ static void noteram_add(FAR struct note_driver_s *driver,
       poll_notify(&drv->pfd, 1, POLLIN);
     }
 }
+#endif
 
 /****************************************************************************
  * Name: noteram_dump_init_context
@@ -1421,9 +1766,14 @@ noteram_initialize(FAR const char *devpath, size_t bufsize,
   drv->ni_bufsize = bufsize;
   drv->ni_buffer = (FAR uint8_t *)(drv + 1) + len;
   drv->ni_overwrite = overwrite;
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+  drv->ni_ringsize = 0;
+  memset(drv->ni_ring, 0, sizeof(drv->ni_ring));
+#else
   drv->ni_head = 0;
   drv->ni_tail = 0;
   drv->ni_read = 0;
+#endif
   drv->pfd = NULL;
 
   ret = note_driver_register(&drv->driver);
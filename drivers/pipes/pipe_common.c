@@ -85,6 +85,22 @@ static void pipecommon_wakeup(FAR sem_t *sem)
     }
 }
 
+/****************************************************************************
+ * Name: pipecommon_relock
+ *
+ * Description:
+ *   Retake d_bflock after a splice actor returned.  The lent region has to
+ *   be given back, so a signal must not abort the wait.
+ *
+ ****************************************************************************/
+
+static void pipecommon_relock(FAR struct pipe_dev_s *dev)
+{
+  while (nxrmutex_lock(&dev->d_bflock) < 0)
+    {
+    }
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -438,13 +454,17 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
       return ret;
     }
 
-  /* If the pipe is empty, then wait for something to be written to it */
+  /* If the pipe is empty, then wait for something to be written to it.
+   * Also wait while its data is lent to a splice.
+   */
 
-  while (circbuf_is_empty(&dev->d_buffer))
+  while (circbuf_is_empty(&dev->d_buffer) ||
+         (dev->d_splice & PIPE_SPLICE_READ) != 0)
     {
       /* If there are no writers on the pipe, then return end of file */
 
-      if (dev->d_nwriters <= 0 && PIPE_IS_POLICY_0(dev->d_flags))
+      if ((dev->d_splice & PIPE_SPLICE_READ) == 0 &&
+          dev->d_nwriters <= 0 && PIPE_IS_POLICY_0(dev->d_flags))
         {
           nxrmutex_unlock(&dev->d_bflock);
           return 0;
@@ -566,9 +586,12 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
           return nwritten == 0 ? -EPIPE : nwritten;
         }
 
-      /* Would the next write overflow the circular buffer? */
+      /* Would the next write overflow the circular buffer?  The free
+       * space cannot be used either while it is lent to a splice.
+       */
 
-      if (!circbuf_is_full(&dev->d_buffer))
+      if (!circbuf_is_full(&dev->d_buffer) &&
+          (dev->d_splice & PIPE_SPLICE_WRITE) == 0)
         {
           /* Loop until all of the bytes have been written */
 
@@ -869,6 +892,12 @@ int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
               break;
             }
 
+          if (dev->d_splice != 0)
+            {
+              ret = -EBUSY;
+              break;
+            }
+
           size = MIN(size, CONFIG_DEV_PIPE_MAXSIZE);
           ret = circbuf_resize(&dev->d_buffer, size);
           if (ret != 0)
@@ -951,4 +980,281 @@ int pipecommon_unlink(FAR struct inode *inode)
 }
 #endif
 
+/****************************************************************************
+ * Name: pipe_splice_read
+ *
+ * Description:
+ *   Pass the data in the pipe to 'actor' in place, see include/nuttx/fs/fs.h
+ *
+ ****************************************************************************/
+
+ssize_t pipe_splice_read(FAR struct file *filep, splice_actor_t actor,
+                         FAR void *priv, size_t count, unsigned int flags,
+                         bool peek)
+{
+  FAR struct inode      *inode = filep->f_inode;
+  FAR struct pipe_dev_s *dev   = inode->i_private;
+  FAR struct circbuf_s  *circ;
+  FAR char              *base;
+  size_t                 nread = 0;
+  size_t                 offset;
+  size_t                 tail;
+  size_t                 size;
+  size_t                 len;
+  ssize_t                ret;
+
+  DEBUGASSERT(dev != NULL && actor != NULL);
+
+  if (count == 0)
+    {
+      return 0;
+    }
+
+  /* Make sure that we have exclusive access to the device structure */
+
+  ret = nxrmutex_lock(&dev->d_bflock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* If the pipe is empty, then wait for something to be written to it.
+   * Also wait while its data is lent to another splice.
+   */
+
+  circ = &dev->d_buffer;
+  while (circbuf_is_empty(circ) ||
+         (dev->d_splice & PIPE_SPLICE_READ) != 0)
+    {
+      /* If there are no writers on the pipe, then return end of file */
+
+      if ((dev->d_splice & PIPE_SPLICE_READ) == 0 &&
+          dev->d_nwriters <= 0 && PIPE_IS_POLICY_0(dev->d_flags))
+        {
+          nxrmutex_unlock(&dev->d_bflock);
+          return 0;
+        }
+
+      if ((filep->f_oflags & O_NONBLOCK) != 0 ||
+          (flags & SPLICE_F_NONBLOCK) != 0)
+        {
+          nxrmutex_unlock(&dev->d_bflock);
+          return -EAGAIN;
+        }
+
+      nxrmutex_unlock(&dev->d_bflock);
+      ret = nxsem_wait(&dev->d_rdsem);
+      if (ret < 0 || (ret = nxrmutex_lock(&dev->d_bflock)) < 0)
+        {
+          return ret;
+        }
+    }
+
+  /* Lend the buffered data to the actor and drop the lock, so that a
+   * destination which blocks does not stall the writers and the close of
+   * the pipe.  Writers only touch the free space, and other readers and
+   * resizing wait for PIPE_SPLICE_READ to clear, so the data stays put.
+   */
+
+  count = MIN(count, circbuf_used(circ));
+  base  = circ->base;
+  tail  = circ->tail;
+  size  = circ->size;
+  dev->d_splice |= PIPE_SPLICE_READ;
+  nxrmutex_unlock(&dev->d_bflock);
+
+  /* Hand the data to the actor one contiguous region at a time.  Nothing
+   * is committed until the end so that the regions can be found relative
+   * to the unchanged read position.
+   */
+
+  while (nread < count)
+    {
+      offset = (tail + nread) % size;
+      len    = MIN(count - nread, size - offset);
+
+      ret = actor(priv, base + offset, len);
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      pipe_dumpbuffer("From PIPE:", (FAR uint8_t *)base + offset, ret);
+      nread += ret;
+
+      /* Stop if the destination did not take everything */
+
+      if ((size_t)ret < len)
+        {
+          break;
+        }
+    }
+
+  pipecommon_relock(dev);
+  dev->d_splice &= ~PIPE_SPLICE_READ;
+
+  /* Let the readers waiting for the data to come back check again */
+
+  pipecommon_wakeup(&dev->d_rdsem);
+
+  if (nread > 0 && !peek)
+    {
+      circbuf_readcommit(circ, nread);
+
+      /* Notify all poll/select waiters that they can write to the
+       * FIFO when buffer can accept more than d_polloutthrd bytes.
+       */
+
+      if (circbuf_used(circ) <= (dev->d_bufsize - dev->d_polloutthrd))
+        {
+          poll_notify(dev->d_fds, CONFIG_DEV_PIPE_NPOLLWAITERS, POLLOUT);
+        }
+
+      pipecommon_wakeup(&dev->d_wrsem);
+    }
+
+  nxrmutex_unlock(&dev->d_bflock);
+  return nread > 0 ? (ssize_t)nread : ret;
+}
+
+/****************************************************************************
+ * Name: pipe_splice_write
+ *
+ * Description:
+ *   Let 'actor' fill the free space in the pipe in place, see
+ *   include/nuttx/fs/fs.h
+ *
+ ****************************************************************************/
+
+ssize_t pipe_splice_write(FAR struct file *filep, splice_actor_t actor,
+                          FAR void *priv, size_t count, unsigned int flags)
+{
+  FAR struct inode      *inode    = filep->f_inode;
+  FAR struct pipe_dev_s *dev      = inode->i_private;
+  FAR struct circbuf_s  *circ;
+  FAR char              *base;
+  size_t                 nwritten = 0;
+  size_t                 offset;
+  size_t                 head;
+  size_t                 size;
+  size_t                 len;
+  ssize_t                ret;
+
+  DEBUGASSERT(dev != NULL && actor != NULL);
+  DEBUGASSERT(up_interrupt_context() == false);
+
+  if (count == 0)
+    {
+      return 0;
+    }
+
+  /* Make sure that we have exclusive access to the device structure */
+
+  ret = nxrmutex_lock(&dev->d_bflock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Wait until there is some free space in the pipe that is not lent to
+   * another splice.
+   */
+
+  circ = &dev->d_buffer;
+  for (; ; )
+    {
+      if (dev->d_nreaders <= 0 && PIPE_IS_POLICY_0(dev->d_flags))
+        {
+          nxrmutex_unlock(&dev->d_bflock);
+          return -EPIPE;
+        }
+
+      if (!circbuf_is_full(circ) &&
+          (dev->d_splice & PIPE_SPLICE_WRITE) == 0)
+        {
+          break;
+        }
+
+      if ((filep->f_oflags & O_NONBLOCK) != 0 ||
+          (flags & SPLICE_F_NONBLOCK) != 0)
+        {
+          nxrmutex_unlock(&dev->d_bflock);
+          return -EAGAIN;
+        }
+
+      nxrmutex_unlock(&dev->d_bflock);
+      ret = nxsem_wait(&dev->d_wrsem);
+      if (ret < 0 || (ret = nxrmutex_lock(&dev->d_bflock)) < 0)
+        {
+          return ret;
+        }
+    }
+
+  /* Lend the free space to the actor and drop the lock, so that a source
+   * which blocks, e.g. a socket, does not stall the readers and the close
+   * of the pipe.  Readers only consume the committed data, and other
+   * writers and resizing wait for PIPE_SPLICE_WRITE to clear.
+   */
+
+  count = MIN(count, circbuf_space(circ));
+  base  = circ->base;
+  head  = circ->head;
+  size  = circ->size;
+  dev->d_splice |= PIPE_SPLICE_WRITE;
+  nxrmutex_unlock(&dev->d_bflock);
+
+  /* Let the actor produce the data directly into the free space, at most
+   * two contiguous regions when the free space wraps around.  Nothing is
+   * committed until the end, so the readers never see a partial region.
+   */
+
+  while (nwritten < count)
+    {
+      offset = (head + nwritten) % size;
+      len    = MIN(count - nwritten, size - offset);
+
+      ret = actor(priv, base + offset, len);
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      pipe_dumpbuffer("To PIPE:", (FAR uint8_t *)base + offset, ret);
+      nwritten += ret;
+
+      /* Stop if the source had less data than requested */
+
+      if ((size_t)ret < len)
+        {
+          break;
+        }
+    }
+
+  pipecommon_relock(dev);
+  dev->d_splice &= ~PIPE_SPLICE_WRITE;
+
+  /* Let the writers waiting for the space to come back check again */
+
+  pipecommon_wakeup(&dev->d_wrsem);
+
+  if (nwritten > 0)
+    {
+      circbuf_writecommit(circ, nwritten);
+
+      /* Notify all poll/select waiters that they can read from the
+       * FIFO when buffer used exceeds poll threshold.
+       */
+
+      if (circbuf_used(circ) > dev->d_pollinthrd)
+        {
+          poll_notify(dev->d_fds, CONFIG_DEV_PIPE_NPOLLWAITERS, POLLIN);
+        }
+
+      pipecommon_wakeup(&dev->d_rdsem);
+    }
+
+  nxrmutex_unlock(&dev->d_bflock);
+  return nwritten > 0 ? (ssize_t)nwritten : ret;
+}
+
 #endif /* CONFIG_PIPES */
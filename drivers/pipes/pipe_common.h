@@ -96,6 +96,13 @@
 #define PIPE_UNLINK(f)      do { (f) |= PIPE_FLAG_UNLINKED; } while (0)
 #define PIPE_IS_UNLINKED(f) (((f) & PIPE_FLAG_UNLINKED) != 0)
 
+/* d_splice values: a region of d_buffer is lent to a splice actor, which
+ * runs without d_bflock.  Other readers (writers) wait until it is back.
+ */
+
+#define PIPE_SPLICE_READ    (1 << 0) /* Bit 0: Data at the tail is lent */
+#define PIPE_SPLICE_WRITE   (1 << 1) /* Bit 1: Space at the head is lent */
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -128,6 +135,7 @@ struct pipe_dev_s
   uint8_t          d_nwriters;    /* Number of reference counts for write access */
   uint8_t          d_nreaders;    /* Number of reference counts for read access */
   uint8_t          d_flags;       /* See PIPE_FLAG_* definitions */
+  uint8_t          d_splice;      /* See PIPE_SPLICE_* definitions */
   int16_t          d_crefs;       /* References to dev */
   struct circbuf_s d_buffer;      /* Buffer allocated when device opened */
 
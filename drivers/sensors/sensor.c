@@ -120,6 +120,9 @@ struct sensor_upperhalf_s
   struct sensor_state_s          state;  /* The state of sensor device */
   struct circbuf_s   timing;             /* The circular buffer of generation */
   struct circbuf_s   buffer;             /* The circular buffer of data */
+#ifdef CONFIG_SENSORS_SHM
+  FAR struct sensor_shm_s *shm;          /* The topic ring mapped by users */
+#endif
   rmutex_t           lock;               /* Manages exclusive access to file operations */
   struct list_node   userlist;           /* List of users */
   char               name[NAME_MAX];     /* Upper topic name */
@@ -139,6 +142,10 @@ static ssize_t sensor_write(FAR struct file *filep, FAR const char *buffer,
                             size_t buflen);
 static int     sensor_ioctl(FAR struct file *filep, int cmd,
                             unsigned long arg);
+#ifdef CONFIG_SENSORS_SHM
+static int     sensor_mmap(FAR struct file *filep,
+                           FAR struct mm_map_entry_s *map);
+#endif
 static int     sensor_poll(FAR struct file *filep, FAR struct pollfd *fds,
                            bool setup);
 static ssize_t sensor_push_event(FAR void *priv, FAR const void *data,
@@ -231,7 +238,11 @@ static const struct file_operations g_sensor_fops =
   sensor_write,   /* write */
   NULL,           /* seek  */
   sensor_ioctl,   /* ioctl */
+#ifdef CONFIG_SENSORS_SHM
+  sensor_mmap,    /* mmap */
+#else
   NULL,           /* mmap */
+#endif
   NULL,           /* truncate */
   sensor_poll     /* poll  */
 };
@@ -498,6 +509,89 @@ static void sensor_generate_timing(FAR struct sensor_upperhalf_s *upper,
     }
 }
 
+#ifdef CONFIG_SENSORS_SHM
+static void sensor_shm_publish(FAR struct sensor_shm_s *shm,
+                               FAR const void *data, unsigned long nums)
+{
+  FAR const uint8_t *ptr = data;
+  FAR struct sensor_shm_slot_s *slot;
+  irqstate_t flags;
+  uint32_t head;
+
+  /* Fill the slot after the head first, then move the head over it, so
+   * that readers never see a sample number that is not in place yet.
+   */
+
+  while (nums-- > 0)
+    {
+      head = (shm->head + 1) % shm->nslots;
+      slot = SENSOR_SHM_SLOT(shm, head);
+
+      flags = write_seqlock_irqsave(&slot->sequence);
+      slot->count = shm->count + 1;
+      memcpy(SENSOR_SHM_DATA(slot), ptr, shm->esize);
+      write_sequnlock_irqrestore(&slot->sequence, flags);
+
+      flags = write_seqlock_irqsave(&shm->sequence);
+      shm->head = head;
+      shm->count++;
+      if (shm->nused < shm->nslots)
+        {
+          shm->nused++;
+        }
+
+      write_sequnlock_irqrestore(&shm->sequence, flags);
+      ptr += shm->esize;
+    }
+}
+
+static int sensor_shm_create(FAR struct sensor_upperhalf_s *upper)
+{
+  FAR struct sensor_lowerhalf_s *lower = upper->lower;
+  FAR struct sensor_shm_s *shm;
+  FAR uint8_t *data;
+  size_t esize = upper->state.esize;
+  size_t used;
+  size_t pos;
+
+  shm = kmm_zalloc(SENSOR_SHM_SIZE(esize, lower->nbuffer));
+  if (shm == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  shm->esize    = esize;
+  shm->nslots   = lower->nbuffer;
+  shm->slotsize = SENSOR_SHM_SLOTSIZE(esize);
+  shm->head     = shm->nslots - 1;
+  seqlock_init(&shm->sequence);
+
+  /* Seed the ring with the samples already buffered, so that a new
+   * subscriber of a persistent topic finds the latest value in place.
+   */
+
+  if (circbuf_is_init(&upper->buffer))
+    {
+      used = circbuf_used(&upper->buffer);
+      data = kmm_malloc(esize);
+      if (data != NULL)
+        {
+          for (pos = upper->buffer.head - used;
+               pos != upper->buffer.head; pos += esize)
+            {
+              circbuf_peekat(&upper->buffer, pos, data, esize);
+              sensor_shm_publish(shm, data, 1);
+            }
+
+          kmm_free(data);
+        }
+    }
+
+  upper->shm = shm;
+  return OK;
+}
+#endif
+
 static bool sensor_is_updated(FAR struct sensor_upperhalf_s *upper,
                               FAR struct sensor_user_s *user)
 {
@@ -1036,7 +1130,11 @@ static int sensor_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
       case SNIOC_SET_BUFFER_NUMBER:
         {
           nxrmutex_lock(&upper->lock);
+#ifdef CONFIG_SENSORS_SHM
+          if (!circbuf_is_init(&upper->buffer) && upper->shm == NULL)
+#else
           if (!circbuf_is_init(&upper->buffer))
+#endif
             {
               if (arg1 >= lower->nbuffer)
                 {
@@ -1158,6 +1256,51 @@ static int sensor_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
   return ret;
 }
 
+#ifdef CONFIG_SENSORS_SHM
+static int sensor_mmap(FAR struct file *filep,
+                       FAR struct mm_map_entry_s *map)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct sensor_upperhalf_s *upper = inode->i_private;
+  FAR struct sensor_lowerhalf_s *lower = upper->lower;
+  int ret = OK;
+
+  /* Devices fetched on demand have no topic buffer to share */
+
+  if (lower->ops->fetch)
+    {
+      return -ENODEV;
+    }
+
+  nxrmutex_lock(&upper->lock);
+  if (upper->shm == NULL)
+    {
+      ret = sensor_shm_create(upper);
+      if (ret < 0)
+        {
+          goto out;
+        }
+    }
+
+  if (map->offset != 0 ||
+      map->length > SENSOR_SHM_SIZE(upper->shm->esize, upper->shm->nslots))
+    {
+      ret = -EINVAL;
+      goto out;
+    }
+
+  /* The ring lives until the topic is unregistered, so the mapping needs
+   * no munmap hook.
+   */
+
+  map->vaddr = upper->shm;
+
+out:
+  nxrmutex_unlock(&upper->lock);
+  return ret;
+}
+#endif
+
 static int sensor_poll(FAR struct file *filep,
                        FAR struct pollfd *fds, bool setup)
 {
@@ -1283,6 +1426,13 @@ static ssize_t sensor_push_event(FAR void *priv, FAR const void *data,
   smdebug(upper->name, "the number of write event is:%lu", envcount);
   circbuf_overwrite(&upper->buffer, data, bytes);
   sensor_generate_timing(upper, envcount);
+#ifdef CONFIG_SENSORS_SHM
+  if (upper->shm != NULL)
+    {
+      sensor_shm_publish(upper->shm, data, envcount);
+    }
+#endif
+
   list_for_every_entry(&upper->userlist, user, struct sensor_user_s, node)
     {
       if (sensor_is_updated(upper, user))
@@ -1589,5 +1739,9 @@ void sensor_custom_unregister(FAR struct sensor_lowerhalf_s *lower,
       circbuf_uninit(&upper->timing);
     }
 
+#ifdef CONFIG_SENSORS_SHM
+  kmm_free(upper->shm);
+#endif
+
   kmm_free(upper);
 }
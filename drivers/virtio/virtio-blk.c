@@ -27,6 +27,7 @@
 #include <nuttx/debug.h>
 #include <errno.h>
 #include <stdio.h>
+#include <sys/param.h>
 
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
@@ -34,6 +35,7 @@
 #include <nuttx/spinlock.h>
 #include <nuttx/virtio/virtio.h>
 #include <nuttx/init.h>
+#include <nuttx/sched.h>
 
 #include "virtio-blk.h"
 
@@ -46,15 +48,22 @@
 
 /* Block feature bits */
 
+#define VIRTIO_BLK_F_SIZE_MAX       1  /* Maximum size of any segment */
+#define VIRTIO_BLK_F_SEG_MAX        2  /* Maximum segments in a request */
 #define VIRTIO_BLK_F_RO             5  /* Disk is read-only */
 #define VIRTIO_BLK_F_BLK_SIZE       6  /* Block size of disk is available */
 #define VIRTIO_BLK_F_FLUSH          9  /* Cache flush command support */
+#define VIRTIO_BLK_F_MQ             12 /* Support more than one vq */
+#define VIRTIO_BLK_F_DISCARD        13 /* Discard command support */
+#define VIRTIO_BLK_F_WRITE_ZEROES   14 /* Write zeroes command support */
 
 /* Block request type */
 
 #define VIRTIO_BLK_T_IN             0  /* READ */
 #define VIRTIO_BLK_T_OUT            1  /* WRITE */
 #define VIRTIO_BLK_T_FLUSH          4  /* FLUSH */
+#define VIRTIO_BLK_T_DISCARD        11 /* DISCARD */
+#define VIRTIO_BLK_T_WRITE_ZEROES   13 /* WRITE ZEROES */
 
 /* Block request return status */
 
@@ -67,6 +76,18 @@
 #define VIRTIO_BLK_SECTOR_BITS      9
 #define VIRTIO_BLK_SECTOR_SIZE      (1UL << VIRTIO_BLK_SECTOR_BITS)
 
+/* Driver limits */
+
+#define VIRTIO_BLK_NQUEUES          CONFIG_DRIVERS_VIRTIO_BLK_NQUEUES
+#define VIRTIO_BLK_QUEUE_DEPTH      CONFIG_DRIVERS_VIRTIO_BLK_QUEUE_DEPTH
+#define VIRTIO_BLK_MAX_SEGS         CONFIG_DRIVERS_VIRTIO_BLK_MAX_SEGS
+
+/* Bound the segment size so that a request length never overflows size_t
+ * when the device doesn't offer VIRTIO_BLK_F_SIZE_MAX.
+ */
+
+#define VIRTIO_BLK_MAX_SEG_SIZE     (1UL << 20)
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -87,6 +108,15 @@ begin_packed_struct struct virtio_blk_resp_s
   uint8_t status;
 } end_packed_struct;
 
+/* Discard and write zeroes request segment */
+
+begin_packed_struct struct virtio_blk_discard_s
+{
+  uint64_t sector;
+  uint32_t num_sectors;
+  uint32_t flags;
+} end_packed_struct;
+
 begin_packed_struct struct virtio_blk_config_s
 {
   uint64_t capacity;
@@ -115,12 +145,50 @@ begin_packed_struct struct virtio_blk_config_s
   uint32_t secure_erase_sector_alignment;
 } end_packed_struct;
 
+/* The completion shared by all the requests of one transfer */
+
+struct virtio_blk_wait_s
+{
+  sem_t                         sem;            /* Posted per request */
+  volatile int                  pending;        /* Requests in flight */
+  int                           result;         /* The first error */
+  bool                          polling;        /* Complete by polling */
+};
+
+/* One block request, the requests merged into it ride on its descriptor
+ * chain and complete with it.
+ */
+
+struct virtio_blk_io_s
+{
+  struct list_node              node;           /* Pending/merged list */
+  struct list_node              merged;         /* Merged requests */
+  FAR struct virtio_blk_wait_s *wait;           /* Completion */
+  FAR void                     *buffer;         /* Data buffer */
+  size_t                        len;            /* Data length in bytes */
+  uint16_t                      nsegs;          /* Data descriptors */
+  struct virtio_blk_req_s       req;            /* Out header */
+  struct virtio_blk_resp_s      resp;           /* In header */
+};
+
+/* Request virtqueue */
+
+struct virtio_blk_vq_s
+{
+  FAR struct virtqueue         *vq;             /* Virtqueue */
+  spinlock_t                    lock;           /* Lock */
+  struct list_node              pending;        /* Requests not submitted */
+};
+
 struct virtio_blk_priv_s
 {
   FAR struct virtio_device     *vdev;           /* Virtio device */
-  spinlock_t                    lock;           /* Lock */
+  struct virtio_blk_vq_s        vqs[VIRTIO_BLK_NQUEUES];
+  int                           nvqs;           /* Virtqueues in use */
   uint64_t                      nsectors;       /* Sectore numbers */
   uint32_t                      block_size;     /* Block size */
+  uint32_t                      seg_size;       /* Max bytes per segment */
+  uint16_t                      seg_max;        /* Max segments per req */
   char                          name[NAME_MAX]; /* Device name */
 };
 
@@ -130,6 +198,18 @@ struct virtio_blk_priv_s
 
 /* BLK block_operations functions and they helper function */
 
+static void    virtio_blk_io_init(FAR struct virtio_blk_priv_s *priv,
+                                  FAR struct virtio_blk_io_s *io,
+                                  FAR struct virtio_blk_wait_s *wait,
+                                  uint32_t type, uint64_t sector,
+                                  FAR void *buffer, size_t len);
+static void    virtio_blk_dispatch(FAR struct virtio_blk_priv_s *priv,
+                                   FAR struct virtio_blk_vq_s *q);
+static void    virtio_blk_complete(FAR struct virtio_blk_priv_s *priv,
+                                   FAR struct virtio_blk_vq_s *q);
+static int     virtio_blk_submit(FAR struct virtio_blk_priv_s *priv,
+                                 FAR struct virtio_blk_io_s *io, int nio,
+                                 FAR struct virtio_blk_wait_s *wait);
 static ssize_t virtio_blk_rdwr(FAR struct virtio_blk_priv_s *priv,
                                FAR void *buffer, blkcnt_t startsector,
                                unsigned int nsectors, bool write);
@@ -146,6 +226,9 @@ static int     virtio_blk_geometry(FAR struct inode *inode,
 static int     virtio_blk_ioctl(FAR struct inode *inode, int cmd,
                                 unsigned long arg);
 static int     virtio_blk_flush(FAR struct virtio_blk_priv_s *priv);
+static int     virtio_blk_discard(FAR struct virtio_blk_priv_s *priv,
+                                  uint32_t type,
+                                  FAR const blkcnt_t *range);
 
 /* Other functions */
 
@@ -185,119 +268,388 @@ static int g_virtio_blk_idx = 0;
  ****************************************************************************/
 
 /****************************************************************************
- * Name: virtio_blk_wait_complete
+ * Name: virtio_blk_io_init
  *
  * Description:
- *   Wait the virtio block request complete
+ *   Initialize a block request, 'sector' is in VIRTIO_BLK_SECTOR_SIZE unit
  *
  ****************************************************************************/
 
-static void virtio_blk_wait_complete(FAR struct virtqueue *vq,
-                                     FAR sem_t *respsem)
+static void virtio_blk_io_init(FAR struct virtio_blk_priv_s *priv,
+                               FAR struct virtio_blk_io_s *io,
+                               FAR struct virtio_blk_wait_s *wait,
+                               uint32_t type, uint64_t sector,
+                               FAR void *buffer, size_t len)
 {
-  FAR struct virtio_blk_priv_s *priv = vq->vq_dev->priv;
-  FAR sem_t *sem;
+  io->wait         = wait;
+  io->buffer       = buffer;
+  io->len          = len;
+  io->nsegs        = (len + priv->seg_size - 1) / priv->seg_size;
+  io->req.type     = type;
+  io->req.reserved = 0;
+  io->req.sector   = sector;
+  io->resp.status  = VIRTIO_BLK_S_IOERR;
+  list_initialize(&io->merged);
+}
+
+/****************************************************************************
+ * Name: virtio_blk_merge
+ *
+ * Description:
+ *   Move the pending requests which continue the sector range of 'io' into
+ *   its merged list, as long as the segments fit in one descriptor chain.
+ *   Return the total number of data segments.  Must be called with the
+ *   virtqueue lock held.
+ *
+ ****************************************************************************/
 
-  if (up_interrupt_context() || OSINIT_IS_PANIC())
+static uint16_t virtio_blk_merge(FAR struct virtio_blk_priv_s *priv,
+                                 FAR struct virtio_blk_vq_s *q,
+                                 FAR struct virtio_blk_io_s *io)
+{
+  FAR struct virtio_blk_io_s *next;
+  FAR struct virtio_blk_io_s *tmp;
+  uint16_t nsegs = io->nsegs;
+  uint64_t end;
+
+  if (io->req.type != VIRTIO_BLK_T_IN && io->req.type != VIRTIO_BLK_T_OUT)
+    {
+      return nsegs;
+    }
+
+  end = io->req.sector + (io->len >> VIRTIO_BLK_SECTOR_BITS);
+  list_for_every_entry_safe(&q->pending, next, tmp,
+                            struct virtio_blk_io_s, node)
     {
-      for (; ; )
+      /* Don't move the later requests ahead of a flush */
+
+      if (next->req.type == VIRTIO_BLK_T_FLUSH)
         {
-          sem = virtqueue_get_buffer_lock(vq, NULL, NULL, &priv->lock);
-          if (sem == respsem)
-            {
-              break;
-            }
-          else if (sem != NULL)
+          break;
+        }
+
+      if (next->req.type != io->req.type || next->req.sector != end ||
+          nsegs + next->nsegs > priv->seg_max ||
+          nsegs + next->nsegs + 2 > q->vq->vq_free_cnt)
+        {
+          continue;
+        }
+
+      list_delete(&next->node);
+      list_add_tail(&io->merged, &next->node);
+      nsegs += next->nsegs;
+      end   += next->len >> VIRTIO_BLK_SECTOR_BITS;
+    }
+
+  return nsegs;
+}
+
+/****************************************************************************
+ * Name: virtio_blk_add_segs
+ *
+ * Description:
+ *   Fill the data descriptors of one request, split by the segment size.
+ *
+ ****************************************************************************/
+
+static int virtio_blk_add_segs(FAR struct virtio_blk_priv_s *priv,
+                               FAR struct virtio_blk_io_s *io,
+                               FAR struct virtqueue_buf *vb)
+{
+  FAR uint8_t *buffer = io->buffer;
+  size_t len = io->len;
+  int n = 0;
+
+  while (len > 0)
+    {
+      vb[n].buf = buffer;
+      vb[n].len = MIN(len, priv->seg_size);
+      buffer   += vb[n].len;
+      len      -= vb[n].len;
+      n++;
+    }
+
+  return n;
+}
+
+/****************************************************************************
+ * Name: virtio_blk_dispatch
+ *
+ * Description:
+ *   Hand the pending requests to the device while there are enough free
+ *   descriptors, then notify the device once.  Must be called with the
+ *   virtqueue lock held.
+ *
+ ****************************************************************************/
+
+static void virtio_blk_dispatch(FAR struct virtio_blk_priv_s *priv,
+                                FAR struct virtio_blk_vq_s *q)
+{
+  FAR struct virtqueue_buf vb[VIRTIO_BLK_MAX_SEGS + 2];
+  FAR struct virtio_blk_io_s *io;
+  FAR struct virtio_blk_io_s *next;
+  bool kick = false;
+  int readnum;
+  int nvb;
+  int ret;
+
+  while (!list_is_empty(&q->pending))
+    {
+      io = list_first_entry(&q->pending, struct virtio_blk_io_s, node);
+      if (io->nsegs + 2 > q->vq->vq_free_cnt)
+        {
+          break;
+        }
+
+      list_delete(&io->node);
+      virtio_blk_merge(priv, q, io);
+
+      /* Fill the virtqueue buffer:
+       * Buffer 0: the block out header;
+       * Buffer 1 ~ n: the data segments of the request and the merged ones;
+       * Buffer n + 1: the block in header, return the status.
+       */
+
+      vb[0].buf = &io->req;
+      vb[0].len = VIRTIO_BLK_REQ_HEADER_SIZE;
+      nvb = 1 + virtio_blk_add_segs(priv, io, &vb[1]);
+      list_for_every_entry(&io->merged, next, struct virtio_blk_io_s, node)
+        {
+          nvb += virtio_blk_add_segs(priv, next, &vb[nvb]);
+        }
+
+      vb[nvb].buf = &io->resp;
+      vb[nvb].len = VIRTIO_BLK_RESP_HEADER_SIZE;
+      nvb++;
+
+      readnum = io->req.type == VIRTIO_BLK_T_IN ? 1 : nvb - 1;
+      ret = virtqueue_add_buffer(q->vq, vb, readnum, nvb - readnum, io);
+      if (ret < 0)
+        {
+          /* Can't happen since the free descriptors were checked, put the
+           * request back and try again on the next completion.
+           */
+
+          vrterr("virtqueue_add_buffer failed, ret=%d\n", ret);
+          while (!list_is_empty(&io->merged))
             {
-              nxsem_post(sem);
+              next = list_last_entry(&io->merged, struct virtio_blk_io_s,
+                                     node);
+              list_delete(&next->node);
+              list_add_head(&q->pending, &next->node);
             }
+
+          list_add_head(&q->pending, &io->node);
+          break;
         }
+
+      kick = true;
+    }
+
+  if (kick)
+    {
+      virtqueue_kick(q->vq);
+    }
+}
+
+/****************************************************************************
+ * Name: virtio_blk_io_done
+ *
+ * Description:
+ *   Report the completion of one request to its waiter.  The request and
+ *   the waiter may vanish as soon as the waiter is woken up.
+ *
+ ****************************************************************************/
+
+static void virtio_blk_io_done(FAR struct virtio_blk_io_s *io,
+                               uint8_t status)
+{
+  FAR struct virtio_blk_wait_s *wait = io->wait;
+
+  if (status != VIRTIO_BLK_S_OK && wait->result == OK)
+    {
+      wait->result = status == VIRTIO_BLK_S_UNSUPP ? -ENOTSUP : -EIO;
+    }
+
+  if (wait->polling)
+    {
+      wait->pending--;
     }
   else
     {
-      nxsem_wait_uninterruptible(respsem);
+      nxsem_post(&wait->sem);
     }
 }
 
 /****************************************************************************
- * Name: virtio_blk_rdwr
+ * Name: virtio_blk_complete
  *
  * Description:
- *   Common function for read and write
+ *   Reap the finished requests of a virtqueue, refill the virtqueue with
+ *   the pending requests and wake up the waiters.
  *
  ****************************************************************************/
 
-static ssize_t virtio_blk_rdwr(FAR struct virtio_blk_priv_s *priv,
-                               FAR void *buffer, blkcnt_t startsector,
-                               unsigned int nsectors, bool write)
+static void virtio_blk_complete(FAR struct virtio_blk_priv_s *priv,
+                                FAR struct virtio_blk_vq_s *q)
 {
-  FAR struct virtio_device *vdev = priv->vdev;
-  FAR struct virtqueue *vq = vdev->vrings_info[0].vq;
-  FAR struct virtqueue_buf vb[3];
-  struct virtio_blk_resp_s resp;
-  struct virtio_blk_req_s req;
+  FAR struct virtio_blk_io_s *io;
+  FAR struct virtio_blk_io_s *next;
+  FAR struct virtio_blk_io_s *tmp;
+  struct list_node done;
   irqstate_t flags;
-  sem_t respsem;
-  ssize_t ret;
-  int readnum;
 
-  nxsem_init(&respsem, 0, 0);
+  list_initialize(&done);
 
-  /* Build the block request */
+  flags = spin_lock_irqsave(&q->lock);
+  while ((io = virtqueue_get_buffer(q->vq, NULL, NULL)) != NULL)
+    {
+      list_add_tail(&done, &io->node);
+    }
 
-  req.type     = write ? VIRTIO_BLK_T_OUT : VIRTIO_BLK_T_IN;
-  req.reserved = 0;
-  req.sector   = startsector * priv->block_size >> VIRTIO_BLK_SECTOR_BITS;
-  resp.status  = VIRTIO_BLK_S_IOERR;
+  virtio_blk_dispatch(priv, q);
+  spin_unlock_irqrestore(&q->lock, flags);
 
-  /* Fill the virtqueue buffer:
-   * Buffer 0: the block out header;
-   * Buffer 1: the read/write buffer;
-   * Buffer 2: the block in header, return the status.
-   */
+  list_for_every_entry_safe(&done, io, tmp, struct virtio_blk_io_s, node)
+    {
+      uint8_t status = io->resp.status;
 
-  vb[0].buf = &req;
-  vb[0].len = VIRTIO_BLK_REQ_HEADER_SIZE;
-  vb[1].buf = buffer;
-  vb[1].len = nsectors * priv->block_size;
-  vb[2].buf = &resp;
-  vb[2].len = VIRTIO_BLK_RESP_HEADER_SIZE;
-  readnum = write ? 2 : 1;
+      while (!list_is_empty(&io->merged))
+        {
+          next = list_first_entry(&io->merged, struct virtio_blk_io_s,
+                                  node);
+          list_delete(&next->node);
+          virtio_blk_io_done(next, status);
+        }
+
+      virtio_blk_io_done(io, status);
+    }
+}
 
-  if (up_interrupt_context())
+/****************************************************************************
+ * Name: virtio_blk_submit
+ *
+ * Description:
+ *   Queue 'nio' requests to the virtqueue of this CPU and wait for all of
+ *   them to complete.
+ *
+ ****************************************************************************/
+
+static int virtio_blk_submit(FAR struct virtio_blk_priv_s *priv,
+                             FAR struct virtio_blk_io_s *io, int nio,
+                             FAR struct virtio_blk_wait_s *wait)
+{
+  FAR struct virtio_blk_vq_s *q = &priv->vqs[this_cpu() % priv->nvqs];
+  irqstate_t flags;
+  int i;
+
+  wait->pending = nio;
+  if (wait->polling)
     {
-      virtqueue_disable_cb_lock(vq, &priv->lock);
+      virtqueue_disable_cb_lock(q->vq, &q->lock);
     }
 
-  flags = spin_lock_irqsave(&priv->lock);
-  ret = virtqueue_add_buffer(vq, vb, readnum, 3 - readnum, &respsem);
-  if (ret < 0)
+  flags = spin_lock_irqsave(&q->lock);
+  for (i = 0; i < nio; i++)
+    {
+      DEBUGASSERT(io[i].nsegs <= priv->seg_max);
+      list_add_tail(&q->pending, &io[i].node);
+    }
+
+  virtio_blk_dispatch(priv, q);
+  spin_unlock_irqrestore(&q->lock, flags);
+
+  /* Wait for the requests completion */
+
+  if (wait->polling)
     {
-      spin_unlock_irqrestore(&priv->lock, flags);
-      vrterr("virtqueue_add_buffer failed, ret=%zd\n", ret);
-      goto err;
+      while (wait->pending > 0)
+        {
+          virtio_blk_complete(priv, q);
+        }
+
+      virtqueue_enable_cb_lock(q->vq, &q->lock);
+    }
+  else
+    {
+      for (i = 0; i < nio; i++)
+        {
+          nxsem_wait_uninterruptible(&wait->sem);
+        }
     }
 
-  virtqueue_kick(vq);
-  spin_unlock_irqrestore(&priv->lock, flags);
+  return wait->result;
+}
+
+/****************************************************************************
+ * Name: virtio_blk_wait_init
+ ****************************************************************************/
+
+static void virtio_blk_wait_init(FAR struct virtio_blk_wait_s *wait)
+{
+  nxsem_init(&wait->sem, 0, 0);
+  wait->pending = 0;
+  wait->result  = OK;
+  wait->polling = up_interrupt_context() || OSINIT_IS_PANIC();
+}
+
+/****************************************************************************
+ * Name: virtio_blk_rdwr
+ *
+ * Description:
+ *   Common function for read and write.  The transfer is split into the
+ *   largest requests the device accepts and up to VIRTIO_BLK_QUEUE_DEPTH
+ *   of them are kept in flight.
+ *
+ ****************************************************************************/
 
-  /* Wait for the request completion */
+static ssize_t virtio_blk_rdwr(FAR struct virtio_blk_priv_s *priv,
+                               FAR void *buffer, blkcnt_t startsector,
+                               unsigned int nsectors, bool write)
+{
+  struct virtio_blk_io_s io[VIRTIO_BLK_QUEUE_DEPTH];
+  struct virtio_blk_wait_s wait;
+  FAR uint8_t *buf = buffer;
+  size_t maxlen;
+  size_t len;
+  uint64_t sector;
+  int ret = OK;
+  int nio;
 
-  virtio_blk_wait_complete(vq, &respsem);
+  /* The largest request, rounded down to whole blocks */
 
-  if (resp.status != VIRTIO_BLK_S_OK)
+  maxlen = (size_t)priv->seg_size * priv->seg_max;
+  maxlen = MAX(maxlen / priv->block_size, 1) * priv->block_size;
+
+  len    = (size_t)nsectors * priv->block_size;
+  sector = startsector * priv->block_size >> VIRTIO_BLK_SECTOR_BITS;
+
+  virtio_blk_wait_init(&wait);
+  while (len > 0 && ret >= 0)
     {
-      vrterr("%s Error\n", write ? "Write" : "Read");
-      ret = -EIO;
+      for (nio = 0; nio < VIRTIO_BLK_QUEUE_DEPTH && len > 0; nio++)
+        {
+          size_t iolen = MIN(len, maxlen);
+
+          virtio_blk_io_init(priv, &io[nio], &wait,
+                             write ? VIRTIO_BLK_T_OUT : VIRTIO_BLK_T_IN,
+                             sector, buf, iolen);
+          sector += iolen >> VIRTIO_BLK_SECTOR_BITS;
+          buf    += iolen;
+          len    -= iolen;
+        }
+
+      ret = virtio_blk_submit(priv, io, nio, &wait);
     }
 
-err:
-  if (up_interrupt_context())
+  nxsem_destroy(&wait.sem);
+  if (ret < 0)
     {
-      virtqueue_enable_cb_lock(vq, &priv->lock);
+      vrterr("%s Error, ret=%d\n", write ? "Write" : "Read", ret);
+      return ret;
     }
 
-  return ret >= 0 ? nsectors : ret;
+  return nsectors;
 }
 
 /****************************************************************************
@@ -402,54 +754,87 @@ static int virtio_blk_geometry(FAR struct inode *inode,
 }
 
 /****************************************************************************
- * Name: virtio_blk_ioctl
+ * Name: virtio_blk_flush
  ****************************************************************************/
 
 static int virtio_blk_flush(FAR struct virtio_blk_priv_s *priv)
 {
-  FAR struct virtio_device *vdev = priv->vdev;
-  FAR struct virtqueue *vq = vdev->vrings_info[0].vq;
-  FAR struct virtqueue_buf vb[2];
-  struct virtio_blk_resp_s resp;
-  struct virtio_blk_req_s req;
-  irqstate_t flags;
-  sem_t respsem;
+  struct virtio_blk_wait_s wait;
+  struct virtio_blk_io_s io;
   int ret;
 
-  nxsem_init(&respsem, 0, 0);
+  virtio_blk_wait_init(&wait);
+  virtio_blk_io_init(priv, &io, &wait, VIRTIO_BLK_T_FLUSH, 0, NULL, 0);
+  ret = virtio_blk_submit(priv, &io, 1, &wait);
+  nxsem_destroy(&wait.sem);
+  if (ret < 0)
+    {
+      vrterr("Flush Error\n");
+    }
 
-  /* Build the block request */
+  return ret;
+}
+
+/****************************************************************************
+ * Name: virtio_blk_discard
+ *
+ * Description:
+ *   Discard or zero the sector range range[0] ~ range[0] + range[1] - 1,
+ *   'type' is VIRTIO_BLK_T_DISCARD or VIRTIO_BLK_T_WRITE_ZEROES.
+ *
+ ****************************************************************************/
 
-  req.type     = VIRTIO_BLK_T_FLUSH;
-  req.reserved = 0;
-  req.sector   = 0;
-  resp.status  = VIRTIO_BLK_S_IOERR;
+static int virtio_blk_discard(FAR struct virtio_blk_priv_s *priv,
+                              uint32_t type, FAR const blkcnt_t *range)
+{
+  struct virtio_blk_discard_s seg;
+  struct virtio_blk_wait_s wait;
+  struct virtio_blk_io_s io;
+  uint64_t sector;
+  uint64_t nsectors;
+  uint32_t maxsectors = 0;
+  int ret = OK;
 
-  vb[0].buf = &req;
-  vb[0].len = VIRTIO_BLK_REQ_HEADER_SIZE;
-  vb[1].buf = &resp;
-  vb[1].len = VIRTIO_BLK_RESP_HEADER_SIZE;
+  if (range == NULL || range[0] < 0 || range[1] < 0 ||
+      range[0] + range[1] > priv->nsectors)
+    {
+      return -EINVAL;
+    }
 
-  flags = spin_lock_irqsave(&priv->lock);
-  ret = virtqueue_add_buffer(vq, vb, 1, 1, &respsem);
-  if (ret < 0)
+  if (type == VIRTIO_BLK_T_DISCARD)
     {
-      spin_unlock_irqrestore(&priv->lock, flags);
-      return ret;
+      virtio_read_config_member(priv->vdev, struct virtio_blk_config_s,
+                                max_discard_sectors, &maxsectors);
+    }
+  else
+    {
+      virtio_read_config_member(priv->vdev, struct virtio_blk_config_s,
+                                max_write_zeroes_sectors, &maxsectors);
     }
 
-  virtqueue_kick(vq);
-  spin_unlock_irqrestore(&priv->lock, flags);
+  if (maxsectors == 0)
+    {
+      maxsectors = UINT32_MAX;
+    }
 
-  /* Wait for the request completion */
+  sector   = range[0] * priv->block_size >> VIRTIO_BLK_SECTOR_BITS;
+  nsectors = range[1] * priv->block_size >> VIRTIO_BLK_SECTOR_BITS;
 
-  nxsem_wait_uninterruptible(&respsem);
-  if (resp.status != VIRTIO_BLK_S_OK)
+  virtio_blk_wait_init(&wait);
+  while (nsectors > 0 && ret >= 0)
     {
-      vrterr("Flush Error\n");
-      ret = -EIO;
+      seg.sector      = sector;
+      seg.num_sectors = MIN(nsectors, maxsectors);
+      seg.flags       = 0;
+
+      virtio_blk_io_init(priv, &io, &wait, type, 0, &seg, sizeof(seg));
+      ret = virtio_blk_submit(priv, &io, 1, &wait);
+
+      sector   += seg.num_sectors;
+      nsectors -= seg.num_sectors;
     }
 
+  nxsem_destroy(&wait.sem);
   return ret;
 }
 
@@ -474,6 +859,22 @@ static int virtio_blk_ioctl(FAR struct inode *inode, int cmd,
             ret = virtio_blk_flush(priv);
           }
         break;
+
+      case BIOC_TRIM:
+        if (virtio_has_feature(priv->vdev, VIRTIO_BLK_F_DISCARD))
+          {
+            ret = virtio_blk_discard(priv, VIRTIO_BLK_T_DISCARD,
+                                     (FAR const blkcnt_t *)arg);
+          }
+        break;
+
+      case BIOC_ZEROOUT:
+        if (virtio_has_feature(priv->vdev, VIRTIO_BLK_F_WRITE_ZEROES))
+          {
+            ret = virtio_blk_discard(priv, VIRTIO_BLK_T_WRITE_ZEROES,
+                                     (FAR const blkcnt_t *)arg);
+          }
+        break;
     }
 
   return ret;
@@ -486,18 +887,8 @@ static int virtio_blk_ioctl(FAR struct inode *inode, int cmd,
 static void virtio_blk_done(FAR struct virtqueue *vq)
 {
   FAR struct virtio_blk_priv_s *priv = vq->vq_dev->priv;
-  FAR sem_t *respsem;
-
-  for (; ; )
-    {
-      respsem = virtqueue_get_buffer_lock(vq, NULL, NULL, &priv->lock);
-      if (respsem == NULL)
-        {
-          break;
-        }
 
-      nxsem_post(respsem);
-    }
+  virtio_blk_complete(priv, &priv->vqs[vq->vq_queue_index]);
 }
 
 /****************************************************************************
@@ -507,25 +898,45 @@ static void virtio_blk_done(FAR struct virtqueue *vq)
 static int virtio_blk_init(FAR struct virtio_blk_priv_s *priv,
                            FAR struct virtio_device *vdev)
 {
-  FAR const char *vqname[1];
-  vq_callback callback[1];
+  FAR const char *vqname[VIRTIO_BLK_NQUEUES];
+  vq_callback callback[VIRTIO_BLK_NQUEUES];
+  uint16_t num_queues = 1;
   int ret;
+  int i;
 
   priv->vdev = vdev;
   vdev->priv = priv;
-  spin_lock_init(&priv->lock);
 
   /* Initialize the virtio device */
 
   virtio_set_status(vdev, VIRTIO_CONFIG_STATUS_DRIVER);
-  virtio_negotiate_features(vdev, (1UL << VIRTIO_BLK_F_RO) |
+  virtio_negotiate_features(vdev, (1UL << VIRTIO_BLK_F_SIZE_MAX) |
+                                  (1UL << VIRTIO_BLK_F_SEG_MAX) |
+                                  (1UL << VIRTIO_BLK_F_RO) |
                                   (1UL << VIRTIO_BLK_F_BLK_SIZE) |
-                                  (1UL << VIRTIO_BLK_F_FLUSH), NULL);
+                                  (1UL << VIRTIO_BLK_F_FLUSH) |
+                                  (1UL << VIRTIO_BLK_F_MQ) |
+                                  (1UL << VIRTIO_BLK_F_DISCARD) |
+                                  (1UL << VIRTIO_BLK_F_WRITE_ZEROES), NULL);
   virtio_set_status(vdev, VIRTIO_CONFIG_FEATURES_OK);
 
-  vqname[0]   = "virtio_blk_vq";
-  callback[0] = virtio_blk_done;
-  ret = virtio_create_virtqueues(vdev, 0, 1, vqname, callback, NULL);
+  if (virtio_has_feature(vdev, VIRTIO_BLK_F_MQ))
+    {
+      virtio_read_config_member(vdev, struct virtio_blk_config_s,
+                                num_queues, &num_queues);
+    }
+
+  priv->nvqs = MIN(MAX(num_queues, 1), VIRTIO_BLK_NQUEUES);
+  for (i = 0; i < priv->nvqs; i++)
+    {
+      spin_lock_init(&priv->vqs[i].lock);
+      list_initialize(&priv->vqs[i].pending);
+      vqname[i]   = "virtio_blk_vq";
+      callback[i] = virtio_blk_done;
+    }
+
+  ret = virtio_create_virtqueues(vdev, 0, priv->nvqs, vqname, callback,
+                                 NULL);
   if (ret < 0)
     {
       vrterr("virtio_device_create_virtqueue failed, ret=%d\n", ret);
@@ -533,7 +944,12 @@ static int virtio_blk_init(FAR struct virtio_blk_priv_s *priv,
     }
 
   virtio_set_status(vdev, VIRTIO_CONFIG_STATUS_DRIVER_OK);
-  virtqueue_enable_cb(vdev->vrings_info[0].vq);
+  for (i = 0; i < priv->nvqs; i++)
+    {
+      priv->vqs[i].vq = vdev->vrings_info[i].vq;
+      virtqueue_enable_cb(priv->vqs[i].vq);
+    }
+
   return ret;
 }
 
@@ -593,6 +1009,40 @@ static int virtio_blk_probe(FAR struct virtio_device *vdev)
       priv->block_size = VIRTIO_BLK_SECTOR_SIZE;
     }
 
+  /* Read the request limits, the device accepts any segment size and up
+   * to a full virtqueue of segments if they are not offered.
+   */
+
+  priv->seg_size = VIRTIO_BLK_MAX_SEG_SIZE;
+  if (virtio_has_feature(vdev, VIRTIO_BLK_F_SIZE_MAX))
+    {
+      uint32_t size_max;
+
+      virtio_read_config_member(priv->vdev, struct virtio_blk_config_s,
+                                size_max, &size_max);
+      if (size_max > 0)
+        {
+          priv->seg_size = MIN(size_max, VIRTIO_BLK_MAX_SEG_SIZE);
+        }
+    }
+
+  priv->seg_max = MIN(VIRTIO_BLK_MAX_SEGS,
+                      priv->vqs[0].vq->vq_nentries - 2);
+  if (virtio_has_feature(vdev, VIRTIO_BLK_F_SEG_MAX))
+    {
+      uint32_t seg_max;
+
+      virtio_read_config_member(priv->vdev, struct virtio_blk_config_s,
+                                seg_max, &seg_max);
+      if (seg_max > 0)
+        {
+          priv->seg_max = MIN(priv->seg_max, seg_max);
+        }
+    }
+
+  vrtinfo("Virio blk nvqs=%d seg_size=%" PRIu32 " seg_max=%u\n",
+          priv->nvqs, priv->seg_size, priv->seg_max);
+
   /* Register block driver */
 
   snprintf(priv->name, NAME_MAX, "/dev/virtblk%d", g_virtio_blk_idx);
@@ -30,10 +30,16 @@
 #include <string.h>
 #include <stdlib.h>
 
+#include <nuttx/arch.h>
 #include <nuttx/compiler.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/sched.h>
+#include <nuttx/net/ethernet.h>
 #include <nuttx/net/ip.h>
+#include <nuttx/net/netdev.h>
 #include <nuttx/net/netdev_lowerhalf.h>
+#include <nuttx/net/tcp.h>
+#include <nuttx/net/udp.h>
 #include <nuttx/virtio/virtio.h>
 #include <nuttx/net/wifi_sim.h>
 
@@ -45,31 +51,84 @@
 
 /* Virtio net feature bits */
 
-#define VIRTIO_NET_F_MAC      5
+#define VIRTIO_NET_F_CSUM       0
+#define VIRTIO_NET_F_GUEST_CSUM 1
+#define VIRTIO_NET_F_MAC        5
+#define VIRTIO_NET_F_HOST_TSO4  11
+#define VIRTIO_NET_F_HOST_TSO6  12
+#define VIRTIO_NET_F_MRG_RXBUF  15
+#define VIRTIO_NET_F_CTRL_VQ    17
+#define VIRTIO_NET_F_MQ         22
 
-/* Virtio net header size and packet buffer size */
+/* Virtio net header flags and gso types */
+
+#define VIRTIO_NET_HDR_F_NEEDS_CSUM 1
+#define VIRTIO_NET_HDR_F_DATA_VALID 2
+
+#define VIRTIO_NET_HDR_GSO_NONE     0
+#define VIRTIO_NET_HDR_GSO_TCPV4    1
+#define VIRTIO_NET_HDR_GSO_TCPV6    4
+
+/* Virtio net control virtqueue commands */
+
+#define VIRTIO_NET_CTRL_MQ              4
+#define VIRTIO_NET_CTRL_MQ_VQ_PAIRS_SET 0
+
+#define VIRTIO_NET_OK           0
+#define VIRTIO_NET_ERR          1
+
+/* Virtio net header size and packet buffer size, the header is two bytes
+ * shorter when VIRTIO_NET_F_MRG_RXBUF is not negotiated.
+ */
 
 #define VIRTIO_NET_HDRSIZE    (sizeof(struct virtio_net_hdr_s))
-#define VIRTIO_NET_LLHDRSIZE  (sizeof(struct virtio_net_llhdr_s))
+#define VIRTIO_NET_HDRSIZE_NOMRG \
+    (offsetof(struct virtio_net_hdr_s, num_buffers))
 #define VIRTIO_NET_BUFSIZE    (CONFIG_NET_ETH_PKTSIZE + CONFIG_NET_GUARDSIZE)
 
-/* Virtio net virtqueue index and number */
+/* With mergeable RX buffers every RX buffer is a single IOB */
+
+#define VIRTIO_NET_MRG_BUFSIZE \
+    MIN(CONFIG_IOB_BUFSIZE - CONFIG_NET_LL_GUARDSIZE + ETH_HDRLEN, \
+        VIRTIO_NET_BUFSIZE)
+
+/* Virtio net virtqueue index, queue pair n uses virtqueue 2n for RX and
+ * 2n + 1 for TX, the control virtqueue follows the last pair the device
+ * supports.
+ */
+
+#define VIRTIO_NET_RX           0
+#define VIRTIO_NET_TX           1
+#define VIRTIO_NET_NUM          2
 
-#define VIRTIO_NET_RX         0
-#define VIRTIO_NET_TX         1
-#define VIRTIO_NET_NUM        2
+#define VIRTIO_NET_MAX_PAIRS    CONFIG_DRIVERS_VIRTIO_NET_QUEUE_PAIRS
 
 #define VIRTIO_NET_MAX_PKT_SIZE \
     ((CONFIG_NET_LL_GUARDSIZE - ETH_HDRLEN) + VIRTIO_NET_BUFSIZE)
 #define VIRTIO_NET_MAX_NIOB \
     ((VIRTIO_NET_MAX_PKT_SIZE + CONFIG_IOB_BUFSIZE - 1) / CONFIG_IOB_BUFSIZE)
 
+/* The largest TX frame, TCP super-segments up to
+ * CONFIG_DRIVERS_VIRTIO_NET_TSO_MAXSIZE are handed to the device when
+ * VIRTIO_NET_F_HOST_TSO4/6 is negotiated.
+ */
+
+#define VIRTIO_NET_TX_MAXSIZE \
+    MAX(CONFIG_DRIVERS_VIRTIO_NET_TSO_MAXSIZE, VIRTIO_NET_BUFSIZE)
+#define VIRTIO_NET_TX_MAX_NIOB \
+    ((CONFIG_NET_LL_GUARDSIZE - ETH_HDRLEN + VIRTIO_NET_TX_MAXSIZE + \
+      CONFIG_IOB_BUFSIZE - 1) / CONFIG_IOB_BUFSIZE)
+
+/* Control virtqueue command timeout, in microseconds */
+
+#define VIRTIO_NET_CTRL_TIMEOUT 1000000
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
-/* Virtio net header, just define it here for further, now only use it
- * to calculate the virto net header size, see marco VIRTIO_NET_HDRSIZE
+/* Virtio net header, num_buffers is only present when
+ * VIRTIO_NET_F_MRG_RXBUF is negotiated.
  */
 
 begin_packed_struct struct virtio_net_hdr_s
@@ -80,6 +139,7 @@ begin_packed_struct struct virtio_net_hdr_s
   uint16_t gso_size;
   uint16_t csum_start;
   uint16_t csum_offset;
+  uint16_t num_buffers;
 } end_packed_struct;
 
 /* The definition of the struct virtio_net_config refers to the link
@@ -100,6 +160,32 @@ begin_packed_struct struct virtio_net_config_s
   uint32_t supported_hash_types;
 } end_packed_struct;
 
+/* Virtio net control virtqueue command, only VIRTIO_NET_CTRL_MQ is used */
+
+begin_packed_struct struct virtio_net_ctrl_s
+{
+  uint8_t  class;
+  uint8_t  cmd;
+  uint16_t pairs;
+  uint8_t  ack;
+} end_packed_struct;
+
+struct virtio_net_rxq_s
+{
+  FAR struct virtqueue     *vq;
+  spinlock_t                lock;
+};
+
+struct virtio_net_txq_s
+{
+  FAR struct virtqueue     *vq;
+  spinlock_t                lock;
+
+  /* Descriptor scratch, protected by lock */
+
+  struct virtqueue_buf      vb[VIRTIO_NET_TX_MAX_NIOB + 1];
+};
+
 struct virtio_net_priv_s
 {
 #ifdef CONFIG_DRIVERS_WIFI_SIM
@@ -113,12 +199,17 @@ struct virtio_net_priv_s
   struct netdev_lowerhalf_s lower;     /* The netdev lowerhalf */
 #endif
 
-  spinlock_t                lock[VIRTIO_NET_NUM];
+  struct virtio_net_rxq_s   rxq[VIRTIO_NET_MAX_PAIRS];
+  struct virtio_net_txq_s   txq[VIRTIO_NET_MAX_PAIRS];
 
   /* Virtio device information */
 
   FAR struct virtio_device *vdev;      /* Virtio device pointer */
-  int                       bufnum;    /* TX and RX Buffer number */
+  int                       txnum;     /* TX buffer number */
+  int                       rxnum;     /* RX buffer number */
+  uint16_t                  npairs;    /* Queue pairs in use */
+  uint16_t                  rxbufsize; /* Size of each RX buffer */
+  uint8_t                   hdrsize;   /* Virtio net header size */
 };
 
 /* Virtio Link Layer Header, follow shows the iob buffer layout:
@@ -128,23 +219,19 @@ struct virtio_net_priv_s
  * | Virtio Header |  ETH Header   |    data    | free | --> | next netpkt |
  * +---------------+---------------+------------+------+     +-------------+
  * |               |<--------- datalen -------->|
- * ^base           ^data
+ *                 ^data
+ *
+ * The netpkt itself is the virtqueue cookie, so only the virtio header has
+ * to fit in front of the ETH header:
  *
- * CONFIG_NET_LL_GUARDSIZE >= VIRTIO_NET_LLHDRSIZE + ETH_HDR_SIZE
- *                          = sizeof(uintptr) + 10 + 14
- *                          = 32 (64-Bit)
- *                          = 28 (32-Bit)
+ * CONFIG_NET_LL_GUARDSIZE >= VIRTIO_NET_HDRSIZE + ETH_HDR_SIZE
+ *                          = 12 + 14
+ *                          = 26
  */
 
-begin_packed_struct struct virtio_net_llhdr_s
-{
-  FAR netpkt_t           *pkt;         /* Netpaket pointer */
-  struct virtio_net_hdr_s vhdr;        /* Virtio net header */
-} end_packed_struct;
-
-static_assert(CONFIG_NET_LL_GUARDSIZE >= VIRTIO_NET_LLHDRSIZE + ETH_HDRLEN,
+static_assert(CONFIG_NET_LL_GUARDSIZE >= VIRTIO_NET_HDRSIZE + ETH_HDRLEN,
               "CONFIG_NET_LL_GUARDSIZE cannot be less than ETH_HDRLEN"
-              " + VIRTIO_NET_LLHDRSIZE");
+              " + VIRTIO_NET_HDRSIZE");
 
 /****************************************************************************
  * Private Function Prototypes
@@ -207,76 +294,54 @@ static uint8_t g_netdev_num = 0;
  ****************************************************************************/
 
 /****************************************************************************
- * Name: virtio_net_addbuffer
+ * Name: virtio_net_fillbuf
+ *
+ * Description:
+ *   Describe the netpkt and the virtio net header in front of it with
+ *   virtqueue buffers, return the number of buffers used.
+ *
  ****************************************************************************/
 
-static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
-                                FAR struct virtqueue *vq, FAR netpkt_t *pkt,
-                                unsigned int vq_id)
+static int virtio_net_fillbuf(FAR struct netdev_lowerhalf_s *dev,
+                              FAR netpkt_t *pkt,
+                              FAR struct virtqueue_buf *vb, int nvb)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtio_net_llhdr_s *hdr;
-  struct virtqueue_buf vb[VIRTIO_NET_MAX_NIOB + 1];
-  struct iovec iov[VIRTIO_NET_MAX_NIOB];
-  int iov_cnt;
-  int i;
-
-  /* Convert netpkt to virtqueue_buf */
-
-  iov_cnt = netpkt_to_iov(dev, pkt, iov, VIRTIO_NET_MAX_NIOB);
+  FAR uint8_t *hdr;
+  int iov_cnt = 0;
 
-  /* Alloc cookie and net header from transport layer */
+  /* The virtio net header is just in front of the link layer header */
 
-  hdr = (FAR struct virtio_net_llhdr_s *)
-          ((FAR uint8_t *)iov[0].iov_base - VIRTIO_NET_LLHDRSIZE);
-  DEBUGASSERT((FAR uint8_t *)hdr >= netpkt_getbase(pkt));
-  memset(&hdr->vhdr, 0, sizeof(hdr->vhdr));
-  hdr->pkt = pkt;
+  hdr = IOB_DATA(pkt) - NET_LL_HDRLEN(&dev->netdev) - priv->hdrsize;
+  DEBUGASSERT(hdr >= netpkt_getbase(pkt));
 
   /* Prepare buffers depends on the feature VIRTIO_F_ANY_LAYOUT */
 
+  vb[iov_cnt].buf = hdr;
   if (virtio_has_feature(priv->vdev, VIRTIO_F_ANY_LAYOUT))
     {
       /* Append the virtio net header to the first buffer */
 
-      vb[0].buf = &hdr->vhdr;
-      vb[0].len = iov[0].iov_len + VIRTIO_NET_HDRSIZE;
-
-#if VIRTIO_NET_MAX_NIOB > 1
-      for (i = 1; i < iov_cnt; i++)
-        {
-          vb[i].buf = iov[i].iov_base;
-          vb[i].len = iov[i].iov_len;
-        }
-#endif
+      vb[iov_cnt++].len = priv->hdrsize + NET_LL_HDRLEN(&dev->netdev) +
+                          pkt->io_len;
     }
   else
     {
       /* Buffer 0 is only for virtio net header */
 
-      vb[0].buf = &hdr->vhdr;
-      vb[0].len = VIRTIO_NET_HDRSIZE;
-
-      for (i = 0; i < iov_cnt; i++)
-        {
-          vb[i + 1].buf = iov[i].iov_base;
-          vb[i + 1].len = iov[i].iov_len;
-        }
-
-      iov_cnt++;
+      vb[iov_cnt++].len = priv->hdrsize;
+      vb[iov_cnt].buf   = hdr + priv->hdrsize;
+      vb[iov_cnt++].len = NET_LL_HDRLEN(&dev->netdev) + pkt->io_len;
     }
 
-  vrtinfo("Fill vq=%u, hdr=%p, count=%d\n", vq_id, hdr, iov_cnt);
-  if (vq_id == VIRTIO_NET_RX)
-    {
-      return virtqueue_add_buffer_lock(vq, vb, 0, iov_cnt, hdr,
-                                       &priv->lock[vq_id]);
-    }
-  else
+  for (pkt = pkt->io_flink; pkt != NULL && iov_cnt < nvb;
+       pkt = pkt->io_flink)
     {
-      return virtqueue_add_buffer_lock(vq, vb, iov_cnt, 0, hdr,
-                                       &priv->lock[vq_id]);
+      vb[iov_cnt].buf   = IOB_DATA(pkt);
+      vb[iov_cnt++].len = pkt->io_len;
     }
+
+  return pkt == NULL ? iov_cnt : -E2BIG;
 }
 
 /****************************************************************************
@@ -286,11 +351,17 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
 static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_RX].vq;
+  FAR struct virtio_net_rxq_s *rxq;
+  struct virtqueue_buf vb[VIRTIO_NET_MAX_NIOB + 1];
+  bool kick[VIRTIO_NET_MAX_PAIRS];
+  irqstate_t flags;
   FAR netpkt_t *pkt;
+  int iov_cnt;
   int i;
+  int j;
 
-  for (i = 0; i < priv->bufnum; i++)
+  memset(kick, 0, sizeof(kick));
+  for (i = 0; i < priv->rxnum; i++)
     {
       /* IOB Offload, Alloc buffer from RX netpkt */
 
@@ -303,22 +374,47 @@ static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev)
 
       /* Preserve data length */
 
-      if (netpkt_setdatalen(dev, pkt, VIRTIO_NET_BUFSIZE) <
-          VIRTIO_NET_BUFSIZE)
+      if (netpkt_setdatalen(dev, pkt, priv->rxbufsize) < priv->rxbufsize)
         {
           vrtwarn("No enough buffer to prepare RX buffer, i=%d\n", i);
           netpkt_free(dev, pkt, NETPKT_RX);
           break;
         }
 
-      /* Add buffer to RX virtqueue */
+      iov_cnt = virtio_net_fillbuf(dev, pkt, vb, nitems(vb));
+
+      /* Add buffer to the RX virtqueue with the most free descriptors */
+
+      rxq = &priv->rxq[0];
+      for (j = 1; j < priv->npairs; j++)
+        {
+          if (priv->rxq[j].vq->vq_free_cnt > rxq->vq->vq_free_cnt)
+            {
+              rxq = &priv->rxq[j];
+            }
+        }
+
+      flags = spin_lock_irqsave(&rxq->lock);
+      if (iov_cnt < 0 || rxq->vq->vq_free_cnt < iov_cnt)
+        {
+          spin_unlock_irqrestore(&rxq->lock, flags);
+          netpkt_free(dev, pkt, NETPKT_RX);
+          break;
+        }
 
-      virtio_net_addbuffer(dev, vq, pkt, VIRTIO_NET_RX);
+      vrtinfo("Fill rxq=%d, pkt=%p, count=%d\n",
+              (int)(rxq - priv->rxq), pkt, iov_cnt);
+      virtqueue_add_buffer(rxq->vq, vb, 0, iov_cnt, pkt);
+      spin_unlock_irqrestore(&rxq->lock, flags);
+      kick[rxq - priv->rxq] = true;
     }
 
-  if (i > 0)
+  for (j = 0; j < priv->npairs; j++)
     {
-      virtqueue_kick_lock(vq, &priv->lock[VIRTIO_NET_RX]);
+      if (kick[j])
+        {
+          virtqueue_kick_lock(priv->rxq[j].vq, &priv->rxq[j].lock);
+        }
     }
 }
 
@@ -329,23 +425,285 @@ static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev)
 static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_TX].vq;
-  FAR struct virtio_net_llhdr_s *hdr;
+  FAR struct virtio_net_txq_s *txq;
+  FAR netpkt_t *pkt;
+  int i;
+
+  for (i = 0; i < priv->npairs; i++)
+    {
+      txq = &priv->txq[i];
+      while (1)
+        {
+          /* Get buffer from tx virtqueue */
+
+          pkt = virtqueue_get_buffer_lock(txq->vq, NULL, NULL, &txq->lock);
+          if (pkt == NULL)
+            {
+              break;
+            }
+
+          vrtinfo("Free, txq=%d, pkt: %p\n", i, pkt);
+          netpkt_free(dev, pkt, NETPKT_TX);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: virtio_net_csum_add
+ *
+ * Description:
+ *   One's complement addition of a 16-bit value to a checksum.
+ *
+ ****************************************************************************/
+
+static inline uint16_t virtio_net_csum_add(uint16_t sum, uint16_t val)
+{
+  sum += val;
+  return sum < val ? sum + 1 : sum;
+}
+
+/****************************************************************************
+ * Name: virtio_net_l4hdr
+ *
+ * Description:
+ *   Locate the TCP/UDP header of the Ethernet frame in pkt.  The IP and
+ *   TCP/UDP headers must be in the first IOB and the IPv4 packet must not
+ *   be a fragment.
+ *
+ * Returned Value:
+ *   The offset of the L4 header from the start of the frame, proto, the
+ *   pseudo-header checksum (without the length) and the L4 length are
+ *   returned through the pointers.  -EINVAL if there is no L4 header the
+ *   device could checksum.
+ *
+ ****************************************************************************/
+
+static int virtio_net_l4hdr(FAR struct netdev_lowerhalf_s *dev,
+                            FAR netpkt_t *pkt, FAR uint8_t *proto,
+                            FAR uint16_t *sum, FAR uint16_t *l4len)
+{
+  FAR struct eth_hdr_s *eth =
+    (FAR struct eth_hdr_s *)netpkt_getdata(dev, pkt);
+  unsigned int len = NET_LL_HDRLEN(&dev->netdev) + pkt->io_len;
+  unsigned int off = ETH_HDRLEN;
+  unsigned int l4hdrlen;
+
+  if (len < ETH_HDRLEN)
+    {
+      return -EINVAL;
+    }
 
-  while (1)
+#ifdef CONFIG_NET_IPv4
+  if (eth->type == HTONS(ETHTYPE_IP))
     {
-      /* Get buffer from tx virtqueue */
+      FAR struct ipv4_hdr_s *ipv4 =
+        (FAR struct ipv4_hdr_s *)((FAR uint8_t *)eth + off);
+      uint16_t iplen;
 
-      hdr = virtqueue_get_buffer_lock(vq, NULL, NULL,
-                                      &priv->lock[VIRTIO_NET_TX]);
-      if (hdr == NULL)
+      if (len < off + IPv4_HDRLEN ||
+          (ipv4->ipoffset[0] & 0x3f) != 0 || ipv4->ipoffset[1] != 0)
         {
-          break;
+          return -EINVAL;
+        }
+
+      iplen  = ((uint16_t)ipv4->len[0] << 8) + ipv4->len[1];
+      off   += (ipv4->vhl & IPv4_HLMASK) << 2;
+      *proto = ipv4->proto;
+      *l4len = iplen - ((ipv4->vhl & IPv4_HLMASK) << 2);
+      *sum   = chksum(*proto, (FAR uint8_t *)ipv4->srcipaddr,
+                      2 * sizeof(in_addr_t));
+    }
+  else
+#endif
+#ifdef CONFIG_NET_IPv6
+  if (eth->type == HTONS(ETHTYPE_IP6))
+    {
+      FAR struct ipv6_hdr_s *ipv6 =
+        (FAR struct ipv6_hdr_s *)((FAR uint8_t *)eth + off);
+
+      if (len < off + IPv6_HDRLEN)
+        {
+          return -EINVAL;
         }
 
-      netpkt_free(dev, hdr->pkt, NETPKT_TX);
-      vrtinfo("Free, hdr: %p, pkt: %p\n", hdr, hdr->pkt);
+      off   += IPv6_HDRLEN;
+      *proto = ipv6->proto;
+      *l4len = ((uint16_t)ipv6->len[0] << 8) + ipv6->len[1];
+      *sum   = chksum(*proto, (FAR uint8_t *)ipv6->srcipaddr,
+                      2 * sizeof(net_ipv6addr_t));
+    }
+  else
+#endif
+    {
+      return -EINVAL;
+    }
+
+  if (*proto == IP_PROTO_TCP)
+    {
+      l4hdrlen = TCP_HDRLEN;
+    }
+  else if (*proto == IP_PROTO_UDP)
+    {
+      l4hdrlen = UDP_HDRLEN;
+    }
+  else
+    {
+      return -EINVAL;
     }
+
+  return len < off + l4hdrlen ? -EINVAL : off;
+}
+
+/****************************************************************************
+ * Name: virtio_net_txoffload
+ *
+ * Description:
+ *   Fill the checksum and segmentation offload part of the virtio net
+ *   header.  The stack leaves the TCP/UDP checksum to us when
+ *   NETDEV_TX_CSUM is set, the device expects the pseudo-header checksum
+ *   in the checksum field.
+ *
+ ****************************************************************************/
+
+static int virtio_net_txoffload(FAR struct netdev_lowerhalf_s *dev,
+                                FAR netpkt_t *pkt,
+                                FAR struct virtio_net_hdr_s *hdr)
+{
+  FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
+  unsigned int len = netpkt_getdatalen(dev, pkt);
+  bool gso = len > NETDEV_PKTSIZE(&dev->netdev);
+  FAR uint16_t *csum;
+  FAR uint8_t *l4;
+  uint16_t l4len;
+  uint16_t sum;
+  uint8_t proto;
+  int off;
+
+  if (!virtio_has_feature(priv->vdev, VIRTIO_NET_F_CSUM))
+    {
+      return gso ? -EMSGSIZE : OK;
+    }
+
+  off = virtio_net_l4hdr(dev, pkt, &proto, &sum, &l4len);
+  if (off < 0)
+    {
+      return gso ? -EMSGSIZE : OK;
+    }
+
+  l4 = netpkt_getdata(dev, pkt) + off;
+  if (proto == IP_PROTO_TCP)
+    {
+      csum = &((FAR struct tcp_hdr_s *)l4)->tcpchksum;
+      hdr->csum_offset = offsetof(struct tcp_hdr_s, tcpchksum);
+    }
+  else
+    {
+      csum = &((FAR struct udp_hdr_s *)l4)->udpchksum;
+      hdr->csum_offset = offsetof(struct udp_hdr_s, udpchksum);
+    }
+
+  if (gso)
+    {
+      FAR struct tcp_hdr_s *tcp = (FAR struct tcp_hdr_s *)l4;
+      unsigned int hdrlen = off + ((tcp->tcpoffset >> 4) << 2);
+      bool ipv4 = ((FAR struct eth_hdr_s *)netpkt_getdata(dev, pkt))->type
+                  == HTONS(ETHTYPE_IP);
+
+      if (proto != IP_PROTO_TCP || len > VIRTIO_NET_TX_MAXSIZE ||
+          hdrlen >= NETDEV_PKTSIZE(&dev->netdev) ||
+          !virtio_has_feature(priv->vdev, ipv4 ? VIRTIO_NET_F_HOST_TSO4 :
+                                                 VIRTIO_NET_F_HOST_TSO6))
+        {
+          return -EMSGSIZE;
+        }
+
+      /* The device segments at gso_size and fixes the length of each
+       * segment, so the pseudo-header checksum excludes the length.
+       */
+
+      hdr->gso_type = ipv4 ? VIRTIO_NET_HDR_GSO_TCPV4 :
+                             VIRTIO_NET_HDR_GSO_TCPV6;
+      hdr->hdr_len  = hdrlen;
+      hdr->gso_size = NETDEV_PKTSIZE(&dev->netdev) - hdrlen;
+    }
+  else
+    {
+      sum = virtio_net_csum_add(sum, l4len);
+    }
+
+  *csum = HTONS(sum);
+  hdr->flags      = VIRTIO_NET_HDR_F_NEEDS_CSUM;
+  hdr->csum_start = off;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: virtio_net_rxcsum
+ *
+ * Description:
+ *   With NETDEV_RX_CSUM the stack trusts all received checksums, verify
+ *   the frames the device did not validate.
+ *
+ ****************************************************************************/
+
+static bool virtio_net_rxcsum(FAR struct netdev_lowerhalf_s *dev,
+                              FAR netpkt_t *pkt, uint8_t flags)
+{
+  FAR struct eth_hdr_s *eth =
+    (FAR struct eth_hdr_s *)netpkt_getdata(dev, pkt);
+  unsigned int len;
+  uint16_t l4len;
+  uint16_t sum;
+  uint8_t proto;
+  int off;
+
+#ifdef CONFIG_NET_IPv4
+  if (eth->type == HTONS(ETHTYPE_IP))
+    {
+      FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)IOB_DATA(pkt);
+
+      if (pkt->io_len < IPv4_HDRLEN ||
+          pkt->io_len < ((ipv4->vhl & IPv4_HLMASK) << 2) ||
+          ipv4_chksum(ipv4) != 0xffff)
+        {
+          return false;
+        }
+    }
+#endif
+
+  if ((flags & (VIRTIO_NET_HDR_F_NEEDS_CSUM |
+                VIRTIO_NET_HDR_F_DATA_VALID)) != 0)
+    {
+      return true;
+    }
+
+  off = virtio_net_l4hdr(dev, pkt, &proto, &sum, &l4len);
+  if (off < 0)
+    {
+      return true;
+    }
+
+  /* Drop the Ethernet padding so that only the L4 data is summed */
+
+  len = netpkt_getdatalen(dev, pkt);
+  if (len < off + l4len)
+    {
+      return false;
+    }
+  else if (len > off + l4len)
+    {
+      netpkt_setdatalen(dev, pkt, off + l4len);
+    }
+
+  if (proto == IP_PROTO_UDP &&
+      ((FAR struct udp_hdr_s *)((FAR uint8_t *)eth + off))->udpchksum == 0)
+    {
+      return true;
+    }
+
+  sum = virtio_net_csum_add(sum, l4len);
+  sum = chksum_iob(sum, pkt, off - NET_LL_HDRLEN(&dev->netdev));
+  return sum == 0 || sum == 0xffff;
 }
 
 /****************************************************************************
@@ -355,6 +713,7 @@ static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev)
 static int virtio_net_ifup(FAR struct netdev_lowerhalf_s *dev)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
+  int i;
 
 #ifdef CONFIG_NET_IPv4
   vrtinfo("Bringing up: %u.%u.%u.%u\n",
@@ -371,8 +730,11 @@ static int virtio_net_ifup(FAR struct netdev_lowerhalf_s *dev)
 
   /* Prepare interrupt and packets for receiving */
 
-  virtqueue_enable_cb_lock(priv->vdev->vrings_info[VIRTIO_NET_RX].vq,
-                           &priv->lock[VIRTIO_NET_RX]);
+  for (i = 0; i < priv->npairs; i++)
+    {
+      virtqueue_enable_cb_lock(priv->rxq[i].vq, &priv->rxq[i].lock);
+    }
+
   virtio_net_rxfill(dev);
 
 #ifdef CONFIG_DRIVERS_WIFI_SIM
@@ -396,10 +758,10 @@ static int virtio_net_ifdown(FAR struct netdev_lowerhalf_s *dev)
 
   /* Disable the Ethernet interrupt */
 
-  for (i = 0; i < VIRTIO_NET_NUM; i++)
+  for (i = 0; i < priv->npairs; i++)
     {
-      virtqueue_disable_cb_lock(priv->vdev->vrings_info[i].vq,
-                                &priv->lock[i]);
+      virtqueue_disable_cb_lock(priv->rxq[i].vq, &priv->rxq[i].lock);
+      virtqueue_disable_cb_lock(priv->txq[i].vq, &priv->txq[i].lock);
     }
 
 #ifdef CONFIG_DRIVERS_WIFI_SIM
@@ -423,20 +785,62 @@ static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
                            FAR netpkt_t *pkt)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_TX].vq;
+  FAR struct virtio_net_txq_s *txq = &priv->txq[this_cpu() % priv->npairs];
+  FAR struct virtio_net_hdr_s *hdr;
+  irqstate_t flags;
+  int iov_cnt;
+  int ret;
+  int i;
 
   /* Check the send length */
 
-  if (netpkt_getdatalen(dev, pkt) > VIRTIO_NET_BUFSIZE)
+  if (netpkt_getdatalen(dev, pkt) > VIRTIO_NET_TX_MAXSIZE)
     {
       vrterr("net send buffer too large\n");
       return -EINVAL;
     }
 
-  /* Add buffer to vq and notify the other side */
+  /* Prepare the virtio net header and the offload information */
+
+  hdr = (FAR struct virtio_net_hdr_s *)
+        (netpkt_getdata(dev, pkt) - priv->hdrsize);
+  memset(hdr, 0, priv->hdrsize);
+
+  ret = virtio_net_txoffload(dev, pkt, hdr);
+  if (ret < 0)
+    {
+      vrterr("net send offload failed, ret=%d\n", ret);
+      return ret;
+    }
+
+  /* Add buffer to vq and notify the other side, reclaim the sent buffers
+   * first if a super-segment does not fit in the free descriptors.
+   */
+
+  for (i = 0; ; i++)
+    {
+      flags = spin_lock_irqsave(&txq->lock);
+      iov_cnt = virtio_net_fillbuf(dev, pkt, txq->vb, nitems(txq->vb));
+      if (iov_cnt >= 0 && txq->vq->vq_free_cnt >= iov_cnt)
+        {
+          break;
+        }
+
+      spin_unlock_irqrestore(&txq->lock, flags);
+      if (iov_cnt < 0 || i > 0)
+        {
+          vrterr("No enough TX descriptors, count=%d\n", iov_cnt);
+          return -ENOBUFS;
+        }
+
+      virtio_net_txfree(dev);
+    }
 
-  virtio_net_addbuffer(dev, vq, pkt, VIRTIO_NET_TX);
-  virtqueue_kick_lock(vq, &priv->lock[VIRTIO_NET_TX]);
+  vrtinfo("Send, txq=%d, pkt=%p, count=%d\n",
+          (int)(txq - priv->txq), pkt, iov_cnt);
+  virtqueue_add_buffer(txq->vq, txq->vb, iov_cnt, 0, pkt);
+  virtqueue_kick(txq->vq);
+  spin_unlock_irqrestore(&txq->lock, flags);
 
   /* Try return Netpkt TX buffer to upper-half. */
 
@@ -446,7 +850,48 @@ static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
 
   if (netdev_lower_quota_load(dev, NETPKT_TX) <= 0)
     {
-      virtqueue_enable_cb_lock(vq, &priv->lock[VIRTIO_NET_TX]);
+      for (i = 0; i < priv->npairs; i++)
+        {
+          virtqueue_enable_cb_lock(priv->txq[i].vq, &priv->txq[i].lock);
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: virtio_net_rxmerge
+ *
+ * Description:
+ *   Collect the rest of the buffers of a frame received with
+ *   VIRTIO_NET_F_MRG_RXBUF.  Each of those buffers is a single IOB whose
+ *   payload starts where the virtio net header would be.
+ *
+ ****************************************************************************/
+
+static int virtio_net_rxmerge(FAR struct netdev_lowerhalf_s *dev,
+                              FAR struct virtio_net_rxq_s *rxq,
+                              FAR netpkt_t *pkt, uint16_t nbufs)
+{
+  FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
+  FAR netpkt_t *next;
+  uint32_t len;
+
+  while (--nbufs > 0)
+    {
+      next = virtqueue_get_buffer_lock(rxq->vq, &len, NULL, &rxq->lock);
+      if (next == NULL)
+        {
+          return -EIO;
+        }
+
+      DEBUGASSERT(next->io_flink == NULL);
+      DEBUGASSERT(len <= priv->rxbufsize + priv->hdrsize);
+
+      next->io_offset -= NET_LL_HDRLEN(&dev->netdev) + priv->hdrsize;
+      next->io_len     = len;
+      next->io_pktlen  = len;
+      netpkt_concat(dev, pkt, next, NETPKT_RX);
     }
 
   return OK;
@@ -459,39 +904,70 @@ static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
 static netpkt_t *virtio_net_recv(FAR struct netdev_lowerhalf_s *dev)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_RX].vq;
-  FAR struct virtio_net_llhdr_s *hdr;
+  FAR struct virtio_net_hdr_s *hdr;
+  FAR struct virtio_net_rxq_s *rxq;
   irqstate_t flags;
+  FAR netpkt_t *pkt;
+  uint16_t nbufs;
   uint32_t len;
+  int i;
 
   /* Fill the free Netpkt RX buffer to the RX virtqueue */
 
   virtio_net_rxfill(dev);
 
-  /* Get received buffer form RX virtqueue */
+  /* Get received buffer form RX virtqueue, start from the queue of the
+   * current CPU.  The upper half calls receive() with the device locked,
+   * so the RSS threads take turns and whichever runs drains all queues.
+   */
 
-  flags = spin_lock_irqsave(&priv->lock[VIRTIO_NET_RX]);
-  hdr = virtqueue_get_buffer(vq, &len, NULL);
-  if (hdr == NULL)
+  for (i = 0; i < priv->npairs; )
     {
-      /* If we have no buffer left, enable RX callback. */
+      rxq = &priv->rxq[(this_cpu() + i) % priv->npairs];
 
-      virtqueue_enable_cb(vq);
-      spin_unlock_irqrestore(&priv->lock[VIRTIO_NET_RX], flags);
+      flags = spin_lock_irqsave(&rxq->lock);
+      pkt = virtqueue_get_buffer(rxq->vq, &len, NULL);
+      if (pkt == NULL)
+        {
+          /* If we have no buffer left, enable RX callback. */
 
-      vrtinfo("get NULL buffer\n");
-      return NULL;
-    }
-  else
-    {
-      spin_unlock_irqrestore(&priv->lock[VIRTIO_NET_RX], flags);
-    }
+          virtqueue_enable_cb(rxq->vq);
+          spin_unlock_irqrestore(&rxq->lock, flags);
+          i++;
+          continue;
+        }
+
+      spin_unlock_irqrestore(&rxq->lock, flags);
+
+      /* Set the received pkt length */
+
+      hdr = (FAR struct virtio_net_hdr_s *)
+            (netpkt_getdata(dev, pkt) - priv->hdrsize);
+      nbufs = virtio_has_feature(priv->vdev, VIRTIO_NET_F_MRG_RXBUF) ?
+              hdr->num_buffers : 1;
+
+      netpkt_setdatalen(dev, pkt, len - priv->hdrsize);
+      if (nbufs > 1 && virtio_net_rxmerge(dev, rxq, pkt, nbufs) < 0)
+        {
+          vrterr("Recv merge failed, nbufs=%u\n", nbufs);
+          netpkt_free(dev, pkt, NETPKT_RX);
+          continue;
+        }
+
+      if (virtio_has_feature(priv->vdev, VIRTIO_NET_F_GUEST_CSUM) &&
+          !virtio_net_rxcsum(dev, pkt, hdr->flags))
+        {
+          vrtwarn("Recv bad checksum, pkt=%p\n", pkt);
+          netpkt_free(dev, pkt, NETPKT_RX);
+          continue;
+        }
 
-  /* Set the received pkt length */
+      vrtinfo("Recv, pkt=%p, len=%" PRIu32 ", nbufs=%u\n", pkt, len, nbufs);
+      return pkt;
+    }
 
-  netpkt_setdatalen(dev, hdr->pkt, len - VIRTIO_NET_HDRSIZE);
-  vrtinfo("Recv, hdr=%p, pkt=%p, len=%" PRIu32 "\n", hdr, hdr->pkt, len);
-  return hdr->pkt;
+  vrtinfo("get NULL buffer\n");
+  return NULL;
 }
 
 #ifdef CONFIG_NET_MCASTGROUP
@@ -536,7 +1012,8 @@ static void virtio_net_rxready(FAR struct virtqueue *vq)
 {
   FAR struct virtio_net_priv_s *priv = vq->vq_dev->priv;
 
-  virtqueue_disable_cb_lock(vq, &priv->lock[VIRTIO_NET_RX]);
+  virtqueue_disable_cb_lock(vq,
+                            &priv->rxq[vq->vq_queue_index / 2].lock);
   netdev_lower_rxready((FAR struct netdev_lowerhalf_s *)priv);
 }
 
@@ -548,10 +1025,124 @@ static void virtio_net_txdone(FAR struct virtqueue *vq)
 {
   FAR struct virtio_net_priv_s *priv = vq->vq_dev->priv;
 
-  virtqueue_disable_cb_lock(vq, &priv->lock[VIRTIO_NET_TX]);
+  virtqueue_disable_cb_lock(vq,
+                            &priv->txq[vq->vq_queue_index / 2].lock);
   netdev_lower_txdone((FAR struct netdev_lowerhalf_s *)priv);
 }
 
+/****************************************************************************
+ * Name: virtio_net_set_pairs
+ *
+ * Description:
+ *   Tell the device how many queue pairs are used through the control
+ *   virtqueue.
+ *
+ ****************************************************************************/
+
+#if VIRTIO_NET_MAX_PAIRS > 1
+static int virtio_net_set_pairs(FAR struct virtio_net_priv_s *priv,
+                                FAR struct virtqueue *vq, uint16_t pairs)
+{
+  FAR struct virtio_net_ctrl_s *ctrl;
+  struct virtqueue_buf vb[3];
+  int ret = -ETIMEDOUT;
+  int i;
+
+  ctrl = virtio_zalloc_buf(priv->vdev, sizeof(*ctrl), 16);
+  if (ctrl == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ctrl->class = VIRTIO_NET_CTRL_MQ;
+  ctrl->cmd   = VIRTIO_NET_CTRL_MQ_VQ_PAIRS_SET;
+  ctrl->pairs = pairs;
+  ctrl->ack   = VIRTIO_NET_ERR;
+
+  vb[0].buf = ctrl;
+  vb[0].len = offsetof(struct virtio_net_ctrl_s, pairs);
+  vb[1].buf = &ctrl->pairs;
+  vb[1].len = sizeof(ctrl->pairs);
+  vb[2].buf = &ctrl->ack;
+  vb[2].len = sizeof(ctrl->ack);
+
+  virtqueue_add_buffer(vq, vb, 2, 1, ctrl);
+  virtqueue_kick(vq);
+
+  /* The device handles control commands synchronously, poll for it */
+
+  for (i = 0; i < VIRTIO_NET_CTRL_TIMEOUT / 10; i++)
+    {
+      if (virtqueue_get_buffer(vq, NULL, NULL) != NULL)
+        {
+          ret = ctrl->ack == VIRTIO_NET_OK ? OK : -EIO;
+          break;
+        }
+
+      up_udelay(10);
+    }
+
+  if (ret != -ETIMEDOUT)
+    {
+      virtio_free_buf(priv->vdev, ctrl);
+    }
+
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: virtio_net_bufnum
+ *
+ * Description:
+ *   Calculate the TX and RX buffer number from the IOB budget and the
+ *   descriptors of the virtqueues.
+ *
+ ****************************************************************************/
+
+static void virtio_net_bufnum(FAR struct virtio_net_priv_s *priv)
+{
+  FAR struct virtio_device *vdev = priv->vdev;
+  int rxdescs = 0;
+  int txdescs = 0;
+  int bufnum;
+  int ndesc;
+  int i;
+
+#if CONFIG_DRIVERS_VIRTIO_NET_BUFNUM > 0
+  bufnum = CONFIG_DRIVERS_VIRTIO_NET_BUFNUM;
+#else
+  /* Calculate the virtio network buffer number:
+   * 1/4 for the TX netpkts, 1/4 for the RX netpkts.
+   */
+
+  bufnum = CONFIG_IOB_NBUFFERS / VIRTIO_NET_MAX_NIOB / 4;
+#endif
+
+  for (i = 0; i < priv->npairs; i++)
+    {
+      rxdescs += vdev->vrings_info[2 * i + VIRTIO_NET_RX].info.num_descs;
+      txdescs += vdev->vrings_info[2 * i + VIRTIO_NET_TX].info.num_descs;
+    }
+
+  /* Mergeable RX buffers are single IOBs, so the same IOB budget gives
+   * VIRTIO_NET_MAX_NIOB times more of them.
+   */
+
+  ndesc = virtio_has_feature(vdev, VIRTIO_F_ANY_LAYOUT) ? 0 : 1;
+  if (virtio_has_feature(vdev, VIRTIO_NET_F_MRG_RXBUF))
+    {
+      priv->rxnum = MIN(rxdescs / (ndesc + 1),
+                        bufnum * VIRTIO_NET_MAX_NIOB);
+    }
+  else
+    {
+      priv->rxnum = MIN(rxdescs / (VIRTIO_NET_MAX_NIOB + ndesc), bufnum);
+    }
+
+  priv->txnum = MIN(txdescs / (VIRTIO_NET_MAX_NIOB + ndesc), bufnum);
+}
+
 /****************************************************************************
  * Name: virtio_net_init
  ****************************************************************************/
@@ -559,28 +1150,87 @@ static void virtio_net_txdone(FAR struct virtqueue *vq)
 static int virtio_net_init(FAR struct virtio_net_priv_s *priv,
                            FAR struct virtio_device *vdev)
 {
-  FAR const char *vqnames[VIRTIO_NET_NUM];
-  vq_callback callbacks[VIRTIO_NET_NUM];
+  FAR const char **vqnames;
+  FAR vq_callback *callbacks;
+  uint16_t maxpairs = 1;
+  uint64_t features;
+  int nvqs;
   int ret;
+  int i;
 
-  spin_lock_init(&priv->lock[VIRTIO_NET_RX]);
-  spin_lock_init(&priv->lock[VIRTIO_NET_TX]);
   priv->vdev = vdev;
   vdev->priv = priv;
 
   /* Initialize the virtio device */
 
+  features = (1UL << VIRTIO_NET_F_MAC) |
+             (1UL << VIRTIO_F_ANY_LAYOUT) |
+             (1UL << VIRTIO_NET_F_CSUM) |
+             (1UL << VIRTIO_NET_F_GUEST_CSUM) |
+             (1UL << VIRTIO_NET_F_MRG_RXBUF);
+#if CONFIG_DRIVERS_VIRTIO_NET_TSO_MAXSIZE > 0
+  features |= (1UL << VIRTIO_NET_F_HOST_TSO4) |
+              (1UL << VIRTIO_NET_F_HOST_TSO6);
+#endif
+#if VIRTIO_NET_MAX_PAIRS > 1
+  features |= (1UL << VIRTIO_NET_F_CTRL_VQ) |
+              (1UL << VIRTIO_NET_F_MQ);
+#endif
+
   virtio_set_status(vdev, VIRTIO_CONFIG_STATUS_DRIVER);
-  virtio_negotiate_features(vdev, (1UL << VIRTIO_NET_F_MAC) |
-                                  (1UL << VIRTIO_F_ANY_LAYOUT), NULL);
+  virtio_negotiate_features(vdev, features, NULL);
   virtio_set_status(vdev, VIRTIO_CONFIG_FEATURES_OK);
 
-  vqnames[VIRTIO_NET_RX]   = "virtio_net_rx";
-  vqnames[VIRTIO_NET_TX]   = "virtio_net_tx";
-  callbacks[VIRTIO_NET_RX] = virtio_net_rxready;
-  callbacks[VIRTIO_NET_TX] = virtio_net_txdone;
-  ret = virtio_create_virtqueues(vdev, 0, VIRTIO_NET_NUM, vqnames,
-                                 callbacks, NULL);
+  if (virtio_has_feature(vdev, VIRTIO_NET_F_MRG_RXBUF))
+    {
+      priv->hdrsize   = VIRTIO_NET_HDRSIZE;
+      priv->rxbufsize = VIRTIO_NET_MRG_BUFSIZE;
+    }
+  else
+    {
+      priv->hdrsize   = VIRTIO_NET_HDRSIZE_NOMRG;
+      priv->rxbufsize = VIRTIO_NET_BUFSIZE;
+    }
+
+  /* The control virtqueue is after all the queue pairs of the device, so
+   * all of them have to be created even if only some are used.
+   */
+
+  if (virtio_has_feature(vdev, VIRTIO_NET_F_MQ))
+    {
+      virtio_read_config_member(vdev, struct virtio_net_config_s,
+                                max_virtqueue_pairs, &maxpairs);
+      maxpairs = MAX(maxpairs, 1);
+      nvqs = 2 * maxpairs + 1;
+    }
+  else
+    {
+      nvqs = VIRTIO_NET_NUM;
+    }
+
+  vqnames = kmm_malloc(nvqs * (sizeof(*vqnames) + sizeof(*callbacks)));
+  if (vqnames == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  callbacks = (FAR vq_callback *)&vqnames[nvqs];
+  for (i = 0; i < 2 * maxpairs; i += VIRTIO_NET_NUM)
+    {
+      vqnames[i + VIRTIO_NET_RX]   = "virtio_net_rx";
+      vqnames[i + VIRTIO_NET_TX]   = "virtio_net_tx";
+      callbacks[i + VIRTIO_NET_RX] = virtio_net_rxready;
+      callbacks[i + VIRTIO_NET_TX] = virtio_net_txdone;
+    }
+
+  if (i < nvqs)
+    {
+      vqnames[i]   = "virtio_net_ctrl";
+      callbacks[i] = NULL;
+    }
+
+  ret = virtio_create_virtqueues(vdev, 0, nvqs, vqnames, callbacks, NULL);
+  kmm_free(vqnames);
   if (ret < 0)
     {
       vrterr("virtio_device_create_virtqueue failed, ret=%d\n", ret);
@@ -589,19 +1239,34 @@ static int virtio_net_init(FAR struct virtio_net_priv_s *priv,
 
   virtio_set_status(vdev, VIRTIO_CONFIG_STATUS_DRIVER_OK);
 
-#if CONFIG_DRIVERS_VIRTIO_NET_BUFNUM > 0
-  priv->bufnum = CONFIG_DRIVERS_VIRTIO_NET_BUFNUM;
-#else
-  /* Calculate the virtio network buffer number:
-   * 1/4 for the TX netpkts, 1/4 for the RX netpkts.
-   */
+  priv->npairs = 1;
+#if VIRTIO_NET_MAX_PAIRS > 1
+  if (maxpairs > 1)
+    {
+      uint16_t pairs = MIN(maxpairs, VIRTIO_NET_MAX_PAIRS);
 
-  priv->bufnum = CONFIG_IOB_NBUFFERS / VIRTIO_NET_MAX_NIOB / 4;
+      ret = virtio_net_set_pairs(priv, vdev->vrings_info[nvqs - 1].vq,
+                                 pairs);
+      if (ret < 0)
+        {
+          vrtwarn("Set %u queue pairs failed, ret=%d\n", pairs, ret);
+        }
+      else
+        {
+          priv->npairs = pairs;
+        }
+    }
 #endif
-  priv->bufnum = MIN(vdev->vrings_info[VIRTIO_NET_RX].info.num_descs /
-                     (VIRTIO_NET_MAX_NIOB + 1), priv->bufnum);
-  priv->bufnum = MIN(vdev->vrings_info[VIRTIO_NET_TX].info.num_descs /
-                     (VIRTIO_NET_MAX_NIOB + 1), priv->bufnum);
+
+  for (i = 0; i < priv->npairs; i++)
+    {
+      spin_lock_init(&priv->rxq[i].lock);
+      spin_lock_init(&priv->txq[i].lock);
+      priv->rxq[i].vq = vdev->vrings_info[2 * i + VIRTIO_NET_RX].vq;
+      priv->txq[i].vq = vdev->vrings_info[2 * i + VIRTIO_NET_TX].vq;
+    }
+
+  virtio_net_bufnum(priv);
   return OK;
 }
 
@@ -658,10 +1323,53 @@ static int virtio_net_probe(FAR struct virtio_device *vdev)
   /* Initialize the netdev lower half */
 
   netdev = (FAR struct netdev_lowerhalf_s *)priv;
-  netdev->quota[NETPKT_RX] = priv->bufnum;
-  netdev->quota[NETPKT_TX] = priv->bufnum;
+  netdev->quota[NETPKT_RX] = priv->rxnum;
+  netdev->quota[NETPKT_TX] = priv->txnum;
   netdev->ops = &g_virtio_net_ops;
 
+  /* Let the stack skip the checksums the device takes care of */
+
+  if (virtio_has_feature(vdev, VIRTIO_NET_F_CSUM))
+    {
+      netdev->netdev.d_features |= NETDEV_TX_CSUM;
+    }
+
+  if (virtio_has_feature(vdev, VIRTIO_NET_F_GUEST_CSUM))
+    {
+      netdev->netdev.d_features |= NETDEV_RX_CSUM;
+    }
+
+  if (virtio_has_feature(vdev, VIRTIO_NET_F_HOST_TSO4))
+    {
+      netdev->netdev.d_features |= NETDEV_TX_TSO4;
+    }
+
+  if (virtio_has_feature(vdev, VIRTIO_NET_F_HOST_TSO6))
+    {
+      netdev->netdev.d_features |= NETDEV_TX_TSO6;
+    }
+
+#ifdef CONFIG_NET_TCP_GSO
+  /* TCP builds super-segments no larger than the device takes */
+
+  netdev->netdev.d_tso_maxsize = MIN(VIRTIO_NET_TX_MAXSIZE - ETH_HDRLEN,
+                                     UINT16_MAX);
+#endif
+
+#if defined(CONFIG_SMP) && VIRTIO_NET_MAX_PAIRS > 1
+  /* Start receiving on the CPU the queue interrupt arrives on.  The input
+   * itself is still serialized by the device lock (dev->d_buf and d_iob
+   * are per device), so this spreads the interrupts and the wakeups, not
+   * the protocol processing.
+   */
+
+  if (priv->npairs > 1)
+    {
+      netdev->rxtype   = NETDEV_RX_THREAD_RSS;
+      netdev->priority = CONFIG_DRIVERS_VIRTIO_NET_RSS_PRIORITY;
+    }
+#endif
+
 #ifdef CONFIG_DRIVERS_WIFI_SIM
   /* If the WiFi interfaces has reached the setting value,
    * no more WiFi interfaces will be created.
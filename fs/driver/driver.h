@@ -29,6 +29,10 @@
 
 #include <nuttx/config.h>
 #include <nuttx/compiler.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
 #include <nuttx/fs/fs.h>
 
 #include "inode/inode.h"
@@ -46,6 +50,30 @@ extern "C"
 #define EXTERN extern
 #endif
 
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_BLOCKCACHE
+/* Statistics of one block cache, see blockcache_foreach() */
+
+struct blockcache_info_s
+{
+  FAR const char *name;   /* Name of the block driver */
+  blksize_t sectorsize;   /* Sector size, 0 if the cache is not set up */
+  size_t nblocks;         /* Number of sectors the cache can hold */
+  size_t ndirty;          /* Number of sectors not yet written back */
+  uint32_t hits;          /* Sectors read from the cache */
+  uint32_t misses;        /* Sectors read from the device */
+  uint32_t readahead;     /* Sectors read ahead */
+  uint32_t wbwrites;      /* Write-back transfers */
+  uint32_t wbsectors;     /* Sectors written back */
+};
+
+typedef CODE void (*blockcache_handler_t)
+  (FAR const struct blockcache_info_s *info, FAR void *arg);
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -157,6 +185,80 @@ int mtd_proxy(FAR const char *mtddev, int mountflags,
               FAR struct inode **ppinode);
 #endif
 
+/****************************************************************************
+ * Name: block_partition_parent
+ *
+ * Description:
+ *   Return the parent block driver of 'inode' if it is a partition
+ *   registered by register_partition_with_inode(), NULL otherwise.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_MOUNTPOINT
+FAR struct inode *block_partition_parent(FAR struct inode *inode);
+#endif
+
+/****************************************************************************
+ * Name: blockcache_install
+ *
+ * Description:
+ *   Put the shared block cache in front of the block driver 'inode'.  The
+ *   driver keeps working uncached if this fails.
+ *
+ * Input Parameters:
+ *   inode - The block driver inode
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success or when the driver does not need a
+ *   cache.  On failure, a negated errno value is returned.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_BLOCKCACHE
+int blockcache_install(FAR struct inode *inode);
+#endif
+
+/****************************************************************************
+ * Name: blockcache_flush
+ *
+ * Description:
+ *   Write the dirty sectors cached for the block driver 'inode' back to
+ *   the device.  Nothing is done if the driver is not cached.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  On failure, a negated errno value is
+ *   returned.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_BLOCKCACHE
+int blockcache_flush(FAR struct inode *inode);
+#endif
+
+/****************************************************************************
+ * Name: blockcache_free
+ *
+ * Description:
+ *   Release the cache of a block driver inode that is being freed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_BLOCKCACHE
+void blockcache_free(FAR struct inode *inode);
+#endif
+
+/****************************************************************************
+ * Name: blockcache_foreach
+ *
+ * Description:
+ *   Call 'handler' with the statistics of every installed block cache.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_BLOCKCACHE
+void blockcache_foreach(blockcache_handler_t handler, FAR void *arg);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -0,0 +1,1169 @@
+/****************************************************************************
+ * fs/driver/fs_blockcache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <sys/types.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <nuttx/debug.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
+#include <nuttx/list.h>
+#include <nuttx/mutex.h>
+#include <nuttx/nuttx.h>
+
+#include "inode/inode.h"
+#include "driver/driver.h"
+#include "fs_heap.h"
+
+#ifdef CONFIG_FS_BLOCKCACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define BLOCKCACHE_NBLOCKS    CONFIG_FS_BLOCKCACHE_NBLOCKS
+#define BLOCKCACHE_MAXIO      CONFIG_FS_BLOCKCACHE_MAXIO
+#define BLOCKCACHE_READAHEAD  MIN(CONFIG_FS_BLOCKCACHE_READAHEAD, \
+                                  CONFIG_FS_BLOCKCACHE_MAXIO)
+
+/* Transfers larger than this go straight to the device and are not kept
+ * in the cache, so that one big sequential transfer does not evict all of
+ * the hot metadata blocks.
+ */
+
+#define BLOCKCACHE_BYPASS     MAX(BLOCKCACHE_NBLOCKS / 2, 1)
+
+#define BLOCKCACHE_HASH(s)    ((unsigned int)((s) % BLOCKCACHE_NBLOCKS))
+
+/* Cache entry flags */
+
+#define BLOCKCACHE_VALID      (1 << 0) /* Entry holds a sector */
+#define BLOCKCACHE_DIRTY      (1 << 1) /* Sector not yet written back */
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One cached sector */
+
+struct blockcache_entry_s
+{
+  struct list_node lru;                 /* Entry in the LRU list */
+  FAR struct blockcache_entry_s *flink; /* Next entry in the hash chain */
+  FAR uint8_t *buffer;                  /* Sector data */
+  blkcnt_t sector;                      /* Sector held by the entry */
+  uint8_t flags;                        /* See BLOCKCACHE_* flags */
+};
+
+/* The cache of one block driver.  It replaces the block operations of the
+ * driver inode and calls the original operations with the same inode, so
+ * the i_private data of the driver is left untouched.
+ */
+
+struct blockcache_s
+{
+  struct block_operations bops;         /* Operations installed in inode */
+  FAR const struct block_operations *lower; /* Operations of the driver */
+  FAR struct inode *inode;              /* The block driver inode */
+  FAR struct inode *parent;             /* Parent device of a partition */
+  struct list_node node;                /* Entry in g_blockcache_list */
+  mutex_t lock;                         /* Serializes access to the cache */
+  struct list_node lru;                 /* Most recently used first */
+  FAR struct blockcache_entry_s *hash[BLOCKCACHE_NBLOCKS];
+  FAR struct blockcache_entry_s *entries; /* BLOCKCACHE_NBLOCKS entries */
+  FAR uint8_t *iobuf;                   /* Write-back staging */
+  FAR uint8_t *rabuf;                   /* Read-ahead staging */
+  blksize_t sectorsize;                 /* Sector size, 0 if not set up */
+  blkcnt_t nsectors;                    /* Number of sectors on the device */
+  blkcnt_t nextsector;                  /* Next sector of a sequential read */
+  size_t ndirty;                        /* Number of dirty entries */
+
+  /* Statistics */
+
+  uint32_t hits;                        /* Sectors read from the cache */
+  uint32_t misses;                      /* Sectors read from the device */
+  uint32_t readahead;                   /* Sectors read ahead */
+  uint32_t wbwrites;                    /* Write-back transfers */
+  uint32_t wbsectors;                   /* Sectors written back */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int     blockcache_open(FAR struct inode *inode);
+static int     blockcache_close(FAR struct inode *inode);
+static ssize_t blockcache_read(FAR struct inode *inode,
+                               FAR unsigned char *buffer,
+                               blkcnt_t start_sector,
+                               unsigned int nsectors);
+static ssize_t blockcache_write(FAR struct inode *inode,
+                                FAR const unsigned char *buffer,
+                                blkcnt_t start_sector,
+                                unsigned int nsectors);
+static int     blockcache_geometry(FAR struct inode *inode,
+                                   FAR struct geometry *geometry);
+static int     blockcache_ioctl(FAR struct inode *inode, int cmd,
+                                unsigned long arg);
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+static int     blockcache_unlink(FAR struct inode *inode);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* All installed caches, protected by g_blockcache_lock */
+
+static struct list_node g_blockcache_list =
+  LIST_INITIAL_VALUE(g_blockcache_list);
+static mutex_t g_blockcache_lock = NXMUTEX_INITIALIZER;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: blockcache_from
+ ****************************************************************************/
+
+static inline FAR struct blockcache_s *
+blockcache_from(FAR struct inode *inode)
+{
+  return container_of(inode->u.i_bops, struct blockcache_s, bops);
+}
+
+/****************************************************************************
+ * Name: blockcache_lookup
+ *
+ * Description:
+ *   Return the entry holding 'sector' or NULL if it is not cached.
+ *
+ ****************************************************************************/
+
+static FAR struct blockcache_entry_s *
+blockcache_lookup(FAR struct blockcache_s *cache, blkcnt_t sector)
+{
+  FAR struct blockcache_entry_s *entry;
+
+  for (entry = cache->hash[BLOCKCACHE_HASH(sector)];
+       entry != NULL; entry = entry->flink)
+    {
+      if (entry->sector == sector)
+        {
+          return entry;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: blockcache_touch
+ *
+ * Description:
+ *   Mark the entry as the most recently used one.
+ *
+ ****************************************************************************/
+
+static inline void blockcache_touch(FAR struct blockcache_s *cache,
+                                    FAR struct blockcache_entry_s *entry)
+{
+  list_delete(&entry->lru);
+  list_add_head(&cache->lru, &entry->lru);
+}
+
+/****************************************************************************
+ * Name: blockcache_drop
+ *
+ * Description:
+ *   Forget the content of an entry without writing it back and make it the
+ *   first candidate for reuse.
+ *
+ ****************************************************************************/
+
+static void blockcache_drop(FAR struct blockcache_s *cache,
+                            FAR struct blockcache_entry_s *entry)
+{
+  FAR struct blockcache_entry_s **pprev;
+
+  if ((entry->flags & BLOCKCACHE_VALID) == 0)
+    {
+      return;
+    }
+
+  for (pprev = &cache->hash[BLOCKCACHE_HASH(entry->sector)];
+       *pprev != entry; pprev = &(*pprev)->flink)
+    {
+      DEBUGASSERT(*pprev != NULL);
+    }
+
+  *pprev = entry->flink;
+  entry->flink = NULL;
+
+  if ((entry->flags & BLOCKCACHE_DIRTY) != 0)
+    {
+      cache->ndirty--;
+    }
+
+  entry->flags = 0;
+  list_delete(&entry->lru);
+  list_add_tail(&cache->lru, &entry->lru);
+}
+
+/****************************************************************************
+ * Name: blockcache_invalidate
+ *
+ * Description:
+ *   Drop all cached sectors in [start, start + nsectors), dirty or not.
+ *
+ ****************************************************************************/
+
+static void blockcache_invalidate(FAR struct blockcache_s *cache,
+                                  blkcnt_t start, blkcnt_t nsectors)
+{
+  int i;
+
+  if (cache->entries == NULL)
+    {
+      return;
+    }
+
+  for (i = 0; i < BLOCKCACHE_NBLOCKS; i++)
+    {
+      FAR struct blockcache_entry_s *entry = &cache->entries[i];
+
+      if ((entry->flags & BLOCKCACHE_VALID) != 0 &&
+          entry->sector >= start && entry->sector - start < nsectors)
+        {
+          blockcache_drop(cache, entry);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: blockcache_writeback
+ *
+ * Description:
+ *   Write a dirty entry back to the device.  The dirty neighbours of the
+ *   entry are gathered into the same transfer, up to
+ *   CONFIG_FS_BLOCKCACHE_MAXIO sectors, so that a burst of small writes
+ *   reaches the device as a few large ones.
+ *
+ ****************************************************************************/
+
+static int blockcache_writeback(FAR struct blockcache_s *cache,
+                                FAR struct blockcache_entry_s *entry)
+{
+  FAR struct blockcache_entry_s *run[BLOCKCACHE_MAXIO];
+  FAR struct blockcache_entry_s *next;
+  FAR const uint8_t *buffer;
+  blkcnt_t first = entry->sector;
+  unsigned int count = 1;
+  ssize_t ret;
+  int i;
+
+  DEBUGASSERT((entry->flags & BLOCKCACHE_DIRTY) != 0);
+
+  /* Extend the run backwards ... */
+
+  while (count < BLOCKCACHE_MAXIO && first > 0)
+    {
+      next = blockcache_lookup(cache, first - 1);
+      if (next == NULL || (next->flags & BLOCKCACHE_DIRTY) == 0)
+        {
+          break;
+        }
+
+      first--;
+      count++;
+    }
+
+  /* ... then collect it front to back, including the sectors following
+   * the entry.
+   */
+
+  for (count = 0; count < BLOCKCACHE_MAXIO; count++)
+    {
+      next = blockcache_lookup(cache, first + count);
+      if (next == NULL || (next->flags & BLOCKCACHE_DIRTY) == 0)
+        {
+          break;
+        }
+
+      run[count] = next;
+    }
+
+  DEBUGASSERT(count > 0 && entry->sector - first < count);
+
+  if (count == 1)
+    {
+      buffer = entry->buffer;
+    }
+  else
+    {
+      for (i = 0; i < count; i++)
+        {
+          memcpy(cache->iobuf + i * cache->sectorsize, run[i]->buffer,
+                 cache->sectorsize);
+        }
+
+      buffer = cache->iobuf;
+    }
+
+  ret = cache->lower->write(cache->inode, buffer, first, count);
+  if (ret < 0)
+    {
+      ferr("ERROR: write back of %u sectors at %" PRIuOFF " failed: %zd\n",
+           count, (off_t)first, ret);
+      return (int)ret;
+    }
+
+  /* A short write only cleans the leading sectors of the run */
+
+  for (i = 0; i < ret; i++)
+    {
+      run[i]->flags &= ~BLOCKCACHE_DIRTY;
+      cache->ndirty--;
+    }
+
+  cache->wbwrites++;
+  cache->wbsectors += ret;
+
+  return (entry->flags & BLOCKCACHE_DIRTY) != 0 ? -EIO : OK;
+}
+
+/****************************************************************************
+ * Name: blockcache_flushall
+ ****************************************************************************/
+
+static int blockcache_flushall(FAR struct blockcache_s *cache)
+{
+  int ret;
+  int i;
+
+  for (i = 0; cache->ndirty > 0 && i < BLOCKCACHE_NBLOCKS; i++)
+    {
+      if ((cache->entries[i].flags & BLOCKCACHE_DIRTY) != 0)
+        {
+          ret = blockcache_writeback(cache, &cache->entries[i]);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: blockcache_alloc
+ *
+ * Description:
+ *   Take the least recently used entry, writing it back first if it is
+ *   dirty, and assign it to 'sector'.
+ *
+ ****************************************************************************/
+
+static int blockcache_alloc(FAR struct blockcache_s *cache, blkcnt_t sector,
+                            FAR struct blockcache_entry_s **pentry)
+{
+  FAR struct blockcache_entry_s *entry;
+  int ret;
+
+  DEBUGASSERT(blockcache_lookup(cache, sector) == NULL);
+
+  entry = list_last_entry(&cache->lru, struct blockcache_entry_s, lru);
+  if ((entry->flags & BLOCKCACHE_DIRTY) != 0)
+    {
+      ret = blockcache_writeback(cache, entry);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  blockcache_drop(cache, entry);
+
+  entry->sector = sector;
+  entry->flags  = BLOCKCACHE_VALID;
+  entry->flink  = cache->hash[BLOCKCACHE_HASH(sector)];
+  cache->hash[BLOCKCACHE_HASH(sector)] = entry;
+  blockcache_touch(cache, entry);
+
+  *pentry = entry;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: blockcache_insert
+ *
+ * Description:
+ *   Copy sectors just transferred from the device into the cache.
+ *
+ ****************************************************************************/
+
+static void blockcache_insert(FAR struct blockcache_s *cache,
+                              FAR const uint8_t *buffer, blkcnt_t sector,
+                              unsigned int nsectors)
+{
+  FAR struct blockcache_entry_s *entry;
+
+  while (nsectors-- > 0)
+    {
+      if (blockcache_alloc(cache, sector, &entry) < 0)
+        {
+          return;
+        }
+
+      memcpy(entry->buffer, buffer, cache->sectorsize);
+      buffer += cache->sectorsize;
+      sector++;
+    }
+}
+
+/****************************************************************************
+ * Name: blockcache_release
+ *
+ * Description:
+ *   Free the buffers of the cache.  Dirty content is lost.
+ *
+ ****************************************************************************/
+
+static void blockcache_release(FAR struct blockcache_s *cache)
+{
+  if (cache->entries != NULL)
+    {
+      fs_heap_free(cache->entries[0].buffer);
+      fs_heap_free(cache->entries);
+    }
+
+  memset(cache->hash, 0, sizeof(cache->hash));
+  list_initialize(&cache->lru);
+  cache->entries    = NULL;
+  cache->iobuf      = NULL;
+  cache->rabuf      = NULL;
+  cache->sectorsize = 0;
+  cache->ndirty     = 0;
+}
+
+/****************************************************************************
+ * Name: blockcache_setup
+ *
+ * Description:
+ *   Allocate the buffers once the geometry of the device is known.
+ *
+ ****************************************************************************/
+
+static int blockcache_setup(FAR struct blockcache_s *cache)
+{
+  FAR uint8_t *buffer;
+  struct geometry geo;
+  int ret;
+  int i;
+
+  if (cache->entries != NULL)
+    {
+      return OK;
+    }
+
+  ret = cache->lower->geometry(cache->inode, &geo);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (!geo.geo_available || geo.geo_sectorsize == 0)
+    {
+      return -ENODEV;
+    }
+
+  cache->entries = fs_heap_zalloc(BLOCKCACHE_NBLOCKS *
+                                  sizeof(struct blockcache_entry_s));
+  if (cache->entries == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  /* The read-ahead has its own staging buffer: inserting the sectors read
+   * ahead may evict dirty entries, whose write-back is staged in iobuf.
+   */
+
+  buffer = fs_heap_malloc((BLOCKCACHE_NBLOCKS + BLOCKCACHE_MAXIO +
+                           BLOCKCACHE_READAHEAD) * geo.geo_sectorsize);
+  if (buffer == NULL)
+    {
+      fs_heap_free(cache->entries);
+      cache->entries = NULL;
+      return -ENOMEM;
+    }
+
+  for (i = 0; i < BLOCKCACHE_NBLOCKS; i++)
+    {
+      cache->entries[i].buffer = buffer + i * geo.geo_sectorsize;
+      list_add_tail(&cache->lru, &cache->entries[i].lru);
+    }
+
+  cache->iobuf      = buffer + BLOCKCACHE_NBLOCKS * geo.geo_sectorsize;
+  cache->rabuf      = cache->iobuf + BLOCKCACHE_MAXIO * geo.geo_sectorsize;
+  cache->sectorsize = geo.geo_sectorsize;
+  cache->nsectors   = geo.geo_nsectors;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: blockcache_readahead
+ *
+ * Description:
+ *   Prefetch the sectors following a sequential read.  This is only done
+ *   once the reader has caught up with the previous read-ahead, so the
+ *   device sees one read of CONFIG_FS_BLOCKCACHE_READAHEAD sectors instead
+ *   of a single sector per request.
+ *
+ ****************************************************************************/
+
+static void blockcache_readahead(FAR struct blockcache_s *cache,
+                                 blkcnt_t sector)
+{
+  unsigned int count;
+  ssize_t ret;
+
+  if (BLOCKCACHE_READAHEAD == 0 || sector >= cache->nsectors ||
+      blockcache_lookup(cache, sector) != NULL)
+    {
+      return;
+    }
+
+  for (count = 1; count < BLOCKCACHE_READAHEAD &&
+                  sector + count < cache->nsectors &&
+                  blockcache_lookup(cache, sector + count) == NULL;
+       count++)
+    {
+    }
+
+  ret = cache->lower->read(cache->inode, cache->rabuf, sector, count);
+  if (ret > 0)
+    {
+      cache->readahead += ret;
+      blockcache_insert(cache, cache->rabuf, sector, ret);
+    }
+}
+
+/****************************************************************************
+ * Name: blockcache_open
+ ****************************************************************************/
+
+static int blockcache_open(FAR struct inode *inode)
+{
+  FAR struct blockcache_s *cache = blockcache_from(inode);
+
+  if (cache->lower->open != NULL)
+    {
+      return cache->lower->open(inode);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: blockcache_close
+ ****************************************************************************/
+
+static int blockcache_close(FAR struct inode *inode)
+{
+  FAR struct blockcache_s *cache = blockcache_from(inode);
+  int ret;
+
+  ret = nxmutex_lock(&cache->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = blockcache_flushall(cache);
+  nxmutex_unlock(&cache->lock);
+
+  if (ret >= 0 && cache->lower->close != NULL)
+    {
+      ret = cache->lower->close(inode);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: blockcache_read
+ ****************************************************************************/
+
+static ssize_t blockcache_read(FAR struct inode *inode,
+                               FAR unsigned char *buffer,
+                               blkcnt_t start_sector,
+                               unsigned int nsectors)
+{
+  FAR struct blockcache_s *cache = blockcache_from(inode);
+  FAR struct blockcache_entry_s *entry;
+  unsigned int nread = 0;
+  unsigned int count;
+  blkcnt_t sector;
+  ssize_t ret;
+
+  ret = nxmutex_lock(&cache->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (blockcache_setup(cache) < 0)
+    {
+      ret = cache->lower->read(inode, buffer, start_sector, nsectors);
+      goto out;
+    }
+
+  if (nsectors > BLOCKCACHE_BYPASS)
+    {
+      /* Large read: one transfer from the device, then overlay the
+       * sectors that are newer in the cache.
+       */
+
+      ret = cache->lower->read(inode, buffer, start_sector, nsectors);
+      if (ret > 0)
+        {
+          cache->misses += ret;
+          for (count = 0; cache->ndirty > 0 && count < (size_t)ret;
+               count++)
+            {
+              entry = blockcache_lookup(cache, start_sector + count);
+              if (entry != NULL && (entry->flags & BLOCKCACHE_DIRTY) != 0)
+                {
+                  memcpy(buffer + count * cache->sectorsize, entry->buffer,
+                         cache->sectorsize);
+                }
+            }
+        }
+
+      goto out;
+    }
+
+  while (nread < nsectors)
+    {
+      sector = start_sector + nread;
+      entry  = blockcache_lookup(cache, sector);
+      if (entry != NULL)
+        {
+          memcpy(buffer + nread * cache->sectorsize, entry->buffer,
+                 cache->sectorsize);
+          blockcache_touch(cache, entry);
+          cache->hits++;
+          nread++;
+          continue;
+        }
+
+      /* Read the whole run of missing sectors with one transfer */
+
+      for (count = 1; nread + count < nsectors &&
+                      blockcache_lookup(cache, sector + count) == NULL;
+           count++)
+        {
+        }
+
+      ret = cache->lower->read(inode, buffer + nread * cache->sectorsize,
+                               sector, count);
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      cache->misses += ret;
+      blockcache_insert(cache, buffer + nread * cache->sectorsize,
+                        sector, ret);
+      nread += ret;
+
+      if ((size_t)ret < count)
+        {
+          break;
+        }
+    }
+
+  if (nread > 0)
+    {
+      if (nread == nsectors && start_sector == cache->nextsector)
+        {
+          blockcache_readahead(cache, start_sector + nread);
+        }
+
+      cache->nextsector = start_sector + nread;
+      ret = nread;
+    }
+
+out:
+  nxmutex_unlock(&cache->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: blockcache_write
+ ****************************************************************************/
+
+static ssize_t blockcache_write(FAR struct inode *inode,
+                                FAR const unsigned char *buffer,
+                                blkcnt_t start_sector,
+                                unsigned int nsectors)
+{
+  FAR struct blockcache_s *cache = blockcache_from(inode);
+  FAR struct blockcache_entry_s *entry;
+  unsigned int i;
+  ssize_t ret;
+
+  ret = nxmutex_lock(&cache->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (blockcache_setup(cache) < 0)
+    {
+      ret = cache->lower->write(inode, buffer, start_sector, nsectors);
+      goto out;
+    }
+
+#ifdef CONFIG_FS_BLOCKCACHE_WRITEBACK
+  if (nsectors <= BLOCKCACHE_BYPASS)
+    {
+      /* Keep the sectors dirty in the cache.  They reach the device when
+       * they are evicted, on BIOC_FLUSH or on the close of the driver.
+       */
+
+      for (i = 0; i < nsectors; i++)
+        {
+          entry = blockcache_lookup(cache, start_sector + i);
+          if (entry == NULL)
+            {
+              ret = blockcache_alloc(cache, start_sector + i, &entry);
+              if (ret < 0)
+                {
+                  break;
+                }
+            }
+
+          memcpy(entry->buffer, buffer + i * cache->sectorsize,
+                 cache->sectorsize);
+          if ((entry->flags & BLOCKCACHE_DIRTY) == 0)
+            {
+              entry->flags |= BLOCKCACHE_DIRTY;
+              cache->ndirty++;
+            }
+
+          blockcache_touch(cache, entry);
+        }
+
+      if (i > 0)
+        {
+          ret = i;
+        }
+
+      goto out;
+    }
+#endif
+
+  /* Write through, then refresh the cached copies.  The new data also
+   * supersedes any dirty copy of the written sectors.
+   */
+
+  ret = cache->lower->write(inode, buffer, start_sector, nsectors);
+  for (i = 0; ret > 0 && i < (size_t)ret; i++)
+    {
+      entry = blockcache_lookup(cache, start_sector + i);
+      if (entry != NULL)
+        {
+          memcpy(entry->buffer, buffer + i * cache->sectorsize,
+                 cache->sectorsize);
+          if ((entry->flags & BLOCKCACHE_DIRTY) != 0)
+            {
+              entry->flags &= ~BLOCKCACHE_DIRTY;
+              cache->ndirty--;
+            }
+        }
+    }
+
+out:
+  nxmutex_unlock(&cache->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: blockcache_geometry
+ ****************************************************************************/
+
+static int blockcache_geometry(FAR struct inode *inode,
+                               FAR struct geometry *geometry)
+{
+  FAR struct blockcache_s *cache = blockcache_from(inode);
+  int ret;
+
+  ret = cache->lower->geometry(inode, geometry);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = nxmutex_lock(&cache->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Anything cached belongs to the old media */
+
+  if (cache->entries != NULL &&
+      (geometry->geo_mediachanged || !geometry->geo_available ||
+       geometry->geo_sectorsize != cache->sectorsize))
+    {
+      blockcache_release(cache);
+    }
+  else
+    {
+      cache->nsectors = geometry->geo_nsectors;
+    }
+
+  nxmutex_unlock(&cache->lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: blockcache_ioctl
+ ****************************************************************************/
+
+static int blockcache_ioctl(FAR struct inode *inode, int cmd,
+                            unsigned long arg)
+{
+  FAR struct blockcache_s *cache = blockcache_from(inode);
+  FAR const blkcnt_t *range;
+  int ret;
+
+  ret = nxmutex_lock(&cache->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  switch (cmd)
+    {
+      case BIOC_FLUSH:
+        ret = blockcache_flushall(cache);
+        break;
+
+      case BIOC_TRIM:
+      case BIOC_ZEROOUT:
+
+        /* The content of the range is discarded or zeroed by the device,
+         * so there is nothing left worth writing back.
+         */
+
+        range = (FAR const blkcnt_t *)((uintptr_t)arg);
+        if (range != NULL)
+          {
+            blockcache_invalidate(cache, range[0], range[1]);
+          }
+        break;
+
+      default:
+        break;
+    }
+
+  if (ret >= 0)
+    {
+      if (cache->lower->ioctl != NULL)
+        {
+          ret = cache->lower->ioctl(inode, cmd, arg);
+        }
+      else
+        {
+          ret = -ENOTTY;
+        }
+
+      /* The cache is flushed even if the driver has nothing to flush */
+
+      if (cmd == BIOC_FLUSH && (ret == -ENOTTY || ret == -EINVAL))
+        {
+          ret = OK;
+        }
+    }
+
+  nxmutex_unlock(&cache->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: blockcache_unlink
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+static int blockcache_unlink(FAR struct inode *inode)
+{
+  FAR struct blockcache_s *cache = blockcache_from(inode);
+
+  blockcache_flush(inode);
+  return cache->lower->unlink(inode);
+}
+#endif
+
+/****************************************************************************
+ * Name: blockcache_installed
+ ****************************************************************************/
+
+static inline bool blockcache_installed(FAR struct inode *inode)
+{
+  return inode->u.i_bops != NULL &&
+         inode->u.i_bops->geometry == blockcache_geometry;
+}
+
+/****************************************************************************
+ * Name: blockcache_partition_cached
+ *
+ * Description:
+ *   Return true if a partition of the device 'inode' carries a cache.
+ *   Caching the device too would leave two caches of the same sectors.
+ *
+ * Assumptions:
+ *   The caller holds g_blockcache_lock.
+ *
+ ****************************************************************************/
+
+static bool blockcache_partition_cached(FAR struct inode *inode)
+{
+  FAR struct blockcache_s *cache;
+
+  list_for_every_entry(&g_blockcache_list, cache, struct blockcache_s,
+                       node)
+    {
+      if (cache->parent == inode)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: blockcache_install
+ *
+ * Description:
+ *   Put a block cache in front of the block driver 'inode'.  Nothing is
+ *   done if the driver is already cached, is memory mapped (BIOC_XIPBASE
+ *   succeeds, so caching would only copy memory around), is a partition
+ *   whose parent device carries the cache or is the parent device of a
+ *   cached partition.
+ *
+ * Input Parameters:
+ *   inode - The block driver inode.  The caller holds a reference.
+ *
+ * Returned Value:
+ *   Zero on success or when no cache is needed; a negated errno value on
+ *   failure, in which case the driver continues to work uncached.
+ *
+ ****************************************************************************/
+
+int blockcache_install(FAR struct inode *inode)
+{
+  FAR const struct block_operations *lower;
+  FAR struct blockcache_s *cache;
+  FAR struct inode *parent;
+  FAR void *xipbase;
+  int ret;
+
+  DEBUGASSERT(inode != NULL && INODE_IS_BLOCK(inode));
+
+  ret = nxmutex_lock(&g_blockcache_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* A partition reads and writes through its parent, so only one of the
+   * two may be cached.  Whichever is opened first gets the cache.
+   */
+
+  lower  = inode->u.i_bops;
+  parent = block_partition_parent(inode);
+  if (lower == NULL || lower->read == NULL || lower->geometry == NULL ||
+      blockcache_installed(inode) ||
+      (parent != NULL && blockcache_installed(parent)) ||
+      blockcache_partition_cached(inode) ||
+      (lower->ioctl != NULL &&
+       lower->ioctl(inode, BIOC_XIPBASE,
+                    (unsigned long)((uintptr_t)&xipbase)) >= 0))
+    {
+      goto out;
+    }
+
+  cache = fs_heap_zalloc(sizeof(struct blockcache_s));
+  if (cache == NULL)
+    {
+      ret = -ENOMEM;
+      goto out;
+    }
+
+  cache->bops.open     = blockcache_open;
+  cache->bops.close    = blockcache_close;
+  cache->bops.read     = blockcache_read;
+  cache->bops.write    = lower->write != NULL ? blockcache_write : NULL;
+  cache->bops.geometry = blockcache_geometry;
+  cache->bops.ioctl    = blockcache_ioctl;
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  cache->bops.unlink   = lower->unlink != NULL ? blockcache_unlink : NULL;
+#endif
+
+  cache->lower  = lower;
+  cache->inode  = inode;
+  cache->parent = parent;
+  nxmutex_init(&cache->lock);
+  list_initialize(&cache->lru);
+  list_add_tail(&g_blockcache_list, &cache->node);
+
+  inode->u.i_bops = &cache->bops;
+
+out:
+  nxmutex_unlock(&g_blockcache_lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: blockcache_flush
+ *
+ * Description:
+ *   Write all dirty sectors of the cache of 'inode' back to the device.
+ *   Does nothing if the driver is not cached.
+ *
+ ****************************************************************************/
+
+int blockcache_flush(FAR struct inode *inode)
+{
+  FAR struct blockcache_s *cache;
+  int ret;
+
+  if (!INODE_IS_BLOCK(inode) || !blockcache_installed(inode))
+    {
+      return OK;
+    }
+
+  cache = blockcache_from(inode);
+  ret = nxmutex_lock(&cache->lock);
+  if (ret >= 0)
+    {
+      ret = blockcache_flushall(cache);
+      nxmutex_unlock(&cache->lock);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: blockcache_free
+ *
+ * Description:
+ *   Called when the block driver inode is freed.  The driver is gone by
+ *   now, so the cache is discarded without any write back.
+ *
+ ****************************************************************************/
+
+void blockcache_free(FAR struct inode *inode)
+{
+  FAR struct blockcache_s *cache;
+
+  if (!INODE_IS_BLOCK(inode) || !blockcache_installed(inode))
+    {
+      return;
+    }
+
+  cache = blockcache_from(inode);
+  if (cache->ndirty > 0)
+    {
+      ferr("ERROR: %zu dirty sectors of %s lost\n",
+           cache->ndirty, inode->i_name);
+    }
+
+  nxmutex_lock(&g_blockcache_lock);
+  list_delete(&cache->node);
+  nxmutex_unlock(&g_blockcache_lock);
+
+  inode->u.i_bops = cache->lower;
+  blockcache_release(cache);
+  nxmutex_destroy(&cache->lock);
+  fs_heap_free(cache);
+}
+
+/****************************************************************************
+ * Name: blockcache_foreach
+ *
+ * Description:
+ *   Report the statistics of every block cache to 'handler'.
+ *
+ ****************************************************************************/
+
+void blockcache_foreach(blockcache_handler_t handler, FAR void *arg)
+{
+  FAR struct blockcache_s *cache;
+  struct blockcache_info_s info;
+
+  if (nxmutex_lock(&g_blockcache_lock) < 0)
+    {
+      return;
+    }
+
+  list_for_every_entry(&g_blockcache_list, cache, struct blockcache_s,
+                       node)
+    {
+      info.name       = cache->inode->i_name;
+      info.sectorsize = cache->sectorsize;
+      info.nblocks    = BLOCKCACHE_NBLOCKS;
+      info.ndirty     = cache->ndirty;
+      info.hits       = cache->hits;
+      info.misses     = cache->misses;
+      info.readahead  = cache->readahead;
+      info.wbwrites   = cache->wbwrites;
+      info.wbsectors  = cache->wbsectors;
+
+      handler(&info, arg);
+    }
+
+  nxmutex_unlock(&g_blockcache_lock);
+}
+
+#endif /* CONFIG_FS_BLOCKCACHE */
@@ -297,6 +297,28 @@ static int part_unlink(FAR struct inode *inode)
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: block_partition_parent
+ *
+ * Description:
+ *   Return the parent block driver of 'inode' if it is a partition
+ *   registered by register_partition_with_inode(), NULL otherwise.
+ *
+ ****************************************************************************/
+
+FAR struct inode *block_partition_parent(FAR struct inode *inode)
+{
+  FAR struct part_struct_s *dev;
+
+  if (inode->u.i_bops != &g_part_bops)
+    {
+      return NULL;
+    }
+
+  dev = inode->i_private;
+  return dev->parent;
+}
+
 /****************************************************************************
  * Name: register_blockpartition/register_partition_with_inode
  *
@@ -120,6 +120,12 @@ int find_blockdriver(FAR const char *pathname, int mountflags,
       goto errout_with_inode;
     }
 
+#ifdef CONFIG_FS_BLOCKCACHE
+  /* Route all further accesses through the shared block cache */
+
+  blockcache_install(inode);
+#endif
+
   *ppinode = inode;
   RELEASE_SEARCH(&desc);
   return OK;
@@ -29,6 +29,7 @@
 #include <nuttx/fs/fs.h>
 
 #include "inode/inode.h"
+#include "driver/driver.h"
 #include "vfs/vfs.h"
 
 /****************************************************************************
@@ -45,8 +46,26 @@
 
 int unregister_blockdriver(FAR const char *path)
 {
+#ifdef CONFIG_FS_BLOCKCACHE
+  struct inode_search_s desc;
+#endif
   int ret;
 
+#ifdef CONFIG_FS_BLOCKCACHE
+  /* The driver goes away with the inode, so write back what is still
+   * cached for it while it can.
+   */
+
+  SETUP_SEARCH(&desc, path, false);
+  if (inode_find(&desc) >= 0)
+    {
+      blockcache_flush(desc.node);
+      inode_release(desc.node);
+    }
+
+  RELEASE_SEARCH(&desc);
+#endif
+
   inode_lock();
   ret = inode_remove(path);
   inode_unlock();
@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/statfs.h>
@@ -267,6 +268,16 @@ static int fat_open(FAR struct file *filep, FAR const char *relpath,
 
       if ((oflags & (O_TRUNC | O_WRONLY)) == (O_TRUNC | O_WRONLY))
         {
+#ifdef CONFIG_FAT_EXTENTMAP
+          /* Forget the extent maps of every open instance of the file
+           * before its clusters are freed.
+           */
+
+          fat_extmap_resetall(fs,
+                              ((off_t)DIR_GETFSTCLUSTHI(direntry) << 16) |
+                              DIR_GETFSTCLUSTLO(direntry));
+#endif
+
           /* Truncate the file to zero length */
 
           ret = fat_dirtruncate(fs, direntry);
@@ -472,6 +483,10 @@ static int fat_close(FAR struct file *filep)
       fat_io_free(ff->ff_buffer, fs->fs_hwsectorsize);
     }
 
+#ifdef CONFIG_FAT_EXTENTMAP
+  fat_extmap_reset(ff);
+#endif
+
   /* Then free the file structure itself. */
 
   fs_heap_free(ff);
@@ -622,6 +637,24 @@ static int fat_get_sectors(FAR struct file *filep, bool read)
 
   /* Traverse the existing chain */
 
+#ifdef CONFIG_FAT_EXTENTMAP
+  i = num_traversed;
+  if (i < num_clu && i < new_num_clu)
+    {
+      /* Look the cluster up in the extent map instead of following the
+       * chain cluster by cluster.  Past the end of the map, the chain is
+       * followed from the cluster already reached if that is nearer.
+       */
+
+      i = MIN(num_clu, new_num_clu);
+      cluster = fat_extmap_cluster(fs, ff, i - 1, num_traversed - 1,
+                                   cluster);
+      if (cluster < 0)
+        {
+          return cluster;
+        }
+    }
+#else
   for (i = num_traversed; i < num_clu && i < new_num_clu; i++)
     {
       cluster = fat_getcluster(fs, cluster);
@@ -633,6 +666,7 @@ static int fat_get_sectors(FAR struct file *filep, bool read)
           return -EIO;
         }
     }
+#endif
 
   if (read)
     {
@@ -1905,6 +1939,25 @@ static int fat_sync(FAR struct file *filep)
       ret          = fat_updatefsinfo(fs);
     }
 
+#ifdef CONFIG_FS_BLOCKCACHE
+  /* Then have the block driver push out whatever it still buffers, e.g.
+   * the dirty sectors of a write-back block cache.  Drivers that do not
+   * know the command reject it with -ENOTTY or -EINVAL.
+   */
+
+  if (ret >= 0 && fs->fs_blkdriver->u.i_bops->ioctl != NULL)
+    {
+      int flushret;
+
+      flushret = fs->fs_blkdriver->u.i_bops->ioctl(fs->fs_blkdriver,
+                                                    BIOC_FLUSH, 0);
+      if (flushret < 0 && flushret != -ENOTTY && flushret != -EINVAL)
+        {
+          ret = flushret;
+        }
+    }
+#endif
+
 errout_with_lock:
   nxmutex_unlock(&fs->fs_lock);
   return ret;
@@ -2012,6 +2065,12 @@ static int fat_dup(FAR const struct file *oldp, FAR struct file *newp)
   newff->ff_startcluster     = oldff->ff_startcluster;     /* Start cluster of file on media */
   newff->ff_currentsector    = oldff->ff_currentsector;    /* Current sector */
   newff->ff_cachesector      = 0;                          /* Sector in file buffer */
+#ifdef CONFIG_FAT_EXTENTMAP
+  newff->ff_extents          = NULL;                       /* Rebuilt on demand */
+  newff->ff_nextents         = 0;
+  newff->ff_maxextents       = 0;
+  newff->ff_nmapped          = 0;
+#endif
 
   /* Attach the private date to the struct file instance */
 
@@ -2344,6 +2403,12 @@ static int fat_truncate(FAR struct file *filep, off_t length)
           ret = fat_dirshrink(fs, direntry, length);
         }
 
+#ifdef CONFIG_FAT_EXTENTMAP
+      /* Forget the extent maps of every open instance of the file */
+
+      fat_extmap_resetall(fs, ff->ff_startcluster);
+#endif
+
       if (ret >= 0)
         {
           /* The truncation has completed without error.  Update the file
@@ -2771,6 +2836,13 @@ static int fat_unbind(FAR void *handle, FAR struct inode **blkdriver,
       fat_io_free(fs->fs_buffer, fs->fs_hwsectorsize);
     }
 
+#ifdef CONFIG_FAT_FREEMAP
+  if (fs->fs_freemap)
+    {
+      fs_heap_free(fs->fs_freemap);
+    }
+#endif
+
   nxmutex_destroy(&fs->fs_lock);
   fs_heap_free(fs);
   return OK;
@@ -891,7 +891,24 @@ struct fat_mountpt_s
   uint8_t  fs_fatsecperclus;       /* MBR: Sectors per allocation unit: 2**n, n=0..7 */
   uint8_t *fs_buffer;              /* This is an allocated buffer to hold one
                                     * sector from the device */
+#ifdef CONFIG_FAT_FREEMAP
+  uint8_t *fs_freemap;             /* Bit set: no free cluster in the group */
+  uint32_t fs_freegroup;           /* Clusters per group (per FAT sector) */
+#endif
+};
+
+#ifdef CONFIG_FAT_EXTENTMAP
+/* One run of contiguous clusters of a file.  The extents of a file are
+ * sorted and cover the chain from its first cluster without gaps.
+ */
+
+struct fat_extent_s
+{
+  uint32_t fe_index;               /* First cluster index within the file */
+  uint32_t fe_cluster;             /* First cluster of the run */
+  uint32_t fe_count;               /* Number of clusters in the run */
 };
+#endif
 
 /* This structure represents on open file under the mountpoint.  An instance
  * of this structure is retained as struct file specific information on each
@@ -913,6 +930,12 @@ struct fat_file_s
   off_t    ff_cachesector;         /* Current sector in the file buffer */
   off_t    ff_pos;                 /* Current position in the file */
   uint8_t *ff_buffer;              /* File buffer (for partial sector accesses) */
+#ifdef CONFIG_FAT_EXTENTMAP
+  FAR struct fat_extent_s *ff_extents; /* Run-length map of the chain */
+  uint16_t ff_nextents;            /* Number of valid entries in ff_extents */
+  uint16_t ff_maxextents;          /* Number of allocated entries */
+  uint32_t ff_nmapped;             /* Number of clusters covered by the map */
+#endif
 };
 
 /* This structure holds the sequence of directory entries used by one
@@ -1055,6 +1078,19 @@ EXTERN int32_t fat_extendchain(FAR struct fat_mountpt_s *fs,
 
 #define fat_createchain(fs) fat_extendchain(fs, 0)
 
+#ifdef CONFIG_FAT_FREEMAP
+EXTERN void   fat_freemap_init(FAR struct fat_mountpt_s *fs);
+#endif
+
+#ifdef CONFIG_FAT_EXTENTMAP
+EXTERN off_t  fat_extmap_cluster(FAR struct fat_mountpt_s *fs,
+                                 FAR struct fat_file_s *ff, uint32_t index,
+                                 uint32_t pos, off_t cluster);
+EXTERN void   fat_extmap_reset(FAR struct fat_file_s *ff);
+EXTERN void   fat_extmap_resetall(FAR struct fat_mountpt_s *fs,
+                                  off_t startcluster);
+#endif
+
 /* Help for traversing directory trees and accessing directory entries */
 
 EXTERN int    fat_nextdirentry(FAR struct fat_mountpt_s *fs,
@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <sys/types.h>
 #include <inttypes.h>
 #include <stdint.h>
@@ -43,6 +44,7 @@
 
 #include "inode/inode.h"
 #include "fs_fat32.h"
+#include "fs_heap.h"
 
 /****************************************************************************
  * Private Functions
@@ -270,6 +272,214 @@ static int fat_checkbootrecord(struct fat_mountpt_s *fs)
   return OK;
 }
 
+#ifdef CONFIG_FAT_FREEMAP
+/****************************************************************************
+ * Name: fat_freemap_first/last
+ *
+ * Description:
+ *   Return the first and the last cluster of the free map group containing
+ *   'cluster'.
+ *
+ ****************************************************************************/
+
+static inline uint32_t fat_freemap_first(FAR struct fat_mountpt_s *fs,
+                                         uint32_t cluster)
+{
+  uint32_t first = cluster - cluster % fs->fs_freegroup;
+
+  return first < 2 ? 2 : first;
+}
+
+static inline uint32_t fat_freemap_last(FAR struct fat_mountpt_s *fs,
+                                        uint32_t cluster)
+{
+  uint32_t last = cluster - cluster % fs->fs_freegroup +
+                  fs->fs_freegroup - 1;
+
+  return MIN(last, fs->fs_nclusters + 1);
+}
+
+/****************************************************************************
+ * Name: fat_freemap_isfull
+ *
+ * Description:
+ *   Return true if all clusters of the group of 'cluster' are known to be
+ *   allocated.
+ *
+ ****************************************************************************/
+
+static inline bool fat_freemap_isfull(FAR struct fat_mountpt_s *fs,
+                                      uint32_t cluster)
+{
+  uint32_t group = cluster / fs->fs_freegroup;
+
+  return fs->fs_freemap != NULL &&
+         (fs->fs_freemap[group >> 3] & (1 << (group & 7))) != 0;
+}
+
+/****************************************************************************
+ * Name: fat_freemap_mark
+ ****************************************************************************/
+
+static inline void fat_freemap_mark(FAR struct fat_mountpt_s *fs,
+                                    uint32_t cluster, bool full)
+{
+  uint32_t group = cluster / fs->fs_freegroup;
+
+  if (fs->fs_freemap != NULL)
+    {
+      if (full)
+        {
+          fs->fs_freemap[group >> 3] |= 1 << (group & 7);
+        }
+      else
+        {
+          fs->fs_freemap[group >> 3] &= ~(1 << (group & 7));
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: fat_findfreecluster
+ *
+ * Description:
+ *   Search the FAT for a free cluster, starting after 'startcluster' and
+ *   wrapping around at the end of the FAT.  Groups of clusters that the
+ *   free map knows to be fully allocated are skipped without reading the
+ *   FAT.
+ *
+ * Returned Value:
+ *   <0:error, 0: no free cluster, >=2: free cluster number
+ *
+ ****************************************************************************/
+
+static int32_t fat_findfreecluster(FAR struct fat_mountpt_s *fs,
+                                   uint32_t startcluster)
+{
+  uint32_t newcluster = startcluster;
+  uint32_t remaining;
+  off_t nextcluster;
+#ifdef CONFIG_FAT_FREEMAP
+  uint32_t scanfrom = 0;
+  uint32_t skip;
+#endif
+
+  /* Visit each cluster exactly once */
+
+  for (remaining = fs->fs_nclusters; remaining > 0; remaining--)
+    {
+      newcluster++;
+      if (newcluster >= fs->fs_nclusters + 2)
+        {
+          newcluster = 2;
+        }
+
+#ifdef CONFIG_FAT_FREEMAP
+      if (fat_freemap_isfull(fs, newcluster))
+        {
+          /* Skip the rest of a group without free clusters */
+
+          skip = MIN(fat_freemap_last(fs, newcluster) - newcluster,
+                     remaining - 1);
+          newcluster += skip;
+          remaining  -= skip;
+          continue;
+        }
+
+      if (newcluster == fat_freemap_first(fs, newcluster))
+        {
+          scanfrom = newcluster;
+        }
+#endif
+
+      nextcluster = fat_getcluster(fs, newcluster);
+      if (nextcluster == 0)
+        {
+          return newcluster;
+        }
+      else if (nextcluster < 0)
+        {
+          return nextcluster;
+        }
+
+#ifdef CONFIG_FAT_FREEMAP
+      /* Remember a group that was scanned completely without finding a
+       * free cluster.
+       */
+
+      if (newcluster == fat_freemap_last(fs, newcluster) &&
+          scanfrom == fat_freemap_first(fs, newcluster))
+        {
+          fat_freemap_mark(fs, newcluster, true);
+        }
+#endif
+    }
+
+  return 0;
+}
+
+#ifdef CONFIG_FAT_EXTENTMAP
+/****************************************************************************
+ * Name: fat_extmap_append
+ *
+ * Description:
+ *   Record that cluster number 'index' of the file is 'cluster'.  Only
+ *   the cluster right after the mapped part of the chain can be recorded.
+ *
+ ****************************************************************************/
+
+static void fat_extmap_append(FAR struct fat_file_s *ff, uint32_t index,
+                              uint32_t cluster)
+{
+  FAR struct fat_extent_s *extent;
+
+  if (index != ff->ff_nmapped)
+    {
+      return;
+    }
+
+  if (ff->ff_nextents > 0)
+    {
+      extent = &ff->ff_extents[ff->ff_nextents - 1];
+      if (extent->fe_cluster + extent->fe_count == cluster)
+        {
+          extent->fe_count++;
+          ff->ff_nmapped++;
+          return;
+        }
+    }
+
+  if (ff->ff_nextents >= ff->ff_maxextents)
+    {
+      uint32_t maxextents;
+
+      if (ff->ff_maxextents >= CONFIG_FAT_EXTENTMAP_MAX)
+        {
+          return;
+        }
+
+      maxextents = ff->ff_maxextents > 0 ? 2 * ff->ff_maxextents : 4;
+      maxextents = MIN(maxextents, CONFIG_FAT_EXTENTMAP_MAX);
+      extent = fs_heap_realloc(ff->ff_extents,
+                               maxextents * sizeof(struct fat_extent_s));
+      if (extent == NULL)
+        {
+          return;
+        }
+
+      ff->ff_extents    = extent;
+      ff->ff_maxextents = maxextents;
+    }
+
+  extent             = &ff->ff_extents[ff->ff_nextents++];
+  extent->fe_index   = index;
+  extent->fe_cluster = cluster;
+  extent->fe_count   = 1;
+  ff->ff_nmapped++;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -636,6 +846,10 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
     }
 #endif
 
+#ifdef CONFIG_FAT_FREEMAP
+  fat_freemap_init(fs);
+#endif
+
   /* We did it! */
 
   finfo("FAT%d:\n", fs->fs_type == 0 ? 12 : fs->fs_type == 1  ? 16 : 32);
@@ -1103,6 +1317,16 @@ int fat_putcluster(struct fat_mountpt_s *fs, uint32_t clusterno,
       /* Mark the modified sector as "dirty" and return success */
 
       fs->fs_dirty = true;
+
+#ifdef CONFIG_FAT_FREEMAP
+      /* A released cluster makes its group searchable again */
+
+      if (nextcluster == 0)
+        {
+          fat_freemap_mark(fs, clusterno, false);
+        }
+#endif
+
       return OK;
     }
 
@@ -1175,7 +1399,7 @@ int fat_removechain(struct fat_mountpt_s *fs, uint32_t cluster)
 int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster)
 {
   off_t    startsector;
-  uint32_t newcluster;
+  int32_t  newcluster;
   uint32_t startcluster;
   int      ret;
 
@@ -1226,67 +1450,17 @@ int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster)
       startcluster = cluster;
     }
 
-  /* Loop until (1) we discover that there are not free clusters
-   * (return 0), an errors occurs (return -errno), or (3) we find
-   * the next cluster (return the new cluster number).
-   */
+  /* Find a free cluster after the start cluster */
 
-  newcluster = startcluster;
-  for (; ; )
+  newcluster = fat_findfreecluster(fs, startcluster);
+  if (newcluster <= 0)
     {
-      /* Examine the next cluster in the FAT */
+      /* No free cluster (0) or an error (negated errno) */
 
-      newcluster++;
-      if (newcluster >= fs->fs_nclusters + 2)
-        {
-          /* If we hit the end of the available clusters, then
-           * wrap back to the beginning because we might have
-           * started at a non-optimal place.  But don't continue
-           * past the start cluster.
-           */
-
-          newcluster = 2;
-          if (newcluster > startcluster)
-            {
-              /* We are back past the starting cluster, then there
-               * is no free cluster.
-               */
-
-              return 0;
-            }
-        }
-
-      /* We have a candidate cluster.  Check if the cluster number is
-       * mapped to a group of sectors.
-       */
-
-      startsector = fat_getcluster(fs, newcluster);
-      if (startsector == 0)
-        {
-          /* Found have found a free cluster break out */
-
-          break;
-        }
-      else if (startsector < 0)
-        {
-          /* Some error occurred, return the error number */
-
-          return startsector;
-        }
-
-      /* We wrap all the back to the starting cluster?  If so, then
-       * there are no free clusters.
-       */
-
-      if (newcluster == startcluster)
-        {
-          return 0;
-        }
+      return newcluster;
     }
 
-  /* We get here only if we break out with an available cluster
-   * number in 'newcluster'  Now mark that cluster as in-use.
-   */
+  /* Now mark that cluster as in-use */
 
   ret = fat_putcluster(fs, newcluster, 0x0fffffff);
   if (ret < 0)
@@ -2206,3 +2380,179 @@ int fat_currentsector(struct fat_mountpt_s *fs, struct fat_file_s *ff,
 
   return -ENOSPC;
 }
+
+/****************************************************************************
+ * Name: fat_freemap_init
+ *
+ * Description:
+ *   (Re-)allocate the free cluster map of a volume that was just mounted.
+ *   The map starts out empty, i.e. every group may hold a free cluster,
+ *   and is refined by fat_extendchain().  Without memory for the map the
+ *   search works as before.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FAT_FREEMAP
+void fat_freemap_init(FAR struct fat_mountpt_s *fs)
+{
+  uint32_t ngroups;
+
+  /* One group is the set of clusters described by one FAT sector */
+
+  switch (fs->fs_type)
+    {
+      case FSTYPE_FAT12:
+        fs->fs_freegroup = fs->fs_hwsectorsize * 2 / 3;
+        break;
+
+      case FSTYPE_FAT16:
+        fs->fs_freegroup = fs->fs_hwsectorsize / 2;
+        break;
+
+      default:
+        fs->fs_freegroup = fs->fs_hwsectorsize / 4;
+        break;
+    }
+
+  ngroups = (fs->fs_nclusters + 2 + fs->fs_freegroup - 1) /
+            fs->fs_freegroup;
+
+  if (fs->fs_freemap != NULL)
+    {
+      fs_heap_free(fs->fs_freemap);
+    }
+
+  fs->fs_freemap = fs_heap_zalloc((ngroups + 7) / 8);
+}
+#endif
+
+/****************************************************************************
+ * Name: fat_extmap_cluster
+ *
+ * Description:
+ *   Return the cluster number 'index' (counted from zero) of the chain of
+ *   an open file.  Clusters in the mapped part of the chain are found by a
+ *   binary search over the extents.  Beyond it the chain is followed from
+ *   the last mapped cluster or from 'cluster', the known cluster number
+ *   'pos' of the chain, whichever is nearer.  Clusters found right after
+ *   the mapped part are added to the map, so once the map is full a
+ *   sequential access still takes one FAT step per cluster.
+ *
+ * Returned Value:
+ *   The cluster number on success; a negated errno value if the chain is
+ *   broken or cannot be read.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FAT_EXTENTMAP
+off_t fat_extmap_cluster(FAR struct fat_mountpt_s *fs,
+                         FAR struct fat_file_s *ff, uint32_t index,
+                         uint32_t pos, off_t cluster)
+{
+  FAR struct fat_extent_s *extent;
+
+  if (ff->ff_nmapped == 0)
+    {
+      fat_extmap_append(ff, 0, ff->ff_startcluster);
+    }
+
+  if (index < ff->ff_nmapped)
+    {
+      int low  = 0;
+      int high = ff->ff_nextents - 1;
+
+      /* Find the last extent starting at or before 'index' */
+
+      while (low < high)
+        {
+          int mid = (low + high + 1) / 2;
+
+          if (ff->ff_extents[mid].fe_index <= index)
+            {
+              low = mid;
+            }
+          else
+            {
+              high = mid - 1;
+            }
+        }
+
+      extent = &ff->ff_extents[low];
+      return extent->fe_cluster + (index - extent->fe_index);
+    }
+
+  /* Follow the chain from the end of the map if that is nearer than the
+   * position given by the caller (or from the start of the chain if
+   * neither is usable).
+   */
+
+  if (ff->ff_nmapped > 0 && (pos > index || ff->ff_nmapped - 1 > pos))
+    {
+      extent  = &ff->ff_extents[ff->ff_nextents - 1];
+      pos     = ff->ff_nmapped - 1;
+      cluster = extent->fe_cluster + extent->fe_count - 1;
+    }
+  else if (pos > index || cluster < 2)
+    {
+      pos     = 0;
+      cluster = ff->ff_startcluster;
+    }
+
+  while (pos < index)
+    {
+      cluster = fat_getcluster(fs, cluster);
+      if (cluster < 2 || cluster >= fs->fs_nclusters + 2)
+        {
+          return -EIO;
+        }
+
+      fat_extmap_append(ff, ++pos, cluster);
+    }
+
+  return cluster;
+}
+
+/****************************************************************************
+ * Name: fat_extmap_reset
+ *
+ * Description:
+ *   Forget the extent map of a file whose cluster chain was changed other
+ *   than by appending clusters.
+ *
+ ****************************************************************************/
+
+void fat_extmap_reset(FAR struct fat_file_s *ff)
+{
+  if (ff->ff_extents != NULL)
+    {
+      fs_heap_free(ff->ff_extents);
+    }
+
+  ff->ff_extents    = NULL;
+  ff->ff_nextents   = 0;
+  ff->ff_maxextents = 0;
+  ff->ff_nmapped    = 0;
+}
+
+/****************************************************************************
+ * Name: fat_extmap_resetall
+ *
+ * Description:
+ *   Forget the extent maps of every open instance of the file whose chain
+ *   starts at 'startcluster', before clusters of that chain are freed.
+ *
+ ****************************************************************************/
+
+void fat_extmap_resetall(FAR struct fat_mountpt_s *fs, off_t startcluster)
+{
+  FAR struct fat_file_s *ff;
+
+  for (ff = fs->fs_head; ff != NULL; ff = ff->ff_next)
+    {
+      if (ff->ff_startcluster == startcluster)
+        {
+          fat_extmap_reset(ff);
+        }
+    }
+}
+#endif
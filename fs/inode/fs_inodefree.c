@@ -33,6 +33,7 @@
 #include <nuttx/fs/fs.h>
 
 #include "inode/inode.h"
+#include "driver/driver.h"
 #include "fs_heap.h"
 
 /****************************************************************************
@@ -76,6 +77,10 @@ void inode_free(FAR struct inode *inode)
         }
 #endif
 
+#ifdef CONFIG_FS_BLOCKCACHE
+      blockcache_free(inode);
+#endif
+
       fs_heap_free(inode);
     }
 }
@@ -0,0 +1,242 @@
+/****************************************************************************
+ * fs/inode/fs_inodehash.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <assert.h>
+
+#include <nuttx/fs/fs.h>
+
+#include "inode/inode.h"
+
+#ifdef CONFIG_FS_INODE_HASH
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if (CONFIG_FS_INODE_HASH_SIZE & (CONFIG_FS_INODE_HASH_SIZE - 1)) != 0
+#  error CONFIG_FS_INODE_HASH_SIZE must be a power of two
+#endif
+
+#define INODE_HASH_MASK (CONFIG_FS_INODE_HASH_SIZE - 1)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* All inodes below the root, hashed by parent inode and name */
+
+static FAR struct inode *g_inode_hash[CONFIG_FS_INODE_HASH_SIZE];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_hashkey
+ *
+ * Description:
+ *   Return the hash bucket of the name 'name' (terminated by '\0' or '/')
+ *   below 'parent'.
+ *
+ ****************************************************************************/
+
+static FAR struct inode **inode_hashkey(FAR struct inode *parent,
+                                        FAR const char *name)
+{
+  uint32_t hash = 2166136261u ^ (uint32_t)((uintptr_t)parent >> 4);
+
+  /* FNV-1a over the name, seeded with the parent */
+
+  while (*name != '\0' && *name != '/')
+    {
+      hash = (hash ^ (uint8_t)*name++) * 16777619u;
+    }
+
+  return &g_inode_hash[(hash ^ (hash >> 16)) & INODE_HASH_MASK];
+}
+
+/****************************************************************************
+ * Name: inode_hashmatch
+ *
+ * Description:
+ *   Return true if the path segment 'name' equals the inode name.
+ *
+ ****************************************************************************/
+
+static bool inode_hashmatch(FAR const char *name, FAR struct inode *inode)
+{
+  FAR const char *nname = inode->i_name;
+
+  while (*nname != '\0' && *nname == *name)
+    {
+      nname++;
+      name++;
+    }
+
+  return *nname == '\0' && (*name == '\0' || *name == '/');
+}
+
+/****************************************************************************
+ * Name: inode_hashdel
+ *
+ * Description:
+ *   Remove one inode from its hash chain, if it is there.
+ *
+ ****************************************************************************/
+
+static void inode_hashdel(FAR struct inode *inode)
+{
+  FAR struct inode **curr;
+
+  curr = inode_hashkey(inode->i_parent, inode->i_name);
+  for (; *curr != NULL; curr = &(*curr)->i_hnext)
+    {
+      if (*curr == inode)
+        {
+          *curr = inode->i_hnext;
+          inode->i_hnext = NULL;
+          break;
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_hash_find
+ *
+ * Description:
+ *   Find the child of 'parent' named by the first segment of 'name'.
+ *
+ * Assumptions:
+ *   The caller holds the inode lock (read or write).
+ *
+ ****************************************************************************/
+
+FAR struct inode *inode_hash_find(FAR struct inode *parent,
+                                  FAR const char *name)
+{
+  FAR struct inode *inode = *inode_hashkey(parent, name);
+
+  for (; inode != NULL; inode = inode->i_hnext)
+    {
+      if (inode->i_parent == parent && inode_hashmatch(name, inode))
+        {
+          break;
+        }
+    }
+
+  return inode;
+}
+
+/****************************************************************************
+ * Name: inode_hash_add
+ *
+ * Description:
+ *   Add an inode to the hash index, inode->i_parent must be set.
+ *
+ * Assumptions:
+ *   The caller holds the inode write lock.
+ *
+ ****************************************************************************/
+
+void inode_hash_add(FAR struct inode *inode)
+{
+  FAR struct inode **head;
+
+  DEBUGASSERT(inode->i_parent != NULL);
+
+  head = inode_hashkey(inode->i_parent, inode->i_name);
+  inode->i_hnext = *head;
+  *head = inode;
+}
+
+/****************************************************************************
+ * Name: inode_hash_remove
+ *
+ * Description:
+ *   Remove an inode and the subtree below it from the hash index.  Only
+ *   the children still parented by an inode are visited, the children
+ *   already moved to another inode by rename are left alone.
+ *
+ * Assumptions:
+ *   The caller holds the inode write lock.
+ *
+ ****************************************************************************/
+
+void inode_hash_remove(FAR struct inode *inode)
+{
+  FAR struct inode *child;
+
+  for (child = inode->i_child; child != NULL; child = child->i_peer)
+    {
+      if (child->i_parent == inode)
+        {
+          inode_hash_remove(child);
+        }
+    }
+
+  if (inode->i_parent != NULL)
+    {
+      inode_hashdel(inode);
+    }
+}
+
+/****************************************************************************
+ * Name: inode_hash_reparent
+ *
+ * Description:
+ *   Hash the children of 'parent' again after they have been moved below
+ *   it, as rename does.
+ *
+ * Assumptions:
+ *   The caller holds the inode write lock.
+ *
+ ****************************************************************************/
+
+void inode_hash_reparent(FAR struct inode *parent)
+{
+  FAR struct inode *child;
+
+  for (child = parent->i_child; child != NULL; child = child->i_peer)
+    {
+      if (child->i_parent != NULL)
+        {
+          inode_hashdel(child);
+        }
+
+      child->i_parent = parent;
+      inode_hash_add(child);
+    }
+}
+
+#endif /* CONFIG_FS_INODE_HASH */
@@ -79,6 +79,24 @@ static FAR struct inode *inode_unlink(FAR const char *path)
       inode = desc.node;
       DEBUGASSERT(inode != NULL);
 
+#ifdef CONFIG_FS_INODE_HASH
+      /* inode_search() doesn't return the left peer when it uses the hash
+       * index, look for it among the peers.
+       */
+
+      if (desc.parent != NULL)
+        {
+          FAR struct inode *curr = desc.parent->i_child;
+
+          for (; curr != inode; curr = curr->i_peer)
+            {
+              desc.peer = curr;
+            }
+
+          inode_hash_remove(inode);
+        }
+#endif
+
       /* If peer is non-null, then remove the node from the right of
        * of that peer node.
        */
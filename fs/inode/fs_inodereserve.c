@@ -28,6 +28,7 @@
 
 #include <assert.h>
 #include <errno.h>
+#include <string.h>
 
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
@@ -109,6 +110,27 @@ static void inode_insert(FAR struct inode *inode,
                          FAR struct inode *peer,
                          FAR struct inode *parent)
 {
+#ifdef CONFIG_FS_INODE_HASH
+  FAR struct inode *curr;
+
+  /* inode_search() doesn't return the left peer when it uses the hash
+   * index, find the place that keeps the peers sorted here.
+   */
+
+  DEBUGASSERT(parent != NULL);
+
+  peer = NULL;
+  for (curr = parent->i_child; curr != NULL; curr = curr->i_peer)
+    {
+      if (strcmp(curr->i_name, inode->i_name) > 0)
+        {
+          break;
+        }
+
+      peer = curr;
+    }
+#endif
+
   /* If peer is non-null, then new node simply goes to the right
    * of that peer node.
    */
@@ -129,6 +151,10 @@ static void inode_insert(FAR struct inode *inode,
       inode->i_parent = parent;
       parent->i_child = inode;
     }
+
+#ifdef CONFIG_FS_INODE_HASH
+  inode_hash_add(inode);
+#endif
 }
 
 /****************************************************************************
@@ -242,7 +242,28 @@ static int _inode_search(FAR struct inode_search_s *desc)
 
   while (inode != NULL)
     {
-      int result = _inode_compare(name, inode);
+      int result;
+
+#ifdef CONFIG_FS_INODE_HASH
+      /* Below the root, find the child of 'above' in the hash index
+       * instead of walking its peers.  'left' is not tracked then.
+       */
+
+      if (above != NULL)
+        {
+          inode = inode_hash_find(above, name);
+          if (inode == NULL)
+            {
+              break;
+            }
+
+          result = 0;
+        }
+      else
+#endif
+        {
+          result = _inode_compare(name, inode);
+        }
 
       /* Case 1:  The name is less than the name of the node.
        * Since the names are ordered, these means that there
@@ -100,7 +100,8 @@
  *  node     - INPUT:  (not used)
  *             OUTPUT: On success, holds the pointer to the inode found.
  *  peer     - INPUT:  (not used)
- *             OUTPUT: The inode to the "left" of the inode found.
+ *             OUTPUT: The inode to the "left" of the inode found.  Not
+ *                     set below the root with CONFIG_FS_INODE_HASH.
  *  parent   - INPUT:  (not used)
  *             OUTPUT: The inode to the "above" of the inode found.
  *  relpath  - INPUT:  (not used)
@@ -388,6 +389,27 @@ int inode_reserve(FAR const char *path,
 
 int inode_remove(FAR const char *path);
 
+/****************************************************************************
+ * Name: inode_hash_find/add/remove/reparent
+ *
+ * Description:
+ *   Maintain and query the index of the inodes hashed by parent and name.
+ *   inode_search() uses it to find a child without walking its peers.
+ *
+ * Assumptions:
+ *   The caller must hold the inode semaphore, for writing unless only
+ *   searching.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_INODE_HASH
+FAR struct inode *inode_hash_find(FAR struct inode *parent,
+                                  FAR const char *name);
+void inode_hash_add(FAR struct inode *inode);
+void inode_hash_remove(FAR struct inode *inode);
+void inode_hash_reparent(FAR struct inode *parent);
+#endif
+
 /****************************************************************************
  * Name: inode_addref
  *
@@ -56,6 +56,7 @@
  * External Definitions
  ****************************************************************************/
 
+extern const struct procfs_operations g_blockcache_operations;
 extern const struct procfs_operations g_clk_operations;
 extern const struct procfs_operations g_cpuinfo_operations;
 extern const struct procfs_operations g_cpuload_operations;
@@ -125,6 +126,10 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "fdt",          &g_fdt_operations,      PROCFS_FILE_TYPE   },
 #endif
 
+#if defined(CONFIG_FS_BLOCKCACHE) && !defined(CONFIG_FS_PROCFS_EXCLUDE_BLOCKCACHE)
+  { "fs/blockcache", &g_blockcache_operations, PROCFS_FILE_TYPE },
+#endif
+
 #ifndef CONFIG_FS_PROCFS_EXCLUDE_BLOCKS
   { "fs/blocks",    &g_mount_operations,    PROCFS_FILE_TYPE   },
 #endif
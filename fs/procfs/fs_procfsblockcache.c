@@ -0,0 +1,328 @@
+/****************************************************************************
+ * fs/procfs/fs_procfsblockcache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <nuttx/debug.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#include "driver/driver.h"
+#include "fs_heap.h"
+
+#if defined(CONFIG_FS_PROCFS) && defined(CONFIG_FS_BLOCKCACHE) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_BLOCKCACHE)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define BLOCKCACHE_LINELEN 128
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct blockcache_file_s
+{
+  struct procfs_file_s base;      /* Base open file structure */
+  char line[BLOCKCACHE_LINELEN];  /* Buffer for formatted lines */
+};
+
+/* State of one read() call while walking the caches */
+
+struct blockcache_read_s
+{
+  FAR struct blockcache_file_s *procfile;
+  FAR char *buffer;               /* Remaining user buffer */
+  size_t buflen;                  /* Size of the remaining user buffer */
+  off_t offset;                   /* File offset still to skip */
+  size_t totalsize;               /* Number of bytes returned so far */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     blockcache_open(FAR struct file *filep,
+                 FAR const char *relpath, int oflags, mode_t mode);
+static int     blockcache_close(FAR struct file *filep);
+static ssize_t blockcache_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     blockcache_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     blockcache_stat(FAR const char *relpath,
+                 FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations g_blockcache_operations =
+{
+  blockcache_open,   /* open */
+  blockcache_close,  /* close */
+  blockcache_read,   /* read */
+  NULL,              /* write */
+  NULL,              /* poll */
+  blockcache_dup,    /* dup */
+  NULL,              /* opendir */
+  NULL,              /* closedir */
+  NULL,              /* readdir */
+  NULL,              /* rewinddir */
+  blockcache_stat    /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: blockcache_copy
+ ****************************************************************************/
+
+static void blockcache_copy(FAR struct blockcache_read_s *state,
+                            size_t linesize)
+{
+  size_t copysize;
+
+  copysize = procfs_memcpy(state->procfile->line, linesize, state->buffer,
+                           state->buflen, &state->offset);
+
+  state->buffer    += copysize;
+  state->buflen    -= copysize;
+  state->totalsize += copysize;
+}
+
+/****************************************************************************
+ * Name: blockcache_entry
+ *
+ * Description:
+ *   Format the statistics of one cache.
+ *
+ ****************************************************************************/
+
+static void blockcache_entry(FAR const struct blockcache_info_s *info,
+                             FAR void *arg)
+{
+  FAR struct blockcache_read_s *state = arg;
+  uint32_t total = info->hits + info->misses;
+  size_t linesize;
+
+  linesize = procfs_snprintf(state->procfile->line, BLOCKCACHE_LINELEN,
+                             "%-12s%8zu%8zu%8zu%11" PRIu32 "%11" PRIu32
+                             "%5" PRIu32 "%%%11" PRIu32 "%11" PRIu32
+                             "%11" PRIu32 "\n",
+                             info->name, (size_t)info->sectorsize,
+                             info->nblocks, info->ndirty, info->hits,
+                             info->misses,
+                             total > 0 ? (uint32_t)
+                             ((uint64_t)info->hits * 100 / total) : 0,
+                             info->readahead, info->wbwrites,
+                             info->wbsectors);
+
+  blockcache_copy(state, linesize);
+}
+
+/****************************************************************************
+ * Name: blockcache_open
+ ****************************************************************************/
+
+static int blockcache_open(FAR struct file *filep, FAR const char *relpath,
+                           int oflags, mode_t mode)
+{
+  FAR struct blockcache_file_s *procfile;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  procfile = (FAR struct blockcache_file_s *)
+    fs_heap_zalloc(sizeof(struct blockcache_file_s));
+  if (!procfile)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)procfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: blockcache_close
+ ****************************************************************************/
+
+static int blockcache_close(FAR struct file *filep)
+{
+  FAR struct blockcache_file_s *procfile;
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = (FAR struct blockcache_file_s *)filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  /* Release the file attributes structure */
+
+  fs_heap_free(procfile);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: blockcache_read
+ ****************************************************************************/
+
+static ssize_t blockcache_read(FAR struct file *filep, FAR char *buffer,
+                               size_t buflen)
+{
+  struct blockcache_read_s state;
+  size_t linesize;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  DEBUGASSERT(buffer != NULL && buflen > 0);
+
+  /* Recover our private data from the struct file instance */
+
+  state.procfile  = (FAR struct blockcache_file_s *)filep->f_priv;
+  state.buffer    = buffer;
+  state.buflen    = buflen;
+  state.offset    = filep->f_pos;
+  state.totalsize = 0;
+  DEBUGASSERT(state.procfile);
+
+  /* The first line is the headers, then one line per cached device */
+
+  linesize = procfs_snprintf(state.procfile->line, BLOCKCACHE_LINELEN,
+                             "%-12s%8s%8s%8s%11s%11s%6s%11s%11s%11s\n",
+                             "device", "secsize", "nblocks", "ndirty",
+                             "hits", "misses", "hit", "readahead",
+                             "wbwrites", "wbsectors");
+  blockcache_copy(&state, linesize);
+
+  blockcache_foreach(blockcache_entry, &state);
+
+  /* Update the file offset */
+
+  filep->f_pos += state.totalsize;
+  return state.totalsize;
+}
+
+/****************************************************************************
+ * Name: blockcache_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int blockcache_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct blockcache_file_s *oldattr;
+  FAR struct blockcache_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct blockcache_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = (FAR struct blockcache_file_s *)
+    fs_heap_malloc(sizeof(struct blockcache_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct blockcache_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: blockcache_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int blockcache_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "fs/blockcache" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+#endif /* CONFIG_FS_PROCFS && CONFIG_FS_BLOCKCACHE &&
+        * !CONFIG_FS_PROCFS_EXCLUDE_BLOCKCACHE */
@@ -45,6 +45,7 @@
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/procfs.h>
 #include <nuttx/sched.h>
+#include <nuttx/semaphore.h>
 
 #include "fs_heap.h"
 
@@ -360,6 +361,96 @@ static ssize_t critmon_read_cpu(FAR struct critmon_file_s *attr,
   return totalsize;
 }
 
+/****************************************************************************
+ * Name: critmon_read_site
+ ****************************************************************************/
+
+#if CONFIG_SCHED_CRITMONITOR_CSECTION_SITES > 0
+static ssize_t critmon_read_site(FAR struct critmon_file_s *attr,
+                                 FAR char *buffer, size_t buflen,
+                                 FAR off_t *offset,
+                                 FAR const struct critmon_site_s *site)
+{
+  struct timespec ts;
+  clock_t times[3];
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+  int i;
+
+  /* Generate output for the call site and its number of entries */
+
+  linesize = procfs_snprintf(attr->line, CRITMON_LINELEN,
+                             "cs %p,%" PRIu32 ",%" PRIu32,
+                             site->caller, site->count, site->contended);
+  copysize = procfs_memcpy(attr->line, linesize, buffer, buflen, offset);
+
+  totalsize = copysize;
+  buffer   += copysize;
+  buflen   -= copysize;
+
+  /* Then the total waiting, total holding and max holding time */
+
+  times[0] = site->wait;
+  times[1] = site->hold;
+  times[2] = site->hold_max;
+
+  for (i = 0; i < 3 && buflen > 0; i++)
+    {
+      perf_convert(times[i], &ts);
+      linesize = procfs_snprintf(attr->line, CRITMON_LINELEN, ",%lu.%09lu",
+                                 (unsigned long)ts.tv_sec,
+                                 (unsigned long)ts.tv_nsec);
+      copysize = procfs_memcpy(attr->line, linesize, buffer, buflen,
+                               offset);
+
+      totalsize += copysize;
+      buffer    += copysize;
+      buflen    -= copysize;
+    }
+
+  if (buflen <= 0)
+    {
+      return totalsize;
+    }
+
+  linesize = procfs_snprintf(attr->line, CRITMON_LINELEN, "\n");
+  copysize = procfs_memcpy(attr->line, linesize, buffer, buflen, offset);
+
+  totalsize += copysize;
+
+  return totalsize;
+}
+#endif
+
+/****************************************************************************
+ * Name: critmon_read_spin
+ ****************************************************************************/
+
+#ifdef CONFIG_SEM_ADAPTIVE_SPIN_STATS
+static ssize_t critmon_read_spin(FAR struct critmon_file_s *attr,
+                                 FAR char *buffer, size_t buflen,
+                                 FAR off_t *offset, int cpu)
+{
+  FAR struct nxsem_spinstat_s *stat = &g_nxsem_spinstat[cpu];
+  struct timespec ts;
+  size_t linesize;
+
+  /* Generate output for the CPU, the number of spins on a mutex, how many
+   * of them acquired it and the total time spent spinning.
+   */
+
+  perf_convert(stat->time, &ts);
+  linesize = procfs_snprintf(attr->line, CRITMON_LINELEN,
+                             "spin %d,%" PRIu32 ",%" PRIu32 ",%" PRIu32
+                             ",%lu.%09lu\n", cpu, stat->spins,
+                             stat->acquired, stat->blocked,
+                             (unsigned long)ts.tv_sec,
+                             (unsigned long)ts.tv_nsec);
+  return procfs_memcpy(attr->line, linesize, buffer, buflen, offset);
+}
+#endif
+
 /****************************************************************************
  * Name: critmon_read
  ****************************************************************************/
@@ -371,6 +462,9 @@ static ssize_t critmon_read(FAR struct file *filep, FAR char *buffer,
   off_t offset;
   ssize_t ret;
   int cpu;
+#if CONFIG_SCHED_CRITMONITOR_CSECTION_SITES > 0
+  int i;
+#endif
 
   finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
 
@@ -396,6 +490,30 @@ static ssize_t critmon_read(FAR struct file *filep, FAR char *buffer,
         }
     }
 
+#if CONFIG_SCHED_CRITMONITOR_CSECTION_SITES > 0
+  /* Then the use of the global critical section by call site */
+
+  for (i = 0; i < CONFIG_SCHED_CRITMONITOR_CSECTION_SITES &&
+              ret < buflen; i++)
+    {
+      if (g_crit_sites[i].caller != NULL)
+        {
+          ret += critmon_read_site(attr, buffer + ret, buflen - ret,
+                                   &offset, &g_crit_sites[i]);
+        }
+    }
+#endif
+
+#ifdef CONFIG_SEM_ADAPTIVE_SPIN_STATS
+  /* Then the adaptive spinning on mutexes for each CPU */
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS && ret < buflen; cpu++)
+    {
+      ret += critmon_read_spin(attr, buffer + ret, buflen - ret,
+                               &offset, cpu);
+    }
+#endif
+
   if (ret > 0)
     {
       filep->f_pos += ret;
@@ -28,6 +28,8 @@
 
 #include <sys/stat.h>
 #include <sys/statfs.h>
+#include <sys/param.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
 #include <fcntl.h>
@@ -58,6 +60,26 @@
 #  warning CONFIG_FS_TMPFS_FILE_FREEGUARD needs to be > ALLOCGUARD
 #endif
 
+#ifdef CONFIG_FS_TMPFS_PAGED
+#  if (CONFIG_FS_TMPFS_PAGESIZE & (CONFIG_FS_TMPFS_PAGESIZE - 1)) != 0
+#    error CONFIG_FS_TMPFS_PAGESIZE must be a power of two
+#  endif
+
+/* The page table grows in units of this many entries */
+
+#  define TMPFS_PAGETABLE_ALIGN 8
+#endif
+
+#ifdef CONFIG_FS_TMPFS_DIRECTORY_HASH
+/* Hash table sizing.  The table is rebuilt with more buckets when the
+ * average chain length exceeds TMPFS_HASH_LOAD.
+ */
+
+#  define TMPFS_HASH_MINBUCKETS 16
+#  define TMPFS_HASH_MAXBUCKETS 32768
+#  define TMPFS_HASH_LOAD       2
+#endif
+
 #define tmpfs_lock(fs) \
            nxrmutex_lock(&fs->tfs_lock)
 #define tmpfs_lock_object(to) \
@@ -96,11 +118,28 @@ static int  tmpfs_realloc_directory(FAR struct tmpfs_directory_s *tdo,
               unsigned int nentries);
 static int  tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
               size_t newsize);
+#ifdef CONFIG_FS_TMPFS_PAGED
+static void tmpfs_copy_pages(FAR struct tmpfs_file_s *tfo, size_t pos,
+              FAR uint8_t *buffer, size_t len, bool towrite);
+static int  tmpfs_coalesce_pages(FAR struct tmpfs_file_s *tfo);
+static FAR uint8_t *tmpfs_map_pages(FAR struct tmpfs_file_s *tfo,
+              size_t offset, size_t length);
+#endif
+#ifdef CONFIG_FS_TMPFS_DIRECTORY_HASH
+static uint32_t tmpfs_hash_name(FAR const char *name, size_t len);
+static void tmpfs_hash_link(FAR struct tmpfs_directory_s *tdo,
+              unsigned int index);
+static void tmpfs_hash_unlink(FAR struct tmpfs_directory_s *tdo,
+              unsigned int index);
+static void tmpfs_hash_rebuild(FAR struct tmpfs_directory_s *tdo);
+#endif
 static void tmpfs_release_lockedobject(FAR struct tmpfs_object_s *to);
 static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo);
 static int  tmpfs_release_file(FAR struct tmpfs_file_s *tfo);
 static int  tmpfs_find_dirent(FAR struct tmpfs_directory_s *tdo,
               FAR const char *name, size_t len);
+static void tmpfs_free_dirent(FAR struct tmpfs_directory_s *tdo,
+              unsigned int index);
 static int  tmpfs_remove_dirent(FAR struct tmpfs_directory_s *tdo,
               FAR const char *name);
 static int  tmpfs_add_dirent(FAR struct tmpfs_directory_s *tdo,
@@ -272,6 +311,127 @@ static int tmpfs_realloc_directory(FAR struct tmpfs_directory_s *tdo,
  * Name: tmpfs_realloc_file
  ****************************************************************************/
 
+#ifdef CONFIG_FS_TMPFS_PAGED
+static int tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
+                              size_t newsize)
+{
+  FAR uint8_t **newpages;
+  unsigned int maxpages;
+  unsigned int npages;
+  unsigned int i;
+  size_t offset;
+
+  if (newsize > SIZE_MAX - TMPFS_PAGE_MASK)
+    {
+      return -ENOMEM;
+    }
+
+  /* Free the pages beyond the new end of the file.  Pages that are part
+   * of the extent cannot be freed individually, they are kept for reuse.
+   */
+
+  npages = TMPFS_NPAGES(newsize);
+  while (tfo->tfo_npages > npages)
+    {
+      if (--tfo->tfo_npages >= tfo->tfo_nextent)
+        {
+          fs_heap_free(tfo->tfo_pages[tfo->tfo_npages]);
+        }
+    }
+
+  /* The part of the last page beyond the end of the file is always kept
+   * zeroed so that the file can be extended again without clearing it.
+   */
+
+  offset = newsize & TMPFS_PAGE_MASK;
+  if (newsize < tfo->tfo_size && offset != 0)
+    {
+      memset(tfo->tfo_pages[npages - 1] + offset, 0,
+             TMPFS_PAGE_SIZE - offset);
+    }
+
+  if (npages == 0)
+    {
+      /* Free the page table, and the extent unless it is still mapped */
+
+      fs_heap_free(tfo->tfo_pages);
+      tfo->tfo_pages    = NULL;
+      tfo->tfo_maxpages = 0;
+
+      if (tfo->tfo_nmaps == 0)
+        {
+          fs_heap_free(tfo->tfo_extent);
+          tfo->tfo_extent  = NULL;
+          tfo->tfo_nextent = 0;
+        }
+    }
+  else if (npages > tfo->tfo_maxpages)
+    {
+      /* Grow the page table.  Only the table is reallocated, the existing
+       * pages never move.
+       */
+
+      maxpages = (npages + TMPFS_PAGETABLE_ALIGN - 1) &
+                 ~(TMPFS_PAGETABLE_ALIGN - 1);
+      newpages = fs_heap_realloc(tfo->tfo_pages,
+                                 maxpages * sizeof(FAR uint8_t *));
+      if (newpages == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      tfo->tfo_pages    = newpages;
+      tfo->tfo_maxpages = maxpages;
+    }
+
+  /* An empty file that grows by more than one page, typically written or
+   * truncated to its final size in one go, gets all of its pages in one
+   * contiguous extent so that it can be mapped in place.  If that fails,
+   * fall back to single pages.
+   */
+
+  if (tfo->tfo_npages == 0 && tfo->tfo_nextent == 0 && npages > 1)
+    {
+      tfo->tfo_extent = fs_heap_zalloc((size_t)npages * TMPFS_PAGE_SIZE);
+      if (tfo->tfo_extent != NULL)
+        {
+          tfo->tfo_nextent = npages;
+        }
+    }
+
+  /* Allocate zeroed pages up to the new end of the file */
+
+  for (i = tfo->tfo_npages; i < npages; i++)
+    {
+      if (i < tfo->tfo_nextent)
+        {
+          tfo->tfo_pages[i] = tfo->tfo_extent +
+                              (size_t)i * TMPFS_PAGE_SIZE;
+          memset(tfo->tfo_pages[i], 0, TMPFS_PAGE_SIZE);
+          continue;
+        }
+
+      tfo->tfo_pages[i] = fs_heap_zalloc(TMPFS_PAGE_SIZE);
+      if (tfo->tfo_pages[i] == NULL)
+        {
+          while (i > tfo->tfo_npages)
+            {
+              if (--i >= tfo->tfo_nextent)
+                {
+                  fs_heap_free(tfo->tfo_pages[i]);
+                }
+            }
+
+          return -ENOMEM;
+        }
+    }
+
+  tfo->tfo_npages = npages;
+  tfo->tfo_alloc  = (size_t)npages * TMPFS_PAGE_SIZE;
+  tfo->tfo_size   = newsize;
+  return OK;
+}
+#else
 static int tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
                               size_t newsize)
 {
@@ -345,6 +505,230 @@ static int tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
   tfo->tfo_data  = newdata;
   return OK;
 }
+#endif
+
+#ifdef CONFIG_FS_TMPFS_PAGED
+/****************************************************************************
+ * Name: tmpfs_copy_pages
+ *
+ * Description:
+ *   Copy data between a buffer and the file pages.  The range must lie
+ *   within the allocated pages.
+ *
+ ****************************************************************************/
+
+static void tmpfs_copy_pages(FAR struct tmpfs_file_s *tfo, size_t pos,
+                             FAR uint8_t *buffer, size_t len, bool towrite)
+{
+  FAR uint8_t *page;
+  size_t offset;
+  size_t ncopy;
+
+  while (len > 0)
+    {
+      offset = pos & TMPFS_PAGE_MASK;
+      ncopy  = MIN(len, TMPFS_PAGE_SIZE - offset);
+      page   = tfo->tfo_pages[pos / TMPFS_PAGE_SIZE] + offset;
+
+      if (towrite)
+        {
+          memcpy(page, buffer, ncopy);
+        }
+      else
+        {
+          memcpy(buffer, page, ncopy);
+        }
+
+      buffer += ncopy;
+      pos    += ncopy;
+      len    -= ncopy;
+    }
+}
+
+/****************************************************************************
+ * Name: tmpfs_coalesce_pages
+ *
+ * Description:
+ *   Move all pages of the file into one new contiguous extent.  This must
+ *   not be done while any page is mapped in place.  The file must be
+ *   locked.
+ *
+ ****************************************************************************/
+
+static int tmpfs_coalesce_pages(FAR struct tmpfs_file_s *tfo)
+{
+  FAR uint8_t *extent;
+  unsigned int i;
+
+  DEBUGASSERT(tfo->tfo_nmaps == 0 && tfo->tfo_npages > 0);
+
+  extent = fs_heap_malloc((size_t)tfo->tfo_npages * TMPFS_PAGE_SIZE);
+  if (extent == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  for (i = 0; i < tfo->tfo_npages; i++)
+    {
+      memcpy(extent + (size_t)i * TMPFS_PAGE_SIZE, tfo->tfo_pages[i],
+             TMPFS_PAGE_SIZE);
+      if (i >= tfo->tfo_nextent)
+        {
+          fs_heap_free(tfo->tfo_pages[i]);
+        }
+
+      tfo->tfo_pages[i] = extent + (size_t)i * TMPFS_PAGE_SIZE;
+    }
+
+  fs_heap_free(tfo->tfo_extent);
+  tfo->tfo_extent  = extent;
+  tfo->tfo_nextent = tfo->tfo_npages;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: tmpfs_map_pages
+ *
+ * Description:
+ *   Return the address of the file data at 'offset' if the 'length' bytes
+ *   from there can be held in physically contiguous pages, or NULL if
+ *   they cannot.  If the pages are scattered and nothing is mapped in
+ *   place yet, the file is first moved into one contiguous extent; it then
+ *   stays there for later mappings.  The file must be locked.
+ *
+ ****************************************************************************/
+
+static FAR uint8_t *tmpfs_map_pages(FAR struct tmpfs_file_s *tfo,
+                                    size_t offset, size_t length)
+{
+  unsigned int first = offset / TMPFS_PAGE_SIZE;
+  unsigned int last = (offset + length - 1) / TMPFS_PAGE_SIZE;
+  unsigned int i;
+
+  DEBUGASSERT(length > 0 && last < tfo->tfo_npages);
+
+  for (i = first; i < last; i++)
+    {
+      if (tfo->tfo_pages[i] + TMPFS_PAGE_SIZE != tfo->tfo_pages[i + 1])
+        {
+          /* Moving the pages would break the existing mappings */
+
+          if (tfo->tfo_nmaps > 0 || tmpfs_coalesce_pages(tfo) < 0)
+            {
+              return NULL;
+            }
+
+          break;
+        }
+    }
+
+  return tfo->tfo_pages[first] + (offset & TMPFS_PAGE_MASK);
+}
+#endif
+
+#ifdef CONFIG_FS_TMPFS_DIRECTORY_HASH
+/****************************************************************************
+ * Name: tmpfs_hash_name
+ ****************************************************************************/
+
+static uint32_t tmpfs_hash_name(FAR const char *name, size_t len)
+{
+  uint32_t hash = 2166136261u;
+
+  /* 32-bit FNV-1a */
+
+  while (len-- > 0)
+    {
+      hash ^= (uint8_t)*name++;
+      hash *= 16777619u;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: tmpfs_hash_link
+ ****************************************************************************/
+
+static void tmpfs_hash_link(FAR struct tmpfs_directory_s *tdo,
+                            unsigned int index)
+{
+  FAR struct tmpfs_dirent_s *tde = &tdo->tdo_entry[index];
+  FAR uint16_t *bucket;
+
+  bucket        = &tdo->tdo_hash[tde->tde_hash & (tdo->tdo_nbuckets - 1)];
+  tde->tde_next = *bucket;
+  *bucket       = index;
+}
+
+/****************************************************************************
+ * Name: tmpfs_hash_unlink
+ ****************************************************************************/
+
+static void tmpfs_hash_unlink(FAR struct tmpfs_directory_s *tdo,
+                              unsigned int index)
+{
+  FAR struct tmpfs_dirent_s *tde = &tdo->tdo_entry[index];
+  FAR uint16_t *link;
+
+  if (tdo->tdo_hash == NULL)
+    {
+      return;
+    }
+
+  link = &tdo->tdo_hash[tde->tde_hash & (tdo->tdo_nbuckets - 1)];
+  while (*link != index)
+    {
+      DEBUGASSERT(*link != TMPFS_HASH_NONE);
+      link = &tdo->tdo_entry[*link].tde_next;
+    }
+
+  *link = tde->tde_next;
+}
+
+/****************************************************************************
+ * Name: tmpfs_hash_rebuild
+ *
+ * Description:
+ *   Resize the bucket table for the current number of entries and relink
+ *   every entry.  If memory cannot be allocated, the table is dropped and
+ *   lookups fall back to a linear search until the next rebuild.
+ *
+ ****************************************************************************/
+
+static void tmpfs_hash_rebuild(FAR struct tmpfs_directory_s *tdo)
+{
+  FAR uint16_t *newhash;
+  unsigned int nbuckets = TMPFS_HASH_MINBUCKETS;
+  unsigned int i;
+
+  while (nbuckets < tdo->tdo_nentries && nbuckets < TMPFS_HASH_MAXBUCKETS)
+    {
+      nbuckets <<= 1;
+    }
+
+  if (nbuckets != tdo->tdo_nbuckets || tdo->tdo_hash == NULL)
+    {
+      newhash = fs_heap_realloc(tdo->tdo_hash, nbuckets * sizeof(uint16_t));
+      if (newhash == NULL)
+        {
+          fs_heap_free(tdo->tdo_hash);
+          tdo->tdo_hash     = NULL;
+          tdo->tdo_nbuckets = 0;
+          return;
+        }
+
+      tdo->tdo_hash     = newhash;
+      tdo->tdo_nbuckets = nbuckets;
+    }
+
+  memset(tdo->tdo_hash, 0xff, nbuckets * sizeof(uint16_t));
+  for (i = 0; i < tdo->tdo_nentries; i++)
+    {
+      tmpfs_hash_link(tdo, i);
+    }
+}
+#endif
 
 /****************************************************************************
  * Name: tmpfs_release_lockedobject
@@ -383,7 +767,7 @@ static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo)
     {
       tmpfs_unlock_file(tfo);
       nxrmutex_destroy(&tfo->tfo_lock);
-      fs_heap_free(tfo->tfo_data);
+      tmpfs_realloc_file(tfo, 0);
       fs_heap_free(tfo);
     }
 
@@ -425,6 +809,10 @@ static int tmpfs_release_file(FAR struct tmpfs_file_s *tfo)
 static int tmpfs_find_dirent(FAR struct tmpfs_directory_s *tdo,
                              FAR const char *name, size_t len)
 {
+#ifdef CONFIG_FS_TMPFS_DIRECTORY_HASH
+  FAR struct tmpfs_dirent_s *tde;
+  uint32_t hash;
+#endif
   int i;
 
   if (len == 0)
@@ -441,6 +829,29 @@ static int tmpfs_find_dirent(FAR struct tmpfs_directory_s *tdo,
         }
     }
 
+#ifdef CONFIG_FS_TMPFS_DIRECTORY_HASH
+  /* Search the hash chain for the name, if there is a hash table */
+
+  if (tdo->tdo_hash != NULL)
+    {
+      hash = tmpfs_hash_name(name, len);
+      for (i = tdo->tdo_hash[hash & (tdo->tdo_nbuckets - 1)];
+           i != TMPFS_HASH_NONE;
+           i = tde->tde_next)
+        {
+          tde = &tdo->tdo_entry[i];
+          if (tde->tde_hash == hash &&
+              strncmp(tde->tde_name, name, len) == 0 &&
+              tde->tde_name[len] == 0)
+            {
+              return i;
+            }
+        }
+
+      return -ENOENT;
+    }
+#endif
+
   /* Search the list of directory entries for a match */
 
   for (i = 0;
@@ -462,7 +873,6 @@ static int tmpfs_remove_dirent(FAR struct tmpfs_directory_s *tdo,
                                FAR const char *name)
 {
   int index;
-  int last;
 
   /* Search the list of directory entries for a match */
 
@@ -472,6 +882,24 @@ static int tmpfs_remove_dirent(FAR struct tmpfs_directory_s *tdo,
       return index;
     }
 
+  tmpfs_free_dirent(tdo, index);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: tmpfs_free_dirent
+ *
+ * Description:
+ *   Free the name of the directory entry at 'index' and remove the entry by
+ *   replacing it with the final directory entry.
+ *
+ ****************************************************************************/
+
+static void tmpfs_free_dirent(FAR struct tmpfs_directory_s *tdo,
+                              unsigned int index)
+{
+  unsigned int last;
+
   /* Free the object name */
 
   if (tdo->tdo_entry[index].tde_name != NULL)
@@ -482,15 +910,29 @@ static int tmpfs_remove_dirent(FAR struct tmpfs_directory_s *tdo,
   /* Remove by replacing this entry with the final directory entry */
 
   last = tdo->tdo_nentries - 1;
+
+#ifdef CONFIG_FS_TMPFS_DIRECTORY_HASH
+  tmpfs_hash_unlink(tdo, index);
+  if (index != last)
+    {
+      tmpfs_hash_unlink(tdo, last);
+    }
+#endif
+
   if (index != last)
     {
       tdo->tdo_entry[index] = tdo->tdo_entry[last];
+#ifdef CONFIG_FS_TMPFS_DIRECTORY_HASH
+      if (tdo->tdo_hash != NULL)
+        {
+          tmpfs_hash_link(tdo, index);
+        }
+#endif
     }
 
   /* And decrement the count of directory entries */
 
   tdo->tdo_nentries = last;
-  return OK;
 }
 
 /****************************************************************************
@@ -552,6 +994,23 @@ static int tmpfs_add_dirent(FAR struct tmpfs_directory_s *tdo,
   tde->tde_object = to;
   tde->tde_name   = newname;
 
+#ifdef CONFIG_FS_TMPFS_DIRECTORY_HASH
+  /* Add the new entry to the hash index, growing the index if the chains
+   * are getting too long.
+   */
+
+  tde->tde_hash   = tmpfs_hash_name(newname, namelen);
+  if (tdo->tdo_hash == NULL ||
+      nentries > TMPFS_HASH_LOAD * tdo->tdo_nbuckets)
+    {
+      tmpfs_hash_rebuild(tdo);
+    }
+  else
+    {
+      tmpfs_hash_link(tdo, index);
+    }
+#endif
+
   return OK;
 }
 
@@ -582,7 +1041,16 @@ tmpfs_alloc_file(FAR struct tmpfs_directory_s *parent)
   tfo->tfo_parent = parent;
   tfo->tfo_flags  = 0;
   tfo->tfo_size   = 0;
+#ifdef CONFIG_FS_TMPFS_PAGED
+  tfo->tfo_npages   = 0;
+  tfo->tfo_maxpages = 0;
+  tfo->tfo_nextent  = 0;
+  tfo->tfo_nmaps    = 0;
+  tfo->tfo_pages    = NULL;
+  tfo->tfo_extent   = NULL;
+#else
   tfo->tfo_data   = NULL;
+#endif
 
   nxrmutex_init(&tfo->tfo_lock);
   tmpfs_lock_file(tfo);
@@ -732,6 +1200,10 @@ tmpfs_alloc_directory(FAR struct tmpfs_directory_s *parent)
   tdo->tdo_parent   = parent;
   tdo->tdo_nentries = 0;
   tdo->tdo_entry    = NULL;
+#ifdef CONFIG_FS_TMPFS_DIRECTORY_HASH
+  tdo->tdo_nbuckets = 0;
+  tdo->tdo_hash     = NULL;
+#endif
 
   nxrmutex_init(&tdo->tdo_lock);
 
@@ -1220,34 +1692,13 @@ static int tmpfs_statfs_callout(FAR struct tmpfs_directory_s *tdo,
 static int tmpfs_free_callout(FAR struct tmpfs_directory_s *tdo,
                               unsigned int index, FAR void *arg)
 {
-  FAR struct tmpfs_dirent_s *tde;
   FAR struct tmpfs_object_s *to;
   FAR struct tmpfs_file_s *tfo;
-  unsigned int last;
-
-  /* Free the object name */
-
-  if (tdo->tdo_entry[index].tde_name != NULL)
-    {
-      fs_heap_free(tdo->tdo_entry[index].tde_name);
-    }
-
-  /* Remove by replacing this entry with the final directory entry */
-
-  tde  = &tdo->tdo_entry[index];
-  to   = tde->tde_object;
-  last = tdo->tdo_nentries - 1;
 
-  if (index != last)
-    {
-      /* Move the directory entry */
+  /* Remove the directory entry and free its name */
 
-      *tde = tdo->tdo_entry[last];
-    }
-
-  /* And decrement the count of directory entries */
-
-  tdo->tdo_nentries = last;
+  to = tdo->tdo_entry[index].tde_object;
+  tmpfs_free_dirent(tdo, index);
 
   /* Is this directory entry a file object? */
 
@@ -1265,13 +1716,16 @@ static int tmpfs_free_callout(FAR struct tmpfs_directory_s *tdo,
           return TMPFS_UNLINKED;
         }
 
-      fs_heap_free(tfo->tfo_data);
+      tmpfs_realloc_file(tfo, 0);
     }
   else /* if (to->to_type == TMPFS_DIRECTORY) */
     {
       tdo = (FAR struct tmpfs_directory_s *)to;
 
       fs_heap_free(tdo->tdo_entry);
+#ifdef CONFIG_FS_TMPFS_DIRECTORY_HASH
+      fs_heap_free(tdo->tdo_hash);
+#endif
     }
 
   /* Free the object now */
@@ -1586,6 +2040,10 @@ static ssize_t tmpfs_read(FAR struct file *filep, FAR char *buffer,
 
   /* Copy data from the memory object to the user buffer */
 
+#ifdef CONFIG_FS_TMPFS_PAGED
+  tmpfs_copy_pages(tfo, startpos, (FAR uint8_t *)buffer, nread, false);
+  filep->f_pos += nread;
+#else
   if (tfo->tfo_data != NULL)
     {
       memcpy(buffer, &tfo->tfo_data[startpos], nread);
@@ -1595,6 +2053,7 @@ static ssize_t tmpfs_read(FAR struct file *filep, FAR char *buffer,
     {
       DEBUGASSERT(tfo->tfo_size == 0 && nread == 0);
     }
+#endif
 
   /* Release the lock on the file */
 
@@ -1656,8 +2115,11 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
         }
     }
 
-  /* Copy data from the memory object to the user buffer */
+  /* Copy data from the user buffer to the memory object */
 
+#ifdef CONFIG_FS_TMPFS_PAGED
+  tmpfs_copy_pages(tfo, startpos, (FAR uint8_t *)buffer, nwritten, true);
+#else
   if (tfo->tfo_data != NULL)
     {
       memcpy(&tfo->tfo_data[startpos], buffer, nwritten);
@@ -1666,6 +2128,7 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
     {
       DEBUGASSERT(tfo->tfo_size == 0 && nwritten == 0);
     }
+#endif
 
   filep->f_pos = endpos;
 
@@ -1753,6 +2216,11 @@ static int tmpfs_unmap(FAR struct task_group_s *group,
       ret = mm_map_remove(get_group_mm(group), entry);
       if (ret >= 0)
         {
+#ifdef CONFIG_FS_TMPFS_PAGED
+          tmpfs_lock_file(tfo);
+          tfo->tfo_nmaps--;
+          tmpfs_unlock_file(tfo);
+#endif
           ret = tmpfs_release_file(tfo);
         }
     }
@@ -1788,17 +2256,43 @@ static int tmpfs_mmap(FAR struct file *filep, FAR struct mm_map_entry_s *map)
   if (map->offset >= 0 && map->offset < tfo->tfo_size &&
       map->length && map->offset + map->length <= tfo->tfo_size)
     {
+#ifdef CONFIG_FS_TMPFS_PAGED
+      /* The pages can only be mapped in place if they are contiguous.
+       * Otherwise let the caller fall back to a copy of the file.  The
+       * mapping is counted before the lock is dropped so that the pages
+       * cannot be moved under it.
+       */
+
+      tmpfs_lock_file(tfo);
+      map->vaddr = tmpfs_map_pages(tfo, map->offset, map->length);
+      if (map->vaddr == NULL)
+        {
+          tmpfs_unlock_file(tfo);
+          return -ENOTTY;
+        }
+
+      tfo->tfo_nmaps++;
+      tmpfs_unlock_file(tfo);
+#else
       map->vaddr = tfo->tfo_data + map->offset;
+#endif
       map->priv.p = tfo;
       map->munmap = tmpfs_unmap;
       ret = mm_map_add(get_current_mm(), map);
 
+      tmpfs_lock_file(tfo);
       if (ret >= 0)
         {
-          tmpfs_lock_file(tfo);
           tfo->tfo_refs++;
-          tmpfs_unlock_file(tfo);
         }
+#ifdef CONFIG_FS_TMPFS_PAGED
+      else
+        {
+          tfo->tfo_nmaps--;
+        }
+#endif
+
+      tmpfs_unlock_file(tfo);
     }
 
   return ret;
@@ -1842,8 +2336,23 @@ static int tmpfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
     {
       FAR uintptr_t *ptr = (FAR uintptr_t *)arg;
 
+#ifdef CONFIG_FS_TMPFS_PAGED
+      /* There is only a base address if all pages are contiguous */
+
+      if (tfo->tfo_size == 0)
+        {
+          *ptr = 0;
+          return OK;
+        }
+
+      tmpfs_lock_file(tfo);
+      *ptr = (uintptr_t)tmpfs_map_pages(tfo, 0, tfo->tfo_size);
+      tmpfs_unlock_file(tfo);
+      return *ptr != 0 ? OK : -ENOTTY;
+#else
       *ptr = (uintptr_t)tfo->tfo_data;
       return OK;
+#endif
     }
 
   return ret;
@@ -1976,6 +2485,7 @@ static int tmpfs_truncate(FAR struct file *filep, off_t length)
           goto errout_with_lock;
         }
 
+#ifndef CONFIG_FS_TMPFS_PAGED
       /* If the size has increased, then we need to zero the newly added
        * memory.
        */
@@ -1984,6 +2494,7 @@ static int tmpfs_truncate(FAR struct file *filep, off_t length)
         {
           memset(&tfo->tfo_data[oldsize], 0, length - oldsize);
         }
+#endif
 
       ret = OK;
     }
@@ -2264,6 +2775,9 @@ static int tmpfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
 
   nxrmutex_destroy(&tdo->tdo_lock);
   fs_heap_free(tdo->tdo_entry);
+#ifdef CONFIG_FS_TMPFS_DIRECTORY_HASH
+  fs_heap_free(tdo->tdo_hash);
+#endif
   fs_heap_free(tdo);
 
   nxrmutex_destroy(&fs->tfs_lock);
@@ -2430,7 +2944,7 @@ static int tmpfs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
   else
     {
       nxrmutex_destroy(&tfo->tfo_lock);
-      fs_heap_free(tfo->tfo_data);
+      tmpfs_realloc_file(tfo, 0);
       fs_heap_free(tfo);
     }
 
@@ -2573,6 +3087,9 @@ static int tmpfs_rmdir(FAR struct inode *mountpt, FAR const char *relpath)
 
   nxrmutex_destroy(&tdo->tdo_lock);
   fs_heap_free(tdo->tdo_entry);
+#ifdef CONFIG_FS_TMPFS_DIRECTORY_HASH
+  fs_heap_free(tdo->tdo_hash);
+#endif
   fs_heap_free(tdo);
 
   /* Release the reference and lock on the parent directory */
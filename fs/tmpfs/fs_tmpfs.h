@@ -42,6 +42,20 @@
 
 #define TFO_FLAG_UNLINKED (1 << 0)  /* Bit 0: File is unlinked */
 
+#ifdef CONFIG_FS_TMPFS_PAGED
+/* File data is held in fixed size pages */
+
+#  define TMPFS_PAGE_SIZE     CONFIG_FS_TMPFS_PAGESIZE
+#  define TMPFS_PAGE_MASK     (TMPFS_PAGE_SIZE - 1)
+#  define TMPFS_NPAGES(s)     (((s) + TMPFS_PAGE_MASK) / TMPFS_PAGE_SIZE)
+#endif
+
+#ifdef CONFIG_FS_TMPFS_DIRECTORY_HASH
+/* End of a directory hash chain */
+
+#  define TMPFS_HASH_NONE     UINT16_MAX
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -70,6 +84,10 @@ struct tmpfs_dirent_s
 {
   FAR struct tmpfs_object_s *tde_object;
   FAR char *tde_name;
+#ifdef CONFIG_FS_TMPFS_DIRECTORY_HASH
+  uint32_t tde_hash;     /* Hash of tde_name */
+  uint16_t tde_next;     /* Next entry in the same hash chain */
+#endif
 };
 
 /* The generic form of a TMPFS memory object */
@@ -101,6 +119,10 @@ struct tmpfs_directory_s
 
   uint16_t tdo_nentries; /* Number of directory entries */
   FAR struct tmpfs_dirent_s *tdo_entry;
+#ifdef CONFIG_FS_TMPFS_DIRECTORY_HASH
+  uint16_t tdo_nbuckets; /* Number of hash buckets (power of two) */
+  FAR uint16_t *tdo_hash; /* Index of the first entry in each bucket */
+#endif
 };
 
 #define SIZEOF_TMPFS_DIRECTORY(n) ((n) * sizeof(struct tmpfs_dirent_s))
@@ -128,7 +150,16 @@ struct tmpfs_file_s
 
   uint8_t       tfo_flags; /* See TFO_FLAG_* definitions */
   size_t        tfo_size;  /* Valid file size */
+#ifdef CONFIG_FS_TMPFS_PAGED
+  unsigned int  tfo_npages;   /* Number of allocated pages */
+  unsigned int  tfo_maxpages; /* Number of slots in the page table */
+  unsigned int  tfo_nextent;  /* Number of pages in tfo_extent */
+  unsigned int  tfo_nmaps;    /* Number of in-place mappings */
+  FAR uint8_t **tfo_pages;    /* Page table */
+  FAR uint8_t  *tfo_extent;   /* Contiguous backing of the first pages */
+#else
   FAR uint8_t  *tfo_data;  /* File data starts here */
+#endif
 };
 
 /* This structure represents one instance of a TMPFS file system */
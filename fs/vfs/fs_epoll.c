@@ -42,20 +42,40 @@
 #include <nuttx/list.h>
 #include <nuttx/mutex.h>
 #include <nuttx/signal.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/tls.h>
 
 #include "inode/inode.h"
 #include "fs_heap.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if (CONFIG_FS_EPOLL_HASH_SIZE & (CONFIG_FS_EPOLL_HASH_SIZE - 1)) != 0
+#  error CONFIG_FS_EPOLL_HASH_SIZE must be a power of two
+#endif
+
+#define EPOLL_HASH_MASK     (CONFIG_FS_EPOLL_HASH_SIZE - 1)
+
+/* Epoll node states, identify the list holding a registered node */
+
+#define EPOLL_NODE_SETUP    0 /* Poll is setup, node in the setup list */
+#define EPOLL_NODE_TEARDOWN 1 /* Poll is torn down, node in teardown list */
+#define EPOLL_NODE_ONESHOT  2 /* Poll is torn down, node in oneshot list */
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
 struct epoll_node_s
 {
-  struct list_node         node;
+  struct list_node         node;     /* The list given by state, or free */
+  struct list_node         hnode;    /* The fd hash bucket */
+  struct list_node         rnode;    /* The ready list */
   epoll_data_t             data;
-  bool                     notified;
+  uint8_t                  state;    /* See EPOLL_NODE_* definitions */
+  bool                     ready;    /* True: node is in the ready list */
   struct pollfd            pfd;
   FAR struct file         *filep;
   FAR struct epoll_head_s *eph;
@@ -69,11 +89,18 @@ struct epoll_head_s
   int                   crefs;
   mutex_t               lock;
   sem_t                 sem;
+  spinlock_t            spinlock; /* Protect the ready list, it is updated
+                                   * from the poll callback.
+                                   */
+  struct list_node      ready;    /* The ready list, store all the setuped
+                                   * epoll node notified by the poll
+                                   * callback and not reported yet.
+                                   */
   struct list_node      setup;    /* The setup list, store all the setuped
                                    * epoll node.
                                    */
   struct list_node      teardown; /* The teardown list, store all the epoll
-                                   * node notified after epoll_wait finish,
+                                   * node reported by the last epoll_wait,
                                    * these epoll node should be setup again
                                    * to check the pending poll notification.
                                    */
@@ -90,6 +117,7 @@ struct epoll_head_s
                                    * first node, used to free the malloced
                                    * memory in epoll_do_close().
                                    */
+  struct list_node      hash[CONFIG_FS_EPOLL_HASH_SIZE]; /* Nodes by fd */
 };
 
 typedef struct epoll_head_s epoll_head_t;
@@ -250,16 +278,23 @@ static int epoll_do_create(int size, int flags)
   eph->size = size;
   nxmutex_init(&eph->lock);
   nxsem_init(&eph->sem, 0, 0);
+  spin_lock_init(&eph->spinlock);
 
   /* List initialize */
 
   epn = (FAR epoll_node_t *)(eph + 1);
 
+  list_initialize(&eph->ready);
   list_initialize(&eph->setup);
   list_initialize(&eph->teardown);
   list_initialize(&eph->oneshot);
   list_initialize(&eph->extend);
   list_initialize(&eph->free);
+  for (i = 0; i < CONFIG_FS_EPOLL_HASH_SIZE; i++)
+    {
+      list_initialize(&eph->hash[i]);
+    }
+
   for (i = 0; i < size; i++)
     {
       list_add_tail(&eph->free, &epn[i].node);
@@ -281,11 +316,146 @@ static int epoll_do_create(int size, int flags)
   return fd;
 }
 
+/****************************************************************************
+ * Name: epoll_find
+ *
+ * Description:
+ *   Find the epoll node registered for fd in the fd hash table.
+ *
+ * Input Parameters:
+ *   eph - The epoll head pointer
+ *   fd  - The file descriptor
+ *
+ * Returned Value:
+ *   The epoll node, or NULL if fd isn't registered.
+ *
+ ****************************************************************************/
+
+static FAR epoll_node_t *epoll_find(FAR epoll_head_t *eph, int fd)
+{
+  FAR epoll_node_t *epn;
+
+  list_for_every_entry(&eph->hash[fd & EPOLL_HASH_MASK], epn,
+                       epoll_node_t, hnode)
+    {
+      if (epn->pfd.fd == fd)
+        {
+          return epn;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: epoll_notify
+ *
+ * Description:
+ *   Wake up the epoll waiter, at most one count is kept in the semaphore.
+ *
+ ****************************************************************************/
+
+static void epoll_notify(FAR epoll_head_t *eph)
+{
+  int semcount = 0;
+
+  nxsem_get_value(&eph->sem, &semcount);
+  if (semcount < 1)
+    {
+      nxsem_post(&eph->sem);
+    }
+}
+
+/****************************************************************************
+ * Name: epoll_unready
+ *
+ * Description:
+ *   Remove the epoll node from the ready list if it is queued there.
+ *
+ ****************************************************************************/
+
+static void epoll_unready(FAR epoll_head_t *eph, FAR epoll_node_t *epn)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&eph->spinlock);
+  if (epn->ready)
+    {
+      list_delete(&epn->rnode);
+      epn->ready = false;
+    }
+
+  spin_unlock_irqrestore(&eph->spinlock, flags);
+}
+
+/****************************************************************************
+ * Name: epoll_arm
+ *
+ * Description:
+ *   Setup the poll of the epoll node and move it to the setup list.  The
+ *   poll callback queues the node to the ready list immediately if the
+ *   expected events are already pending.
+ *
+ * Input Parameters:
+ *   eph - The epoll head pointer
+ *   epn - The epoll node, its poll must be torn down
+ *
+ * Returned Value:
+ *   Zero on success, negative on fail.  The node is moved to the teardown
+ *   list on fail, so the setup is retried by the next epoll_wait().
+ *
+ ****************************************************************************/
+
+static int epoll_arm(FAR epoll_head_t *eph, FAR epoll_node_t *epn)
+{
+  int ret;
+
+  epn->pfd.revents = 0;
+  ret = file_poll(epn->filep, &epn->pfd, true);
+  list_delete(&epn->node);
+  if (ret < 0)
+    {
+      ferr("epoll setup failed, filep=%p, events=%08" PRIx32 ", "
+           "ret=%d\n", epn->filep, epn->pfd.events, ret);
+      epoll_unready(eph, epn);
+      epn->state = EPOLL_NODE_TEARDOWN;
+      list_add_tail(&eph->teardown, &epn->node);
+      return ret;
+    }
+
+  epn->state = EPOLL_NODE_SETUP;
+  list_add_tail(&eph->setup, &epn->node);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: epoll_disarm
+ *
+ * Description:
+ *   Teardown the poll of the epoll node and drop it from the ready list.
+ *   The caller moves the node to its new list.
+ *
+ ****************************************************************************/
+
+static void epoll_disarm(FAR epoll_head_t *eph, FAR epoll_node_t *epn)
+{
+  if (epn->state == EPOLL_NODE_SETUP)
+    {
+      file_poll(epn->filep, &epn->pfd, false);
+    }
+
+  /* The callback may queue the node again until the poll is torn down */
+
+  epoll_unready(eph, epn);
+  list_delete(&epn->node);
+}
+
 /****************************************************************************
  * Name: epoll_setup
  *
  * Description:
- *   Setup all the fd.
+ *   Setup all the fd reported by the last epoll_wait() again, the others
+ *   are still setup.
  *
  * Input Parameters:
  *   eph       - The epoll head pointer
@@ -313,18 +483,11 @@ static int epoll_setup(FAR epoll_head_t *eph)
        * cover the situation several poll event pending on one fd.
        */
 
-      epn->notified    = false;
-      epn->pfd.revents = 0;
-      ret = file_poll(epn->filep, &epn->pfd, true);
+      ret = epoll_arm(eph, epn);
       if (ret < 0)
         {
-          ferr("epoll setup failed, filep=%p, events=%08" PRIx32 ", "
-               "ret=%d\n", epn->filep, epn->pfd.events, ret);
           break;
         }
-
-      list_delete(&epn->node);
-      list_add_tail(&eph->setup, &epn->node);
     }
 
   nxmutex_unlock(&eph->lock);
@@ -335,8 +498,8 @@ static int epoll_setup(FAR epoll_head_t *eph)
  * Name: epoll_teardown
  *
  * Description:
- *   Teardown all the notified fd and check the notified fd's event with user
- *   expected event.
+ *   Teardown the fd in the ready list and report their events, the fd not
+ *   notified since the last epoll_wait() aren't touched at all.
  *
  * Input Parameters:
  *   eph       - The epoll head pointer
@@ -352,43 +515,57 @@ static int epoll_setup(FAR epoll_head_t *eph)
 static int epoll_teardown(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
                           int maxevents)
 {
-  FAR epoll_node_t *tepn;
   FAR epoll_node_t *epn;
+  irqstate_t flags;
+  bool more;
   int i = 0;
 
   nxmutex_lock(&eph->lock);
 
-  list_for_every_entry_safe(&eph->setup, epn, tepn, epoll_node_t, node)
+  for (; ; )
     {
-      /* Only check the notified fd */
-
-      if (!epn->notified)
+      flags = spin_lock_irqsave(&eph->spinlock);
+      more  = !list_is_empty(&eph->ready);
+      if (!more || i >= maxevents)
         {
-          continue;
+          spin_unlock_irqrestore(&eph->spinlock, flags);
+          break;
         }
 
-      /* Teradown all the notified fd */
+      epn = list_first_entry(&eph->ready, epoll_node_t, rnode);
+      list_delete(&epn->rnode);
+      epn->ready = false;
+      spin_unlock_irqrestore(&eph->spinlock, flags);
 
-      file_poll(epn->filep, &epn->pfd, false);
-      list_delete(&epn->node);
+      /* Teardown the notified fd, it is setup again by the next
+       * epoll_wait() unless it is a oneshot fd.
+       */
+
+      epoll_disarm(eph, epn);
 
-      if (epn->pfd.revents != 0 && i < maxevents)
+      if (epn->pfd.revents != 0)
         {
           evs[i].data     = epn->data;
           evs[i++].events = epn->pfd.revents;
           if ((epn->pfd.events & EPOLLONESHOT) != 0)
             {
+              epn->state = EPOLL_NODE_ONESHOT;
               list_add_tail(&eph->oneshot, &epn->node);
-            }
-          else
-            {
-              list_add_tail(&eph->teardown, &epn->node);
+              continue;
             }
         }
-      else
-        {
-          list_add_tail(&eph->teardown, &epn->node);
-        }
+
+      epn->state = EPOLL_NODE_TEARDOWN;
+      list_add_tail(&eph->teardown, &epn->node);
+    }
+
+  /* The remaining ready fd are still setup, keep the waiter awake so they
+   * are reported by the next epoll_wait().
+   */
+
+  if (more)
+    {
+      epoll_notify(eph);
     }
 
   nxmutex_unlock(&eph->lock);
@@ -413,7 +590,8 @@ static void epoll_cleanup(FAR void *arg)
  *
  * Description:
  *   The default epoll callback function, this function do the final step of
- *   poll notification.
+ *   poll notification: queue the epoll node to the ready list and wake up
+ *   the waiter.
  *
  * Input Parameters:
  *   fds - The fds
@@ -426,17 +604,23 @@ static void epoll_cleanup(FAR void *arg)
 static void epoll_default_cb(FAR struct pollfd *fds)
 {
   FAR epoll_node_t *epn = fds->arg;
-  int semcount = 0;
+  FAR epoll_head_t *eph = epn->eph;
+  irqstate_t flags;
 
-  epn->notified = true;
-  if (fds->revents != 0)
+  if (fds->revents == 0)
     {
-      nxsem_get_value(&epn->eph->sem, &semcount);
-      if (semcount < 1)
-        {
-          nxsem_post(&epn->eph->sem);
-        }
+      return;
+    }
+
+  flags = spin_lock_irqsave(&eph->spinlock);
+  if (!epn->ready)
+    {
+      epn->ready = true;
+      list_add_tail(&eph->ready, &epn->rnode);
     }
+
+  spin_unlock_irqrestore(&eph->spinlock, flags);
+  epoll_notify(eph);
 }
 
 /****************************************************************************
@@ -531,31 +715,10 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
 
         /* Check repetition */
 
-        list_for_every_entry(&eph->setup, epn, epoll_node_t, node)
+        if (epoll_find(eph, fd) != NULL)
           {
-            if (epn->pfd.fd == fd)
-              {
-                ret = -EEXIST;
-                goto err;
-              }
-          }
-
-        list_for_every_entry(&eph->teardown, epn, epoll_node_t, node)
-          {
-            if (epn->pfd.fd == fd)
-              {
-                ret = -EEXIST;
-                goto err;
-              }
-          }
-
-        list_for_every_entry(&eph->oneshot, epn, epoll_node_t, node)
-          {
-            if (epn->pfd.fd == fd)
-              {
-                ret = -EEXIST;
-                goto err;
-              }
+            ret = -EEXIST;
+            goto err;
           }
 
         if (list_is_empty(&eph->free))
@@ -585,8 +748,8 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
         epn = container_of(list_remove_head(&eph->free), epoll_node_t, node);
         epn->eph         = eph;
         epn->data        = ev->data;
-        epn->notified    = false;
-        epn->pfd.events  = ev->events | POLLALWAYS;
+        epn->ready       = false;
+        epn->pfd.events  = ev->events;
         epn->pfd.fd      = fd;
         epn->pfd.arg     = epn;
         epn->pfd.cb      = epoll_default_cb;
@@ -602,122 +765,59 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
         ret = file_poll(epn->filep, &epn->pfd, true);
         if (ret < 0)
           {
+            epoll_unready(eph, epn);
             file_put(epn->filep);
             list_add_tail(&eph->free, &epn->node);
             goto err;
           }
 
+        epn->state = EPOLL_NODE_SETUP;
         list_add_tail(&eph->setup, &epn->node);
+        list_add_tail(&eph->hash[fd & EPOLL_HASH_MASK], &epn->hnode);
         break;
 
       case EPOLL_CTL_DEL:
         finfo("%p CTL DEL: fd=%d\n", eph, fd);
-        list_for_every_entry(&eph->setup, epn, epoll_node_t, node)
-          {
-            if (epn->pfd.fd == fd)
-              {
-                file_poll(epn->filep, &epn->pfd, false);
-                file_put(epn->filep);
-                list_delete(&epn->node);
-                list_add_tail(&eph->free, &epn->node);
-                goto out;
-              }
-          }
-
-        list_for_every_entry(&eph->teardown, epn, epoll_node_t, node)
+        epn = epoll_find(eph, fd);
+        if (epn != NULL)
           {
-            if (epn->pfd.fd == fd)
-              {
-                file_put(epn->filep);
-                list_delete(&epn->node);
-                list_add_tail(&eph->free, &epn->node);
-                goto out;
-              }
-          }
-
-        list_for_every_entry(&eph->oneshot, epn, epoll_node_t, node)
-          {
-            if (epn->pfd.fd == fd)
-              {
-                file_put(epn->filep);
-                list_delete(&epn->node);
-                list_add_tail(&eph->free, &epn->node);
-                goto out;
-              }
+            epoll_disarm(eph, epn);
+            file_put(epn->filep);
+            list_delete(&epn->hnode);
+            list_add_tail(&eph->free, &epn->node);
           }
 
         break;
 
       case EPOLL_CTL_MOD:
         finfo("%p CTL MOD: fd=%d ev=%08" PRIx32 "\n", eph, fd, ev->events);
-        list_for_every_entry(&eph->setup, epn, epoll_node_t, node)
+        epn = epoll_find(eph, fd);
+        if (epn == NULL)
           {
-            if (epn->pfd.fd == fd)
-              {
-                if (epn->pfd.events != (ev->events | POLLALWAYS))
-                  {
-                    file_poll(epn->filep, &epn->pfd, false);
-
-                    epn->notified    = false;
-                    epn->data        = ev->data;
-                    epn->pfd.events  = ev->events | POLLALWAYS;
-                    epn->pfd.revents = 0;
-
-                    ret = file_poll(epn->filep, &epn->pfd, true);
-                    if (ret < 0)
-                      {
-                        goto err;
-                      }
-                  }
-
-                goto out;
-              }
+            break;
           }
 
-        list_for_every_entry(&eph->teardown, epn, epoll_node_t, node)
+        epn->data = ev->data;
+
+        /* A oneshot fd is always setup again, the others only if the
+         * expected events change.
+         */
+
+        if (epn->state != EPOLL_NODE_ONESHOT &&
+            epn->pfd.events == ev->events)
           {
-            if (epn->pfd.fd == fd)
-              {
-                if (epn->pfd.events != (ev->events | POLLALWAYS))
-                  {
-                    epn->notified    = false;
-                    epn->data        = ev->data;
-                    epn->pfd.events  = ev->events | POLLALWAYS;
-                    epn->pfd.revents = 0;
-
-                    ret = file_poll(epn->filep, &epn->pfd, true);
-                    if (ret < 0)
-                      {
-                        goto err;
-                      }
-
-                    list_delete(&epn->node);
-                    list_add_tail(&eph->setup, &epn->node);
-                  }
-
-                goto out;
-              }
+            break;
           }
 
-        list_for_every_entry(&eph->oneshot, epn, epoll_node_t, node)
+        epoll_disarm(eph, epn);
+        list_add_tail(&eph->teardown, &epn->node);
+        epn->state      = EPOLL_NODE_TEARDOWN;
+        epn->pfd.events = ev->events;
+
+        ret = epoll_arm(eph, epn);
+        if (ret < 0)
           {
-            if (epn->pfd.fd == fd)
-              {
-                epn->notified    = false;
-                epn->data        = ev->data;
-                epn->pfd.events  = ev->events | POLLALWAYS;
-                epn->pfd.revents = 0;
-
-                ret = file_poll(epn->filep, &epn->pfd, true);
-                if (ret < 0)
-                  {
-                    goto err;
-                  }
-
-                list_delete(&epn->node);
-                list_add_tail(&eph->setup, &epn->node);
-                break;
-              }
+            goto err;
           }
 
         break;
@@ -727,7 +827,6 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
         goto err;
     }
 
-out:
   nxmutex_unlock(&eph->lock);
   file_put(filep);
   return OK;
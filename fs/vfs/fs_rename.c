@@ -189,6 +189,12 @@ static int pseudorename(FAR const char *oldpath, FAR struct inode *oldinode,
 #endif
   newinode->i_private = oldinode->i_private; /* Per inode driver private data */
 
+#ifdef CONFIG_FS_INODE_HASH
+  /* The children are now found below the new inode */
+
+  inode_hash_reparent(newinode);
+#endif
+
 #ifdef CONFIG_PSEUDOFS_SOFTLINKS
   /* Prevent the link target string from being deallocated.  The pointer to
    * the allocated link target path was copied above (under the guise of
@@ -27,6 +27,8 @@
 #include <nuttx/config.h>
 
 #include <sys/sendfile.h>
+#include <sys/param.h>
+#include <sys/stat.h>
 #include <stdbool.h>
 #include <errno.h>
 #include <nuttx/debug.h>
@@ -40,6 +42,133 @@
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_PIPES
+/****************************************************************************
+ * Name: splicefile
+ *
+ * Description:
+ *   Transfer to or from a pipe with file_splice(), which moves the data
+ *   directly between the pipe buffer and the other file.  Like copyfile(),
+ *   keep going until 'count' bytes are transferred or end of file.
+ *
+ ****************************************************************************/
+
+static ssize_t splicefile(FAR struct file *outfile, FAR struct file *infile,
+                          FAR off_t *offset, size_t count)
+{
+  size_t ntransferred = 0;
+  ssize_t ret;
+
+  while (ntransferred < count)
+    {
+      ret = file_splice(infile, offset, outfile, NULL,
+                        count - ntransferred, 0);
+      if (ret <= 0)
+        {
+          if (ret < 0 && (ret != -EINTR || ntransferred == 0))
+            {
+              return ret;
+            }
+
+          break;
+        }
+
+      ntransferred += ret;
+    }
+
+  return ntransferred;
+}
+#endif
+
+/****************************************************************************
+ * Name: xipfile
+ *
+ * Description:
+ *   If the input file is resident in memory (FIOC_XIPBASE) on a file
+ *   system that cannot modify its files, such as romfs, write the data to
+ *   the output file directly from there.  Returns -ENOTTY if the input
+ *   file cannot be accessed in place.
+ *
+ ****************************************************************************/
+
+static ssize_t xipfile(FAR struct file *outfile, FAR struct file *infile,
+                       FAR off_t *offset, size_t count)
+{
+  FAR struct inode *inode = infile->f_inode;
+  FAR const char *base = NULL;
+  struct stat buf;
+  size_t ntransferred = 0;
+  ssize_t nwritten;
+  off_t pos;
+  int ret;
+
+  /* file_write() may block for a long time with no lock held on the input
+   * file.  A file system that can write, like tmpfs, may reallocate or
+   * free the data meanwhile on an append or truncate, so only use the
+   * data in place if the file system has no way to change it.
+   */
+
+  if (!INODE_IS_MOUNTPT(inode) || inode->u.i_mops == NULL ||
+      inode->u.i_mops->write != NULL || inode->u.i_mops->truncate != NULL)
+    {
+      return -ENOTTY;
+    }
+
+  ret = file_ioctl(infile, FIOC_XIPBASE,
+                   (unsigned long)((uintptr_t)&base));
+  if (ret < 0 || base == NULL)
+    {
+      return -ENOTTY;
+    }
+
+  ret = file_fstat(infile, &buf);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  pos = offset != NULL ? *offset : infile->f_pos;
+  if (pos < 0)
+    {
+      return -EINVAL;
+    }
+  else if (pos >= buf.st_size)
+    {
+      return 0;
+    }
+
+  count = MIN(count, buf.st_size - pos);
+  while (ntransferred < count)
+    {
+      nwritten = file_write(outfile, base + pos + ntransferred,
+                            count - ntransferred);
+      if (nwritten < 0)
+        {
+          if (nwritten != -EINTR || ntransferred == 0)
+            {
+              return nwritten;
+            }
+
+          break;
+        }
+
+      ntransferred += nwritten;
+    }
+
+  /* Update the offset, or the file position if there is no offset */
+
+  if (offset != NULL)
+    {
+      *offset = pos + ntransferred;
+    }
+  else
+    {
+      infile->f_pos = pos + ntransferred;
+    }
+
+  return ntransferred;
+}
+
 static ssize_t copyfile(FAR struct file *outfile, FAR struct file *infile,
                         FAR off_t *offset, size_t count)
 {
@@ -249,12 +378,23 @@ static ssize_t copyfile(FAR struct file *outfile, FAR struct file *infile,
 ssize_t file_sendfile(FAR struct file *outfile, FAR struct file *infile,
                       FAR off_t *offset, size_t count)
 {
+  ssize_t ret;
+
   if (count == 0)
     {
       nwarn("WARNING: sendfile count is zero\n");
       return 0;
     }
 
+#ifdef CONFIG_PIPES
+  /* Transfers to or from a pipe go directly through the pipe buffer */
+
+  if (INODE_IS_PIPE(infile->f_inode) || INODE_IS_PIPE(outfile->f_inode))
+    {
+      return splicefile(outfile, infile, offset, count);
+    }
+#endif
+
 #ifdef CONFIG_NET_SENDFILE
   /* Check the destination file descriptor:  Is it a (probable) file
    * descriptor?  Check the source file:  Is it a normal file?
@@ -267,7 +407,7 @@ ssize_t file_sendfile(FAR struct file *outfile, FAR struct file *infile,
     {
       /* Then let psock_sendfile do the work. */
 
-      int ret = psock_sendfile(psock, infile, offset, count);
+      ret = psock_sendfile(psock, infile, offset, count);
       if (ret >= 0 || ret != -ENOSYS)
         {
           return ret;
@@ -279,6 +419,14 @@ ssize_t file_sendfile(FAR struct file *outfile, FAR struct file *infile,
     }
 #endif
 
+  /* Memory resident files can be written out in place */
+
+  ret = xipfile(outfile, infile, offset, count);
+  if (ret != -ENOTTY)
+    {
+      return ret;
+    }
+
   /* No... then this is probably a file-to-file transfer.  The generic
    * copyfile() can handle that case.
    */
@@ -0,0 +1,227 @@
+/****************************************************************************
+ * fs/vfs/fs_splice.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+
+#include <nuttx/fs/fs.h>
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The file on the other side of the pipe */
+
+struct splice_file_s
+{
+  FAR struct file *filep;  /* The file */
+  FAR off_t *offset;       /* Explicit file offset (may be NULL) */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_PIPES
+
+/****************************************************************************
+ * Name: splice_write_actor
+ *
+ * Description:
+ *   Write a region of the source pipe buffer to the destination file.
+ *
+ ****************************************************************************/
+
+static ssize_t splice_write_actor(FAR void *priv, FAR char *buf,
+                                  size_t len)
+{
+  FAR struct splice_file_s *sf = priv;
+  ssize_t ret;
+
+  if (sf->offset != NULL)
+    {
+      ret = file_pwrite(sf->filep, buf, len, *sf->offset);
+      if (ret > 0)
+        {
+          *sf->offset += ret;
+        }
+    }
+  else
+    {
+      ret = file_write(sf->filep, buf, len);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: splice_read_actor
+ *
+ * Description:
+ *   Read from the source file directly into the destination pipe buffer.
+ *
+ ****************************************************************************/
+
+static ssize_t splice_read_actor(FAR void *priv, FAR char *buf, size_t len)
+{
+  FAR struct splice_file_s *sf = priv;
+  ssize_t ret;
+
+  if (sf->offset != NULL)
+    {
+      ret = file_pread(sf->filep, buf, len, *sf->offset);
+      if (ret > 0)
+        {
+          *sf->offset += ret;
+        }
+    }
+  else
+    {
+      ret = file_read(sf->filep, buf, len);
+    }
+
+  return ret;
+}
+
+#endif /* CONFIG_PIPES */
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: file_splice
+ *
+ * Description:
+ *   Move data between two files, at least one of which should be a pipe,
+ *   without an intermediate buffer.  See include/nuttx/fs/fs.h.
+ *
+ ****************************************************************************/
+
+ssize_t file_splice(FAR struct file *infile, FAR off_t *inoffset,
+                    FAR struct file *outfile, FAR off_t *outoffset,
+                    size_t count, unsigned int flags)
+{
+#ifdef CONFIG_PIPES
+  struct splice_file_s sf;
+#endif
+
+  if (count == 0)
+    {
+      return 0;
+    }
+
+#ifdef CONFIG_PIPES
+  /* Pipe to anything:  Write straight out of the pipe buffer */
+
+  if (INODE_IS_PIPE(infile->f_inode))
+    {
+      /* Moving data from a pipe to itself would corrupt the pipe buffer */
+
+      if (infile->f_inode == outfile->f_inode)
+        {
+          return -EINVAL;
+        }
+
+      if (inoffset != NULL ||
+          (outoffset != NULL && INODE_IS_PIPE(outfile->f_inode)))
+        {
+          return -ESPIPE;
+        }
+
+      sf.filep  = outfile;
+      sf.offset = outoffset;
+
+      return pipe_splice_read(infile, splice_write_actor, &sf, count,
+                              flags, false);
+    }
+
+  /* Anything to a pipe:  Read straight into the pipe buffer */
+
+  if (INODE_IS_PIPE(outfile->f_inode))
+    {
+      if (outoffset != NULL)
+        {
+          return -ESPIPE;
+        }
+
+      sf.filep  = infile;
+      sf.offset = inoffset;
+
+      return pipe_splice_write(outfile, splice_read_actor, &sf, count,
+                               flags);
+    }
+#endif
+
+  /* Neither end is a pipe.  file_sendfile() transfers from the current
+   * position of the output file only.
+   */
+
+  if (outoffset != NULL)
+    {
+      return -EINVAL;
+    }
+
+  return file_sendfile(outfile, infile, inoffset, count);
+}
+
+/****************************************************************************
+ * Name: file_tee
+ *
+ * Description:
+ *   Copy data from a pipe to another pipe without consuming it.  See
+ *   include/nuttx/fs/fs.h.
+ *
+ ****************************************************************************/
+
+ssize_t file_tee(FAR struct file *infile, FAR struct file *outfile,
+                 size_t count, unsigned int flags)
+{
+#ifdef CONFIG_PIPES
+  struct splice_file_s sf;
+
+  if (!INODE_IS_PIPE(infile->f_inode) ||
+      !INODE_IS_PIPE(outfile->f_inode) ||
+      infile->f_inode == outfile->f_inode)
+    {
+      return -EINVAL;
+    }
+
+  if (count == 0)
+    {
+      return 0;
+    }
+
+  sf.filep  = outfile;
+  sf.offset = NULL;
+
+  return pipe_splice_read(infile, splice_write_actor, &sf, count, flags,
+                          true);
+#else
+  return -EINVAL;
+#endif
+}
@@ -135,6 +135,14 @@
 #  define UP_SEV()
 #endif
 
+/* Hint to the CPU that it is busy waiting on a memory location that no
+ * event will be signaled for (unlike UP_WFE()/UP_SEV()).
+ */
+
+#if !defined(UP_CPU_RELAX)
+#  define UP_CPU_RELAX()
+#endif
+
 #ifdef CONFIG_SMP
 #  define SMP_MB()  UP_DMB()
 #  define SMP_RMB() UP_RMB()
@@ -176,6 +176,14 @@
 #define CH_STAT_MTIME      (1 << 4)
 #define CH_STAT_SIZE       (1 << 7)
 
+/* Flags for file_splice() and file_tee().  The values match Linux.
+ * SPLICE_F_MOVE and SPLICE_F_MORE are accepted as hints and ignored.
+ */
+
+#define SPLICE_F_MOVE      (1 << 0) /* Move pages instead of copying */
+#define SPLICE_F_NONBLOCK  (1 << 1) /* Don't block on the pipe */
+#define SPLICE_F_MORE      (1 << 2) /* More data will be coming */
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -415,6 +423,9 @@ struct inode
   struct timespec   i_atime;    /* Time of last access */
   struct timespec   i_mtime;    /* Time of last modification */
   struct timespec   i_ctime;    /* Time of last status change */
+#endif
+#ifdef CONFIG_FS_INODE_HASH
+  FAR struct inode *i_hnext;    /* Link to next inode in hash chain */
 #endif
   FAR void         *i_private;  /* Per inode driver private data */
   char              i_name[1];  /* Name of inode (variable) */
@@ -449,6 +460,15 @@ typedef struct cookie_io_functions_t
   FAR cookie_close_function_t *close;
 } cookie_io_functions_t;
 
+/* Callback used by the pipe splice functions.  It is given a contiguous
+ * region of the pipe buffer and either consumes data from it
+ * (pipe_splice_read) or fills it (pipe_splice_write).  It returns the
+ * number of bytes processed, zero at end of file, or a negated errno value.
+ */
+
+typedef CODE ssize_t (*splice_actor_t)(FAR void *priv, FAR char *buf,
+                                       size_t len);
+
 /* This is the underlying representation of an open file.  A file
  * descriptor is an index into an array of such types. The type associates
  * the file descriptor to the file state and to a set of inode operations.
@@ -1636,6 +1656,56 @@ ssize_t file_pwrite(FAR struct file *filep, FAR const void *buf,
 ssize_t file_sendfile(FAR struct file *outfile, FAR struct file *infile,
                       FAR off_t *offset, size_t count);
 
+/****************************************************************************
+ * Name: file_splice
+ *
+ * Description:
+ *   Move up to 'count' bytes from 'infile' to 'outfile' without bouncing
+ *   the data through an intermediate buffer.  This is similar to the Linux
+ *   splice() interface:  If one of the files is a pipe, the data is moved
+ *   directly between the pipe buffer and the other file.  Otherwise the
+ *   transfer is performed as by file_sendfile(), which maps memory
+ *   resident files in place and uses the network sendfile path for TCP
+ *   sockets.
+ *
+ * Input Parameters:
+ *   infile    - The source file
+ *   inoffset  - If not NULL, the offset to read from in 'infile'.  It is
+ *               updated and the file position is not changed.  Must be
+ *               NULL if 'infile' is a pipe.
+ *   outfile   - The destination file
+ *   outoffset - If not NULL, the offset to write to in 'outfile'.  Must be
+ *               NULL if 'outfile' is a pipe or if neither file is a pipe.
+ *   count     - The maximum number of bytes to move
+ *   flags     - SPLICE_F_* flags
+ *
+ * Returned Value:
+ *   The number of bytes moved, zero at end of file, or a negated errno
+ *   value on failure.  As with read(), fewer bytes than requested may be
+ *   moved.
+ *
+ ****************************************************************************/
+
+ssize_t file_splice(FAR struct file *infile, FAR off_t *inoffset,
+                    FAR struct file *outfile, FAR off_t *outoffset,
+                    size_t count, unsigned int flags);
+
+/****************************************************************************
+ * Name: file_tee
+ *
+ * Description:
+ *   Copy up to 'count' bytes from the pipe 'infile' to the pipe 'outfile'
+ *   without consuming them, like the Linux tee() interface.
+ *
+ * Returned Value:
+ *   The number of bytes copied, zero at end of file, or a negated errno
+ *   value on failure.
+ *
+ ****************************************************************************/
+
+ssize_t file_tee(FAR struct file *infile, FAR struct file *outfile,
+                 size_t count, unsigned int flags);
+
 /****************************************************************************
  * Name: file_seek
  *
@@ -1910,6 +1980,39 @@ int nx_unlink(FAR const char *pathname);
 int file_pipe(FAR struct file *filep[2], size_t bufsize, int flags);
 #endif
 
+/****************************************************************************
+ * Name: pipe_splice_read and pipe_splice_write
+ *
+ * Description:
+ *   Kernel interfaces used by file_splice() and file_tee() to access the
+ *   buffer of a pipe or FIFO in place.  pipe_splice_read() waits for data
+ *   in the pipe and passes contiguous regions of it to 'actor', which
+ *   consumes them.  The data is removed from the pipe unless 'peek' is
+ *   true.  pipe_splice_write() waits for free space in the pipe and has
+ *   'actor' fill it directly.  The pipe is locked while 'actor' runs.
+ *
+ * Input Parameters:
+ *   filep - An open file that refers to a pipe or FIFO
+ *   actor - The callback that consumes or produces the data
+ *   priv  - Argument passed to 'actor'
+ *   count - The maximum number of bytes to transfer
+ *   flags - SPLICE_F_* flags
+ *   peek  - Leave the data in the pipe (pipe_splice_read only)
+ *
+ * Returned Value:
+ *   The number of bytes transferred, zero at end of file, or a negated
+ *   errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PIPES
+ssize_t pipe_splice_read(FAR struct file *filep, splice_actor_t actor,
+                         FAR void *priv, size_t count, unsigned int flags,
+                         bool peek);
+ssize_t pipe_splice_write(FAR struct file *filep, splice_actor_t actor,
+                          FAR void *priv, size_t count, unsigned int flags);
+#endif
+
 /****************************************************************************
  * Name: nx_mkfifo
  *
@@ -366,6 +366,19 @@
                                            * IN:  None
                                            * OUT: None (ioctl return value provides
                                            *      success/failure indication). */
+#define BIOC_TRIM       _BIOC(0x0012)     /* Tell the device that a range of sectors
+                                           * no longer holds valid data.
+                                           * IN:  Pointer to an array of two
+                                           *      blkcnt_t: the start sector and
+                                           *      the number of sectors.
+                                           * OUT: None (ioctl return value provides
+                                           *      success/failure indication). */
+#define BIOC_ZEROOUT    _BIOC(0x0013)     /* Fill a range of sectors with zeroes.
+                                           * IN:  Pointer to an array of two
+                                           *      blkcnt_t: the start sector and
+                                           *      the number of sectors.
+                                           * OUT: None (ioctl return value provides
+                                           *      success/failure indication). */
 
 /* NuttX MTD driver ioctl definitions ***************************************/
 
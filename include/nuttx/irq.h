@@ -166,6 +166,10 @@
 #  define CONFIG_SCHED_CRITMONITOR_MAXTIME_WDOG -1
 #endif
 
+#ifndef CONFIG_SCHED_CRITMONITOR_CSECTION_SITES
+#  define CONFIG_SCHED_CRITMONITOR_CSECTION_SITES 0
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
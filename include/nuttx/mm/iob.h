@@ -220,6 +220,18 @@ FAR struct iob_s *iob_alloc(bool throttled);
 
 FAR struct iob_s *iob_tryalloc(bool throttled);
 
+/****************************************************************************
+ * Name: iob_alloc_batch
+ *
+ * Description:
+ *   Try to allocate up to 'n' I/O buffers at once without waiting.  The
+ *   free list is locked only once for the whole batch.  Returns the number
+ *   of buffers stored in 'iobs'.
+ *
+ ****************************************************************************/
+
+int iob_alloc_batch(FAR struct iob_s **iobs, int n, bool throttled);
+
 #ifdef CONFIG_IOB_ALLOC
 /****************************************************************************
  * Name: iob_alloc_dynamic
@@ -373,7 +385,7 @@ void iob_notifier_teardown(int key);
  *
  * Description:
  *   Free an entire buffer chain, starting at the beginning of the I/O
- *   buffer chain
+ *   buffer chain.  The buffers are returned to the free list at once.
  *
  ****************************************************************************/
 
@@ -87,6 +87,22 @@ struct mempool_procfs_entry_s
 };
 #endif
 
+#ifdef CONFIG_MM_HEAP_MEMPOOL_MAGAZINE
+/* This structure describes the per-CPU cache (magazine) of free blocks
+ * kept in front of a mempool.  It is only accessed by its CPU with the
+ * interrupts disabled, the pool lock is taken only to move a batch of
+ * blocks between the magazine and the pool.
+ */
+
+struct mempool_magazine_s
+{
+  size_t    count;  /* The number of cached blocks */
+  size_t    nhit;   /* Allocations and releases done in the magazine */
+  size_t    nmiss;  /* Batches moved from or to the pool */
+  FAR void *blks[CONFIG_MM_HEAP_MEMPOOL_MAGAZINE_SIZE];
+} aligned_data(64);
+#endif
+
 /* This structure describes memory buffer pool */
 
 struct mempool_s
@@ -110,6 +126,9 @@ struct mempool_s
   size_t     nalloc;  /* The number of used block in mempool */
   spinlock_t lock;    /* The protect lock to mempool */
   sem_t      waitsem; /* The semaphore of waiter get free block */
+#ifdef CONFIG_MM_HEAP_MEMPOOL_MAGAZINE
+  FAR struct mempool_magazine_s *mag; /* The per-CPU magazines or NULL */
+#endif
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMPOOL)
   struct mempool_procfs_entry_s procfs; /* The entry of procfs */
 #endif
@@ -139,6 +158,10 @@ struct mempoolinfo_s
   unsigned long aordblks; /* This is the number of used blocks */
   unsigned long sizeblks; /* This is the size of a mempool blocks */
   unsigned long nwaiter;  /* This is the number of waiter for mempool */
+#ifdef CONFIG_MM_HEAP_MEMPOOL_MAGAZINE
+  unsigned long nhit;     /* This is the number of magazine hits */
+  unsigned long nmiss;    /* This is the number of magazine refills/flushes */
+#endif
 };
 
 /****************************************************************************
@@ -793,6 +793,75 @@ int file_mq_setattr(FAR struct file *mq, FAR const struct mq_attr *mq_stat,
 
 int file_mq_getattr(FAR struct file *mq, FAR struct mq_attr *mq_stat);
 
+#ifdef CONFIG_MQ_ZEROCOPY
+
+/****************************************************************************
+ * Name: file_mq_loan
+ *
+ * Description:
+ *   Borrow a message buffer of at least 'msglen' bytes from the message
+ *   pool.  The buffer is filled in place and queued without copying by
+ *   file_mq_timedsend_loan()/file_mq_ticksend_loan(), or given back with
+ *   file_mq_return().
+ *
+ * Input Parameters:
+ *   mq     - Message queue descriptor the buffer will be sent to
+ *   msglen - The maximum length of the message in bytes
+ *   buf    - The location to return the buffer
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  A negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
+
+int file_mq_loan(FAR struct file *mq, size_t msglen, FAR void **buf);
+
+/****************************************************************************
+ * Name: file_mq_timedsend_loan/file_mq_ticksend_loan
+ *
+ * Description:
+ *   Like file_mq_timedsend()/file_mq_ticksend(), but queue the loaned
+ *   buffer 'buf' itself.  The queue owns the buffer on success, the caller
+ *   still owns it on failure.
+ *
+ ****************************************************************************/
+
+int file_mq_timedsend_loan(FAR struct file *mq, FAR void *buf,
+                           size_t msglen, unsigned int prio,
+                           FAR const struct timespec *abstime);
+int file_mq_ticksend_loan(FAR struct file *mq, FAR void *buf,
+                          size_t msglen, unsigned int prio, sclock_t ticks);
+
+/****************************************************************************
+ * Name: file_mq_timedreceive_loan/file_mq_tickreceive_loan
+ *
+ * Description:
+ *   Like file_mq_timedreceive()/file_mq_tickreceive(), but return the
+ *   message buffer itself in 'buf' instead of copying the message.  The
+ *   caller owns the buffer and gives it back with file_mq_return() or
+ *   sends it on with file_mq_timedsend_loan()/file_mq_ticksend_loan().
+ *
+ ****************************************************************************/
+
+ssize_t file_mq_timedreceive_loan(FAR struct file *mq, FAR void **buf,
+                                  FAR unsigned int *prio,
+                                  FAR const struct timespec *abstime);
+ssize_t file_mq_tickreceive_loan(FAR struct file *mq, FAR void **buf,
+                                 FAR unsigned int *prio, sclock_t ticks);
+
+/****************************************************************************
+ * Name: file_mq_return
+ *
+ * Description:
+ *   Give back a loaned or received message buffer to the message pool.
+ *
+ ****************************************************************************/
+
+void file_mq_return(FAR void *buf);
+
+#endif /* CONFIG_MQ_ZEROCOPY */
+
 #undef EXTERN
 #ifdef __cplusplus
 }
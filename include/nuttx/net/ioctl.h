@@ -110,6 +110,7 @@
 #define TUNSETIFF        _SIOC(0x0028)  /* Set TUN/TAP interface */
 #define TUNGETIFF        _SIOC(0x0035)  /* Get TUN/TAP interface */
 #define TUNSETCARRIER    _SIOC(0x0040)  /* Set TUN/TAP carrier state */
+#define TUNSETOFFLOAD    _SIOC(0x0045)  /* Set TUN/TAP reader offloads */
 
 /* Telnet driver ************************************************************/
 
@@ -84,6 +84,8 @@
 
 #define NETDEV_TX_CSUM  (1 << 1) /* Netdev support hardware tx checksum */
 #define NETDEV_RX_CSUM  (1 << 2) /* Netdev support hardware rx checksum */
+#define NETDEV_TX_TSO4  (1 << 3) /* Netdev support TCP/IPv4 segmentation */
+#define NETDEV_TX_TSO6  (1 << 4) /* Netdev support TCP/IPv6 segmentation */
 
 /* Determine the largest possible address */
 
@@ -168,6 +170,15 @@
 #    define NETDEV_RXARP(dev)
 #  endif
 #  define NETDEV_RXDROPPED(dev)   _NETDEV_STATISTIC(dev,rx_dropped)
+#  ifdef CONFIG_NETDEV_GRO
+#    define NETDEV_RXGRO(dev,nsegs) \
+       do { \
+           _NETDEV_STATISTIC(dev,rx_gro_packets); \
+           (dev)->d_statistics.rx_gro_segs += (nsegs); \
+       } while (0)
+#  else
+#    define NETDEV_RXGRO(dev,nsegs)
+#  endif
 
 #  define NETDEV_TXPACKETS(dev) \
     do { \
@@ -189,6 +200,7 @@
 #  define NETDEV_RXIPV6(dev)
 #  define NETDEV_RXARP(dev)
 #  define NETDEV_RXDROPPED(dev)
+#  define NETDEV_RXGRO(dev,nsegs)
 
 #  define NETDEV_TXPACKETS(dev)
 #  define NETDEV_TXDONE(dev)
@@ -261,6 +273,10 @@ struct netdev_statistics_s
 #endif
   uint32_t rx_dropped;     /* Unsupported Rx packets received */
   uint64_t rx_bytes;       /* Number of bytes received */
+#ifdef CONFIG_NETDEV_GRO
+  uint32_t rx_gro_packets; /* Number of coalesced packets passed up */
+  uint32_t rx_gro_segs;    /* Number of segments coalesced into them */
+#endif
 
   /* Tx Status */
 
@@ -361,6 +377,10 @@ struct net_driver_s
 #endif
 
   uint16_t d_pktsize;           /* Maximum packet size */
+#ifdef CONFIG_NET_TCP_GSO
+  uint16_t d_tso_maxsize;       /* Largest IP packet that the device
+                                 * segments itself (NETDEV_TX_TSO4/6) */
+#endif
 
   /* Link layer address */
 
@@ -449,6 +469,13 @@ struct net_driver_s
   struct iob_queue_s d_arpout;
 #endif
 
+  /* The rest of a TCP super-segment being split into d_gso_mss segments */
+
+#ifdef CONFIG_NET_TCP_GSO
+  FAR struct iob_s *d_gso;
+  uint16_t d_gso_mss;
+#endif
+
   /* The d_buf array is used to hold incoming and outgoing packets. The
    * device driver should place incoming data into this buffer.  When sending
    * data, the device driver should read the link level headers and the
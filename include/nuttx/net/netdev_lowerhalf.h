@@ -402,6 +402,25 @@ FAR netpkt_t *netpkt_alloc(FAR struct netdev_lowerhalf_s *dev,
 void netpkt_free(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt,
                  enum netpkt_type_e type);
 
+/****************************************************************************
+ * Name: netpkt_concat
+ *
+ * Description:
+ *   Append the data of pkt2 to the end of pkt1, used when one frame is
+ *   received into several netpkts.  pkt2 becomes part of pkt1 and no longer
+ *   counts against the quota of the device.
+ *
+ * Input Parameters:
+ *   dev  - The lower half device driver structure
+ *   pkt1 - The packet to append to
+ *   pkt2 - The packet to be appended
+ *   type - Whether used for TX or RX
+ *
+ ****************************************************************************/
+
+void netpkt_concat(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt1,
+                   FAR netpkt_t *pkt2, enum netpkt_type_e type);
+
 /****************************************************************************
  * Name: netpkt_copyin
  *
@@ -197,6 +197,10 @@ struct tcp_stats_s
   net_stats_t syndrop;    /* Number of dropped SYNs due to too few
                            * available connections */
   net_stats_t synrst;     /* Number of SYNs for closed ports triggering a RST */
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  net_stats_t hashlookup; /* Number of hashed connection lookups */
+  net_stats_t hashprobe;  /* Number of connections examined by them */
+#endif
 };
 #endif
 
@@ -42,6 +42,10 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+#include <nuttx/compiler.h>
+
+#include <stdint.h>
+
 #include <nuttx/net/ioctl.h>
 
 /****************************************************************************
@@ -54,13 +58,53 @@
 #define IFF_TAP          0x02
 #define IFF_MASK         0x7f
 #define IFF_NO_PI        0x80
+#define IFF_MULTI_QUEUE  0x0100 /* Attach one more queue (fd) to the
+                                 * interface of the same name */
+#define IFF_BATCH        0x0200 /* Each packet read or written is preceded
+                                 * by its uint16_t length, a read or write
+                                 * may carry many packets */
+#define IFF_VNET_HDR     0x4000 /* Each packet is preceded by a
+                                 * struct tun_vnet_hdr_s */
 
-#ifdef CONFIG_NET_TUN
+/* TUNSETOFFLOAD flags, what the reader of an IFF_VNET_HDR interface
+ * accepts
+ */
+
+#define TUN_F_CSUM       0x01   /* Partial TCP/UDP checksums */
+#define TUN_F_TSO4       0x02   /* TCP/IPv4 super-segments */
+#define TUN_F_TSO6       0x04   /* TCP/IPv6 super-segments */
+
+/* struct tun_vnet_hdr_s flags and gso types */
+
+#define TUN_VNET_HDR_F_NEEDS_CSUM 1 /* Checksum from csum_start to the end
+                                     * and store it at csum_offset */
+#define TUN_VNET_HDR_F_DATA_VALID 2 /* Checksum already verified */
+
+#define TUN_VNET_HDR_GSO_NONE     0
+#define TUN_VNET_HDR_GSO_TCPV4    1 /* Segment at gso_size */
+#define TUN_VNET_HDR_GSO_TCPV6    4
 
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
 
+/* The IFF_VNET_HDR header, the layout of the virtio-net header in host
+ * byte order.  With NEEDS_CSUM the checksum field of the packet holds the
+ * pseudo-header checksum.  Offsets count from the start of the frame.
+ */
+
+begin_packed_struct struct tun_vnet_hdr_s
+{
+  uint8_t  flags;
+  uint8_t  gso_type;
+  uint16_t hdr_len;      /* Length of the headers to copy to each segment */
+  uint16_t gso_size;     /* Payload size of each segment */
+  uint16_t csum_start;
+  uint16_t csum_offset;
+} end_packed_struct;
+
+#ifdef CONFIG_NET_TUN
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -89,6 +89,10 @@ struct udp_stats_s
   net_stats_t recv;         /* Number of received UDP segments */
   net_stats_t sent;         /* Number of sent UDP segments */
   net_stats_t chkerr;       /* Number of UDP segments with a bad checksum */
+#ifdef CONFIG_NET_UDP_CONN_HASH
+  net_stats_t hashlookup;   /* Number of hashed connection lookups */
+  net_stats_t hashprobe;    /* Number of connections examined by them */
+#endif
 };
 #endif
 
@@ -54,6 +54,10 @@
  * NOTERAM_SETREADMODE
  *              - Set read mode
  *                Argument: A read-only pointer to unsigned int
+ * NOTERAM_GETDROPPED
+ *              - Get the number of notes lost on each CPU
+ *                (CONFIG_DRIVERS_NOTERAM_PERCPU only)
+ *                Argument: A writable pointer to unsigned long[NCPUS]
  */
 
 #ifdef CONFIG_DRIVERS_NOTERAM
@@ -62,6 +66,7 @@
 #define NOTERAM_SETMODE         _NOTERAMIOC(0x03)
 #define NOTERAM_GETREADMODE     _NOTERAMIOC(0x04)
 #define NOTERAM_SETREADMODE     _NOTERAMIOC(0x05)
+#define NOTERAM_GETDROPPED      _NOTERAMIOC(0x06)
 #endif
 
 /* Overwrite mode definitions */
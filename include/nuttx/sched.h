@@ -803,6 +803,22 @@ struct smp_call_data_s
 };
 #endif
 
+/* This structure accumulates how one call site of enter_critical_section()
+ * uses the global critical section.
+ */
+
+#if CONFIG_SCHED_CRITMONITOR_CSECTION_SITES > 0
+struct critmon_site_s
+{
+  FAR void *caller;                      /* Caller of critical section      */
+  uint32_t  count;                       /* Number of entries               */
+  uint32_t  contended;                   /* Entries finding the lock held   */
+  clock_t   wait;                        /* Total time waiting for the lock */
+  clock_t   hold;                        /* Total time holding the lock     */
+  clock_t   hold_max;                    /* Max time holding the lock       */
+};
+#endif
+
 #endif /* __ASSEMBLY__ */
 
 /****************************************************************************
@@ -834,6 +850,13 @@ EXTERN clock_t g_busywait_max[CONFIG_SMP_NCPUS];
 EXTERN clock_t g_busywait_total[CONFIG_SMP_NCPUS];
 #endif /* CONFIG_SCHED_CRITMONITOR_MAXTIME_BUSYWAIT >= 0 */
 
+/* Use of the global critical section by call site */
+
+#if CONFIG_SCHED_CRITMONITOR_CSECTION_SITES > 0
+EXTERN struct critmon_site_s
+g_crit_sites[CONFIG_SCHED_CRITMONITOR_CSECTION_SITES];
+#endif
+
 /* g_running_tasks[] holds a references to the running task for each CPU.
  * It is valid only when up_interrupt_context() returns true.
  */
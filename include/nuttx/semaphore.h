@@ -104,6 +104,18 @@ struct nsem_inode_s
 };
 #endif
 
+#ifdef CONFIG_SEM_ADAPTIVE_SPIN_STATS
+/* Per CPU statistics of the adaptive spinning on contended mutexes */
+
+struct nxsem_spinstat_s
+{
+  uint32_t spins;                   /* Number of times a task spun */
+  uint32_t acquired;                /* Mutex acquired while spinning */
+  uint32_t blocked;                 /* Gave up spinning and blocked */
+  clock_t  time;                    /* Total time spent spinning */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -118,6 +130,10 @@ extern "C"
 #define EXTERN extern
 #endif
 
+#ifdef CONFIG_SEM_ADAPTIVE_SPIN_STATS
+EXTERN struct nxsem_spinstat_s g_nxsem_spinstat[CONFIG_SMP_NCPUS];
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -36,6 +36,12 @@
 
 #include <nuttx/sensors/ioctl.h>
 
+#ifdef CONFIG_SENSORS_SHM
+#  include <errno.h>
+#  include <string.h>
+#  include <nuttx/seqlock.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -630,6 +636,24 @@
 #define SENSOR_GNSS_GEOFENCE_TYPE_PAUSE                       (1 << 4)
 #define SENSOR_GNSS_GEOFENCE_TYPE_RESUME                      (1 << 5)
 
+#ifdef CONFIG_SENSORS_SHM
+
+/* Layout of the topic ring returned by mmap() on a sensor device: one
+ * struct sensor_shm_s followed by nslots slots of slotsize bytes, each a
+ * struct sensor_shm_slot_s followed by the sample itself.
+ */
+
+#define SENSOR_SHM_SLOTSIZE(esize) \
+  ((sizeof(struct sensor_shm_slot_s) + (esize) + 7) & ~7)
+#define SENSOR_SHM_SIZE(esize, nbuffer) \
+  (sizeof(struct sensor_shm_s) + (nbuffer) * SENSOR_SHM_SLOTSIZE(esize))
+#define SENSOR_SHM_SLOT(shm, idx) \
+  ((FAR struct sensor_shm_slot_s *)((FAR uint8_t *)((shm) + 1) + \
+                                    (idx) * (shm)->slotsize))
+#define SENSOR_SHM_DATA(slot)  ((FAR void *)((slot) + 1))
+
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -1334,6 +1358,35 @@ struct sensor_device_info_s
   char          vendor[SENSOR_INFO_NAME_SIZE];
 };
 
+#ifdef CONFIG_SENSORS_SHM
+
+/* This structure describes one slot of the shared topic ring.  The writer
+ * updates count and the sample that follows inside a seqlock section, so
+ * readers can copy a slot without any lock and retry on a torn copy.
+ */
+
+struct sensor_shm_slot_s
+{
+  seqcount_t sequence;         /* Guards count and the sample */
+  uint32_t   count;            /* The number of the sample held by slot */
+};
+
+/* This structure describes the head of the shared topic ring */
+
+struct sensor_shm_s
+{
+  uint32_t   esize;            /* The element size of one sample */
+  uint32_t   nslots;           /* The number of slots in the ring */
+  uint32_t   slotsize;         /* The distance between two slots */
+  seqcount_t sequence;         /* Guards head, count and nused */
+  uint32_t   head;             /* The slot holding the latest sample */
+  uint32_t   count;            /* The number of the latest sample */
+  uint32_t   nused;            /* The number of slots holding a sample */
+  uint32_t   reserved;
+};
+
+#endif
+
 /* This structure describes the register info for the user sensor */
 
 #ifdef CONFIG_USENSOR
@@ -1352,4 +1405,168 @@ struct sensor_reginfo_s
 };
 #endif
 
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_SENSORS_SHM
+
+/****************************************************************************
+ * Name: sensor_shm_read
+ *
+ * Description:
+ *   Copy sample number n out of a topic ring mapped by mmap(), without
+ *   any system call or lock.  Sample numbers start at 1 and count up by
+ *   one for every sample published on the topic.
+ *
+ * Input Parameters:
+ *   shm    - The topic ring returned by mmap().
+ *   n      - The number of the sample to copy.
+ *   buffer - The buffer receiving shm->esize bytes.
+ *
+ * Returned Value:
+ *   OK on success; -EAGAIN if sample n is not published yet; -EOVERFLOW
+ *   if it has already been overwritten.
+ *
+ ****************************************************************************/
+
+static inline int sensor_shm_read(FAR const struct sensor_shm_s *shm,
+                                  uint32_t n, FAR void *buffer)
+{
+  FAR struct sensor_shm_slot_s *slot;
+  uint32_t count;
+  uint32_t nused;
+  uint32_t head;
+  uint32_t seq;
+  uint32_t got;
+
+  for (; ; )
+    {
+      do
+        {
+          seq   = read_seqbegin(&shm->sequence);
+          head  = shm->head;
+          count = shm->count;
+          nused = shm->nused;
+        }
+      while (read_seqretry(&shm->sequence, seq));
+
+      if (nused == 0 || (int32_t)(n - count) > 0)
+        {
+          return -EAGAIN;
+        }
+      else if (count - n >= nused)
+        {
+          return -EOVERFLOW;
+        }
+
+      slot = SENSOR_SHM_SLOT(shm, (head + shm->nslots - (count - n)) %
+                                  shm->nslots);
+
+      seq = read_seqbegin(&slot->sequence);
+      got = slot->count;
+      memcpy(buffer, SENSOR_SHM_DATA(slot), shm->esize);
+      if (!read_seqretry(&slot->sequence, seq) && got == n)
+        {
+          return OK;
+        }
+
+      /* Torn copy, or the writer lapped the slot since the head was read,
+       * look again.
+       */
+    }
+}
+
+/****************************************************************************
+ * Name: sensor_shm_read_latest
+ *
+ * Description:
+ *   Copy the most recent sample out of a topic ring mapped by mmap().
+ *
+ * Input Parameters:
+ *   shm    - The topic ring returned by mmap().
+ *   buffer - The buffer receiving shm->esize bytes.
+ *   n      - Optional location receiving the number of the sample.
+ *
+ * Returned Value:
+ *   OK on success; -EAGAIN if nothing was published yet.
+ *
+ ****************************************************************************/
+
+static inline
+int sensor_shm_read_latest(FAR const struct sensor_shm_s *shm,
+                           FAR void *buffer, FAR uint32_t *n)
+{
+  uint32_t count;
+  int ret;
+
+  do
+    {
+      count = shm->count;
+      ret = sensor_shm_read(shm, count, buffer);
+    }
+  while (ret == -EOVERFLOW);
+
+  if (ret >= 0 && n != NULL)
+    {
+      *n = count;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: sensor_shm_read_batch
+ *
+ * Description:
+ *   Copy up to nmax samples, starting at sample number *next, out of a
+ *   topic ring mapped by mmap().  Samples that were overwritten before
+ *   they could be copied are skipped.  A new subscriber starts with
+ *   *next = shm->count + 1 to see only new samples.
+ *
+ * Input Parameters:
+ *   shm    - The topic ring returned by mmap().
+ *   next   - The number of the next sample to copy, updated on return.
+ *   buffer - The buffer receiving up to nmax * shm->esize bytes.
+ *   nmax   - The maximum number of samples to copy.
+ *
+ * Returned Value:
+ *   The number of samples copied.
+ *
+ ****************************************************************************/
+
+static inline
+size_t sensor_shm_read_batch(FAR const struct sensor_shm_s *shm,
+                             FAR uint32_t *next, FAR void *buffer,
+                             size_t nmax)
+{
+  FAR uint8_t *ptr = buffer;
+  size_t nread = 0;
+  int ret;
+
+  while (nread < nmax)
+    {
+      ret = sensor_shm_read(shm, *next, ptr);
+      if (ret == -EOVERFLOW)
+        {
+          /* Skip to the oldest sample still held by the ring */
+
+          *next = shm->count - shm->nused + 1;
+          continue;
+        }
+      else if (ret < 0)
+        {
+          break;
+        }
+
+      *next += 1;
+      ptr   += shm->esize;
+      nread++;
+    }
+
+  return nread;
+}
+
+#endif /* CONFIG_SENSORS_SHM */
+
 #endif /* __INCLUDE_NUTTX_SENSORS_SENSOR_H */
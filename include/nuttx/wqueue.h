@@ -253,6 +253,9 @@ struct work_s
   clock_t          qtime;  /* Time work queued */
   worker_t         worker; /* Work callback */
   FAR void        *arg;    /* Callback argument */
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  uint8_t          cpu;    /* Queue holding the work */
+#endif
 };
 
 /* This is an enumeration of the various events that may be
@@ -96,11 +96,16 @@
  * PTHREAD_MUTEX_DEFAULT
  *  An implementation is allowed to map this mutex to one of the other mutex
  *  types.
+ * PTHREAD_MUTEX_ADAPTIVE_NP
+ *  Non-portable.  A PTHREAD_MUTEX_NORMAL mutex on which a thread spins for
+ *  a bounded time before blocking while the holder runs on another CPU
+ *  (see CONFIG_SEM_ADAPTIVE_SPIN).  Same as PTHREAD_MUTEX_NORMAL otherwise.
  */
 
 #define PTHREAD_MUTEX_NORMAL          0
 #define PTHREAD_MUTEX_ERRORCHECK      1
 #define PTHREAD_MUTEX_RECURSIVE       2
+#define PTHREAD_MUTEX_ADAPTIVE_NP     3
 #define PTHREAD_MUTEX_DEFAULT         PTHREAD_MUTEX_NORMAL
 
 /* Valid ranges for the pthread stacksize attribute */
@@ -296,6 +301,9 @@ struct pthread_mutexattr_s
 #ifdef CONFIG_PTHREAD_MUTEX_BOTH
   uint8_t robust  : 1;  /* PTHREAD_MUTEX_STALLED or PTHREAD_MUTEX_ROBUST */
 #endif
+#ifdef CONFIG_SEM_ADAPTIVE_SPIN
+  uint8_t spin    : 1;  /* Set for PTHREAD_MUTEX_ADAPTIVE_NP */
+#endif
 };
 
 #ifndef __PTHREAD_MUTEXATTR_T_DEFINED
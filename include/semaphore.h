@@ -46,6 +46,7 @@
 #define SEM_PRIO_MASK             3
 
 #define SEM_TYPE_MUTEX            4
+#define SEM_TYPE_SPIN             8 /* Spin before blocking (SMP only) */
 
 /* Value returned by sem_open() in the event of a failure. */
 
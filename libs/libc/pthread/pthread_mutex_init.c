@@ -36,6 +36,18 @@
 
 #include "pthread.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The protocol flag for PTHREAD_MUTEX_ADAPTIVE_NP */
+
+#ifdef CONFIG_SEM_ADAPTIVE_SPIN
+#  define MUTEX_SPIN(attr)  ((attr)->spin ? SEM_TYPE_SPIN : 0)
+#else
+#  define MUTEX_SPIN(attr)  0
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -93,8 +105,8 @@ int pthread_mutex_init(FAR pthread_mutex_t *mutex,
 #if defined(CONFIG_PRIORITY_INHERITANCE) || defined(CONFIG_PRIORITY_PROTECT)
   if (attr)
     {
-      status = mutex_set_protocol(&mutex->mutex,
-                                  SEM_TYPE_MUTEX | attr->proto);
+      status = mutex_set_protocol(&mutex->mutex, SEM_TYPE_MUTEX |
+                                  attr->proto | MUTEX_SPIN(attr));
       if (status < 0)
         {
           mutex_destroy(&mutex->mutex);
@@ -122,6 +134,11 @@ int pthread_mutex_init(FAR pthread_mutex_t *mutex,
       mutex_set_protocol(&mutex->mutex,
                          SEM_TYPE_MUTEX | PTHREAD_MUTEX_DEFAULT_PRIO_FLAGS);
     }
+#elif defined(CONFIG_SEM_ADAPTIVE_SPIN)
+  if (attr && attr->spin)
+    {
+      mutex_set_protocol(&mutex->mutex, SEM_TYPE_MUTEX | SEM_TYPE_SPIN);
+    }
 #endif
 
   return 0;
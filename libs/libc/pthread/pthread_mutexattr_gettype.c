@@ -59,6 +59,12 @@ int pthread_mutexattr_gettype(FAR const pthread_mutexattr_t *attr,
       *type = attr->type;
 #else
       *type = PTHREAD_MUTEX_NORMAL;
+#endif
+#ifdef CONFIG_SEM_ADAPTIVE_SPIN
+      if (attr->spin)
+        {
+          *type = PTHREAD_MUTEX_ADAPTIVE_NP;
+        }
 #endif
       return 0;
     }
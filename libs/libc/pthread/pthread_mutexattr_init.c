@@ -80,6 +80,10 @@ int pthread_mutexattr_init(FAR pthread_mutexattr_t *attr)
       attr->type    = PTHREAD_MUTEX_DEFAULT;
 #endif
 
+#ifdef CONFIG_SEM_ADAPTIVE_SPIN
+      attr->spin    = 0;
+#endif
+
 #ifdef CONFIG_PTHREAD_MUTEX_BOTH
 #ifdef CONFIG_PTHREAD_MUTEX_DEFAULT_UNSAFE
       attr->robust  = PTHREAD_MUTEX_STALLED;
@@ -53,8 +53,18 @@
 int pthread_mutexattr_settype(FAR pthread_mutexattr_t *attr, int type)
 {
   if (attr && type >= PTHREAD_MUTEX_NORMAL &&
-      type <= PTHREAD_MUTEX_RECURSIVE)
+      type <= PTHREAD_MUTEX_ADAPTIVE_NP)
     {
+      /* An adaptive mutex is a normal mutex which spins before blocking */
+
+#ifdef CONFIG_SEM_ADAPTIVE_SPIN
+      attr->spin = type == PTHREAD_MUTEX_ADAPTIVE_NP;
+#endif
+      if (type == PTHREAD_MUTEX_ADAPTIVE_NP)
+        {
+          type = PTHREAD_MUTEX_NORMAL;
+        }
+
 #ifdef CONFIG_PTHREAD_MUTEX_TYPES
       attr->type = type;
 #else
@@ -32,6 +32,7 @@
 #include <nuttx/debug.h>
 
 #include <nuttx/mm/iob.h>
+#include <nuttx/sched.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/spinlock.h>
 
@@ -51,6 +52,32 @@
 #  define iobinfo                _none
 #endif /* CONFIG_DEBUG_FEATURES && CONFIG_IOB_DEBUG */
 
+#ifdef CONFIG_IOB_PERCPU_CACHE
+/* The number of buffers moved between a per-CPU cache and the global free
+ * list at once.
+ */
+
+#  define IOB_PERCPU_BATCH       ((CONFIG_IOB_PERCPU_CACHE_SIZE + 1) / 2)
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_PERCPU_CACHE
+/* The cache of free I/O buffers owned by one CPU.  The lock is normally
+ * only taken by the owning CPU, the other CPUs take it only to reclaim the
+ * cached buffers when the global free list runs dry.
+ */
+
+struct iob_percpu_s
+{
+  spinlock_t        lock;  /* Protects the cache */
+  int16_t           count; /* The number of buffers in the cache */
+  FAR struct iob_s *head;  /* The cached buffers linked by io_flink */
+} aligned_data(64);
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -98,6 +125,12 @@ extern int16_t g_qentry_wait;
 
 extern volatile spinlock_t g_iob_lock;
 
+#ifdef CONFIG_IOB_PERCPU_CACHE
+/* The per-CPU caches of free I/O buffers */
+
+extern struct iob_percpu_s g_iob_percpu[CONFIG_SMP_NCPUS];
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -137,6 +170,87 @@ FAR struct iob_qentry_s *iob_tryalloc_qentry(void);
 
 FAR struct iob_qentry_s *iob_free_qentry(FAR struct iob_qentry_s *iobq);
 
+/****************************************************************************
+ * Name: iob_free_global
+ *
+ * Description:
+ *   Return a list of 'n' I/O buffers linked by io_flink (from 'head' to
+ *   'tail') to the global free list under a single acquisition of the IOB
+ *   lock.  Buffers are handed to waiting allocators first.  This function
+ *   is intended only for internal use by the IOB module.
+ *
+ ****************************************************************************/
+
+void iob_free_global(FAR struct iob_s *head, FAR struct iob_s *tail,
+                     int16_t n);
+
+/****************************************************************************
+ * Name: iob_free_list
+ *
+ * Description:
+ *   Free a list of 'n' I/O buffers linked by io_flink (from 'head' to
+ *   'tail') to the cache of this CPU or to the global free list, and
+ *   signal the IOB notifier.  This function is intended only for internal
+ *   use by the IOB module.
+ *
+ ****************************************************************************/
+
+void iob_free_list(FAR struct iob_s *head, FAR struct iob_s *tail,
+                   int16_t n);
+
+#ifdef CONFIG_IOB_PERCPU_CACHE
+/****************************************************************************
+ * Name: iob_percpu_alloc
+ *
+ * Description:
+ *   Allocate up to 'n' I/O buffers from the cache of this CPU, refilling
+ *   the cache from the global free list as necessary.  Never waits.
+ *
+ * Returned Value:
+ *   The number of buffers returned in 'iobs'.
+ *
+ ****************************************************************************/
+
+int iob_percpu_alloc(FAR struct iob_s **iobs, int n, bool throttled);
+
+/****************************************************************************
+ * Name: iob_percpu_free
+ *
+ * Description:
+ *   Put a list of 'n' free I/O buffers into the cache of this CPU, the
+ *   overflow is returned to the global free list.
+ *
+ * Returned Value:
+ *   False if the buffers were not taken because an allocator is waiting;
+ *   the caller must then use iob_free_global().
+ *
+ ****************************************************************************/
+
+bool iob_percpu_free(FAR struct iob_s *head, FAR struct iob_s *tail,
+                     int16_t n);
+
+/****************************************************************************
+ * Name: iob_percpu_drain
+ *
+ * Description:
+ *   Return the buffers held by the caches of all CPUs to the global free
+ *   list.
+ *
+ ****************************************************************************/
+
+void iob_percpu_drain(void);
+
+/****************************************************************************
+ * Name: iob_percpu_count
+ *
+ * Description:
+ *   Return the number of buffers held by the caches of all CPUs.
+ *
+ ****************************************************************************/
+
+int iob_percpu_count(void);
+#endif
+
 /****************************************************************************
  * Name: iob_notifier_signal
  *
@@ -167,6 +167,19 @@ static FAR struct iob_s *iob_allocwait(bool throttled, unsigned int timeout)
   sem = &g_iob_sem;
 #endif
 
+#ifdef CONFIG_IOB_PERCPU_CACHE
+  /* Try the cache of this CPU first, then reclaim the buffers cached by
+   * all CPUs before considering to wait.
+   */
+
+  if (iob_percpu_alloc(&iob, 1, throttled) > 0)
+    {
+      return iob;
+    }
+
+  iob_percpu_drain();
+#endif
+
   /* The following must be atomic; interrupt must be disabled so that there
    * is no conflict with interrupt level I/O buffer allocations.  This is
    * not as bad as it sounds because interrupts will be re-enabled while
@@ -193,6 +206,15 @@ static FAR struct iob_s *iob_allocwait(bool throttled, unsigned int timeout)
 
       spin_unlock_irqrestore(&g_iob_lock, flags);
 
+#ifdef CONFIG_IOB_PERCPU_CACHE
+      /* A buffer freed into a cache after the drain above, but before we
+       * were counted as a waiter, would never wake us up.  Drain again:
+       * the global free path posts the semaphore for those buffers.
+       */
+
+      iob_percpu_drain();
+#endif
+
       if (timeout == UINT_MAX)
         {
           ret = nxsem_wait_uninterruptible(sem);
@@ -301,6 +323,15 @@ FAR struct iob_s *iob_tryalloc(bool throttled)
   FAR struct iob_s *iob;
   irqstate_t flags;
 
+#ifdef CONFIG_IOB_PERCPU_CACHE
+  if (iob_percpu_alloc(&iob, 1, throttled) > 0)
+    {
+      return iob;
+    }
+
+  iob_percpu_drain();
+#endif
+
   /* We don't know what context we are called from so we use extreme measures
    * to protect the free list:  We disable interrupts very briefly.
    */
@@ -311,6 +342,46 @@ FAR struct iob_s *iob_tryalloc(bool throttled)
   return iob;
 }
 
+/****************************************************************************
+ * Name: iob_alloc_batch
+ *
+ * Description:
+ *   Try to allocate up to 'n' I/O buffers at once without waiting.  The
+ *   free list is locked only once for the whole batch.
+ *
+ * Input Parameters:
+ *   iobs      - The array that receives the allocated buffers
+ *   n         - The number of buffers requested
+ *   throttled - An indication of the IOB allocation is "throttled"
+ *
+ * Returned Value:
+ *   The number of buffers allocated, may be less than 'n'.
+ *
+ ****************************************************************************/
+
+int iob_alloc_batch(FAR struct iob_s **iobs, int n, bool throttled)
+{
+  irqstate_t flags;
+  int ret = 0;
+
+#ifdef CONFIG_IOB_PERCPU_CACHE
+  ret = iob_percpu_alloc(iobs, n, throttled);
+  if (ret == n)
+    {
+      return ret;
+    }
+#endif
+
+  flags = spin_lock_irqsave(&g_iob_lock);
+  while (ret < n && (iobs[ret] = iob_tryalloc_internal(throttled)) != NULL)
+    {
+      ret++;
+    }
+
+  spin_unlock_irqrestore(&g_iob_lock, flags);
+  return ret;
+}
+
 #ifdef CONFIG_IOB_ALLOC
 
 /****************************************************************************
@@ -68,6 +68,140 @@
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: iob_free_global
+ *
+ * Description:
+ *   Return a list of 'n' I/O buffers linked by io_flink (from 'head' to
+ *   'tail') to the global free list under a single acquisition of the IOB
+ *   lock.  Buffers are handed to waiting allocators first.
+ *
+ ****************************************************************************/
+
+void iob_free_global(FAR struct iob_s *head, FAR struct iob_s *tail,
+                     int16_t n)
+{
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+  int npost = 0;
+#if CONFIG_IOB_THROTTLE > 0
+  int nthrottle = 0;
+#endif
+
+  /* We don't know what context we are called from so we use extreme
+   * measures to protect the free list:  We disable interrupts very
+   * briefly.
+   */
+
+  flags = spin_lock_irqsave(&g_iob_lock);
+
+  /* Nobody is waiting, splice the whole list into the free list */
+
+  if (g_iob_count >= 0
+#if CONFIG_IOB_THROTTLE > 0
+      && g_throttle_wait == 0
+#endif
+     )
+    {
+      g_iob_count    += n;
+      tail->io_flink  = g_iob_freelist;
+      g_iob_freelist  = head;
+      head            = NULL;
+    }
+
+  /* Which list?  If there is a task waiting for an IOB, then put
+   * the IOB on either the free list or on the committed list where
+   * it is reserved for that allocation (and not available to
+   * iob_tryalloc()). This is true for both throttled and non-throttled
+   * cases.
+   */
+
+  while (head != NULL)
+    {
+      iob  = head;
+      head = iob->io_flink;
+
+      if (g_iob_count < 0)
+        {
+          g_iob_count++;
+          iob->io_flink   = g_iob_committed;
+          g_iob_committed = iob;
+          npost++;
+        }
+#if CONFIG_IOB_THROTTLE > 0
+      else if (g_throttle_wait > 0 && g_iob_count >= CONFIG_IOB_THROTTLE)
+        {
+          iob->io_flink   = g_iob_committed;
+          g_iob_committed = iob;
+          g_throttle_wait--;
+          nthrottle++;
+        }
+#endif
+      else
+        {
+          g_iob_count++;
+          iob->io_flink   = g_iob_freelist;
+          g_iob_freelist  = iob;
+        }
+    }
+
+  DEBUGASSERT(g_iob_count <= CONFIG_IOB_NBUFFERS);
+  spin_unlock_irqrestore(&g_iob_lock, flags);
+
+  while (npost-- > 0)
+    {
+      nxsem_post(&g_iob_sem);
+    }
+
+#if CONFIG_IOB_THROTTLE > 0
+  while (nthrottle-- > 0)
+    {
+      nxsem_post(&g_throttle_sem);
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: iob_free_list
+ *
+ * Description:
+ *   Free a list of 'n' I/O buffers linked by io_flink (from 'head' to
+ *   'tail') to the cache of this CPU or to the global free list.
+ *
+ ****************************************************************************/
+
+void iob_free_list(FAR struct iob_s *head, FAR struct iob_s *tail,
+                   int16_t n)
+{
+#ifdef CONFIG_IOB_NOTIFIER
+  int16_t navail;
+#endif
+
+#ifdef CONFIG_IOB_PERCPU_CACHE
+  if (!iob_percpu_free(head, tail, n))
+#endif
+    {
+      iob_free_global(head, tail, n);
+    }
+
+#ifdef CONFIG_IOB_NOTIFIER
+  /* Check if the IOB was claimed by a thread that is blocked waiting
+   * for an IOB.  The 'n' buffers may have stepped over the multiple of
+   * IOB_DIVIDER that a single free would have signaled at.
+   */
+
+  navail = iob_navail(false);
+  if (navail > 0 && (navail & ~IOB_MASK) != ((navail - n) & ~IOB_MASK))
+    {
+      /* Signal any threads that have requested a signal notification
+       * when an IOB becomes available.
+       */
+
+      iob_notifier_signal();
+    }
+#endif
+}
+
 /****************************************************************************
  * Name: iob_free
  *
@@ -80,10 +214,6 @@
 FAR struct iob_s *iob_free(FAR struct iob_s *iob)
 {
   FAR struct iob_s *next = iob->io_flink;
-  irqstate_t flags;
-#ifdef CONFIG_IOB_NOTIFIER
-  int16_t navail;
-#endif
 
   iobinfo("iob=%p io_pktlen=%u io_len=%u next=%p\n",
           iob, iob->io_pktlen, iob->io_len, next);
@@ -137,64 +267,12 @@ FAR struct iob_s *iob_free(FAR struct iob_s *iob)
     }
 #endif
 
-  /* Free the I/O buffer by adding it to the head of the free or the
-   * committed list. We don't know what context we are called from so
-   * we use extreme measures to protect the free list:  We disable
-   * interrupts very briefly.
+  /* Free the I/O buffer by adding it to the cache of this CPU or to the
+   * head of the free or the committed list.
    */
 
-  flags = spin_lock_irqsave(&g_iob_lock);
-
-  /* Which list?  If there is a task waiting for an IOB, then put
-   * the IOB on either the free list or on the committed list where
-   * it is reserved for that allocation (and not available to
-   * iob_tryalloc()). This is true for both throttled and non-throttled
-   * cases.
-   */
-
-  if (g_iob_count < 0)
-    {
-      g_iob_count++;
-      iob->io_flink   = g_iob_committed;
-      g_iob_committed = iob;
-      spin_unlock_irqrestore(&g_iob_lock, flags);
-      nxsem_post(&g_iob_sem);
-    }
-#if CONFIG_IOB_THROTTLE > 0
-  else if (g_throttle_wait > 0 && g_iob_count >= CONFIG_IOB_THROTTLE)
-    {
-      iob->io_flink   = g_iob_committed;
-      g_iob_committed = iob;
-      g_throttle_wait--;
-      spin_unlock_irqrestore(&g_iob_lock, flags);
-      nxsem_post(&g_throttle_sem);
-    }
-#endif
-  else
-    {
-      g_iob_count++;
-      iob->io_flink   = g_iob_freelist;
-      g_iob_freelist  = iob;
-      spin_unlock_irqrestore(&g_iob_lock, flags);
-    }
-
-  DEBUGASSERT(g_iob_count <= CONFIG_IOB_NBUFFERS);
-
-#ifdef CONFIG_IOB_NOTIFIER
-  /* Check if the IOB was claimed by a thread that is blocked waiting
-   * for an IOB.
-   */
-
-  navail = iob_navail(false);
-  if (navail > 0 && (navail & IOB_MASK) == 0)
-    {
-      /* Signal any threads that have requested a signal notification
-       * when an IOB becomes available.
-       */
-
-      iob_notifier_signal();
-    }
-#endif
+  iob->io_flink = NULL;
+  iob_free_list(iob, iob, 1);
 
   /* And return the I/O buffer after the one that was freed */
 
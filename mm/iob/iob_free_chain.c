@@ -40,18 +40,49 @@
  *
  * Description:
  *   Free an entire buffer chain, starting at the beginning of the I/O
- *   buffer chain
+ *   buffer chain.  The buffers are returned to the free list at once.
  *
  ****************************************************************************/
 
 void iob_free_chain(FAR struct iob_s *iob)
 {
+  FAR struct iob_s *head = NULL;
+  FAR struct iob_s *tail = NULL;
   FAR struct iob_s *next;
+  int16_t n = 0;
 
-  /* Free each IOB in the chain -- one at a time to keep the count straight */
+  /* Collect the buffers of the chain into one list so that they can be
+   * returned with a single lock acquisition.  The packet length kept in
+   * the head of the chain is irrelevant here since the whole chain goes.
+   */
 
   for (; iob; iob = next)
     {
-      next = iob_free(iob);
+      next = iob->io_flink;
+
+#ifdef CONFIG_IOB_ALLOC
+      /* Buffers with a custom free callback don't belong to the pool */
+
+      if (iob->io_free != NULL)
+        {
+          iob->io_flink = NULL;
+          iob_free(iob);
+          continue;
+        }
+#endif
+
+      iob->io_flink = head;
+      head = iob;
+      if (tail == NULL)
+        {
+          tail = iob;
+        }
+
+      n++;
+    }
+
+  if (head != NULL)
+    {
+      iob_free_list(head, tail, n);
     }
 }
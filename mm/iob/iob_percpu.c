@@ -0,0 +1,305 @@
+/****************************************************************************
+ * mm/iob/iob_percpu.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+#include <nuttx/mm/iob.h>
+
+#include "iob.h"
+
+#ifdef CONFIG_IOB_PERCPU_CACHE
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* The per-CPU caches of free I/O buffers */
+
+struct iob_percpu_s g_iob_percpu[CONFIG_SMP_NCPUS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_percpu_refill
+ *
+ * Description:
+ *   Move a batch of buffers from the global free list into the cache.  The
+ *   cache lock must be held by the caller.
+ *
+ ****************************************************************************/
+
+static void iob_percpu_refill(FAR struct iob_percpu_s *cache)
+{
+  FAR struct iob_s *iob;
+
+  spin_lock(&g_iob_lock);
+  while (cache->count < IOB_PERCPU_BATCH && g_iob_count > 0 &&
+         (iob = g_iob_freelist) != NULL)
+    {
+      g_iob_freelist = iob->io_flink;
+      g_iob_count--;
+
+      iob->io_flink = cache->head;
+      cache->head   = iob;
+      cache->count++;
+    }
+
+  spin_unlock(&g_iob_lock);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_percpu_alloc
+ *
+ * Description:
+ *   Allocate up to 'n' I/O buffers from the cache of this CPU, refilling
+ *   the cache from the global free list as necessary.  Never waits.
+ *
+ * Returned Value:
+ *   The number of buffers returned in 'iobs'.
+ *
+ ****************************************************************************/
+
+int iob_percpu_alloc(FAR struct iob_s **iobs, int n, bool throttled)
+{
+  FAR struct iob_percpu_s *cache;
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+  int ret = 0;
+
+#if CONFIG_IOB_THROTTLE > 0
+  /* Throttled allocations must leave CONFIG_IOB_THROTTLE buffers for the
+   * others, wherever those buffers are cached.
+   */
+
+  if (throttled)
+    {
+      int navail = iob_navail(true);
+
+      if (navail <= 0)
+        {
+          return 0;
+        }
+      else if (n > navail)
+        {
+          n = navail;
+        }
+    }
+#endif
+
+  flags = up_irq_save();
+  cache = &g_iob_percpu[this_cpu()];
+  spin_lock(&cache->lock);
+
+  while (ret < n)
+    {
+      if (cache->count == 0)
+        {
+          iob_percpu_refill(cache);
+          if (cache->count == 0)
+            {
+              break;
+            }
+        }
+
+      iob         = cache->head;
+      cache->head = iob->io_flink;
+      cache->count--;
+
+      /* Put the I/O buffer in a known state */
+
+      iob->io_flink  = NULL; /* Not in a chain */
+      iob->io_len    = 0;    /* Length of the data in the entry */
+      iob->io_offset = 0;    /* Offset to the beginning of data */
+      iob->io_pktlen = 0;    /* Total length of the packet */
+      iobs[ret++]    = iob;
+    }
+
+  spin_unlock(&cache->lock);
+  up_irq_restore(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: iob_percpu_free
+ *
+ * Description:
+ *   Put a list of 'n' free I/O buffers into the cache of this CPU, the
+ *   overflow is returned to the global free list.
+ *
+ * Returned Value:
+ *   False if the buffers were not taken because an allocator is waiting;
+ *   the caller must then use iob_free_global().
+ *
+ ****************************************************************************/
+
+bool iob_percpu_free(FAR struct iob_s *head, FAR struct iob_s *tail,
+                     int16_t n)
+{
+  FAR struct iob_percpu_s *cache;
+  FAR struct iob_s *flush = NULL;
+  FAR struct iob_s *last = NULL;
+  irqstate_t flags;
+  int16_t nflush = 0;
+  int16_t i;
+
+  flags = up_irq_save();
+  cache = &g_iob_percpu[this_cpu()];
+  spin_lock(&cache->lock);
+
+  /* Waiters are only woken up by the global free path.  Check for them
+   * under g_iob_lock, while the cache is locked: a waiter registers under
+   * g_iob_lock and then drains the caches, so either we see it here, or
+   * its drain finds the buffers once we have put them into the cache.
+   */
+
+  spin_lock(&g_iob_lock);
+  if (g_iob_count < 0
+#if CONFIG_IOB_THROTTLE > 0
+      || g_throttle_wait > 0
+#endif
+     )
+    {
+      spin_unlock(&g_iob_lock);
+      spin_unlock(&cache->lock);
+      up_irq_restore(flags);
+      return false;
+    }
+
+  spin_unlock(&g_iob_lock);
+
+  tail->io_flink = cache->head;
+  cache->head    = head;
+  cache->count  += n;
+
+  /* Keep the most recently freed (cache hot) IOB_PERCPU_BATCH buffers and
+   * return the rest to the global free list.
+   */
+
+  if (cache->count > CONFIG_IOB_PERCPU_CACHE_SIZE)
+    {
+      last = cache->head;
+      for (i = 1; i < IOB_PERCPU_BATCH; i++)
+        {
+          last = last->io_flink;
+        }
+
+      flush          = last->io_flink;
+      last->io_flink = NULL;
+      nflush         = cache->count - IOB_PERCPU_BATCH;
+      cache->count   = IOB_PERCPU_BATCH;
+
+      for (last = flush; last->io_flink != NULL; last = last->io_flink)
+        {
+        }
+    }
+
+  spin_unlock(&cache->lock);
+  up_irq_restore(flags);
+
+  if (flush != NULL)
+    {
+      iob_free_global(flush, last, nflush);
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: iob_percpu_drain
+ *
+ * Description:
+ *   Return the buffers held by the caches of all CPUs to the global free
+ *   list.
+ *
+ ****************************************************************************/
+
+void iob_percpu_drain(void)
+{
+  FAR struct iob_percpu_s *cache;
+  FAR struct iob_s *head;
+  FAR struct iob_s *tail;
+  irqstate_t flags;
+  int16_t n;
+  int cpu;
+
+  /* The count is not checked without the lock, a buffer being put into
+   * the cache right now must not be missed.
+   */
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      cache = &g_iob_percpu[cpu];
+      flags = spin_lock_irqsave(&cache->lock);
+      head         = cache->head;
+      n            = cache->count;
+      cache->head  = NULL;
+      cache->count = 0;
+      spin_unlock_irqrestore(&cache->lock, flags);
+
+      if (head != NULL)
+        {
+          for (tail = head; tail->io_flink != NULL; tail = tail->io_flink)
+            {
+            }
+
+          iob_free_global(head, tail, n);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: iob_percpu_count
+ *
+ * Description:
+ *   Return the number of buffers held by the caches of all CPUs.
+ *
+ ****************************************************************************/
+
+int iob_percpu_count(void)
+{
+  int count = 0;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      count += g_iob_percpu[cpu].count;
+    }
+
+  return count;
+}
+
+#endif /* CONFIG_IOB_PERCPU_CACHE */
@@ -54,9 +54,11 @@
 
 void iob_getstats(FAR struct iob_stats_s *stats)
 {
+  int count = g_iob_count;
+
   stats->ntotal = CONFIG_IOB_NBUFFERS;
 
-  stats->nfree = g_iob_count;
+  stats->nfree = count;
   if (stats->nfree < 0)
     {
       stats->nwait = -stats->nfree;
@@ -67,8 +69,15 @@ void iob_getstats(FAR struct iob_stats_s *stats)
       stats->nwait = 0;
     }
 
+#ifdef CONFIG_IOB_PERCPU_CACHE
+  /* The buffers in the per-CPU caches are free too */
+
+  stats->nfree += iob_percpu_count();
+  count = stats->nfree - stats->nwait;
+#endif
+
 #if CONFIG_IOB_THROTTLE > 0
-  stats->nthrottle = (g_iob_count - CONFIG_IOB_THROTTLE);
+  stats->nthrottle = (count - CONFIG_IOB_THROTTLE);
   if (stats->nthrottle < 0)
 #endif
     {
@@ -28,6 +28,7 @@
 #include <execinfo.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <string.h>
 #include <syslog.h>
 
 #include <nuttx/kmalloc.h>
@@ -42,6 +43,13 @@
 
 #define MEMPOOL_HEADER_SIZE (sizeof(sq_entry_t) + CONFIG_MM_NODE_GUARDSIZE)
 
+#ifdef CONFIG_MM_HEAP_MEMPOOL_MAGAZINE
+/* The number of blocks moved between a magazine and its pool at once */
+
+#  define MEMPOOL_MAGAZINE_BATCH \
+          ((CONFIG_MM_HEAP_MEMPOOL_MAGAZINE_SIZE + 1) / 2)
+#endif
+
 #if CONFIG_MM_BACKTRACE >= 0
 #define MEMPOOL_MAGIC_FREE  0x55555555
 #define MEMPOOL_MAGIC_ALLOC 0xAAAAAAAA
@@ -100,6 +108,124 @@ static inline void mempool_add_queue(FAR struct mempool_s *pool,
     }
 }
 
+#ifdef CONFIG_MM_HEAP_MEMPOOL_MAGAZINE
+/****************************************************************************
+ * Name: mempool_magazine_count
+ *
+ * Description:
+ *   Return the number of free blocks parked in the per-CPU magazines.  The
+ *   blocks in the magazines are accounted in pool->nalloc.
+ *
+ ****************************************************************************/
+
+static size_t mempool_magazine_count(FAR struct mempool_s *pool)
+{
+  size_t count = 0;
+  int cpu;
+
+  if (pool->mag != NULL)
+    {
+      for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+        {
+          count += pool->mag[cpu].count;
+        }
+    }
+
+  return count;
+}
+
+/****************************************************************************
+ * Name: mempool_magazine_alloc
+ *
+ * Description:
+ *   Take a block from the magazine of this CPU, refill the magazine with a
+ *   batch of blocks from the pool free queue if it is empty.  Return NULL
+ *   if both are empty, the caller then falls back to the slow path which
+ *   expands the pool.
+ *
+ ****************************************************************************/
+
+static FAR void *mempool_magazine_alloc(FAR struct mempool_s *pool)
+{
+  FAR struct mempool_magazine_s *mag;
+  FAR void *blk = NULL;
+  irqstate_t flags;
+
+  flags = up_irq_save();
+  mag = &pool->mag[this_cpu()];
+  if (mag->count == 0)
+    {
+      FAR sq_entry_t *entry;
+
+      mag->nmiss++;
+      spin_lock(&pool->lock);
+      while (mag->count < MEMPOOL_MAGAZINE_BATCH &&
+             (entry = mempool_remove_queue(pool, &pool->queue)) != NULL)
+        {
+          mag->blks[mag->count++] = entry;
+        }
+
+      pool->nalloc += mag->count;
+      spin_unlock(&pool->lock);
+    }
+  else
+    {
+      mag->nhit++;
+    }
+
+  if (mag->count > 0)
+    {
+      blk = mag->blks[--mag->count];
+    }
+
+  up_irq_restore(flags);
+  return blk;
+}
+
+/****************************************************************************
+ * Name: mempool_magazine_release
+ *
+ * Description:
+ *   Put a free block into the magazine of this CPU, hand the oldest batch
+ *   of blocks back to the pool free queue if the magazine is full.
+ *
+ ****************************************************************************/
+
+static void mempool_magazine_release(FAR struct mempool_s *pool,
+                                     FAR void *blk)
+{
+  FAR struct mempool_magazine_s *mag;
+  irqstate_t flags;
+  size_t i;
+
+  flags = up_irq_save();
+  mag = &pool->mag[this_cpu()];
+  if (mag->count == CONFIG_MM_HEAP_MEMPOOL_MAGAZINE_SIZE)
+    {
+      mag->nmiss++;
+      spin_lock(&pool->lock);
+      for (i = 0; i < MEMPOOL_MAGAZINE_BATCH; i++)
+        {
+          sq_addlast(mag->blks[i], &pool->queue);
+        }
+
+      pool->nalloc -= MEMPOOL_MAGAZINE_BATCH;
+      spin_unlock(&pool->lock);
+
+      mag->count -= MEMPOOL_MAGAZINE_BATCH;
+      memmove(mag->blks, &mag->blks[MEMPOOL_MAGAZINE_BATCH],
+              mag->count * sizeof(mag->blks[0]));
+    }
+  else
+    {
+      mag->nhit++;
+    }
+
+  mag->blks[mag->count++] = blk;
+  up_irq_restore(flags);
+}
+#endif
+
 #if CONFIG_MM_BACKTRACE >= 0
 static inline void mempool_add_backtrace(FAR struct mempool_s *pool,
                                          FAR struct mempool_backtrace_s *buf)
@@ -269,6 +395,19 @@ int mempool_init(FAR struct mempool_s *pool, FAR const char *name)
   sq_init(&pool->iqueue);
   sq_init(&pool->equeue);
   pool->nalloc = 0;
+#ifdef CONFIG_MM_HEAP_MEMPOOL_MAGAZINE
+  if (pool->mag != NULL)
+    {
+      /* The magazines bypass the interrupt queue and the waiters, they
+       * are only usable by an expandable pool.
+       */
+
+      DEBUGASSERT(pool->expandsize > 0 && pool->interruptsize == 0);
+      memset(pool->mag, 0,
+             CONFIG_SMP_NCPUS * sizeof(struct mempool_magazine_s));
+    }
+#endif
+
   if (pool->interruptsize >= blocksize)
     {
       size_t ninterrupt = pool->interruptsize / blocksize;
@@ -354,6 +493,17 @@ FAR void *mempool_allocate(FAR struct mempool_s *pool)
   FAR sq_entry_t *blk;
   irqstate_t flags;
 
+#ifdef CONFIG_MM_HEAP_MEMPOOL_MAGAZINE
+  if (pool->mag != NULL)
+    {
+      blk = mempool_magazine_alloc(pool);
+      if (blk != NULL)
+        {
+          goto out;
+        }
+    }
+#endif
+
 retry:
   flags = spin_lock_irqsave(&pool->lock);
   blk = mempool_remove_queue(pool, &pool->queue);
@@ -409,6 +559,9 @@ retry:
   pool->nalloc++;
   spin_unlock_irqrestore(&pool->lock, flags);
 
+#ifdef CONFIG_MM_HEAP_MEMPOOL_MAGAZINE
+out:
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
   mempool_add_backtrace(pool, (FAR struct mempool_backtrace_s *)
                               ((FAR char *)blk + pool->blocksize));
@@ -435,11 +588,31 @@ retry:
 
 void mempool_release(FAR struct mempool_s *pool, FAR void *blk)
 {
-  irqstate_t flags = spin_lock_irqsave(&pool->lock);
 #if CONFIG_MM_BACKTRACE >= 0
   FAR struct mempool_backtrace_s *buf =
     (FAR struct mempool_backtrace_s *)((FAR char *)blk + pool->blocksize);
+#endif
+  irqstate_t flags;
+
+#ifdef CONFIG_MM_HEAP_MEMPOOL_MAGAZINE
+  if (pool->mag != NULL)
+    {
+#  if CONFIG_MM_BACKTRACE >= 0
+      DEBUGASSERT(buf->magic == MEMPOOL_MAGIC_ALLOC);
+      buf->magic = MEMPOOL_MAGIC_FREE;
+#  endif
+#  ifdef CONFIG_MM_FILL_ALLOCATIONS
+      memset(blk, MM_FREE_MAGIC, pool->blocksize);
+#  endif
+
+      kasan_poison(blk, pool->blocksize);
+      mempool_magazine_release(pool, blk);
+      return;
+    }
+#endif
 
+  flags = spin_lock_irqsave(&pool->lock);
+#if CONFIG_MM_BACKTRACE >= 0
   /* Check double free or out of out of bounds */
 
   DEBUGASSERT(buf->magic == MEMPOOL_MAGIC_ALLOC);
@@ -509,6 +682,24 @@ int mempool_info(FAR struct mempool_s *pool, FAR struct mempoolinfo_s *info)
   info->ordblks = sq_count(&pool->queue);
   info->iordblks = sq_count(&pool->iqueue);
   info->aordblks = pool->nalloc;
+#ifdef CONFIG_MM_HEAP_MEMPOOL_MAGAZINE
+  info->nhit = 0;
+  info->nmiss = 0;
+  if (pool->mag != NULL)
+    {
+      size_t cached = mempool_magazine_count(pool);
+      int cpu;
+
+      info->ordblks += cached;
+      info->aordblks -= cached;
+      for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+        {
+          info->nhit += pool->mag[cpu].nhit;
+          info->nmiss += pool->mag[cpu].nmiss;
+        }
+    }
+#endif
+
   info->arena = sq_count(&pool->equeue) * MEMPOOL_HEADER_SIZE +
     (info->aordblks + info->ordblks + info->iordblks) * blocksize;
   spin_unlock_irqrestore(&pool->lock, flags);
@@ -548,14 +739,23 @@ mempool_info_task(FAR struct mempool_s *pool,
       size_t count = sq_count(&pool->queue) +
                      sq_count(&pool->iqueue);
 
+#ifdef CONFIG_MM_HEAP_MEMPOOL_MAGAZINE
+      count += mempool_magazine_count(pool);
+#endif
+
       spin_unlock_irqrestore(&pool->lock, flags);
       info.aordblks += count;
       info.uordblks += count * blocksize;
     }
   else if (task->pid == PID_MM_ALLOC)
     {
-      info.aordblks += pool->nalloc;
-      info.uordblks += pool->nalloc * blocksize;
+      size_t count = pool->nalloc;
+
+#ifdef CONFIG_MM_HEAP_MEMPOOL_MAGAZINE
+      count -= mempool_magazine_count(pool);
+#endif
+      info.aordblks += count;
+      info.uordblks += count * blocksize;
     }
 #if CONFIG_MM_BACKTRACE >= 0
   else
@@ -625,6 +825,31 @@ int mempool_deinit(FAR struct mempool_s *pool)
   FAR sq_entry_t *blk;
   size_t count = 0;
 
+#ifdef CONFIG_MM_HEAP_MEMPOOL_MAGAZINE
+  if (pool->mag != NULL)
+    {
+      irqstate_t flags = spin_lock_irqsave(&pool->lock);
+      int cpu;
+
+      /* Drain the magazines so that the cached blocks aren't reported as
+       * in use.
+       */
+
+      for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+        {
+          FAR struct mempool_magazine_s *mag = &pool->mag[cpu];
+
+          pool->nalloc -= mag->count;
+          while (mag->count > 0)
+            {
+              sq_addlast(mag->blks[--mag->count], &pool->queue);
+            }
+        }
+
+      spin_unlock_irqrestore(&pool->lock, flags);
+    }
+#endif
+
   if (pool->nalloc != 0)
     {
       return -EBUSY;
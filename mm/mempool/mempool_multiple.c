@@ -403,6 +403,9 @@ mempool_multiple_init(FAR const char *name,
 {
   FAR struct mempool_multiple_s *mpool;
   FAR struct mempool_s *pools;
+#ifdef CONFIG_MM_HEAP_MEMPOOL_MAGAZINE
+  FAR struct mempool_magazine_s *mags;
+#endif
   size_t maxpoolszie;
   size_t minpoolsize;
   int ret;
@@ -453,6 +456,23 @@ mempool_multiple_init(FAR const char *name,
   mpool->minpoolsize = minpoolsize;
   mpool->delta = 0;
 
+#ifdef CONFIG_MM_HEAP_MEMPOOL_MAGAZINE
+  /* The per-CPU magazines of all pools share one allocation, pools[0].mag
+   * is the start of it.
+   */
+
+  mags = alloc(arg, sizeof(struct mempool_magazine_s),
+               npools * CONFIG_SMP_NCPUS *
+               sizeof(struct mempool_magazine_s));
+  if (mags == NULL)
+    {
+      free(arg, mpool);
+      return NULL;
+    }
+
+  mpool->alloced += alloc_size(arg, mags);
+#endif
+
   for (i = 0; i < npools; i++)
     {
       pools[i].blocksize = poolsize[i];
@@ -463,6 +483,9 @@ mempool_multiple_init(FAR const char *name,
       pools[i].alloc = mempool_multiple_alloc_callback;
       pools[i].free = mempool_multiple_free_callback;
       pools[i].check = mempool_multiple_check;
+#ifdef CONFIG_MM_HEAP_MEMPOOL_MAGAZINE
+      pools[i].mag = mags + i * CONFIG_SMP_NCPUS;
+#endif
 #ifdef CONFIG_MM_HEAP_MEMPOOL_WAIT_RELEASE
       pools[i].wait = true;
 #else
@@ -514,6 +537,9 @@ err_with_pools:
       mempool_deinit(pools + i);
     }
 
+#ifdef CONFIG_MM_HEAP_MEMPOOL_MAGAZINE
+  free(arg, mags);
+#endif
   mempool_multiple_free_chunk(mpool, pools);
   return NULL;
 }
@@ -879,6 +905,10 @@ void mempool_multiple_deinit(FAR struct mempool_multiple_s *mpool)
       DEBUGVERIFY(mempool_deinit(mpool->pools + i));
     }
 
+#ifdef CONFIG_MM_HEAP_MEMPOOL_MAGAZINE
+  mpool->free(mpool->arg, mpool->pools[0].mag);
+#endif
+
   for (i = 0; i < mpool->dict_row_num; i++)
     {
       if (mpool->dict[i] != NULL)
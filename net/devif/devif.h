@@ -185,6 +185,11 @@
  *                        out pending IP fragments.  This is a device
  *                        oriented event, not associated with a socket.
  *                   OUT: Not used
+ *   GSO_POLL         IN: Used for polling the segments of a TCP
+ *                        super-segment split in software.  This is a
+ *                        device oriented event, not associated with a
+ *                        socket.
+ *                   OUT: Not used
  */
 
 /* Bits 0-10: Connection specific event bits */
@@ -220,7 +225,7 @@
 
 #define NETDEV_DOWN        (1 << 17)
 
-/* Bits 18-24: device specific poll events.  Unlike connection
+/* Bits 18-25: device specific poll events.  Unlike connection
  * oriented poll events, device related poll events must distinguish
  * between what is being polled for since the callbacks all reside in
  * the same list in the network device structure.
@@ -233,6 +238,7 @@
 #define ICMP_POLL          (1 << 22)
 #define ICMPv6_POLL        (1 << 23)
 #define IPFWD_POLL         (1 << 24)
+#define GSO_POLL           (1 << 25)
 
 /* The set of events that and implications to the TCP connection state */
 
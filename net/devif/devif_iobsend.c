@@ -73,7 +73,15 @@ int devif_iob_send(FAR struct net_driver_s *dev, FAR struct iob_s *iob,
       goto errout;
     }
 
-#ifndef CONFIG_NET_IPFRAG
+#ifdef CONFIG_NET_TCP_GSO
+  /* TCP super-segments are split by tcp_gso_out() or by the device */
+
+  if (len > CONFIG_NET_TCP_GSO_MAXSIZE - target_offset)
+    {
+      ret = -EMSGSIZE;
+      goto errout;
+    }
+#elif !defined(CONFIG_NET_IPFRAG)
   if (len > NETDEV_PKTSIZE(dev) - NET_LL_HDRLEN(dev) - target_offset)
     {
       ret = -EMSGSIZE;
@@ -785,6 +785,86 @@ static inline_function int devif_poll_ipfrag(FAR struct net_driver_s *dev,
 }
 #endif
 
+/****************************************************************************
+ * Name: devif_poll_gso
+ *
+ * Description:
+ *   Send the segments of a TCP super-segment split in software.
+ *
+ * Input Parameters:
+ *   dev - NIC Device instance.
+ *   callback - the actual sending API provided by each NIC driver.
+ *
+ * Returned Value:
+ *   Zero indicated the polling will continue, else stop the polling.
+ *
+ * Assumptions:
+ *   This function is called from the MAC device driver with the network
+ *   locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_GSO
+static int devif_poll_gso(FAR struct net_driver_s *dev,
+                          devif_poll_callback_t callback)
+{
+  FAR struct iob_s *iob;
+  bool reused = false;
+  int bstop = false;
+
+  while (!bstop)
+    {
+      /* Cut the next segment */
+
+      iob = tcp_gso_segment(dev);
+      if (iob == NULL)
+        {
+          break;
+        }
+
+      /* buffer could be reused for other protocols */
+
+      reused = true;
+
+      /* Replace original iob */
+
+      netdev_iob_replace(dev, iob);
+
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+      if ((IOB_DATA(iob)[0] & IP_VERSION_MASK) == IPv4_VERSION)
+        {
+          IFF_SET_IPv4(dev->d_flags);
+        }
+      else
+        {
+          IFF_SET_IPv6(dev->d_flags);
+        }
+#endif
+
+      /* build L2 headers */
+
+      devif_out(dev);
+
+      /* Call back into the driver */
+
+      if (dev->d_len > 0)
+        {
+          bstop = callback(dev);
+        }
+    }
+
+  /* Reuse iob buffer */
+
+  if (!bstop && reused)
+    {
+      iob_update_pktlen(dev->d_iob, 0, false);
+      netdev_iob_prepare(dev, true, 0);
+    }
+
+  return bstop;
+}
+#endif
+
 /****************************************************************************
  * Name: devif_poll_arp
  *
@@ -859,6 +939,14 @@ static int devif_poll_connections(FAR struct net_driver_s *dev,
 
   dev->d_len = 0;
 
+#ifdef CONFIG_NET_TCP_GSO
+  /* Finish a TCP super-segment first, the TCP poll must not send new data
+   * ahead of its segments.
+   */
+
+  bstop = devif_poll_gso(dev, callback);
+#endif
+
   /* Traverse all of the active packet connections and perform the poll
    * action.
    */
@@ -990,6 +1078,14 @@ static int devif_poll_connections(FAR struct net_driver_s *dev,
           case IPFWD_POLL:
             bstop = devif_poll_forward(dev, callback);
             break;
+#endif
+#ifdef CONFIG_NET_TCP_GSO
+          case GSO_POLL:
+
+            /* Send the segments of a TCP super-segment */
+
+            bstop = devif_poll_gso(dev, callback);
+            break;
 #endif
           default:
             nerr("ERROR: Unhandled poll type: %d\n", i - 1);
@@ -1271,6 +1367,16 @@ int devif_poll_out(FAR struct net_driver_s *dev,
       return 0;
     }
 
+#ifdef CONFIG_NET_TCP_GSO
+  /* Split a TCP super-segment that the device cannot take as a whole */
+
+  tcp_gso_out(dev);
+  if (dev->d_len == 0)
+    {
+      return callback ? devif_poll_gso(dev, callback) : 0;
+    }
+#endif
+
   devif_out(dev);
 
   bstop = devif_loopback(dev);
@@ -57,6 +57,7 @@
 #include <arch/irq.h>
 
 #include <nuttx/arch.h>
+#include <nuttx/mutex.h>
 #include <nuttx/wdog.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/queue.h>
@@ -222,13 +223,15 @@ void igmp_grpfree(FAR struct net_driver_s *dev,
 
   wd_cancel(&group->wdog);
 
-  /* Cancel the workqueue */
+  /* Cancel the workqueue.  The timeout work takes the device lock to send
+   * its report, so the device lock must be released while waiting for it.
+   */
 
-  blresult = net_breaklock(&count);
+  blresult = nxrmutex_breaklock(&dev->d_lock, &count);
   work_cancel_sync(LPWORK, &group->work);
   if (blresult >= 0)
     {
-      net_restorelock(count);
+      nxrmutex_restorelock(&dev->d_lock, count);
     }
 
   /* Remove the group structure from the group list in the device structure */
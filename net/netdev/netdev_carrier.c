@@ -35,6 +35,7 @@
 
 #include <net/if.h>
 #include <net/ethernet.h>
+#include <nuttx/mm/iob.h>
 #include <nuttx/net/netdev.h>
 
 #include "ipfrag/ipfrag.h"
@@ -92,6 +93,13 @@ void netdev_carrier_off(FAR struct net_driver_s *dev)
       ip_frag_stop(dev);
 #endif
 
+#ifdef CONFIG_NET_TCP_GSO
+      /* Drop the rest of a TCP super-segment being split */
+
+      iob_free_chain(dev->d_gso);
+      dev->d_gso = NULL;
+#endif
+
       /* Notify clients that the network has been taken down */
 
       devif_dev_event(dev, NETDEV_DOWN);
@@ -68,6 +68,10 @@ static int netprocfs_sent(FAR struct netprocfs_file_s *netfile);
 #ifdef CONFIG_NET_TCP
 static int netprocfs_retransmissions(FAR struct netprocfs_file_s *netfile);
 #endif /* CONFIG_NET_TCP */
+#if defined(CONFIG_NET_TCP_CONN_HASH) || defined(CONFIG_NET_UDP_CONN_HASH)
+static int netprocfs_hashlookup(FAR struct netprocfs_file_s *netfile);
+static int netprocfs_hashprobe(FAR struct netprocfs_file_s *netfile);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -102,6 +106,11 @@ static const linegen_t g_stat_linegen[] =
 #ifdef CONFIG_NET_TCP
   , netprocfs_retransmissions
 #endif /* CONFIG_NET_TCP */
+
+#if defined(CONFIG_NET_TCP_CONN_HASH) || defined(CONFIG_NET_UDP_CONN_HASH)
+  , netprocfs_hashlookup
+  , netprocfs_hashprobe
+#endif
 };
 
 #define NSTAT_LINES (sizeof(g_stat_linegen) / sizeof(linegen_t))
@@ -449,6 +458,73 @@ static int netprocfs_retransmissions(FAR struct netprocfs_file_s *netfile)
 }
 #endif /* CONFIG_NET_STATISTICS && CONFIG_NET_TCP */
 
+/****************************************************************************
+ * Name: netprocfs_hash
+ *
+ * Description:
+ *   Generate the line of connection hash lookups or of the connections
+ *   examined by those lookups.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_STATISTICS) && \
+    (defined(CONFIG_NET_TCP_CONN_HASH) || defined(CONFIG_NET_UDP_CONN_HASH))
+static int netprocfs_hash(FAR struct netprocfs_file_s *netfile, bool probe)
+{
+  int len = 0;
+
+  len += snprintf(&netfile->line[len], NET_LINELEN - len,
+                  probe ? "  Probe    " : "Hash lookup");
+#ifdef CONFIG_NET_IPv4
+  len += snprintf(&netfile->line[len], NET_LINELEN - len, "  ----");
+#endif
+#ifdef CONFIG_NET_IPv6
+  len += snprintf(&netfile->line[len], NET_LINELEN - len, "  ----");
+#endif
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
+                  probe ? g_netstats.tcp.hashprobe :
+                          g_netstats.tcp.hashlookup);
+#elif defined(CONFIG_NET_TCP)
+  len += snprintf(&netfile->line[len], NET_LINELEN - len, "  ----");
+#endif
+#ifdef CONFIG_NET_UDP_CONN_HASH
+  len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
+                  probe ? g_netstats.udp.hashprobe :
+                          g_netstats.udp.hashlookup);
+#elif defined(CONFIG_NET_UDP)
+  len += snprintf(&netfile->line[len], NET_LINELEN - len, "  ----");
+#endif
+#ifdef CONFIG_NET_ICMP
+  len += snprintf(&netfile->line[len], NET_LINELEN - len, "  ----");
+#endif
+#ifdef CONFIG_NET_ICMPv6
+  len += snprintf(&netfile->line[len], NET_LINELEN - len, "  ----");
+#endif
+#ifdef CONFIG_NET_CAN
+  len += snprintf(&netfile->line[len], NET_LINELEN - len, "  ----");
+#endif
+
+  len += snprintf(&netfile->line[len], NET_LINELEN - len, "\n");
+  return len;
+}
+
+/****************************************************************************
+ * Name: netprocfs_hashlookup and netprocfs_hashprobe
+ ****************************************************************************/
+
+static int netprocfs_hashlookup(FAR struct netprocfs_file_s *netfile)
+{
+  return netprocfs_hash(netfile, false);
+}
+
+static int netprocfs_hashprobe(FAR struct netprocfs_file_s *netfile)
+{
+  return netprocfs_hash(netfile, true);
+}
+#endif /* CONFIG_NET_STATISTICS && (CONFIG_NET_TCP_CONN_HASH ||
+        * CONFIG_NET_UDP_CONN_HASH) */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -80,6 +80,9 @@ static int netprocfs_rxpackets(FAR struct netprocfs_file_s *netfile);
 static int netprocfs_txstatistics_header(
     FAR struct netprocfs_file_s *netfile);
 static int netprocfs_txstatistics(FAR struct netprocfs_file_s *netfile);
+#ifdef CONFIG_NETDEV_GRO
+static int netprocfs_grostatistics(FAR struct netprocfs_file_s *netfile);
+#endif
 static int netprocfs_errors(FAR struct netprocfs_file_s *netfile);
 #endif /* CONFIG_NETDEV_STATISTICS */
 
@@ -116,6 +119,9 @@ static const linegen_t g_netstat_linegen[] =
   netprocfs_rxpackets,
   netprocfs_txstatistics_header,
   netprocfs_txstatistics,
+#ifdef CONFIG_NETDEV_GRO
+  netprocfs_grostatistics,
+#endif
   netprocfs_errors
 #endif /* CONFIG_NETDEV_STATISTICS */
 };
@@ -558,6 +564,26 @@ static int netprocfs_txstatistics(FAR struct netprocfs_file_s *netfile)
 }
 #endif /* CONFIG_NETDEV_STATISTICS */
 
+/****************************************************************************
+ * Name: netprocfs_grostatistics
+ ****************************************************************************/
+
+#if defined(CONFIG_NETDEV_STATISTICS) && defined(CONFIG_NETDEV_GRO)
+static int netprocfs_grostatistics(FAR struct netprocfs_file_s *netfile)
+{
+  FAR struct netdev_statistics_s *stats;
+  FAR struct net_driver_s *dev;
+
+  DEBUGASSERT(netfile != NULL && netfile->dev != NULL);
+  dev = netfile->dev;
+  stats = &dev->d_statistics;
+
+  return snprintf(netfile->line, NET_LINELEN,
+                  "\tGRO: Packets %08" PRIx32 " Segments %08" PRIx32 "\n",
+                  stats->rx_gro_packets, stats->rx_gro_segs);
+}
+#endif /* CONFIG_NETDEV_STATISTICS && CONFIG_NETDEV_GRO */
+
 /****************************************************************************
  * Name: netprocfs_errors
  ****************************************************************************/
@@ -111,6 +111,35 @@
 
 #define TCP_INFR              0x08U /* The flag in Fast Recovery */
 #define TCP_INFT              0x10U /* The flag in Fast Transmitted */
+#define TCP_CC_TIMING         0x20U /* An RTT sample is being timed */
+
+/* Size of the per-connection private state of the congestion control
+ * algorithm.  NewReno keeps all of its state in the common fields.
+ */
+
+#if defined(CONFIG_NET_TCP_CC_BBR)
+#  define TCP_CC_PRIV_SIZE    64
+#elif defined(CONFIG_NET_TCP_CC_CUBIC)
+#  define TCP_CC_PRIV_SIZE    32
+#endif
+
+#ifdef TCP_CC_PRIV_SIZE
+#  define TCP_CC_PRIV(conn)   ((FAR void *)(conn)->cc_priv)
+#endif
+
+/* Increments a size inc and holds at max value rather than rollover. */
+
+#define CC_CWND_INC(wnd, inc) \
+ do { \
+  if ((uint32_t)((wnd) + (inc)) >= (wnd)) \
+    { \
+      (wnd) = (uint32_t)((wnd) + (inc)); \
+    } \
+  else \
+    { \
+      (wnd) = (uint32_t)-1; \
+    } \
+ } while(0)
 
 #endif
 
@@ -176,6 +205,43 @@ struct tcp_sack_s
   uint32_t right;   /* Right edge of the SACK */
 };
 
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+/* A sample taken when an ACK acknowledges new data.  rtt is non-zero only
+ * when the ACK completes the timing of a segment, in which case delivered
+ * holds the number of bytes acknowledged during that round trip.
+ */
+
+struct tcp_cc_sample_s
+{
+  uint32_t acked;     /* Bytes acknowledged by this ACK */
+  uint32_t rtt;       /* Round trip time sample (units: microseconds) */
+  uint32_t delivered; /* Bytes acknowledged during the timed round trip */
+};
+
+/* A congestion control algorithm.  The common code implements the RFC 5681
+ * loss detection and the fast recovery (RFC 6582), the algorithm decides
+ * how cwnd and ssthresh evolve:
+ *
+ *   init - Reset the algorithm private state.  Called when the connection
+ *          is established and when the algorithm is changed on a live
+ *          connection.
+ *   ack  - New data was acknowledged outside the fast recovery.
+ *   loss - Fast retransmit was triggered, set ssthresh.  The common code
+ *          then sets cwnd to ssthresh + 3 * mss.
+ *   rto  - The retransmission timer expired, set ssthresh and cwnd.
+ */
+
+struct tcp_cc_ops_s
+{
+  FAR const char *name;
+  CODE void (*init)(FAR struct tcp_conn_s *conn);
+  CODE void (*ack)(FAR struct tcp_conn_s *conn,
+                   FAR const struct tcp_cc_sample_s *rs);
+  CODE void (*loss)(FAR struct tcp_conn_s *conn);
+  CODE void (*rto)(FAR struct tcp_conn_s *conn);
+};
+#endif
+
 struct tcp_conn_s
 {
   /* Common prologue of all connection structures. */
@@ -236,6 +302,10 @@ struct tcp_conn_s
 #endif
   uint16_t lport;         /* The local TCP port, in network byte order */
   uint16_t rport;         /* The remoteTCP port, in network byte order */
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  dq_entry_t hnode;       /* Link in the active connection hash table */
+  dq_entry_t lnode;       /* Link in the listener hash table */
+#endif
   uint16_t mss;           /* Current maximum segment size for the
                            * connection */
 #ifdef CONFIG_NET_TCPPROTO_OPTIONS
@@ -251,6 +321,17 @@ struct tcp_conn_s
   uint32_t cwnd;          /* The Congestion window */
   uint32_t max_cwnd;      /* The Congestion window maximum value */
   uint32_t ssthresh;      /* The Slow start threshold */
+
+  /* Congestion control algorithm and the delivery rate sample state */
+
+  FAR const struct tcp_cc_ops_s *cc_ops;
+  clock_t  cc_rtt_stamp;  /* Time the RTT timing started */
+  uint32_t cc_rtt_seq;    /* The sequence number being timed */
+  uint32_t cc_rtt_delivered; /* cc_delivered when the timing started */
+  uint32_t cc_delivered;  /* Total number of bytes acknowledged */
+#  ifdef TCP_CC_PRIV_SIZE
+  uint64_t cc_priv[TCP_CC_PRIV_SIZE / 8]; /* Algorithm private state */
+#  endif
 #endif
 #ifdef CONFIG_NET_TCP_WINDOW_SCALE
   uint32_t snd_wnd;       /* Sequence and acknowledgement numbers of last
@@ -2356,6 +2437,109 @@ void tcp_cc_update(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp);
  ****************************************************************************/
 
 void tcp_cc_recv_ack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp);
+
+/****************************************************************************
+ * Name: tcp_cc_rto
+ *
+ * Description:
+ *   Update the congestion control variables when the retransmission timer
+ *   expires.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_cc_rto(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_cc_select
+ *
+ * Description:
+ *   Select the congestion control algorithm of a connection by name.  If
+ *   the connection is already established, the state of the new algorithm
+ *   is initialized from the current cwnd and ssthresh.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   name   - The algorithm name, NULL selects CONFIG_NET_TCP_CC_DEFAULT
+ *
+ * Returned Value:
+ *   OK on success; -ENOENT if the algorithm is not available.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int tcp_cc_select(FAR struct tcp_conn_s *conn, FAR const char *name);
+
+/* The congestion control algorithms */
+
+extern const struct tcp_cc_ops_s g_tcp_cc_newreno;
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+extern const struct tcp_cc_ops_s g_tcp_cc_cubic;
+#endif
+#ifdef CONFIG_NET_TCP_CC_BBR
+extern const struct tcp_cc_ops_s g_tcp_cc_bbr;
+#endif
+#endif
+
+#ifdef CONFIG_NET_TCP_GSO
+/****************************************************************************
+ * Name: tcp_gso_maxlen
+ *
+ * Description:
+ *   Return the largest amount of data that the connection may send in one
+ *   packet on the device: a multiple of the MSS when super-segments can be
+ *   used, otherwise the MSS.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+uint32_t tcp_gso_maxlen(FAR struct net_driver_s *dev,
+                        FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_gso_out
+ *
+ * Description:
+ *   If the outgoing packet in d_iob is a TCP super-segment that the device
+ *   does not segment itself, move it to d_gso to be split by
+ *   tcp_gso_segment().  d_len is zero on return in that case.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_gso_out(FAR struct net_driver_s *dev);
+
+/****************************************************************************
+ * Name: tcp_gso_segment
+ *
+ * Description:
+ *   Cut the next segment from the super-segment in d_gso.  The IP and TCP
+ *   headers of the super-segment serve as the template of every segment.
+ *
+ * Returned Value:
+ *   The next segment, or NULL if there is none or no IOB was available (in
+ *   which case the rest of the super-segment is dropped).
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *tcp_gso_segment(FAR struct net_driver_s *dev);
 #endif
 
 #ifdef __cplusplus
@@ -24,6 +24,11 @@
  * Included Files
  ****************************************************************************/
 
+#include <sys/param.h>
+#include <errno.h>
+#include <string.h>
+
+#include <nuttx/clock.h>
 #include <nuttx/debug.h>
 
 #include "tcp/tcp.h"
@@ -60,24 +65,160 @@
     } \
  } while(0)
 
-/* Increments a size inc and holds at max value rather than rollover. */
+#ifndef CONFIG_NET_TCP_CC_DEFAULT
+#  define CONFIG_NET_TCP_CC_DEFAULT "newreno"
+#endif
 
-#define CC_CWND_INC(wnd, inc) \
- do { \
-  if ((uint32_t)((wnd) + (inc)) >= (wnd)) \
-    { \
-      (wnd) = (uint32_t)((wnd) + (inc)); \
-    } \
-  else \
-    { \
-      (wnd) = (uint32_t)-1; \
-    } \
- } while(0)
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void newreno_ack(FAR struct tcp_conn_s *conn,
+                        FAR const struct tcp_cc_sample_s *rs);
+static void newreno_loss(FAR struct tcp_conn_s *conn);
+static void newreno_rto(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct tcp_cc_ops_s g_tcp_cc_newreno =
+{
+  "newreno",      /* name */
+  NULL,           /* init */
+  newreno_ack,    /* ack */
+  newreno_loss,   /* loss */
+  newreno_rto     /* rto */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR const struct tcp_cc_ops_s *const g_tcp_cc_algorithms[] =
+{
+  &g_tcp_cc_newreno,
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+  &g_tcp_cc_cubic,
+#endif
+#ifdef CONFIG_NET_TCP_CC_BBR
+  &g_tcp_cc_bbr,
+#endif
+};
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: newreno_ack
+ *
+ * Description:
+ *   Grow cwnd by slow start below ssthresh and by congestion avoidance
+ *   above it (RFC 5681).
+ *
+ ****************************************************************************/
+
+static void newreno_ack(FAR struct tcp_conn_s *conn,
+                        FAR const struct tcp_cc_sample_s *rs)
+{
+  uint32_t increase;
+
+  if (conn->cwnd < conn->ssthresh)
+    {
+      /* slow start (RFC 5681):
+       * Grow cwnd exponentially by maxseg(smss) per ACK.
+       */
+
+      increase = rs->acked > 0 ? MIN(rs->acked, conn->mss) : conn->mss;
+
+      CC_CWND_INC(conn->cwnd, increase);
+      ninfo("update slow start cwnd to %u\n", conn->cwnd);
+    }
+  else
+    {
+      /* cong avoid (RFC 5681):
+       * Grow cwnd linearly by approximately maxseg per RTT using
+       * maxseg^2 / cwnd per ACK as the increment.
+       * If cwnd > maxseg^2, fix the cwnd increment at 1 byte to
+       * avoid capping cwnd.
+       */
+
+      increase = MAX((conn->mss * conn->mss / conn->cwnd), 1);
+
+      CC_CWND_INC(conn->cwnd, increase);
+      conn->cwnd = MIN(conn->cwnd, conn->max_cwnd);
+      ninfo("update congestion avoidance cwnd to %u\n", conn->cwnd);
+    }
+}
+
+/****************************************************************************
+ * Name: newreno_loss
+ *
+ * Description:
+ *   ssthresh = max (FlightSize / 2, 2*SMSS) referring to rfc5681
+ *
+ ****************************************************************************/
+
+static void newreno_loss(FAR struct tcp_conn_s *conn)
+{
+  conn->ssthresh = MAX(conn->tx_unacked / 2, 2 * conn->mss);
+}
+
+/****************************************************************************
+ * Name: newreno_rto
+ *
+ * Description:
+ *   Reset cwnd and ssthresh, refers to RFC5681.
+ *
+ ****************************************************************************/
+
+static void newreno_rto(FAR struct tcp_conn_s *conn)
+{
+  conn->ssthresh = MAX(conn->tx_unacked / 2, 2 * conn->mss);
+  conn->cwnd = conn->mss;
+}
+
+/****************************************************************************
+ * Name: tcp_cc_sample
+ *
+ * Description:
+ *   Take the round trip time and delivery sample for an ACK of new data.
+ *   A round trip is timed from an ACK to the first ACK covering data sent
+ *   after it, which is one RTT for a sender that is clocked out by the
+ *   ACKs and an upper bound otherwise.  Following Karn's algorithm the
+ *   timing is abandoned on any retransmission.
+ *
+ ****************************************************************************/
+
+static void tcp_cc_sample(FAR struct tcp_conn_s *conn, uint32_t ackno,
+                          FAR struct tcp_cc_sample_s *rs)
+{
+  uint32_t sndseq = tcp_getsequence(conn->sndseq);
+  clock_t now = clock_systime_ticks();
+
+  rs->rtt = 0;
+  rs->delivered = 0;
+
+  if ((conn->flags & TCP_CC_TIMING) != 0 &&
+      TCP_SEQ_GT(ackno, conn->cc_rtt_seq))
+    {
+      clock_t elapsed = now - conn->cc_rtt_stamp;
+
+      rs->rtt = TICK2USEC(MAX(elapsed, 1));
+      rs->delivered = conn->cc_delivered - conn->cc_rtt_delivered;
+      conn->flags &= ~TCP_CC_TIMING;
+    }
+
+  if ((conn->flags & TCP_CC_TIMING) == 0 && TCP_SEQ_LT(ackno, sndseq))
+    {
+      conn->cc_rtt_seq = sndseq;
+      conn->cc_rtt_stamp = now;
+      conn->cc_rtt_delivered = conn->cc_delivered;
+      conn->flags |= TCP_CC_TIMING;
+    }
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -117,6 +258,13 @@ void tcp_cc_init(FAR struct tcp_conn_s *conn)
 
   conn->ssthresh = 2 * TCP_IPV4_DEFAULT_MSS;
   conn->dupacks = 0;
+  conn->cc_delivered = 0;
+  conn->flags &= ~TCP_CC_TIMING;
+
+  if (conn->cc_ops == NULL)
+    {
+      tcp_cc_select(conn, NULL);
+    }
 }
 
 /****************************************************************************
@@ -148,10 +296,10 @@ void tcp_cc_update(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp)
 
   if (conn->flags & TCP_INFT)
     {
-      conn->ssthresh = MAX(conn->tx_unacked / 2, 2 * conn->mss);
+      conn->cc_ops->loss(conn);
       conn->cwnd = conn->ssthresh + 3 * conn->mss;
 
-      conn->flags &= ~TCP_INFT;
+      conn->flags &= ~(TCP_INFT | TCP_CC_TIMING);
       conn->flags |= TCP_INFR;
     }
 
@@ -165,6 +313,11 @@ void tcp_cc_update(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp)
       CC_INIT_CWND(conn->cwnd, conn->mss);
       conn->max_cwnd = conn->snd_wnd;
       conn->ssthresh = MAX(conn->snd_wnd, conn->ssthresh);
+
+      if (conn->cc_ops->init != NULL)
+        {
+          conn->cc_ops->init(conn);
+        }
     }
 }
 
@@ -236,7 +389,10 @@ void tcp_cc_recv_ack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp)
     {
       /* We come here when the ACK acknowledges new data. */
 
-      uint32_t acked = TCP_SEQ_SUB(ackno, conn->last_ackno);
+      struct tcp_cc_sample_s rs;
+
+      rs.acked = TCP_SEQ_SUB(ackno, conn->last_ackno);
+      conn->cc_delivered += rs.acked;
 
       /* Reset dupacks and update last_ackno. */
 
@@ -265,38 +421,100 @@ void tcp_cc_recv_ack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp)
             }
         }
 
-      /* Update the congestion control variables (cwnd and ssthresh). */
+      /* Let the algorithm update cwnd and ssthresh. */
+
+      tcp_cc_sample(conn, ackno, &rs);
 
       if (conn->tcpstateflags >= TCP_ESTABLISHED)
         {
-          uint32_t increase;
+          conn->cc_ops->ack(conn, &rs);
+        }
+    }
+}
 
-          if (conn->cwnd < conn->ssthresh)
-            {
-              /* slow start (RFC 5681):
-               * Grow cwnd exponentially by maxseg(smss) per ACK.
-               */
+/****************************************************************************
+ * Name: tcp_cc_rto
+ *
+ * Description:
+ *   Update the congestion control variables when the retransmission timer
+ *   expires.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
 
-              increase = acked > 0 ? MIN(acked, conn->mss) : conn->mss;
+void tcp_cc_rto(FAR struct tcp_conn_s *conn)
+{
+  /* If conn is TCP_INFR, it should enter to slow start */
 
-              CC_CWND_INC(conn->cwnd, increase);
-              ninfo("update slow start cwnd to %u\n", conn->cwnd);
-            }
-          else
-            {
-              /* cong avoid (RFC 5681):
-               * Grow cwnd linearly by approximately maxseg per RTT using
-               * maxseg^2 / cwnd per ACK as the increment.
-               * If cwnd > maxseg^2, fix the cwnd increment at 1 byte to
-               * avoid capping cwnd.
-               */
+  conn->flags &= ~(TCP_INFR | TCP_CC_TIMING);
 
-              increase = MAX((conn->mss * conn->mss / conn->cwnd), 1);
+  /* update the max_cwnd */
 
-              CC_CWND_INC(conn->cwnd, increase);
-              conn->cwnd = MIN(conn->cwnd, conn->max_cwnd);
-              ninfo("update congestion avoidance cwnd to %u\n", conn->cwnd);
-            }
+  conn->max_cwnd = (conn->max_cwnd + 7 * conn->cwnd) >> 3;
+
+  conn->cc_ops->rto(conn);
+}
+
+/****************************************************************************
+ * Name: tcp_cc_select
+ *
+ * Description:
+ *   Select the congestion control algorithm of a connection by name.  If
+ *   the connection is already established, the state of the new algorithm
+ *   is initialized from the current cwnd and ssthresh.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   name   - The algorithm name, NULL selects CONFIG_NET_TCP_CC_DEFAULT
+ *
+ * Returned Value:
+ *   OK on success; -ENOENT if the algorithm is not available.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int tcp_cc_select(FAR struct tcp_conn_s *conn, FAR const char *name)
+{
+  FAR const struct tcp_cc_ops_s *ops = NULL;
+  int i;
+
+  for (i = 0; i < nitems(g_tcp_cc_algorithms); i++)
+    {
+      if (strcmp(g_tcp_cc_algorithms[i]->name,
+                 name != NULL ? name : CONFIG_NET_TCP_CC_DEFAULT) == 0)
+        {
+          ops = g_tcp_cc_algorithms[i];
+          break;
         }
     }
+
+  if (ops == NULL)
+    {
+      if (name != NULL)
+        {
+          return -ENOENT;
+        }
+
+      ops = &g_tcp_cc_newreno;
+    }
+
+  conn->cc_ops = ops;
+
+  if (conn->tcpstateflags >= TCP_ESTABLISHED && ops->init != NULL)
+    {
+      conn->flags &= ~TCP_CC_TIMING;
+      ops->init(conn);
+    }
+
+  return OK;
 }
@@ -0,0 +1,377 @@
+/****************************************************************************
+ * net/tcp/tcp_cc_bbr.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* A window based variant of BBR (v1).  The model is the same:  the
+ * bottleneck bandwidth is the windowed maximum of the delivery rate and the
+ * propagation delay the windowed minimum of the RTT, and the state machine
+ * STARTUP -> DRAIN -> PROBE_BW (<-> PROBE_RTT) probes them in turn.  The
+ * stack does not pace, so the pacing gain of each phase is folded into the
+ * congestion window.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/debug.h>
+
+#include "tcp/tcp.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Gains are in units of 1/256 */
+
+#define BBR_UNIT              256
+#define BBR_HIGH_GAIN         739  /* 2 / ln(2) */
+#define BBR_CWND_GAIN         512  /* 2 */
+
+#define BBR_BW_ROUNDS         10   /* Rounds in the max bandwidth filter */
+#define BBR_MIN_RTT_WIN       10000 /* Min RTT filter window (units: ms) */
+#define BBR_PROBE_RTT_TIME    200  /* Time spent in PROBE_RTT (units: ms) */
+#define BBR_CYCLE_LEN         8    /* Phases of the PROBE_BW gain cycle */
+#define BBR_FULL_BW_THRESH    320  /* 1.25, growth to count as not full */
+#define BBR_FULL_BW_ROUNDS    3    /* Rounds without growth to be full */
+#define BBR_MIN_CWND(conn)    (4 * (uint32_t)(conn)->mss)
+
+#define BBR_NOW()             ((uint32_t)TICK2MSEC(clock_systime_ticks()))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+enum bbr_mode_e
+{
+  BBR_STARTUP = 0,      /* Ramp up quickly to fill the pipe */
+  BBR_DRAIN,            /* Drain the queue created in STARTUP */
+  BBR_PROBE_BW,         /* Cycle the gain around the estimated bandwidth */
+  BBR_PROBE_RTT         /* Cut inflight to measure the propagation delay */
+};
+
+struct bbr_s
+{
+  uint32_t max_bw[2];       /* Max delivery rate, this and the previous
+                             * filter window (units: bytes per second) */
+  uint32_t min_rtt;         /* Min RTT (units: us), zero if none */
+  uint32_t min_rtt_stamp;   /* Time min_rtt was measured (units: ms) */
+  uint32_t probe_rtt_done;  /* End of PROBE_RTT (units: ms) */
+  uint32_t cycle_stamp;     /* Start of the gain cycle phase (units: ms) */
+  uint32_t full_bw;         /* Bandwidth at the last growth */
+  uint32_t prior_cwnd;      /* cwnd before PROBE_RTT */
+  uint32_t round;           /* Number of round trips timed */
+  uint8_t  mode;            /* See enum bbr_mode_e */
+  uint8_t  cycle_idx;       /* Phase of the PROBE_BW gain cycle */
+  uint8_t  full_bw_cnt;     /* Rounds without bandwidth growth */
+  bool     full_bw_reached; /* The pipe is full */
+};
+
+static_assert(sizeof(struct bbr_s) <= TCP_CC_PRIV_SIZE,
+              "TCP_CC_PRIV_SIZE too small for BBR");
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void bbr_init(FAR struct tcp_conn_s *conn);
+static void bbr_ack(FAR struct tcp_conn_s *conn,
+                    FAR const struct tcp_cc_sample_s *rs);
+static void bbr_loss(FAR struct tcp_conn_s *conn);
+static void bbr_rto(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct tcp_cc_ops_s g_tcp_cc_bbr =
+{
+  "bbr",          /* name */
+  bbr_init,       /* init */
+  bbr_ack,        /* ack */
+  bbr_loss,       /* loss */
+  bbr_rto         /* rto */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The PROBE_BW gain cycle: probe for more bandwidth, drain the queue that
+ * probing may have created, then cruise at the estimated bandwidth.
+ */
+
+static const uint16_t g_bbr_cycle_gain[BBR_CYCLE_LEN] =
+{
+  BBR_UNIT * 5 / 4, BBR_UNIT * 3 / 4, BBR_UNIT, BBR_UNIT,
+  BBR_UNIT, BBR_UNIT, BBR_UNIT, BBR_UNIT
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bbr_bw
+ ****************************************************************************/
+
+static uint32_t bbr_bw(FAR struct bbr_s *bbr)
+{
+  return MAX(bbr->max_bw[0], bbr->max_bw[1]);
+}
+
+/****************************************************************************
+ * Name: bbr_bdp
+ *
+ * Description:
+ *   Return the estimated bandwidth-delay product scaled by gain, or zero
+ *   if there is no estimate yet.
+ *
+ ****************************************************************************/
+
+static uint32_t bbr_bdp(FAR struct bbr_s *bbr, uint32_t gain)
+{
+  uint64_t bdp;
+
+  bdp = (uint64_t)bbr_bw(bbr) * bbr->min_rtt / USEC_PER_SEC;
+  bdp = bdp * gain / BBR_UNIT;
+
+  return MIN(bdp, UINT32_MAX);
+}
+
+/****************************************************************************
+ * Name: bbr_update_model
+ *
+ * Description:
+ *   Feed a completed round trip into the bandwidth and RTT filters.
+ *
+ ****************************************************************************/
+
+static void bbr_update_model(FAR struct tcp_conn_s *conn,
+                             FAR struct bbr_s *bbr,
+                             FAR const struct tcp_cc_sample_s *rs,
+                             uint32_t now)
+{
+  uint64_t bw;
+  bool expired;
+
+  bw = (uint64_t)rs->delivered * USEC_PER_SEC / rs->rtt;
+  bw = MIN(bw, UINT32_MAX);
+
+  if (++bbr->round % BBR_BW_ROUNDS == 0)
+    {
+      bbr->max_bw[1] = bbr->max_bw[0];
+      bbr->max_bw[0] = 0;
+    }
+
+  bbr->max_bw[0] = MAX(bbr->max_bw[0], bw);
+
+  expired = now - bbr->min_rtt_stamp > BBR_MIN_RTT_WIN;
+  if (bbr->min_rtt == 0 || rs->rtt <= bbr->min_rtt || expired)
+    {
+      bbr->min_rtt       = rs->rtt;
+      bbr->min_rtt_stamp = now;
+    }
+
+  /* Enter PROBE_RTT if the min RTT was not refreshed for a while */
+
+  if (expired && bbr->mode != BBR_PROBE_RTT)
+    {
+      bbr->mode           = BBR_PROBE_RTT;
+      bbr->prior_cwnd     = conn->cwnd;
+      bbr->probe_rtt_done = now + BBR_PROBE_RTT_TIME;
+    }
+
+  /* Once per round in STARTUP, check whether the bandwidth is still
+   * growing.
+   */
+
+  if (!bbr->full_bw_reached)
+    {
+      if ((uint64_t)bbr_bw(bbr) * BBR_UNIT >=
+          (uint64_t)bbr->full_bw * BBR_FULL_BW_THRESH)
+        {
+          bbr->full_bw     = bbr_bw(bbr);
+          bbr->full_bw_cnt = 0;
+        }
+      else if (++bbr->full_bw_cnt >= BBR_FULL_BW_ROUNDS)
+        {
+          bbr->full_bw_reached = true;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: bbr_update_mode
+ ****************************************************************************/
+
+static void bbr_update_mode(FAR struct tcp_conn_s *conn,
+                            FAR struct bbr_s *bbr, uint32_t now)
+{
+  switch (bbr->mode)
+    {
+      case BBR_STARTUP:
+        if (bbr->full_bw_reached)
+          {
+            bbr->mode = BBR_DRAIN;
+          }
+        break;
+
+      case BBR_DRAIN:
+        if (conn->tx_unacked <= bbr_bdp(bbr, BBR_UNIT))
+          {
+            bbr->mode        = BBR_PROBE_BW;
+            bbr->cycle_idx   = bbr->round % BBR_CYCLE_LEN;
+            bbr->cycle_stamp = now;
+          }
+        break;
+
+      case BBR_PROBE_BW:
+        if (now - bbr->cycle_stamp > bbr->min_rtt / USEC_PER_MSEC)
+          {
+            bbr->cycle_idx   = (bbr->cycle_idx + 1) % BBR_CYCLE_LEN;
+            bbr->cycle_stamp = now;
+          }
+        break;
+
+      case BBR_PROBE_RTT:
+        if ((int32_t)(now - bbr->probe_rtt_done) >= 0)
+          {
+            bbr->min_rtt_stamp = now;
+            bbr->mode = bbr->full_bw_reached ? BBR_PROBE_BW : BBR_STARTUP;
+            bbr->cycle_stamp = now;
+            conn->cwnd = MAX(conn->cwnd, bbr->prior_cwnd);
+          }
+        break;
+    }
+}
+
+/****************************************************************************
+ * Name: bbr_init
+ ****************************************************************************/
+
+static void bbr_init(FAR struct tcp_conn_s *conn)
+{
+  FAR struct bbr_s *bbr = TCP_CC_PRIV(conn);
+
+  memset(bbr, 0, sizeof(struct bbr_s));
+  bbr->min_rtt_stamp = BBR_NOW();
+}
+
+/****************************************************************************
+ * Name: bbr_ack
+ *
+ * Description:
+ *   Update the model and the state machine, then move cwnd towards the
+ *   target of the current phase.
+ *
+ ****************************************************************************/
+
+static void bbr_ack(FAR struct tcp_conn_s *conn,
+                   FAR const struct tcp_cc_sample_s *rs)
+{
+  FAR struct bbr_s *bbr = TCP_CC_PRIV(conn);
+  uint32_t now = BBR_NOW();
+  uint32_t target;
+  uint32_t gain;
+
+  if (rs->rtt != 0)
+    {
+      bbr_update_model(conn, bbr, rs, now);
+    }
+
+  bbr_update_mode(conn, bbr, now);
+
+  switch (bbr->mode)
+    {
+      case BBR_STARTUP:
+        gain = BBR_HIGH_GAIN;
+        break;
+
+      case BBR_DRAIN:
+        gain = BBR_UNIT;
+        break;
+
+      case BBR_PROBE_BW:
+        gain = BBR_CWND_GAIN * g_bbr_cycle_gain[bbr->cycle_idx] / BBR_UNIT;
+        break;
+
+      default:
+        conn->cwnd = MIN(conn->cwnd, BBR_MIN_CWND(conn));
+        return;
+    }
+
+  target = bbr_bdp(bbr, gain);
+
+  if (bbr->full_bw_reached)
+    {
+      CC_CWND_INC(conn->cwnd, rs->acked);
+      conn->cwnd = MIN(conn->cwnd, target);
+    }
+  else if (conn->cwnd < target || target == 0)
+    {
+      CC_CWND_INC(conn->cwnd, rs->acked);
+    }
+
+  conn->cwnd = MAX(conn->cwnd, BBR_MIN_CWND(conn));
+  ninfo("update bbr mode %u cwnd to %" PRIu32 "\n", bbr->mode, conn->cwnd);
+}
+
+/****************************************************************************
+ * Name: bbr_loss
+ *
+ * Description:
+ *   BBR does not treat the loss as a congestion signal.  Recover with the
+ *   data in flight (packet conservation), bounded by the model.
+ *
+ ****************************************************************************/
+
+static void bbr_loss(FAR struct tcp_conn_s *conn)
+{
+  FAR struct bbr_s *bbr = TCP_CC_PRIV(conn);
+  uint32_t target = bbr_bdp(bbr, BBR_CWND_GAIN);
+
+  conn->ssthresh = conn->tx_unacked;
+  if (target != 0)
+    {
+      conn->ssthresh = MIN(conn->ssthresh, target);
+    }
+
+  conn->ssthresh = MAX(conn->ssthresh, BBR_MIN_CWND(conn));
+}
+
+/****************************************************************************
+ * Name: bbr_rto
+ ****************************************************************************/
+
+static void bbr_rto(FAR struct tcp_conn_s *conn)
+{
+  conn->ssthresh = MAX(conn->cwnd, BBR_MIN_CWND(conn));
+  conn->cwnd     = conn->mss;
+}
@@ -0,0 +1,308 @@
+/****************************************************************************
+ * net/tcp/tcp_cc_cubic.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/debug.h>
+
+#include "tcp/tcp.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* CUBIC constants (RFC 9438): C = 0.4 and beta_cubic = 0.7.
+ *
+ *   K = cubic_root((W_max - cwnd_epoch) / C)             (seconds)
+ *   W_cubic(t) = C * (t - K)^3 + W_max                   (segments)
+ *
+ * The window is kept in bytes and the time in milliseconds, so
+ *
+ *   K_ms = cubic_root(W_max_bytes * 1000 / mss * 2500000)
+ *   delta_bytes = (t_ms - K_ms)^3 / 10^6 * mss * 2 / 5000
+ */
+
+#define CUBIC_BETA_NUM        7    /* beta_cubic = 7 / 10 */
+#define CUBIC_BETA_DEN        10
+#define CUBIC_FC_NUM          17   /* (1 + beta_cubic) / 2 = 17 / 20 */
+#define CUBIC_FC_DEN          20
+#define CUBIC_K_SCALE         2500000ull
+#define CUBIC_MAX_T           (1u << 21)   /* ~35 minutes */
+
+/* The Reno-friendly window grows by alpha = 3 * (1 - beta) / (1 + beta)
+ * = 9 / 17 segments per window of data acknowledged.
+ */
+
+#define CUBIC_ALPHA_NUM       9
+#define CUBIC_ALPHA_DEN       17
+
+#define CUBIC_NOW()           ((uint32_t)TICK2MSEC(clock_systime_ticks()))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct cubic_s
+{
+  uint32_t w_max;       /* cwnd just before the last reduction */
+  uint32_t origin;      /* Window at the plateau of the cubic function */
+  uint32_t k;           /* Time to reach origin (units: ms) */
+  uint32_t epoch;       /* Start of the congestion avoidance epoch (ms) */
+  uint32_t rtt;         /* Latest RTT sample (units: ms) */
+  uint32_t w_est;       /* Reno-friendly window estimate */
+  uint32_t ack_cnt;     /* Bytes acknowledged towards w_est growth */
+  bool     in_epoch;    /* epoch, origin and k are valid */
+};
+
+static_assert(sizeof(struct cubic_s) <= TCP_CC_PRIV_SIZE,
+              "TCP_CC_PRIV_SIZE too small for CUBIC");
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void cubic_init(FAR struct tcp_conn_s *conn);
+static void cubic_ack(FAR struct tcp_conn_s *conn,
+                      FAR const struct tcp_cc_sample_s *rs);
+static void cubic_loss(FAR struct tcp_conn_s *conn);
+static void cubic_rto(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct tcp_cc_ops_s g_tcp_cc_cubic =
+{
+  "cubic",        /* name */
+  cubic_init,     /* init */
+  cubic_ack,      /* ack */
+  cubic_loss,     /* loss */
+  cubic_rto       /* rto */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cubic_root
+ *
+ * Description:
+ *   Integer cube root, rounded down.
+ *
+ ****************************************************************************/
+
+static uint32_t cubic_root(uint64_t a)
+{
+  uint64_t y = 0;
+  uint64_t b;
+  int s;
+
+  for (s = 63; s >= 0; s -= 3)
+    {
+      y <<= 1;
+      b = 3 * y * (y + 1) + 1;
+      if ((a >> s) >= b)
+        {
+          a -= b << s;
+          y++;
+        }
+    }
+
+  return (uint32_t)y;
+}
+
+/****************************************************************************
+ * Name: cubic_reduce
+ *
+ * Description:
+ *   Remember the window at a congestion event, applying the fast
+ *   convergence, and compute the new ssthresh.
+ *
+ ****************************************************************************/
+
+static void cubic_reduce(FAR struct tcp_conn_s *conn)
+{
+  FAR struct cubic_s *cubic = TCP_CC_PRIV(conn);
+
+  if (conn->cwnd < cubic->w_max)
+    {
+      /* Fast convergence: release bandwidth for the new flows */
+
+      cubic->w_max = (uint64_t)conn->cwnd * CUBIC_FC_NUM / CUBIC_FC_DEN;
+    }
+  else
+    {
+      cubic->w_max = conn->cwnd;
+    }
+
+  conn->ssthresh = MAX((uint64_t)conn->cwnd * CUBIC_BETA_NUM /
+                       CUBIC_BETA_DEN, 2 * conn->mss);
+  cubic->in_epoch = false;
+}
+
+/****************************************************************************
+ * Name: cubic_target
+ *
+ * Description:
+ *   Return W_cubic(t) in bytes where t is the time since the start of the
+ *   epoch plus one RTT.
+ *
+ ****************************************************************************/
+
+static uint32_t cubic_target(FAR struct tcp_conn_s *conn,
+                             FAR struct cubic_s *cubic, uint32_t now)
+{
+  uint32_t t = now - cubic->epoch + cubic->rtt;
+  uint64_t offs;
+  uint64_t delta;
+
+  offs = t < cubic->k ? cubic->k - t : t - cubic->k;
+  offs = MIN(offs, CUBIC_MAX_T);
+
+  delta = offs * offs * offs / 1000000;
+  delta = delta * conn->mss * 2 / 5000;
+
+  if (t < cubic->k)
+    {
+      return delta < cubic->origin ? cubic->origin - delta : conn->mss;
+    }
+
+  return MIN(cubic->origin + delta, UINT32_MAX);
+}
+
+/****************************************************************************
+ * Name: cubic_init
+ ****************************************************************************/
+
+static void cubic_init(FAR struct tcp_conn_s *conn)
+{
+  memset(TCP_CC_PRIV(conn), 0, sizeof(struct cubic_s));
+}
+
+/****************************************************************************
+ * Name: cubic_ack
+ *
+ * Description:
+ *   Slow start below ssthresh, otherwise move cwnd towards the larger of
+ *   the cubic window and the Reno-friendly estimate.
+ *
+ ****************************************************************************/
+
+static void cubic_ack(FAR struct tcp_conn_s *conn,
+                      FAR const struct tcp_cc_sample_s *rs)
+{
+  FAR struct cubic_s *cubic = TCP_CC_PRIV(conn);
+  uint32_t now = CUBIC_NOW();
+  uint32_t target;
+  uint32_t limit;
+  uint32_t inc;
+
+  if (rs->rtt != 0)
+    {
+      cubic->rtt = MAX(rs->rtt / USEC_PER_MSEC, 1);
+    }
+
+  if (conn->cwnd < conn->ssthresh)
+    {
+      inc = rs->acked > 0 ? MIN(rs->acked, conn->mss) : conn->mss;
+      CC_CWND_INC(conn->cwnd, inc);
+      return;
+    }
+
+  if (!cubic->in_epoch)
+    {
+      cubic->in_epoch = true;
+      cubic->epoch    = now;
+      cubic->ack_cnt  = 0;
+      cubic->w_est    = conn->cwnd;
+
+      if (conn->cwnd < cubic->w_max)
+        {
+          uint64_t segs = (uint64_t)(cubic->w_max - conn->cwnd) * 1000 /
+                          conn->mss;
+
+          cubic->k      = cubic_root(segs * CUBIC_K_SCALE);
+          cubic->origin = cubic->w_max;
+        }
+      else
+        {
+          cubic->k      = 0;
+          cubic->origin = conn->cwnd;
+        }
+    }
+
+  /* Reno-friendly region */
+
+  cubic->ack_cnt += rs->acked;
+  limit = (uint64_t)conn->cwnd * CUBIC_ALPHA_DEN / CUBIC_ALPHA_NUM;
+  if (cubic->ack_cnt >= limit)
+    {
+      cubic->ack_cnt -= limit;
+      CC_CWND_INC(cubic->w_est, conn->mss);
+    }
+
+  target = cubic_target(conn, cubic, now);
+  target = MAX(target, cubic->w_est);
+
+  /* Never grow more than 1.5 * cwnd per RTT */
+
+  target = MIN(target, conn->cwnd + conn->cwnd / 2);
+
+  if (target > conn->cwnd)
+    {
+      inc = (uint64_t)(target - conn->cwnd) * rs->acked / conn->cwnd;
+      CC_CWND_INC(conn->cwnd, MAX(inc, 1));
+    }
+
+  conn->cwnd = MIN(conn->cwnd, MAX(conn->max_cwnd, conn->snd_wnd));
+  ninfo("update cubic cwnd to %" PRIu32 "\n", conn->cwnd);
+}
+
+/****************************************************************************
+ * Name: cubic_loss
+ ****************************************************************************/
+
+static void cubic_loss(FAR struct tcp_conn_s *conn)
+{
+  cubic_reduce(conn);
+}
+
+/****************************************************************************
+ * Name: cubic_rto
+ ****************************************************************************/
+
+static void cubic_rto(FAR struct tcp_conn_s *conn)
+{
+  cubic_reduce(conn);
+  conn->cwnd = conn->mss;
+}
@@ -61,6 +61,7 @@
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
+#include <nuttx/net/netstats.h>
 #include <nuttx/net/ip.h>
 #include <nuttx/net/tcp.h>
 
@@ -81,6 +82,21 @@
 #  define CONFIG_NET_TCP_MAX_CONNS 0
 #endif
 
+#ifdef CONFIG_NET_TCP_CONN_HASH
+#  if (CONFIG_NET_TCP_CONN_HASH_SIZE & \
+       (CONFIG_NET_TCP_CONN_HASH_SIZE - 1)) != 0
+#    error CONFIG_NET_TCP_CONN_HASH_SIZE must be a power of two
+#  endif
+
+#  define TCP_HASH_MASK (CONFIG_NET_TCP_CONN_HASH_SIZE - 1)
+#endif
+
+#if defined(CONFIG_NET_STATISTICS) && defined(CONFIG_NET_TCP_CONN_HASH)
+#  define TCP_HASH_STATINCR(p) ((p)++)
+#else
+#  define TCP_HASH_STATINCR(p)
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -95,10 +111,141 @@ NET_BUFPOOL_DECLARE(g_tcp_connections, sizeof(struct tcp_conn_s),
 
 static dq_queue_t g_active_tcp_connections;
 
+#ifdef CONFIG_NET_TCP_CONN_HASH
+/* The same connections, hashed by local port, remote port and remote
+ * address.  The local address is not part of the key because it may be
+ * the unspecified address.
+ */
+
+static dq_queue_t g_tcp_conn_hash[CONFIG_NET_TCP_CONN_HASH_SIZE];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tcp_hashkey
+ *
+ * Description:
+ *   Return the hash bucket of a connection from its ports (network byte
+ *   order) and its remote IP address, folded to 32 bits.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CONN_HASH
+static inline_function unsigned int tcp_hashkey(uint16_t lport,
+                                                uint16_t rport,
+                                                uint32_t raddr)
+{
+  uint32_t key = ((uint32_t)lport << 16 | rport) ^ raddr;
+
+  key  = (key ^ (key >> 16)) * 0x45d9f3b;
+  key ^= key >> 16;
+  return key & TCP_HASH_MASK;
+}
+
+#ifdef CONFIG_NET_IPv6
+static inline_function uint32_t tcp_ipv6_fold(FAR const uint16_t *addr)
+{
+  return ((uint32_t)(addr[0] ^ addr[2] ^ addr[4] ^ addr[6]) << 16) |
+         (addr[1] ^ addr[3] ^ addr[5] ^ addr[7]);
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_conn_hashkey
+ *
+ * Description:
+ *   Return the hash bucket of an active connection.
+ *
+ ****************************************************************************/
+
+static unsigned int tcp_conn_hashkey(FAR struct tcp_conn_s *conn)
+{
+  uint32_t raddr;
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (conn->domain == PF_INET6)
+#endif
+    {
+      raddr = tcp_ipv6_fold(conn->u.ipv6.raddr);
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      raddr = conn->u.ipv4.raddr;
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+  return tcp_hashkey(conn->lport, conn->rport, raddr);
+}
+#endif /* CONFIG_NET_TCP_CONN_HASH */
+
+/****************************************************************************
+ * Name: tcp_active_add, tcp_active_remove
+ *
+ * Description:
+ *   Add a connection to, or remove it from, the list of active
+ *   connections.  The connection must not change its ports or remote
+ *   address while it is active.
+ *
+ * Assumptions:
+ *   The caller holds the TCP connection list lock.
+ *
+ ****************************************************************************/
+
+static void tcp_active_add(FAR struct tcp_conn_s *conn)
+{
+  dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  dq_addlast(&conn->hnode, &g_tcp_conn_hash[tcp_conn_hashkey(conn)]);
+#endif
+}
+
+static void tcp_active_remove(FAR struct tcp_conn_s *conn)
+{
+  dq_rem(&conn->sconn.node, &g_active_tcp_connections);
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  dq_rem(&conn->hnode, &g_tcp_conn_hash[tcp_conn_hashkey(conn)]);
+#endif
+}
+
+/****************************************************************************
+ * Name: tcp_active_next
+ *
+ * Description:
+ *   Return the active connection following 'conn' (or the first one if
+ *   'conn' is NULL) that may match the hash bucket 'key'.  Without hashing
+ *   this simply traverses all active connections.
+ *
+ ****************************************************************************/
+
+static inline_function FAR struct tcp_conn_s *
+tcp_active_next(FAR struct tcp_conn_s *conn, unsigned int key)
+{
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  FAR dq_entry_t *entry;
+
+  entry = conn != NULL ? conn->hnode.flink : g_tcp_conn_hash[key].head;
+  if (entry == NULL)
+    {
+      return NULL;
+    }
+
+  TCP_HASH_STATINCR(g_netstats.tcp.hashprobe);
+  return container_of(entry, struct tcp_conn_s, hnode);
+#else
+  UNUSED(key);
+  return tcp_nextconn(conn);
+#endif
+}
+
 /****************************************************************************
  * Name: tcp_listener
  *
@@ -170,10 +317,14 @@ static inline FAR struct tcp_conn_s *
   FAR struct tcp_conn_s *conn;
   in_addr_t srcipaddr;
   in_addr_t destipaddr;
+  unsigned int key = 0;
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = net_ip4addr_conv32(ip->srcipaddr);
   destipaddr = net_ip4addr_conv32(ip->destipaddr);
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  key        = tcp_hashkey(tcp->destport, tcp->srcport, srcipaddr);
+#endif
+  conn       = tcp_active_next(NULL, key);
 
   while (conn)
     {
@@ -210,7 +361,7 @@ static inline FAR struct tcp_conn_s *
 
       /* Look at the next active connection */
 
-      conn = (FAR struct tcp_conn_s *)conn->sconn.node.flink;
+      conn = tcp_active_next(conn, key);
     }
 
   return conn;
@@ -237,10 +388,15 @@ static inline FAR struct tcp_conn_s *
   FAR struct tcp_conn_s *conn;
   net_ipv6addr_t *srcipaddr;
   net_ipv6addr_t *destipaddr;
+  unsigned int key = 0;
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = (net_ipv6addr_t *)ip->srcipaddr;
   destipaddr = (net_ipv6addr_t *)ip->destipaddr;
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  key        = tcp_hashkey(tcp->destport, tcp->srcport,
+                           tcp_ipv6_fold(ip->srcipaddr));
+#endif
+  conn       = tcp_active_next(NULL, key);
 
   while (conn)
     {
@@ -277,7 +433,7 @@ static inline FAR struct tcp_conn_s *
 
       /* Look at the next active connection */
 
-      conn = (FAR struct tcp_conn_s *)conn->sconn.node.flink;
+      conn = tcp_active_next(conn, key);
     }
 
   return conn;
@@ -698,6 +854,9 @@ FAR struct tcp_conn_s *tcp_alloc(uint8_t domain)
       nxsem_init(&conn->snd_sem, 0, 0);
 #endif
       nxrmutex_init(&conn->sconn.s_lock);
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+      tcp_cc_select(conn, NULL);
+#endif
 
       /* Set the default value of mss to max, this field will changed when
        * receive SYN.
@@ -812,7 +971,7 @@ void tcp_free(FAR struct tcp_conn_s *conn)
       /* Remove the connection from the active list */
 
       tcp_conn_list_lock();
-      dq_rem(&conn->sconn.node, &g_active_tcp_connections);
+      tcp_active_remove(conn);
       tcp_conn_list_unlock();
     }
 
@@ -953,6 +1112,8 @@ FAR struct tcp_conn_s *tcp_active(FAR struct net_driver_s *dev,
 {
   FAR struct tcp_conn_s *conn = NULL;
 
+  TCP_HASH_STATINCR(g_netstats.tcp.hashlookup);
+
   tcp_conn_list_lock();
 #ifdef CONFIG_NET_IPv6
 #ifdef CONFIG_NET_IPv4
@@ -1132,6 +1293,9 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
       conn->snd_bufs         = listener->snd_bufs;
 #endif
       conn->mss              = listener->mss;
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+      conn->cc_ops           = listener->cc_ops;
+#endif
 
       /* Fill in the necessary fields for the new connection. */
 
@@ -1181,7 +1345,7 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
        */
 
       tcp_conn_list_lock();
-      dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+      tcp_active_add(conn);
       tcp_conn_list_unlock();
 
       tcp_update_retrantimer(conn, TCP_RTO);
@@ -1490,7 +1654,7 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
   /* And, finally, put the connection structure into the active list. */
 
   tcp_conn_list_lock();
-  dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+  tcp_active_add(conn);
   tcp_conn_list_unlock();
 
   return OK;
@@ -1535,7 +1699,7 @@ void tcp_conn_list_unlock(void)
 
 void tcp_removeconn(FAR struct tcp_conn_s *conn)
 {
-  dq_rem(&conn->sconn.node, &g_active_tcp_connections);
+  tcp_active_remove(conn);
 }
 
 /****************************************************************************
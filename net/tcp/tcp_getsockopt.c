@@ -29,6 +29,7 @@
 #include <sys/time.h>
 #include <stdint.h>
 #include <errno.h>
+#include <string.h>
 #include <assert.h>
 #include <nuttx/debug.h>
 
@@ -240,6 +241,21 @@ int tcp_getsockopt(FAR struct socket *psock, int option,
           }
         break;
 
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+      case TCP_CONGESTION: /* The congestion control algorithm */
+        if (*value_len == 0)
+          {
+            ret          = -EINVAL;
+          }
+        else
+          {
+            *value_len   = MIN(*value_len, strlen(conn->cc_ops->name) + 1);
+            strlcpy(value, conn->cc_ops->name, *value_len);
+            ret          = OK;
+          }
+        break;
+#endif
+
       default:
         nerr("ERROR: Unrecognized TCP option: %d\n", option);
         ret = -ENOPROTOOPT;
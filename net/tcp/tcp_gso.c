@@ -0,0 +1,440 @@
+/****************************************************************************
+ * net/tcp/tcp_gso.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <nuttx/debug.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/tcp.h>
+
+#include "netdev/netdev.h"
+#include "devif/devif.h"
+#include "inet/inet.h"
+#include "tcp/tcp.h"
+
+#if defined(NET_TCP_HAVE_STACK) && defined(CONFIG_NET_TCP_GSO)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_gso_parse
+ *
+ * Description:
+ *   Return the length of the IP and TCP headers of a TCP packet, or zero if
+ *   the packet is not TCP or its headers are not in the first IOB.
+ *
+ ****************************************************************************/
+
+static uint16_t tcp_gso_parse(FAR struct iob_s *iob, FAR uint16_t *iphdrlen,
+                              FAR uint8_t *tso)
+{
+  FAR uint8_t *ip = IOB_DATA(iob);
+  FAR struct tcp_hdr_s *tcp;
+  uint16_t hdrlen;
+
+  if (iob->io_len < IPv4_HDRLEN)
+    {
+      return 0;
+    }
+
+#ifdef CONFIG_NET_IPv4
+  if ((ip[0] & IP_VERSION_MASK) == IPv4_VERSION)
+    {
+      FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)ip;
+
+      if (ipv4->proto != IP_PROTO_TCP)
+        {
+          return 0;
+        }
+
+      *iphdrlen = (ipv4->vhl & IPv4_HLMASK) << 2;
+      *tso      = NETDEV_TX_TSO4;
+    }
+  else
+#endif
+#ifdef CONFIG_NET_IPv6
+  if ((ip[0] & IP_VERSION_MASK) == IPv6_VERSION)
+    {
+      FAR struct ipv6_hdr_s *ipv6 = (FAR struct ipv6_hdr_s *)ip;
+
+      if (ipv6->proto != IP_PROTO_TCP)
+        {
+          return 0;
+        }
+
+      *iphdrlen = IPv6_HDRLEN;
+      *tso      = NETDEV_TX_TSO6;
+    }
+  else
+#endif
+    {
+      return 0;
+    }
+
+  if (iob->io_len < *iphdrlen + TCP_HDRLEN)
+    {
+      return 0;
+    }
+
+  tcp    = (FAR struct tcp_hdr_s *)(ip + *iphdrlen);
+  hdrlen = *iphdrlen + ((tcp->tcpoffset >> 4) << 2);
+  return iob->io_len < hdrlen ? 0 : hdrlen;
+}
+
+/****************************************************************************
+ * Name: tcp_gso_finish
+ *
+ * Description:
+ *   Set the lengths and the checksums of a segment.
+ *
+ ****************************************************************************/
+
+static void tcp_gso_finish(FAR struct net_driver_s *dev,
+                           FAR struct iob_s *seg, uint16_t iphdrlen)
+{
+  FAR uint8_t *ip = IOB_DATA(seg);
+  FAR struct tcp_hdr_s *tcp = (FAR struct tcp_hdr_s *)(ip + iphdrlen);
+  uint16_t tcplen = seg->io_pktlen - iphdrlen;
+  uint16_t sum = 0;
+
+#ifdef CONFIG_NET_IPv4
+  if ((ip[0] & IP_VERSION_MASK) == IPv4_VERSION)
+    {
+      FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)ip;
+
+      ipv4->len[0]   = seg->io_pktlen >> 8;
+      ipv4->len[1]   = seg->io_pktlen & 0xff;
+      ipv4->ipchksum = 0;
+#ifdef CONFIG_NET_IPV4_CHECKSUMS
+      ipv4->ipchksum = ~ipv4_chksum(ipv4);
+#endif
+
+      /* Pseudo-header: the addresses, the protocol and the TCP length */
+
+      sum = chksum(tcplen + IP_PROTO_TCP, (FAR uint8_t *)ipv4->srcipaddr,
+                   2 * sizeof(in_addr_t));
+    }
+  else
+#endif
+    {
+#ifdef CONFIG_NET_IPv6
+      FAR struct ipv6_hdr_s *ipv6 = (FAR struct ipv6_hdr_s *)ip;
+
+      ipv6->len[0] = tcplen >> 8;
+      ipv6->len[1] = tcplen & 0xff;
+
+      sum = chksum(tcplen + IP_PROTO_TCP, (FAR uint8_t *)ipv6->srcipaddr,
+                   2 * sizeof(net_ipv6addr_t));
+#endif
+    }
+
+  tcp->tcpchksum = 0;
+
+#ifdef CONFIG_NET_TCP_CHECKSUMS
+  if ((dev->d_features & NETDEV_TX_CSUM) == 0)
+    {
+      sum = chksum_iob(sum, seg, iphdrlen);
+      tcp->tcpchksum = ~((sum == 0) ? 0xffff : HTONS(sum));
+    }
+#else
+  UNUSED(sum);
+#endif
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_gso_maxlen
+ *
+ * Description:
+ *   Return the largest amount of data that the connection may send in one
+ *   packet on the device.  See net/tcp/tcp.h.
+ *
+ ****************************************************************************/
+
+uint32_t tcp_gso_maxlen(FAR struct net_driver_s *dev,
+                        FAR struct tcp_conn_s *conn)
+{
+  uint16_t hdrsize = tcpip_hdrsize(conn);
+  uint32_t maxlen = CONFIG_NET_TCP_GSO_MAXSIZE;
+  uint8_t tso;
+
+  /* Super-segments are split at the MTU of the device, so a connection
+   * with a smaller MSS sends one MSS at a time.  The loopback device
+   * never splits them.
+   */
+
+  if (conn->mss + hdrsize != NETDEV_PKTSIZE(dev) - NET_LL_HDRLEN(dev) ||
+      devif_is_loopback(dev))
+    {
+      return conn->mss;
+    }
+
+#ifdef CONFIG_NET_6LOWPAN
+  if (dev->d_lltype == NET_LL_IEEE802154 ||
+      dev->d_lltype == NET_LL_PKTRADIO)
+    {
+      return conn->mss;
+    }
+#endif
+
+  /* Keep the super-segments small enough for the device to segment them
+   * itself if it can.
+   */
+
+  tso = net_ip_domain_select(conn->domain, NETDEV_TX_TSO4, NETDEV_TX_TSO6);
+  if ((dev->d_features & tso) != 0 && dev->d_tso_maxsize != 0)
+    {
+      maxlen = MIN(maxlen, dev->d_tso_maxsize);
+    }
+
+  if (maxlen < hdrsize + 2 * conn->mss)
+    {
+      return conn->mss;
+    }
+
+  maxlen -= hdrsize;
+  return maxlen - maxlen % conn->mss;
+}
+
+/****************************************************************************
+ * Name: tcp_gso_out
+ *
+ * Description:
+ *   Move a TCP super-segment that the device does not segment itself to
+ *   d_gso.  See net/tcp/tcp.h.
+ *
+ ****************************************************************************/
+
+void tcp_gso_out(FAR struct net_driver_s *dev)
+{
+  FAR struct iob_s *iob = dev->d_iob;
+  uint16_t iphdrlen;
+  uint16_t hdrlen;
+  uint16_t mtu;
+  uint8_t tso;
+
+  if (iob == NULL || dev->d_len == 0)
+    {
+      return;
+    }
+
+  mtu = devif_get_mtu(dev);
+  if (iob->io_pktlen <= mtu)
+    {
+      return;
+    }
+
+  /* Anything else is left to the IP fragmentation */
+
+  hdrlen = tcp_gso_parse(iob, &iphdrlen, &tso);
+  if (hdrlen == 0 || hdrlen >= mtu || devif_is_loopback(dev))
+    {
+      return;
+    }
+
+  if ((dev->d_features & tso) != 0 && iob->io_pktlen <= dev->d_tso_maxsize &&
+      mtu == NETDEV_PKTSIZE(dev) - NET_LL_HDRLEN(dev))
+    {
+      return;
+    }
+
+  /* TCP holds new data while a super-segment is being split, so there
+   * is never more than one.
+   */
+
+  if (dev->d_gso != NULL)
+    {
+      nerr("ERROR: Dropped TCP super-segment, d_gso busy\n");
+      netdev_iob_release(dev);
+      dev->d_len = 0;
+      return;
+    }
+
+  ninfo("Split TCP super-segment: %u bytes, mss %u\n",
+        iob->io_pktlen, mtu - hdrlen);
+
+  dev->d_gso     = iob;
+  dev->d_gso_mss = mtu - hdrlen;
+  netdev_iob_clear(dev);
+
+  netdev_txnotify_dev(dev, GSO_POLL);
+}
+
+/****************************************************************************
+ * Name: tcp_gso_segment
+ *
+ * Description:
+ *   Cut the next segment from the super-segment in d_gso.  See
+ *   net/tcp/tcp.h.
+ *
+ *   The payload IOBs of the super-segment are moved to the segment, only
+ *   the IOBs straddling a segment boundary are copied.  The rest of the
+ *   super-segment keeps the header, which is advanced to the next segment,
+ *   and goes out as the last segment.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *tcp_gso_segment(FAR struct net_driver_s *dev)
+{
+  FAR struct iob_s *pkt = dev->d_gso;
+  FAR struct tcp_hdr_s *tcp;
+  FAR struct iob_s *tail;
+  FAR struct iob_s *seg;
+  FAR struct iob_s *iob;
+  uint16_t iphdrlen;
+  uint16_t hdrlen;
+  uint16_t ncopy;
+  uint16_t mss;
+  uint16_t len;
+  uint8_t tso;
+
+  if (pkt == NULL)
+    {
+      return NULL;
+    }
+
+  hdrlen = tcp_gso_parse(pkt, &iphdrlen, &tso);
+  mss    = dev->d_gso_mss;
+  DEBUGASSERT(hdrlen != 0);
+
+  if (pkt->io_pktlen <= hdrlen + mss)
+    {
+      /* The rest fits in one segment */
+
+      dev->d_gso = NULL;
+      tcp_gso_finish(dev, pkt, iphdrlen);
+      return pkt;
+    }
+
+  seg = iob_tryalloc(false);
+  if (seg == NULL)
+    {
+      goto errout;
+    }
+
+  iob_reserve(seg, CONFIG_NET_LL_GUARDSIZE);
+
+  /* Copy the header and the payload that shares the first IOB with it,
+   * then move the header up over the copied payload.
+   */
+
+  ncopy = MIN(pkt->io_len, hdrlen + mss);
+  if (iob_trycopyin(seg, IOB_DATA(pkt), ncopy, 0, false) != ncopy)
+    {
+      goto errout;
+    }
+
+  len = ncopy - hdrlen;
+  memmove(IOB_DATA(pkt) + len, IOB_DATA(pkt), hdrlen);
+  pkt->io_offset += len;
+  pkt->io_len    -= len;
+
+  tail = seg;
+  while (tail->io_flink != NULL)
+    {
+      tail = tail->io_flink;
+    }
+
+  /* Move the following IOBs, copy the head of the one across the segment
+   * boundary.
+   */
+
+  while (len < mss)
+    {
+      iob = pkt->io_flink;
+      DEBUGASSERT(iob != NULL);
+
+      if (iob->io_len <= mss - len)
+        {
+          pkt->io_flink   = iob->io_flink;
+          iob->io_flink   = NULL;
+          tail->io_flink  = iob;
+          tail            = iob;
+          seg->io_pktlen += iob->io_len;
+          len            += iob->io_len;
+        }
+      else
+        {
+          ncopy = mss - len;
+          if (iob_trycopyin(seg, IOB_DATA(iob), ncopy, seg->io_pktlen,
+                            false) != ncopy)
+            {
+              goto errout;
+            }
+
+          iob->io_offset += ncopy;
+          iob->io_len    -= ncopy;
+          len            += ncopy;
+        }
+    }
+
+  pkt->io_pktlen -= mss;
+
+  /* Only the last segment carries PSH and FIN */
+
+  tcp = (FAR struct tcp_hdr_s *)(IOB_DATA(seg) + iphdrlen);
+  tcp->flags &= ~(TCP_PSH | TCP_FIN);
+  tcp_gso_finish(dev, seg, iphdrlen);
+
+  /* Advance the header template to the next segment */
+
+  tcp = (FAR struct tcp_hdr_s *)(IOB_DATA(pkt) + iphdrlen);
+  tcp_setsequence(tcp->seqno, tcp_getsequence(tcp->seqno) + mss);
+
+#ifdef CONFIG_NET_IPv4
+  if (tso == NETDEV_TX_TSO4)
+    {
+      FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)IOB_DATA(pkt);
+      uint16_t ipid = ((ipv4->ipid[0] << 8) | ipv4->ipid[1]) + 1;
+
+      ipv4->ipid[0] = ipid >> 8;
+      ipv4->ipid[1] = ipid & 0xff;
+    }
+#endif
+
+  return seg;
+
+errout:
+  nerr("ERROR: Failed to allocate an IOB, dropped TCP super-segment\n");
+  iob_free_chain(seg);
+  iob_free_chain(pkt);
+  dev->d_gso = NULL;
+  return NULL;
+}
+
+#endif /* NET_TCP_HAVE_STACK && CONFIG_NET_TCP_GSO */
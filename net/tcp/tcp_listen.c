@@ -57,13 +57,30 @@
 #include "inet/inet.h"
 #include "tcp/tcp.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CONN_HASH
+#  define TCP_LISTEN_HASH(p) \
+     (((unsigned int)(p) ^ ((unsigned int)(p) >> 8)) & \
+      (CONFIG_NET_TCP_CONN_HASH_SIZE - 1))
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
+#ifdef CONFIG_NET_TCP_CONN_HASH
+/* All currently listening connections, hashed by local port */
+
+static dq_queue_t g_tcp_listen_hash[CONFIG_NET_TCP_CONN_HASH_SIZE];
+static int g_tcp_nlisteners;
+#else
 /* The tcp_listenports list all currently listening ports. */
 
 static FAR struct tcp_conn_s *tcp_listenports[CONFIG_NET_MAX_LISTENPORTS];
+#endif
 
 /****************************************************************************
  * Private Functions
@@ -89,6 +106,18 @@ FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
                                         uint16_t portno)
 #endif
 {
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  FAR dq_entry_t *entry;
+
+  /* Examine the listeners hashed to the same bucket as this port */
+
+  tcp_conn_list_lock();
+  for (entry = g_tcp_listen_hash[TCP_LISTEN_HASH(portno)].head;
+       entry != NULL; entry = entry->flink)
+    {
+      FAR struct tcp_conn_s *conn =
+        container_of(entry, struct tcp_conn_s, lnode);
+#else
   int ndx;
 
   /* Examine each connection structure in each slot of the listener list */
@@ -101,6 +130,7 @@ FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
        */
 
       FAR struct tcp_conn_s *conn = tcp_listenports[ndx];
+#endif
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
       if (tcp_conn_cmp(domain, (FAR const union ip_addr_u *)uaddr, portno,
                        conn))
@@ -136,10 +166,28 @@ FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
 
 int tcp_unlisten(FAR struct tcp_conn_s *conn)
 {
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  FAR dq_queue_t *bucket = &g_tcp_listen_hash[TCP_LISTEN_HASH(conn->lport)];
+  FAR dq_entry_t *entry;
+#else
   int ndx;
+#endif
   int ret = -EINVAL;
 
   tcp_conn_list_lock();
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  for (entry = bucket->head; entry != NULL; entry = entry->flink)
+    {
+      if (entry == &conn->lnode)
+        {
+          dq_rem(entry, bucket);
+          g_tcp_nlisteners--;
+          tcp_remove_syn_backlog(conn);
+          ret = OK;
+          break;
+        }
+    }
+#else
   for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
     {
       if (tcp_listenports[ndx] == conn)
@@ -150,6 +198,7 @@ int tcp_unlisten(FAR struct tcp_conn_s *conn)
           break;
         }
     }
+#endif
 
   tcp_conn_list_unlock();
   return ret;
@@ -168,7 +217,9 @@ int tcp_unlisten(FAR struct tcp_conn_s *conn)
 
 int tcp_listen(FAR struct tcp_conn_s *conn)
 {
+#ifndef CONFIG_NET_TCP_CONN_HASH
   int ndx;
+#endif
   int ret;
 
   /* This must be done with network locked because the listener table
@@ -197,6 +248,15 @@ int tcp_listen(FAR struct tcp_conn_s *conn)
 
       ret = -ENOBUFS; /* Assume failure */
 
+#ifdef CONFIG_NET_TCP_CONN_HASH
+      if (g_tcp_nlisteners < CONFIG_NET_MAX_LISTENPORTS)
+        {
+          dq_addlast(&conn->lnode,
+                     &g_tcp_listen_hash[TCP_LISTEN_HASH(conn->lport)]);
+          g_tcp_nlisteners++;
+          ret = OK;
+        }
+#else
       /* Search all slots until an available slot is found */
 
       for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
@@ -212,6 +272,7 @@ int tcp_listen(FAR struct tcp_conn_s *conn)
               break;
             }
         }
+#endif
     }
 
   tcp_conn_list_unlock();
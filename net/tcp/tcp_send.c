@@ -65,6 +65,23 @@
 #include "tcp/tcp.h"
 #include "utils/utils.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* A super-segment that is split by software GSO gets the checksum of each
+ * segment computed later by tcp_gso_segment(), skip the one over the whole.
+ */
+
+#ifdef CONFIG_NET_TCP_GSO
+#  define TCP_TX_CSUM(d,c) \
+     (((d)->d_features & NETDEV_TX_CSUM) == 0 && \
+      ((d)->d_len <= tcpip_hdrsize(c) + (c)->mss || \
+       ((d)->d_features & (NETDEV_TX_TSO4 | NETDEV_TX_TSO6)) != 0))
+#else
+#  define TCP_TX_CSUM(d,c) (((d)->d_features & NETDEV_TX_CSUM) == 0)
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -200,7 +217,7 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
       tcp->tcpchksum = 0;
 
 #ifdef CONFIG_NET_TCP_CHECKSUMS
-      if ((dev->d_features & NETDEV_TX_CSUM) == 0)
+      if (TCP_TX_CSUM(dev, conn))
         {
           tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
         }
@@ -227,7 +244,7 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
       tcp->tcpchksum = 0;
 
 #ifdef CONFIG_NET_TCP_CHECKSUMS
-      if ((dev->d_features & NETDEV_TX_CSUM) == 0)
+      if (TCP_TX_CSUM(dev, conn))
         {
           tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
         }
@@ -1004,6 +1004,17 @@ static uint32_t psock_send_eventhandler(FAR struct net_driver_s *dev,
       return flags;
     }
 
+#ifdef CONFIG_NET_TCP_GSO
+  if (dev->d_gso != NULL)
+    {
+      /* New data must not overtake the segments of a super-segment that is
+       * still being split, wait for the next poll.
+       */
+
+      return flags;
+    }
+#endif
+
   /* We get here if (1) not all of the data has been ACKed, (2) we have been
    * asked to retransmit data, (3) the connection is still healthy, and (4)
    * the outgoing packet is available for our use.  In this case, we are
@@ -1023,6 +1034,7 @@ static uint32_t psock_send_eventhandler(FAR struct net_driver_s *dev,
       uint32_t predicted_seqno;
       uint32_t seq;
       uint32_t snd_wnd_edge;
+      uint32_t maxlen;
       size_t sndlen;
 
       /* Peek at the head of the write queue (but don't remove anything
@@ -1045,10 +1057,16 @@ static uint32_t psock_send_eventhandler(FAR struct net_driver_s *dev,
 
       /* Get the amount of data that we can send in the next packet.
        * We will send either the remaining data in the buffer I/O
-       * buffer chain, or as much as will fit given the MSS and current
-       * window size.
+       * buffer chain, or as much as will fit given the MSS (or the
+       * super-segment size) and current window size.
        */
 
+#ifdef CONFIG_NET_TCP_GSO
+      maxlen = tcp_gso_maxlen(dev, conn);
+#else
+      maxlen = conn->mss;
+#endif
+
       seq = TCP_WBSEQNO(wrb) + TCP_WBSENT(wrb);
 
 #ifdef CONFIG_NET_TCP_CC_NEWRENO
@@ -1062,9 +1080,9 @@ static uint32_t psock_send_eventhandler(FAR struct net_driver_s *dev,
           int ret;
 
           sndlen = TCP_WBPKTLEN(wrb) - TCP_WBSENT(wrb);
-          if (sndlen > conn->mss)
+          if (sndlen > maxlen)
             {
-              sndlen = conn->mss;
+              sndlen = maxlen;
             }
 
           remaining_snd_wnd = TCP_SEQ_SUB(snd_wnd_edge, seq);
@@ -1223,6 +1241,12 @@ static uint32_t tcp_max_wrb_size(FAR struct tcp_conn_s *conn)
 
   size = 4 * mss;
 
+#ifdef CONFIG_NET_TCP_GSO
+  /* or a whole super-segment */
+
+  size = MAX(size, CONFIG_NET_TCP_GSO_MAXSIZE);
+#endif
+
   /* but it should not hog too many IOB buffers */
 
   if (size > CONFIG_IOB_NBUFFERS * CONFIG_IOB_BUFSIZE / 2)
@@ -29,6 +29,7 @@
 #include <sys/time.h>
 #include <stdint.h>
 #include <errno.h>
+#include <string.h>
 #include <assert.h>
 #include <nuttx/debug.h>
 
@@ -263,6 +264,30 @@ int tcp_setsockopt(FAR struct socket *psock, int option,
           }
         break;
 
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+      case TCP_CONGESTION: /* The congestion control algorithm */
+        {
+          char name[TCP_CA_NAME_MAX];
+          size_t len;
+
+          if (value_len == 0)
+            {
+              return -EINVAL;
+            }
+
+          /* The name need not be NUL terminated within value_len */
+
+          len = MIN(value_len, sizeof(name) - 1);
+          memcpy(name, value, len);
+          name[len] = '\0';
+
+          conn_dev_lock(&conn->sconn, conn->dev);
+          ret = tcp_cc_select(conn, name);
+          conn_dev_unlock(&conn->sconn, conn->dev);
+        }
+        break;
+#endif
+
       default:
         nerr("ERROR: Unrecognized TCP option: %d\n", option);
         ret = -ENOPROTOOPT;
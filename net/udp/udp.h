@@ -113,6 +113,9 @@ struct udp_conn_s
   union ip_binding_u u;   /* IP address binding */
   uint16_t lport;         /* Bound local port number (network byte order) */
   uint16_t rport;         /* Remote port number (network byte order) */
+#ifdef CONFIG_NET_UDP_CONN_HASH
+  dq_entry_t hnode;       /* Link in the connection hash table */
+#endif
   uint8_t  flags;         /* See _UDP_FLAG_* definitions */
   uint8_t  domain;        /* IP domain: PF_INET or PF_INET6 */
   uint8_t  crefs;         /* Reference counts on this instance */
@@ -298,6 +301,18 @@ void udp_conn_list_unlock(void);
 
 uint16_t udp_select_port(uint8_t domain, FAR union ip_binding_u *u);
 
+/****************************************************************************
+ * Name: udp_setport
+ *
+ * Description:
+ *   Assign the local port number (network byte order) of a connection.
+ *   Zero unbinds the connection.  All changes of conn->lport must be made
+ *   with this function so that the connection hash stays consistent.
+ *
+ ****************************************************************************/
+
+void udp_setport(FAR struct udp_conn_s *conn, uint16_t lport);
+
 /****************************************************************************
  * Name: udp_bind
  *
@@ -62,6 +62,7 @@
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
+#include <nuttx/net/netstats.h>
 #include <nuttx/net/ip.h>
 #include <nuttx/net/udp.h>
 
@@ -82,6 +83,23 @@
 #  define CONFIG_NET_UDP_MAX_CONNS 0
 #endif
 
+#ifdef CONFIG_NET_UDP_CONN_HASH
+#  if (CONFIG_NET_UDP_CONN_HASH_SIZE & \
+       (CONFIG_NET_UDP_CONN_HASH_SIZE - 1)) != 0
+#    error CONFIG_NET_UDP_CONN_HASH_SIZE must be a power of two
+#  endif
+
+#  define UDP_HASH(p) \
+     (((unsigned int)(p) ^ ((unsigned int)(p) >> 8)) & \
+      (CONFIG_NET_UDP_CONN_HASH_SIZE - 1))
+#endif
+
+#if defined(CONFIG_NET_STATISTICS) && defined(CONFIG_NET_UDP_CONN_HASH)
+#  define UDP_HASH_STATINCR(p) ((p)++)
+#else
+#  define UDP_HASH_STATINCR(p)
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -96,6 +114,12 @@ NET_BUFPOOL_DECLARE(g_udp_connections, sizeof(struct udp_conn_s),
 
 static dq_queue_t g_active_udp_connections;
 
+#ifdef CONFIG_NET_UDP_CONN_HASH
+/* The bound connections (lport != 0), hashed by local port */
+
+static dq_queue_t g_udp_conn_hash[CONFIG_NET_UDP_CONN_HASH_SIZE];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -182,6 +206,40 @@ static FAR struct udp_conn_s *udp_find_conn(uint8_t domain,
   return conn;
 }
 
+/****************************************************************************
+ * Name: udp_active_next
+ *
+ * Description:
+ *   Return the connection following 'conn' (or the first one if 'conn' is
+ *   NULL) that may be bound to the local port 'lport'.  Without hashing
+ *   this simply traverses all connections.
+ *
+ * Assumptions:
+ *   This function must be called with the udp_conn_list_lock.
+ *
+ ****************************************************************************/
+
+static inline_function FAR struct udp_conn_s *
+udp_active_next(FAR struct udp_conn_s *conn, uint16_t lport)
+{
+#ifdef CONFIG_NET_UDP_CONN_HASH
+  FAR dq_entry_t *entry;
+
+  entry = conn != NULL ? conn->hnode.flink :
+                         g_udp_conn_hash[UDP_HASH(lport)].head;
+  if (entry == NULL)
+    {
+      return NULL;
+    }
+
+  UDP_HASH_STATINCR(g_netstats.udp.hashprobe);
+  return container_of(entry, struct udp_conn_s, hnode);
+#else
+  UNUSED(lport);
+  return udp_nextconn(conn);
+#endif
+}
+
 /****************************************************************************
  * Name: udp_ipv4_active
  *
@@ -204,7 +262,7 @@ udp_ipv4_active(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
 #endif
   FAR struct ipv4_hdr_s *ip = IPv4BUF;
 
-  conn = udp_nextconn(conn);
+  conn = udp_active_next(conn, udp->destport);
 
   while (conn)
     {
@@ -318,7 +376,7 @@ udp_ipv4_active(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
 
       /* Look at the next active connection */
 
-      conn = udp_nextconn(conn);
+      conn = udp_active_next(conn, udp->destport);
     }
 
   return conn;
@@ -344,7 +402,7 @@ udp_ipv6_active(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
 {
   FAR struct ipv6_hdr_s *ip = IPv6BUF;
 
-  conn = udp_nextconn(conn);
+  conn = udp_active_next(conn, udp->destport);
 
   while (conn != NULL)
     {
@@ -458,7 +516,7 @@ udp_ipv6_active(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
 
       /* Look at the next active connection */
 
-      conn = udp_nextconn(conn);
+      conn = udp_active_next(conn, udp->destport);
     }
 
   return conn;
@@ -606,7 +664,7 @@ void udp_free(FAR struct udp_conn_s *conn)
   DEBUGASSERT(conn->crefs == 0);
 
   NET_BUFPOOL_LOCK(g_udp_connections);
-  conn->lport = 0;
+  udp_setport(conn, 0);
 
   /* Remove the connection from the active list */
 
@@ -661,6 +719,11 @@ FAR struct udp_conn_s *udp_active(FAR struct net_driver_s *dev,
                                   FAR struct udp_conn_s *conn,
                                   FAR struct udp_hdr_s *udp)
 {
+  if (conn == NULL)
+    {
+      UDP_HASH_STATINCR(g_netstats.udp.hashlookup);
+    }
+
 #ifdef CONFIG_NET_IPv6
 #ifdef CONFIG_NET_IPv4
   if (IFF_IS_IPv6(dev->d_flags))
@@ -735,6 +798,35 @@ FAR struct udp_conn_s *udp_nextconn(FAR struct udp_conn_s *conn)
     }
 }
 
+/****************************************************************************
+ * Name: udp_setport
+ *
+ * Description:
+ *   Assign the local port number (network byte order) of a connection.
+ *   Zero unbinds the connection.
+ *
+ ****************************************************************************/
+
+void udp_setport(FAR struct udp_conn_s *conn, uint16_t lport)
+{
+  udp_conn_list_lock();
+
+#ifdef CONFIG_NET_UDP_CONN_HASH
+  if (conn->lport != 0)
+    {
+      dq_rem(&conn->hnode, &g_udp_conn_hash[UDP_HASH(conn->lport)]);
+    }
+
+  if (lport != 0)
+    {
+      dq_addlast(&conn->hnode, &g_udp_conn_hash[UDP_HASH(lport)]);
+    }
+#endif
+
+  conn->lport = lport;
+  udp_conn_list_unlock();
+}
+
 /****************************************************************************
  * Name: udp_bind
  *
@@ -876,7 +968,7 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
         }
       else
         {
-          conn->lport = portno;
+          udp_setport(conn, portno);
           ret         = OK;
         }
     }
@@ -901,7 +993,7 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
         {
           /* No.. then bind the socket to the port */
 
-          conn->lport = portno;
+          udp_setport(conn, portno);
           ret         = OK;
         }
       else
@@ -953,7 +1045,7 @@ int udp_connect(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
        * connection structure.
        */
 
-      conn->lport = HTONS(udp_select_port(conn->domain, &conn->u));
+      udp_setport(conn, HTONS(udp_select_port(conn->domain, &conn->u)));
       if (!conn->lport)
         {
           nerr("ERROR: Failed to get a local port!\n");
@@ -27,12 +27,168 @@
 #include <nuttx/config.h>
 #ifdef CONFIG_NET
 
+#include <stdint.h>
+#include <string.h>
+
 #include "utils/utils.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Byte swap of a 16-bit ones' complement sum.  The sum is independent of
+ * the byte order (RFC 1071), so swapping a partial sum is the same as
+ * summing the byte swapped data.
+ */
+
+#define CHKSUM_SWAP(s)   ((uint16_t)(((s) << 8) | ((s) >> 8)))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_CHKSUM_VECTOR) && defined(__GNUC__)
+typedef uint32_t chksum_vec_t __attribute__((vector_size(16)));
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: chksum_fold
+ *
+ * Description:
+ *   Fold a 64-bit accumulator of deferred carries into a 16-bit ones'
+ *   complement sum.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_NET_ARCH_CHKSUM
+static inline_function uint16_t chksum_fold(uint64_t acc)
+{
+  acc = (acc & 0xffffffff) + (acc >> 32);
+  acc = (acc & 0xffffffff) + (acc >> 32);
+  acc = (acc & 0xffff) + (acc >> 16);
+  acc = (acc & 0xffff) + (acc >> 16);
+
+  return (uint16_t)acc;
+}
+
+/****************************************************************************
+ * Name: chksum_native
+ *
+ * Description:
+ *   Return the ones' complement sum of a buffer starting at an even
+ *   position of the data stream, in host byte order.  The data is loaded
+ *   with native 32-bit (or vector) accesses and the carries are
+ *   accumulated in 64 bits, so that they are folded only once at the end.
+ *
+ ****************************************************************************/
+
+static uint16_t chksum_native(FAR const uint8_t *data, size_t len)
+{
+  FAR const uint32_t *ptr;
+  uint64_t acc = 0;
+  union
+  {
+    uint8_t  b[2];
+    uint16_t w;
+  } u;
+
+  /* A buffer at an odd address is summed from its second byte, which is at
+   * an odd stream position, so that partial sum is swapped.
+   */
+
+  if (((uintptr_t)data & 1) != 0)
+    {
+      u.b[0] = data[0];
+      u.b[1] = 0;
+
+      acc = CHKSUM_SWAP(chksum_native(data + 1, len - 1));
+      return chksum_fold(acc + u.w);
+    }
+
+  if (((uintptr_t)data & 2) != 0 && len >= 2)
+    {
+      acc   = *(FAR const uint16_t *)data;
+      data += 2;
+      len  -= 2;
+    }
+
+  ptr = (FAR const uint32_t *)data;
+
+#if defined(CONFIG_NET_CHKSUM_VECTOR) && defined(__GNUC__)
+  if (len >= 64)
+    {
+      chksum_vec_t sum;
+      chksum_vec_t carry;
+      chksum_vec_t v;
+      int i;
+
+      memset(&sum, 0, sizeof(sum));
+      memset(&carry, 0, sizeof(carry));
+
+      /* The lane compare yields all ones (-1) for each lane that wrapped
+       * around, so the carries are counted by subtracting it.
+       */
+
+      do
+        {
+          for (i = 0; i < 4; i++)
+            {
+              memcpy(&v, ptr, sizeof(v));
+              sum   += v;
+              carry -= (chksum_vec_t)(sum < v);
+              ptr   += 4;
+            }
+
+          len -= 64;
+        }
+      while (len >= 64);
+
+      for (i = 0; i < 4; i++)
+        {
+          acc += sum[i] + ((uint64_t)carry[i] << 32);
+        }
+    }
+#endif
+
+  while (len >= 16)
+    {
+      acc += ptr[0];
+      acc += ptr[1];
+      acc += ptr[2];
+      acc += ptr[3];
+      ptr += 4;
+      len -= 16;
+    }
+
+  while (len >= 4)
+    {
+      acc += *ptr++;
+      len -= 4;
+    }
+
+  data = (FAR const uint8_t *)ptr;
+
+  if (len >= 2)
+    {
+      acc  += *(FAR const uint16_t *)data;
+      data += 2;
+      len  -= 2;
+    }
+
+  if (len > 0)
+    {
+      u.b[0] = data[0];
+      u.b[1] = 0;
+      acc   += u.w;
+    }
+
+  return chksum_fold(acc);
+}
+
 /****************************************************************************
  * Name: checksum
  *
@@ -53,60 +209,35 @@
  *
  ****************************************************************************/
 
-#ifndef CONFIG_NET_ARCH_CHKSUM
 uint16_t checksum(uint16_t sum, FAR const uint8_t *data,
                     uint16_t len, bool *odd)
 {
-  FAR const uint8_t *dataptr;
-  FAR const uint8_t *last_byte;
-  uint16_t t;
+  uint32_t t;
 
-  dataptr = data;
-  last_byte = data + len - 1;
-
-  if (*odd == true)
+  if (len == 0)
     {
-      t = dataptr[0];
-      sum += t;
-      if (sum < t)
-        {
-          sum++; /* carry */
-        }
-
-      dataptr += 1;
+      return sum;
     }
 
-  while (dataptr < last_byte)
-    {
-      /* At least two more bytes */
+  t = NTOHS(chksum_native(data, len));
 
-      t = ((uint16_t)dataptr[0] << 8) + dataptr[1];
-      sum += t;
-      if (sum < t)
-        {
-          sum++; /* carry */
-        }
+  /* The data started at an odd position of the stream (e.g. after an iob
+   * holding an odd number of bytes), its bytes are the other way round.
+   */
 
-      dataptr += 2;
+  if (*odd)
+    {
+      t = CHKSUM_SWAP(t);
     }
 
-  *odd = false;
-
-  if (dataptr == last_byte)
-    {
-      t = (dataptr[0] << 8) + 0;
-      sum += t;
-      if (sum < t)
-        {
-          sum++; /* carry */
-        }
+  t += sum;
+  t  = (t & 0xffff) + (t >> 16);
 
-      *odd = true;
-    }
+  *odd ^= (len & 1) != 0;
 
   /* Return sum in host byte order. */
 
-  return sum;
+  return (uint16_t)t;
 }
 
 /****************************************************************************
@@ -57,6 +57,8 @@
 #include "mqueue/msg.h"
 #include "clock/clock.h"
 #include "timer/timer.h"
+#include "wdog/wdog.h"
+#include "wqueue/wqueue.h"
 #include "irq/irq.h"
 #include "group/group.h"
 #include "init/init.h"
@@ -637,6 +639,16 @@ void nx_start(void)
 
   clock_initialize();
 
+  /* Initialize the watchdog timer queue */
+
+  wd_initialize();
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  /* Initialize the per-CPU queues of the kernel work queues */
+
+  work_initialize();
+#endif
+
 #ifndef CONFIG_DISABLE_POSIX_TIMERS
   timer_initialize();
 #endif
@@ -291,6 +291,18 @@ irqstate_t enter_critical_section(void)
 {
   FAR struct tcb_s *rtcb;
   irqstate_t flags;
+#if CONFIG_SCHED_CRITMONITOR_CSECTION_SITES > 0
+  clock_t start = perf_gettime();
+  bool contended = false;
+
+#  ifdef CONFIG_SMP
+  /* Sample the lock before taking it, the calling CPU cannot hold it yet
+   * when the entry is the outermost one which is the only one recorded.
+   */
+
+  contended = spin_is_locked(&g_cpu_irqlock);
+#  endif
+#endif
 
   /* If CONFIG_SCHED_CRITMONITOR_MAXTIME_BUSYWAIT >= 0,
    * start counting time of busy-waiting.
@@ -312,6 +324,10 @@ irqstate_t enter_critical_section(void)
 #if CONFIG_SCHED_CRITMONITOR_MAXTIME_CSECTION >= 0
           nxsched_critmon_csection(rtcb, true, return_address(0));
 #endif
+#if CONFIG_SCHED_CRITMONITOR_CSECTION_SITES > 0
+          nxsched_critmon_cssite(return_address(0), contended,
+                                 perf_gettime() - start);
+#endif
 #ifdef CONFIG_SCHED_INSTRUMENTATION_CSECTION
           sched_note_csection(rtcb, true);
 #endif
@@ -52,7 +52,8 @@ struct msgpool_s
 #ifndef CONFIG_DISABLE_MQUEUE
   uint8_t mqueue[MQ_BLOCK_SIZE *
                  (CONFIG_PREALLOC_MQ_MSGS +
-                  CONFIG_PREALLOC_MQ_IRQ_MSGS)];
+                  CONFIG_PREALLOC_MQ_IRQ_MSGS)]
+                 aligned_data(sizeof(FAR void *));
 #endif
 #ifndef CONFIG_DISABLE_MQUEUE_SYSV
   struct msgbuf_s msgbuf[CONFIG_PREALLOC_MQ_MSGS];
@@ -31,6 +31,7 @@
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/nuttx.h>
 #include <nuttx/spinlock.h>
 
 #include "mqueue/mqueue.h"
@@ -103,3 +104,25 @@ void nxmq_free_msg(FAR struct mqueue_msg_s *mqmsg)
       DEBUGPANIC();
     }
 }
+
+/****************************************************************************
+ * Name: file_mq_return
+ *
+ * Description:
+ *   Give back a message buffer obtained with file_mq_loan() or
+ *   file_mq_[timed|tick]receive_loan() to the message pool.
+ *
+ * Input Parameters:
+ *   buf - The loaned message buffer
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MQ_ZEROCOPY
+void file_mq_return(FAR void *buf)
+{
+  nxmq_free_msg(container_of(buf, struct mqueue_msg_s, mail));
+}
+#endif
@@ -28,6 +28,7 @@
 
 #include <sys/types.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <assert.h>
 #include <errno.h>
 #include <mqueue.h>
@@ -104,6 +105,92 @@ static int nxmq_verify_receive(FAR struct file *mq,
 }
 #endif
 
+/****************************************************************************
+ * Name: nxmq_do_receive
+ *
+ * Description:
+ *   This is internal, common logic shared by the copying and the loan
+ *   variants of [nx]mq_receive.  It removes the oldest of the highest
+ *   priority messages from the message queue, waiting for one if the
+ *   queue is empty, and notifies any waiting senders.
+ *
+ * Input Parameters:
+ *   mq      - Message Queue Descriptor
+ *   rcvmsg  - The location to return the dequeued message
+ *   abstime - the absolute time to wait until a timeout is declared.
+ *   ticks   - Ticks to wait from the start time until the semaphore is
+ *             posted.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success, the message is then owned by the
+ *   caller.  A negated errno value is returned on failure.
+ *
+ ****************************************************************************/
+
+static int nxmq_do_receive(FAR struct file *mq,
+                           FAR struct mqueue_msg_s **rcvmsg,
+                           FAR const struct timespec *abstime,
+                           sclock_t ticks)
+{
+  FAR struct mqueue_inode_s *msgq = mq->f_inode->i_private;
+  FAR struct mqueue_msg_s *mqmsg;
+  irqstate_t flags;
+  int ret;
+
+  /* Furthermore, nxmq_wait_receive() expects to have interrupts disabled
+   * because messages can be sent from interrupt level.
+   */
+
+  flags = enter_critical_section();
+
+  /* Get the message from the message queue */
+
+  mqmsg = (FAR struct mqueue_msg_s *)list_remove_head(&msgq->msglist);
+  if (mqmsg == NULL)
+    {
+      if ((mq->f_oflags & O_NONBLOCK) != 0)
+        {
+          leave_critical_section(flags);
+          return -EAGAIN;
+        }
+
+      /* If we are in interrupt context, return EAGAIN instead of blocking */
+
+      if (up_interrupt_context())
+        {
+          leave_critical_section(flags);
+          return -EAGAIN;
+        }
+
+      /* Wait & get the message from the message queue */
+
+      ret = nxmq_wait_receive(msgq, &mqmsg, abstime, ticks);
+      if (ret < 0)
+        {
+          leave_critical_section(flags);
+          return ret;
+        }
+    }
+
+  /* If we got message, then decrement the number of messages in
+   * the queue while we are still in the critical section
+   */
+
+  if (msgq->nmsgs-- == msgq->maxmsgs)
+    {
+      nxmq_pollnotify(msgq, POLLOUT);
+    }
+
+  /* Notify all threads waiting for a message in the message queue */
+
+  nxmq_notify_receive(msgq);
+
+  leave_critical_section(flags);
+
+  *rcvmsg = mqmsg;
+  return OK;
+}
+
 /****************************************************************************
  * Name: file_mq_timedreceive_internal
  *
@@ -140,9 +227,7 @@ ssize_t file_mq_timedreceive_internal(FAR struct file *mq, FAR char *msg,
                                       FAR const struct timespec *abstime,
                                       sclock_t ticks)
 {
-  FAR struct mqueue_inode_s *msgq;
   FAR struct mqueue_msg_s *mqmsg;
-  irqstate_t flags;
   ssize_t ret = 0;
 
   /* Verify the input parameters */
@@ -169,74 +254,88 @@ ssize_t file_mq_timedreceive_internal(FAR struct file *mq, FAR char *msg,
     }
 #endif
 
-  msgq = mq->f_inode->i_private;
+  ret = nxmq_do_receive(mq, &mqmsg, abstime, ticks);
+  if (ret < 0)
+    {
+      return ret;
+    }
 
-  /* Furthermore, nxmq_wait_receive() expects to have interrupts disabled
-   * because messages can be sent from interrupt level.
-   */
+  /* Return the message to the caller */
 
-  flags = enter_critical_section();
+  if (prio)
+    {
+      *prio = mqmsg->priority;
+    }
 
-  /* Get the message from the message queue */
+  memcpy(msg, mqmsg->mail, mqmsg->msglen);
+  ret = mqmsg->msglen;
 
-  mqmsg = (FAR struct mqueue_msg_s *)list_remove_head(&msgq->msglist);
-  if (mqmsg == NULL)
-    {
-      if ((mq->f_oflags & O_NONBLOCK) != 0)
-        {
-          leave_critical_section(flags);
-          return -EAGAIN;
-        }
+  /* Free the message structure */
 
-      /* If we are in interrupt context, return EAGAIN instead of blocking */
+  nxmq_free_msg(mqmsg);
 
-      if (up_interrupt_context())
-        {
-          leave_critical_section(flags);
-          return -EAGAIN;
-        }
+  return ret;
+}
 
-      /* Wait & get the message from the message queue */
+/****************************************************************************
+ * Name: file_mq_timedreceive_loan_internal
+ *
+ * Description:
+ *   This is an internal function of file_mq_timedreceive_loan()/
+ *   file_mq_tickreceive_loan(), please refer to the detailed description
+ *   for more information.
+ *
+ ****************************************************************************/
 
-      ret = nxmq_wait_receive(msgq, &mqmsg, abstime, ticks);
-      if (ret < 0)
-        {
-          leave_critical_section(flags);
-          return ret;
-        }
-    }
+#ifdef CONFIG_MQ_ZEROCOPY
+static ssize_t
+file_mq_timedreceive_loan_internal(FAR struct file *mq, FAR void **buf,
+                                   FAR unsigned int *prio,
+                                   FAR const struct timespec *abstime,
+                                   sclock_t ticks)
+{
+  FAR struct mqueue_msg_s *mqmsg;
+  ssize_t ret;
 
-  /* If we got message, then decrement the number of messages in
-   * the queue while we are still in the critical section
-   */
+  /* Verify the input parameters */
 
-  if (msgq->nmsgs-- == msgq->maxmsgs)
+  if (abstime && (abstime->tv_nsec < 0 || abstime->tv_nsec >= 1000000000))
     {
-      nxmq_pollnotify(msgq, POLLOUT);
+      return -EINVAL;
     }
 
-  /* Notify all threads waiting for a message in the message queue */
+  if (mq == NULL || buf == NULL)
+    {
+      return -EINVAL;
+    }
 
-  nxmq_notify_receive(msgq);
+#ifdef CONFIG_DEBUG_FEATURES
+  /* The message is not copied, so any buffer size is large enough */
 
-  leave_critical_section(flags);
+  ret = nxmq_verify_receive(mq, (FAR char *)buf, SIZE_MAX);
+  if (ret < 0)
+    {
+      return ret;
+    }
+#endif
 
-  /* Return the message to the caller */
+  ret = nxmq_do_receive(mq, &mqmsg, abstime, ticks);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Hand the message buffer itself over to the caller */
 
   if (prio)
     {
       *prio = mqmsg->priority;
     }
 
-  memcpy(msg, mqmsg->mail, mqmsg->msglen);
-  ret = mqmsg->msglen;
-
-  /* Free the message structure */
-
-  nxmq_free_msg(mqmsg);
-
-  return ret;
+  *buf = mqmsg->mail;
+  return mqmsg->msglen;
 }
+#endif
 
 /****************************************************************************
  * Public Functions
@@ -597,3 +696,64 @@ ssize_t mq_receive(mqd_t mqdes, FAR char *msg, size_t msglen,
   leave_cancellation_point();
   return ret;
 }
+
+#ifdef CONFIG_MQ_ZEROCOPY
+
+/****************************************************************************
+ * Name: file_mq_timedreceive_loan
+ *
+ * Description:
+ *   This function behaves like file_mq_timedreceive(), except that the
+ *   message is not copied: the message buffer itself is returned in 'buf'
+ *   and owned by the caller from then on.  The caller gives it back with
+ *   file_mq_return() or forwards it with file_mq_timedsend_loan().
+ *
+ * Input Parameters:
+ *   mq      - Message Queue Descriptor
+ *   buf     - The location to return the message buffer
+ *   prio    - If not NULL, the location to store message priority.
+ *   abstime - the absolute time to wait until a timeout is declared.
+ *
+ * Returned Value:
+ *   On success, the length of the selected message in bytes is returned.
+ *   A negated errno value is returned on failure (see
+ *   file_mq_timedreceive() for the list of valid values).
+ *
+ ****************************************************************************/
+
+ssize_t file_mq_timedreceive_loan(FAR struct file *mq, FAR void **buf,
+                                  FAR unsigned int *prio,
+                                  FAR const struct timespec *abstime)
+{
+  return file_mq_timedreceive_loan_internal(mq, buf, prio, abstime, -1);
+}
+
+/****************************************************************************
+ * Name: file_mq_tickreceive_loan
+ *
+ * Description:
+ *   This function behaves like file_mq_timedreceive_loan(), except that
+ *   the ceiling on the time for which the call will block is relative and
+ *   given in clock ticks.
+ *
+ * Input Parameters:
+ *   mq      - Message Queue Descriptor
+ *   buf     - The location to return the message buffer
+ *   prio    - If not NULL, the location to store message priority.
+ *   ticks   - Ticks to wait from the start time until the semaphore is
+ *             posted.
+ *
+ * Returned Value:
+ *   On success, the length of the selected message in bytes is returned.
+ *   A negated errno value is returned on failure (see
+ *   file_mq_timedreceive() for the list of valid values).
+ *
+ ****************************************************************************/
+
+ssize_t file_mq_tickreceive_loan(FAR struct file *mq, FAR void **buf,
+                                 FAR unsigned int *prio, sclock_t ticks)
+{
+  return file_mq_timedreceive_loan_internal(mq, buf, prio, NULL, ticks);
+}
+
+#endif /* CONFIG_MQ_ZEROCOPY */
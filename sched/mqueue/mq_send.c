@@ -36,6 +36,7 @@
 #include <nuttx/arch.h>
 #include <nuttx/cancelpt.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/nuttx.h>
 #include <nuttx/spinlock.h>
 #include <nuttx/irq.h>
 
@@ -239,6 +240,84 @@ static void nxmq_add_queue(FAR struct mqueue_inode_s *msgq,
     }
 }
 
+/****************************************************************************
+ * Name: nxmq_do_send
+ *
+ * Description:
+ *   This is internal, common logic shared by the copying and the loan
+ *   variants of [nx]mq_send.  It waits for the message queue to become
+ *   non-full if necessary, then queues the prepared message (mqmsg) in
+ *   priority order and notifies any waiting receivers.
+ *
+ * Input Parameters:
+ *   mq      - Message queue descriptor
+ *   mqmsg   - The message to queue, msglen must already be set
+ *   prio    - The priority of the message
+ *   abstime - the absolute time to wait until a timeout is declared
+ *   ticks   - Ticks to wait from the start time until the semaphore is
+ *             posted.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  A negated errno value is returned
+ *   on failure, the message is then still owned by the caller.
+ *
+ ****************************************************************************/
+
+static int nxmq_do_send(FAR struct file *mq, FAR struct mqueue_msg_s *mqmsg,
+                        unsigned int prio, FAR const struct timespec *abstime,
+                        sclock_t ticks)
+{
+  FAR struct mqueue_inode_s *msgq = mq->f_inode->i_private;
+  irqstate_t flags;
+  int ret = OK;
+
+  mqmsg->priority = prio;
+
+  /* Disable interruption */
+
+  flags = enter_critical_section();
+
+  if (msgq->nmsgs >= msgq->maxmsgs)
+    {
+      /* Verify that the message is full and we can't wait */
+
+      if ((up_interrupt_context() || (mq->f_oflags & O_NONBLOCK) != 0))
+        {
+          ret = -EAGAIN;
+          goto out;
+        }
+
+      /* The message queue is full.  We will need to wait for the message
+       * queue to become non-full.
+       */
+
+      ret = nxmq_wait_send(msgq, abstime, ticks);
+      if (ret < 0)
+        {
+          goto out;
+        }
+    }
+
+  /* Add the message to the message queue */
+
+  nxmq_add_queue(msgq, mqmsg, prio);
+
+  /* Increment the count of messages in the queue */
+
+  if (msgq->nmsgs++ == 0)
+    {
+      nxmq_pollnotify(msgq, POLLIN);
+    }
+
+  /* Notify any tasks that are waiting for a message to become available */
+
+  nxmq_notify_send(msgq);
+
+out:
+  leave_critical_section(flags);
+  return ret;
+}
+
 /****************************************************************************
  * Name: file_mq_timedsend_internal
  *
@@ -277,9 +356,7 @@ int file_mq_timedsend_internal(FAR struct file *mq, FAR const char *msg,
                                FAR const struct timespec *abstime,
                                sclock_t ticks)
 {
-  FAR struct mqueue_inode_s *msgq;
   FAR struct mqueue_msg_s *mqmsg;
-  irqstate_t flags;
   int ret = 0;
 
   /* Verify the input parameters */
@@ -304,8 +381,6 @@ int file_mq_timedsend_internal(FAR struct file *mq, FAR const char *msg,
     }
 #endif
 
-  msgq = mq->f_inode->i_private;
-
   /* Pre-allocate a message structure */
 
   mqmsg = nxmq_alloc_msg(msglen);
@@ -315,59 +390,71 @@ int file_mq_timedsend_internal(FAR struct file *mq, FAR const char *msg,
     }
 
   memcpy(mqmsg->mail, msg, msglen);
-  mqmsg->priority = prio;
-  mqmsg->msglen   = msglen;
-
-  /* Disable interruption */
+  mqmsg->msglen = msglen;
 
-  flags = enter_critical_section();
-
-  if (msgq->nmsgs >= msgq->maxmsgs)
+  ret = nxmq_do_send(mq, mqmsg, prio, abstime, ticks);
+  if (ret < 0)
     {
-      /* Verify that the message is full and we can't wait */
-
-      if ((up_interrupt_context() || (mq->f_oflags & O_NONBLOCK) != 0))
-        {
-          ret = -EAGAIN;
-          goto out;
-        }
-
-      /* The message queue is full.  We will need to wait for the message
-       * queue to become non-full.
-       */
-
-      ret = nxmq_wait_send(msgq, abstime, ticks);
-      if (ret < 0)
-        {
-          goto out;
-        }
+      nxmq_free_msg(mqmsg);
     }
 
-  /* Add the message to the message queue */
+  return ret;
+}
 
-  nxmq_add_queue(msgq, mqmsg, prio);
+/****************************************************************************
+ * Name: file_mq_timedsend_loan_internal
+ *
+ * Description:
+ *   This is an internal function of file_mq_timedsend_loan()/
+ *   file_mq_ticksend_loan(), please refer to the detailed description for
+ *   more information.
+ *
+ ****************************************************************************/
 
-  /* Increment the count of messages in the queue */
+#ifdef CONFIG_MQ_ZEROCOPY
+static
+int file_mq_timedsend_loan_internal(FAR struct file *mq, FAR void *buf,
+                                    size_t msglen, unsigned int prio,
+                                    FAR const struct timespec *abstime,
+                                    sclock_t ticks)
+{
+  FAR struct mqueue_msg_s *mqmsg;
+  int ret = 0;
 
-  if (msgq->nmsgs++ == 0)
+  /* Verify the input parameters */
+
+  if (abstime && (abstime->tv_nsec < 0 || abstime->tv_nsec >= 1000000000))
     {
-      nxmq_pollnotify(msgq, POLLIN);
+      return -EINVAL;
     }
 
-  /* Notify any tasks that are waiting for a message to become available */
+  if (mq == NULL || buf == NULL)
+    {
+      return -EINVAL;
+    }
 
-  nxmq_notify_send(msgq);
+#ifdef CONFIG_DEBUG_FEATURES
+  ret = nxmq_verify_send(mq, buf, msglen, prio);
+  if (ret < 0)
+    {
+      return ret;
+    }
+#endif
 
-out:
-  leave_critical_section(flags);
+  /* The message may only shrink, the buffer was sized by file_mq_loan()
+   * or by the message it was received with.
+   */
 
-  if (ret < 0)
+  mqmsg = container_of(buf, struct mqueue_msg_s, mail);
+  if (msglen > mqmsg->msglen)
     {
-      nxmq_free_msg(mqmsg);
+      return -EMSGSIZE;
     }
 
-  return ret;
+  mqmsg->msglen = msglen;
+  return nxmq_do_send(mq, mqmsg, prio, abstime, ticks);
 }
+#endif
 
 /****************************************************************************
  * Public Functions
@@ -744,3 +831,121 @@ int mq_send(mqd_t mqdes, FAR const char *msg, size_t msglen,
   leave_cancellation_point();
   return ret;
 }
+
+#ifdef CONFIG_MQ_ZEROCOPY
+
+/****************************************************************************
+ * Name: file_mq_loan
+ *
+ * Description:
+ *   Borrow a message buffer of at least 'msglen' bytes from the message
+ *   pool of the system.  The caller fills the buffer in place and then
+ *   passes it to file_mq_timedsend_loan()/file_mq_ticksend_loan(), which
+ *   queue the buffer itself instead of a copy.  A buffer that is not sent
+ *   must be given back with file_mq_return().
+ *
+ * Input Parameters:
+ *   mq     - Message queue descriptor the buffer will be sent to
+ *   msglen - The maximum length of the message in bytes
+ *   buf    - The location to return the buffer
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  A negated errno value is returned
+ *   on failure:
+ *
+ *   EINVAL   Either buf or mq is NULL.
+ *   EMSGSIZE 'msglen' was greater than the maxmsgsize attribute of the
+ *            message queue.
+ *   ENOMEM   No message buffer is available.
+ *
+ ****************************************************************************/
+
+int file_mq_loan(FAR struct file *mq, size_t msglen, FAR void **buf)
+{
+  FAR struct mqueue_inode_s *msgq;
+  FAR struct mqueue_msg_s *mqmsg;
+
+  if (mq == NULL || mq->f_inode == NULL || buf == NULL)
+    {
+      return -EINVAL;
+    }
+
+  msgq = mq->f_inode->i_private;
+  if (msglen > (size_t)msgq->maxmsgsize)
+    {
+      return -EMSGSIZE;
+    }
+
+  mqmsg = nxmq_alloc_msg(msglen);
+  if (mqmsg == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  mqmsg->msglen = msglen;
+  *buf = mqmsg->mail;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: file_mq_timedsend_loan
+ *
+ * Description:
+ *   This function behaves like file_mq_timedsend(), except that the
+ *   message is the buffer 'buf' itself, as returned by file_mq_loan() or
+ *   file_mq_timedreceive_loan().  The ownership of the buffer passes to
+ *   the message queue on success; on failure the caller still owns it and
+ *   may retry or give it back with file_mq_return().
+ *
+ * Input Parameters:
+ *   mq      - Message queue descriptor
+ *   buf     - The loaned message buffer
+ *   msglen  - The length of the message in bytes, must not exceed the
+ *             length the buffer was loaned or received with.
+ *   prio    - The priority of the message
+ *   abstime - the absolute time to wait until a timeout is declared
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  A negated errno value is returned
+ *   on failure (see file_mq_timedsend() for the list of valid values).
+ *
+ ****************************************************************************/
+
+int file_mq_timedsend_loan(FAR struct file *mq, FAR void *buf,
+                           size_t msglen, unsigned int prio,
+                           FAR const struct timespec *abstime)
+{
+  return file_mq_timedsend_loan_internal(mq, buf, msglen, prio,
+                                         abstime, -1);
+}
+
+/****************************************************************************
+ * Name: file_mq_ticksend_loan
+ *
+ * Description:
+ *   This function behaves like file_mq_timedsend_loan(), except that the
+ *   ceiling on the time for which the call will block is relative and
+ *   given in clock ticks.
+ *
+ * Input Parameters:
+ *   mq      - Message queue descriptor
+ *   buf     - The loaned message buffer
+ *   msglen  - The length of the message in bytes
+ *   prio    - The priority of the message
+ *   ticks   - Ticks to wait from the start time until the semaphore is
+ *             posted.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  A negated errno value is returned
+ *   on failure (see file_mq_timedsend() for the list of valid values).
+ *
+ ****************************************************************************/
+
+int file_mq_ticksend_loan(FAR struct file *mq, FAR void *buf,
+                          size_t msglen, unsigned int prio, sclock_t ticks)
+{
+  return file_mq_timedsend_loan_internal(mq, buf, msglen, prio,
+                                         NULL, ticks);
+}
+
+#endif /* CONFIG_MQ_ZEROCOPY */
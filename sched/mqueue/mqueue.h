@@ -75,7 +75,11 @@ struct mqueue_msg_s
 #else
   uint16_t msglen;         /* Message data length */
 #endif
+#ifdef CONFIG_MQ_ZEROCOPY
+  char mail[1] aligned_data(sizeof(FAR void *)); /* Message data */
+#else
   char mail[1];            /* Message data */
+#endif
 };
 
 /****************************************************************************
@@ -185,6 +185,10 @@ extern dq_queue_t g_readytorun;
  *    pthread_attr_setaffinity(), or
  *  - Temporarily through scheduling logic when a previously unassigned task
  *    is made to run.
+ *
+ * If CONFIG_SCHED_READYTORUN_BITMAP is selected, the ready-to-run tasks are
+ * held in per-CPU priority bitmap run queues (see sched_runqueue.c) and
+ * g_readytorun stays empty.
  */
 
 extern FAR struct tcb_s *g_assignedtasks[CONFIG_SMP_NCPUS];
@@ -407,6 +411,30 @@ void nxsched_process_delivered(int cpu);
 #  define nxsched_select_cpu(a)     (0)
 #endif
 
+/* SMP ready-to-run queue operations.  These manage the tasks that are
+ * ready-to-run but not running.  A queued TCB is accounted to the run
+ * queue of tcb->cpu at its current sched_priority, so neither may change
+ * while the TCB is queued.
+ *
+ * nxsched_runq_pick() returns the highest priority queued task that may run
+ * on 'cpu' and has a priority strictly greater than 'sched_priority', or
+ * NULL.  The task is not removed from the queue.
+ */
+
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+void nxsched_runq_add(FAR struct tcb_s *tcb);
+void nxsched_runq_remove(FAR struct tcb_s *tcb);
+FAR struct tcb_s *nxsched_runq_pick(int cpu, int sched_priority);
+#  define nxsched_runq_peek(cpu)    nxsched_runq_pick(cpu, 0)
+#elif defined(CONFIG_SMP)
+#  define nxsched_runq_add(tcb) \
+     nxsched_add_prioritized(tcb, list_readytorun())
+#  define nxsched_runq_remove(tcb) \
+     dq_rem((FAR dq_entry_t *)(tcb), list_readytorun())
+#  define nxsched_runq_peek(cpu) \
+     ((FAR struct tcb_s *)dq_peek(list_readytorun()))
+#endif
+
 #define nxsched_islocked_tcb(tcb)   ((tcb)->lockcount > 0)
 
 /* CPU load measurement support */
@@ -439,6 +467,11 @@ void nxsched_critmon_csection(FAR struct tcb_s *tcb, bool state,
                               FAR void *caller);
 #endif
 
+#if CONFIG_SCHED_CRITMONITOR_CSECTION_SITES > 0
+void nxsched_critmon_cssite(FAR void *caller, bool contended,
+                            clock_t wait);
+#endif
+
 /* TCB operations */
 
 bool nxsched_verify_tcb(FAR struct tcb_s *tcb);
@@ -534,6 +567,33 @@ static inline_function bool nxsched_add_prioritized(FAR struct tcb_s *tcb,
 
 #  ifdef CONFIG_SMP
 
+#    ifndef CONFIG_SCHED_READYTORUN_BITMAP
+static inline_function FAR struct tcb_s *
+nxsched_runq_pick(int cpu, int sched_priority)
+{
+  FAR struct tcb_s *btcb;
+
+  for (btcb = (FAR struct tcb_s *)dq_peek(list_readytorun());
+       btcb && btcb->sched_priority > sched_priority;
+       btcb = btcb->flink)
+    {
+      /* Check if the task found in ready-to-run list is allowed to run on
+       * this CPU. TCB_FLAG_CPU_LOCKED may be used to override affinity. If
+       * the flag is set, assume that btcb->cpu is valid, and it is the only
+       * CPU on which the btcb can run.
+       */
+
+      if (CPU_ISSET(cpu, &btcb->affinity) &&
+          ((btcb->flags & TCB_FLAG_CPU_LOCKED) == 0 || btcb->cpu == cpu))
+        {
+          return btcb;
+        }
+    }
+
+  return NULL;
+}
+#    endif
+
 /* Try to switch the head of the ready-to-run list to active on "target_cpu".
  * "cpu" is "this_cpu()", and passed only for optimization.
  */
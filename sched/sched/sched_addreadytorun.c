@@ -173,43 +173,31 @@ bool nxsched_switch_running(int cpu, bool switch_equal)
    * switch the current task to that one.
    */
 
-  for (btcb = (FAR struct tcb_s *)dq_peek(list_readytorun());
-       btcb && btcb->sched_priority > sched_priority;
-       btcb = btcb->flink)
+  btcb = nxsched_runq_pick(cpu, sched_priority);
+  if (btcb != NULL)
     {
-      /* Check if the task found in ready-to-run list is allowed to run on
-       * this CPU. TCB_FLAG_CPU_LOCKED may be used to override affinity. If
-       * the flag is set, assume that btcb->cpu is valid, and it is the only
-       * CPU on which the btcb can run.
-       */
-
-      if (CPU_ISSET(cpu, &btcb->affinity) &&
-          ((btcb->flags & TCB_FLAG_CPU_LOCKED) == 0 || btcb->cpu == cpu))
-        {
-          /* Found a task, remove it from ready-to-run list */
+      /* Found a task, remove it from ready-to-run list */
 
-          dq_rem((FAR struct dq_entry_s *)btcb, list_readytorun());
+      nxsched_runq_remove(btcb);
 
-          if (!is_idle_task(rtcb))
-            {
-              /* Put currently running task back to ready-to-run list */
+      if (!is_idle_task(rtcb))
+        {
+          /* Put currently running task back to ready-to-run list */
 
-              rtcb->task_state = TSTATE_TASK_READYTORUN;
-              nxsched_add_prioritized(rtcb, list_readytorun());
-            }
-          else
-            {
-              rtcb->task_state = TSTATE_TASK_ASSIGNED;
-            }
+          rtcb->task_state = TSTATE_TASK_READYTORUN;
+          nxsched_runq_add(rtcb);
+        }
+      else
+        {
+          rtcb->task_state = TSTATE_TASK_ASSIGNED;
+        }
 
-          g_assignedtasks[cpu] = btcb;
-          up_update_task(btcb);
+      g_assignedtasks[cpu] = btcb;
+      up_update_task(btcb);
 
-          btcb->cpu = cpu;
-          btcb->task_state = TSTATE_TASK_RUNNING;
-          ret = true;
-          break;
-        }
+      btcb->cpu = cpu;
+      btcb->task_state = TSTATE_TASK_RUNNING;
+      ret = true;
     }
 
   return ret;
@@ -262,11 +250,12 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
    */
 
   btcb->task_state = TSTATE_TASK_READYTORUN;
-  nxsched_add_prioritized(btcb, list_readytorun());
 
   /* In some cases, such as setaffinity, cpu need to be used. */
 
   btcb->cpu = target_cpu;
+  nxsched_runq_add(btcb);
+
   if (tcb->sched_priority < btcb->sched_priority)
     {
       doswitch = nxsched_deliver_task(this_cpu(), target_cpu,
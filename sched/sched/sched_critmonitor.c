@@ -129,6 +129,12 @@ clock_t g_busywait_max[CONFIG_SMP_NCPUS];
 clock_t g_busywait_total[CONFIG_SMP_NCPUS];
 #endif
 
+/* Use of the global critical section by call site */
+
+#if CONFIG_SCHED_CRITMONITOR_CSECTION_SITES > 0
+struct critmon_site_s g_crit_sites[CONFIG_SCHED_CRITMONITOR_CSECTION_SITES];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -182,6 +188,55 @@ static void nxsched_critmon_cpuload(FAR struct tcb_s *tcb, clock_t current,
 }
 #endif
 
+/****************************************************************************
+ * Name: nxsched_critmon_site
+ *
+ * Description:
+ *   Find the statistics of a critical section call site, allocating a new
+ *   entry in the open addressed table for a site seen for the first time.
+ *
+ * Input Parameters:
+ *   caller - The address of the caller of enter_critical_section().
+ *
+ * Returned Value:
+ *   The site entry, or NULL if the table is full.
+ *
+ * Assumptions:
+ *   Called within the critical section, which serializes the table.
+ *
+ ****************************************************************************/
+
+#if CONFIG_SCHED_CRITMONITOR_CSECTION_SITES > 0
+static FAR struct critmon_site_s *nxsched_critmon_site(FAR void *caller)
+{
+  FAR struct critmon_site_s *site;
+  int index;
+  int i;
+
+  index = ((uintptr_t)caller >> 2) % CONFIG_SCHED_CRITMONITOR_CSECTION_SITES;
+  for (i = 0; i < CONFIG_SCHED_CRITMONITOR_CSECTION_SITES; i++)
+    {
+      site = &g_crit_sites[index];
+      if (site->caller == caller)
+        {
+          return site;
+        }
+      else if (site->caller == NULL)
+        {
+          site->caller = caller;
+          return site;
+        }
+
+      if (++index >= CONFIG_SCHED_CRITMONITOR_CSECTION_SITES)
+        {
+          index = 0;
+        }
+    }
+
+  return NULL;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -260,6 +315,9 @@ void nxsched_critmon_preemption(FAR struct tcb_s *tcb, bool state,
 void nxsched_critmon_csection(FAR struct tcb_s *tcb, bool state,
                               FAR void *caller)
 {
+#if CONFIG_SCHED_CRITMONITOR_CSECTION_SITES > 0
+  FAR struct critmon_site_s *site;
+#endif
   clock_t current = perf_gettime();
 
   /* Are we entering or leaving the critical section? */
@@ -291,10 +349,59 @@ void nxsched_critmon_csection(FAR struct tcb_s *tcb, bool state,
         {
           g_crit_max[cpu] = elapsed;
         }
+
+#if CONFIG_SCHED_CRITMONITOR_CSECTION_SITES > 0
+      /* Charge the holding time to the site that entered the section */
+
+      site = nxsched_critmon_site(tcb->crit_caller);
+      if (site != NULL)
+        {
+          site->hold += elapsed;
+          if (elapsed > site->hold_max)
+            {
+              site->hold_max = elapsed;
+            }
+        }
+#endif
     }
 }
 #endif /* CONFIG_SCHED_CRITMONITOR_MAXTIME_CSECTION >= 0 */
 
+/****************************************************************************
+ * Name: nxsched_critmon_cssite
+ *
+ * Description:
+ *   Called when a thread has entered the critical section, to account the
+ *   entry and the time spent waiting for the global lock to its call site.
+ *
+ * Input Parameters:
+ *   caller    - The address of the caller of enter_critical_section().
+ *   contended - True if another CPU held the lock when it was requested.
+ *   wait      - The time spent acquiring the lock.
+ *
+ * Assumptions:
+ *   - Called within a critical section.
+ *   - Never called from an interrupt handler
+ *
+ ****************************************************************************/
+
+#if CONFIG_SCHED_CRITMONITOR_CSECTION_SITES > 0
+void nxsched_critmon_cssite(FAR void *caller, bool contended, clock_t wait)
+{
+  FAR struct critmon_site_s *site = nxsched_critmon_site(caller);
+
+  if (site != NULL)
+    {
+      site->count++;
+      site->wait += wait;
+      if (contended)
+        {
+          site->contended++;
+        }
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: nxsched_critmon_busywait
  *
@@ -180,13 +180,9 @@ bool nxsched_remove_readytorun(FAR struct tcb_s *tcb)
     }
   else
     {
-      FAR dq_queue_t *tasklist;
-
-      tasklist = TLIST_HEAD(tcb, tcb->cpu);
-
       /* The task is not running.  Just remove its TCB from the task list */
 
-      dq_rem((FAR dq_entry_t *)tcb, tasklist);
+      nxsched_runq_remove(tcb);
 
       /* Since the TCB is no longer in any list, it is now invalid */
 
@@ -0,0 +1,289 @@
+/****************************************************************************
+ * sched/sched/sched_runqueue.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <strings.h>
+#include <assert.h>
+
+#include <nuttx/queue.h>
+
+#include "sched/sched.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* One FIFO list per priority level, one bitmap bit per list */
+
+#define RUNQ_NLEVELS             (SCHED_PRIORITY_MAX + 1)
+#define RUNQ_NWORDS              (RUNQ_NLEVELS / 32)
+
+#define RUNQ_WORD(p)             ((p) >> 5)
+#define RUNQ_BIT(p)              ((uint32_t)1 << ((p) & 31))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This is the ready-to-run queue of one CPU.  The two level bitmap allows
+ * the highest non-empty priority level to be found with two fls()
+ * operations, independent of the number of queued tasks.
+ */
+
+struct runqueue_s
+{
+  uint32_t   summary;               /* Bit n set: bitmap[n] != 0 */
+  uint32_t   bitmap[RUNQ_NWORDS];   /* Bit p set: queue[p] is not empty */
+  dq_queue_t queue[RUNQ_NLEVELS];   /* Ready-to-run tasks, FIFO per level */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct runqueue_s g_runqueue[CONFIG_SMP_NCPUS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_runq_highest
+ *
+ * Description:
+ *   Return the highest priority level holding at least one task, or -1 if
+ *   the run queue is empty.
+ *
+ ****************************************************************************/
+
+static inline_function int nxsched_runq_highest(FAR struct runqueue_s *rq)
+{
+  int word;
+
+  if (rq->summary == 0)
+    {
+      return -1;
+    }
+
+  word = fls(rq->summary) - 1;
+  return (word << 5) + fls(rq->bitmap[word]) - 1;
+}
+
+/****************************************************************************
+ * Name: nxsched_runq_below
+ *
+ * Description:
+ *   Return the highest priority level below 'priority' holding at least
+ *   one task, or -1 if there is none.
+ *
+ ****************************************************************************/
+
+static inline_function int nxsched_runq_below(FAR struct runqueue_s *rq,
+                                              int priority)
+{
+  int word = RUNQ_WORD(priority);
+  uint32_t bits;
+
+  bits = rq->bitmap[word] & (RUNQ_BIT(priority) - 1);
+  if (bits == 0)
+    {
+      bits = rq->summary & (RUNQ_BIT(word) - 1);
+      if (bits == 0)
+        {
+          return -1;
+        }
+
+      word = fls(bits) - 1;
+      bits = rq->bitmap[word];
+    }
+
+  return (word << 5) + fls(bits) - 1;
+}
+
+/****************************************************************************
+ * Name: nxsched_runq_migratable
+ *
+ * Description:
+ *   Return the first task in priority and FIFO order of another CPU's run
+ *   queue that has a priority strictly greater than 'sched_priority' and
+ *   may migrate to 'cpu', or NULL.  Tasks that are locked to their CPU or
+ *   whose affinity excludes 'cpu' are skipped, so they do not hide the
+ *   tasks queued behind them.
+ *
+ ****************************************************************************/
+
+static FAR struct tcb_s *nxsched_runq_migratable(FAR struct runqueue_s *rq,
+                                                 int cpu,
+                                                 int sched_priority)
+{
+  FAR struct tcb_s *tcb;
+  int priority;
+
+  for (priority = nxsched_runq_highest(rq);
+       priority > sched_priority;
+       priority = nxsched_runq_below(rq, priority))
+    {
+      for (tcb = (FAR struct tcb_s *)dq_peek(&rq->queue[priority]);
+           tcb != NULL; tcb = tcb->flink)
+        {
+          if (CPU_ISSET(cpu, &tcb->affinity) &&
+              (tcb->flags & TCB_FLAG_CPU_LOCKED) == 0)
+            {
+              return tcb;
+            }
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_runq_add
+ *
+ * Description:
+ *   Append a TCB to the tail of its priority level in the run queue of
+ *   tcb->cpu.  Tasks of equal priority are therefore served in FIFO order,
+ *   as with the prioritized g_readytorun list.
+ *
+ * Input Parameters:
+ *   tcb - The TCB to be queued.  tcb->cpu must hold the target CPU.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The caller has established a critical section.
+ *
+ ****************************************************************************/
+
+void nxsched_runq_add(FAR struct tcb_s *tcb)
+{
+  FAR struct runqueue_s *rq = &g_runqueue[tcb->cpu];
+  int priority = tcb->sched_priority;
+
+  DEBUGASSERT(priority >= SCHED_PRIORITY_MIN && !is_idle_task(tcb));
+
+  dq_addlast((FAR dq_entry_t *)tcb, &rq->queue[priority]);
+  rq->bitmap[RUNQ_WORD(priority)] |= RUNQ_BIT(priority);
+  rq->summary |= RUNQ_BIT(RUNQ_WORD(priority));
+}
+
+/****************************************************************************
+ * Name: nxsched_runq_remove
+ *
+ * Description:
+ *   Remove a TCB from the run queue of tcb->cpu.
+ *
+ * Input Parameters:
+ *   tcb - The queued TCB to be removed.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The caller has established a critical section.
+ *
+ ****************************************************************************/
+
+void nxsched_runq_remove(FAR struct tcb_s *tcb)
+{
+  FAR struct runqueue_s *rq = &g_runqueue[tcb->cpu];
+  int priority = tcb->sched_priority;
+
+  dq_rem((FAR dq_entry_t *)tcb, &rq->queue[priority]);
+  if (dq_empty(&rq->queue[priority]))
+    {
+      rq->bitmap[RUNQ_WORD(priority)] &= ~RUNQ_BIT(priority);
+      if (rq->bitmap[RUNQ_WORD(priority)] == 0)
+        {
+          rq->summary &= ~RUNQ_BIT(RUNQ_WORD(priority));
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_runq_pick
+ *
+ * Description:
+ *   Select the next task for 'cpu'.  The head of the highest level of the
+ *   CPU's own run queue is always eligible because tasks are only queued
+ *   on a CPU in their affinity set.  The highest priority task of every
+ *   other run queue that is allowed to migrate to 'cpu' and has a strictly
+ *   higher priority is also considered and pulled over, even if it is
+ *   queued behind tasks pinned to that CPU.  This balances the run queues
+ *   whenever a CPU looks for work.  Usually the first task checked on each
+ *   CPU qualifies or has a too low priority; only tasks pinned to their
+ *   CPU have to be skipped.
+ *
+ * Input Parameters:
+ *   cpu            - The CPU that will run the selected task
+ *   sched_priority - Only tasks with a higher priority are returned
+ *
+ * Returned Value:
+ *   The selected TCB (still queued) or NULL.
+ *
+ * Assumptions:
+ *   The caller has established a critical section.
+ *
+ ****************************************************************************/
+
+FAR struct tcb_s *nxsched_runq_pick(int cpu, int sched_priority)
+{
+  FAR struct tcb_s *btcb = NULL;
+  FAR struct tcb_s *tcb;
+  int priority;
+  int i;
+
+  priority = nxsched_runq_highest(&g_runqueue[cpu]);
+  if (priority > sched_priority)
+    {
+      btcb = (FAR struct tcb_s *)dq_peek(&g_runqueue[cpu].queue[priority]);
+      sched_priority = priority;
+    }
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      if (i == cpu)
+        {
+          continue;
+        }
+
+      tcb = nxsched_runq_migratable(&g_runqueue[i], cpu, sched_priority);
+      if (tcb != NULL)
+        {
+          btcb = tcb;
+          sched_priority = tcb->sched_priority;
+        }
+    }
+
+  return btcb;
+}
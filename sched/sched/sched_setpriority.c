@@ -71,7 +71,7 @@ static inline void nxsched_running_setpriority(FAR struct tcb_s *tcb,
   /* Get the TCB of the next highest priority, ready to run task */
 
 #ifdef CONFIG_SMP
-  nxttcb = (FAR struct tcb_s *)dq_peek(list_readytorun());
+  nxttcb = nxsched_runq_peek(tcb->cpu);
 #else
   nxttcb = tcb->flink;
 #endif
@@ -169,7 +169,7 @@ static void nxsched_readytorun_setpriority(FAR struct tcb_s *tcb,
   rtcb = this_task();
 
 #ifdef CONFIG_SMP
-  dq_rem((FAR struct dq_entry_s *)tcb, list_readytorun());
+  nxsched_runq_remove(tcb);
   tcb->sched_priority = sched_priority;
   if (nxsched_add_readytorun(tcb))
 #else
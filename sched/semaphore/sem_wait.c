@@ -41,6 +41,147 @@
 #include "sched/sched.h"
 #include "semaphore/semaphore.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Check if a task may spin on the mutex before blocking.  Mutexes with
+ * priority protection never spin, the ceiling is applied in the slow path.
+ */
+
+#if defined(CONFIG_SEM_ADAPTIVE_SPIN_ALL)
+#  define NXSEM_MSPIN(s) (((s)->flags & SEM_PRIO_MASK) != SEM_PRIO_PROTECT)
+#elif defined(CONFIG_SEM_ADAPTIVE_SPIN)
+#  define NXSEM_MSPIN(s) (((s)->flags & SEM_TYPE_SPIN) != 0 && \
+                          ((s)->flags & SEM_PRIO_MASK) != SEM_PRIO_PROTECT)
+#endif
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef CONFIG_SEM_ADAPTIVE_SPIN_STATS
+struct nxsem_spinstat_s g_nxsem_spinstat[CONFIG_SMP_NCPUS];
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsem_mholder_running
+ *
+ * Description:
+ *   Check if the mutex holder is the running task of another CPU.  The
+ *   result is only a hint, the holder may be switched out at any time.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SEM_ADAPTIVE_SPIN
+static bool nxsem_mholder_running(int32_t holder)
+{
+  int me = this_cpu();
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      FAR struct tcb_s *tcb = g_running_tasks[cpu];
+
+      if (cpu != me && tcb != NULL && tcb->pid == holder)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: nxsem_mspin
+ *
+ * Description:
+ *   Busy wait on a locked mutex as long as its holder is running on
+ *   another CPU, but not longer than CONFIG_SEM_ADAPTIVE_SPIN_NSEC.  The
+ *   mutex is taken the same way as in the fast path of nxsem_wait().
+ *
+ * Input Parameters:
+ *   sem  - The mutex to spin on
+ *   rtcb - The TCB of the calling task
+ *
+ * Returned Value:
+ *   true if the mutex was acquired; false if the caller has to block.
+ *
+ ****************************************************************************/
+
+static bool nxsem_mspin(FAR sem_t *sem, FAR struct tcb_s *rtcb)
+{
+  FAR atomic_t *mholder = NXSEM_MHOLDER(sem);
+  clock_t start = perf_gettime();
+  clock_t limit;
+  bool acquired = false;
+  int32_t holder;
+#ifdef CONFIG_SEM_ADAPTIVE_SPIN_STATS
+  FAR struct nxsem_spinstat_s *stat;
+#endif
+
+  limit = (clock_t)((uint64_t)CONFIG_SEM_ADAPTIVE_SPIN_NSEC *
+                    perf_getfreq() / NSEC_PER_SEC);
+
+  for (; ; )
+    {
+      holder = atomic_read(mholder);
+      if (holder == NXSEM_NO_MHOLDER)
+        {
+          if (atomic_try_cmpxchg_acquire(mholder, &holder, rtcb->pid))
+            {
+              acquired = true;
+              break;
+            }
+
+          continue;
+        }
+
+      /* Give up if other tasks already block on the mutex (they are
+       * served first on release), if the mutex was reset, if the holder
+       * is not running or if the time is up.
+       */
+
+      if (NXSEM_MBLOCKING(holder) || !NXSEM_MACQUIRED(holder) ||
+          !nxsem_mholder_running(holder) ||
+          perf_gettime() - start >= limit)
+        {
+          break;
+        }
+
+      /* The release is a plain store that signals no event, so only hint
+       * the CPU that this is a busy wait instead of using UP_WFE().
+       */
+
+      UP_CPU_RELAX();
+    }
+
+#ifdef CONFIG_SEM_ADAPTIVE_SPIN_STATS
+  /* The task may have migrated meanwhile, so the counters of a CPU are
+   * approximate.
+   */
+
+  stat = &g_nxsem_spinstat[this_cpu()];
+  stat->spins++;
+  stat->time += perf_gettime() - start;
+  if (acquired)
+    {
+      stat->acquired++;
+    }
+  else
+    {
+      stat->blocked++;
+    }
+#endif
+
+  return acquired;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -84,6 +225,19 @@ int nxsem_wait_slow(FAR sem_t *sem)
   FAR struct tcb_s *htcb = NULL;
   bool mutex = NXSEM_IS_MUTEX(sem);
 
+#ifdef CONFIG_SEM_ADAPTIVE_SPIN
+  /* If the holder of the mutex runs on another CPU, it may release the
+   * mutex soon.  Spin for a while before paying for a context switch, but
+   * not if we are in a critical section and would stall the other CPUs.
+   */
+
+  if (mutex && NXSEM_MSPIN(sem) && rtcb->irqcount == 0 &&
+      nxsem_mspin(sem, rtcb))
+    {
+      return OK;
+    }
+#endif
+
   /* The following operations must be performed with interrupts
    * disabled because nxsem_post() may be called from an interrupt
    * handler.
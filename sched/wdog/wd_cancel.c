@@ -38,6 +38,37 @@
 #include "sched/sched.h"
 #include "wdog/wdog.h"
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_running_elsewhere
+ *
+ * Description:
+ *   Check if the callback of the watchdog is executing on another CPU.
+ *   Called with g_wdspinlock held.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+static bool wd_running_elsewhere(FAR struct wdog_s *wdog)
+{
+  int me = this_cpu();
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      if (cpu != me && g_wdrunning[cpu] == wdog)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -47,7 +78,9 @@
  *
  * Description:
  *   This function cancels a currently running watchdog timer. Watchdog
- *   timers may be canceled from the interrupt level.
+ *   timers may be canceled from the interrupt level.  If the callback of
+ *   the watchdog is executing on another CPU, wait for it to return, so
+ *   that the watchdog may be freed afterwards.
  *
  * Input Parameters:
  *   wdog - ID of the watchdog to cancel.
@@ -60,7 +93,9 @@
 
 int wd_cancel(FAR struct wdog_s *wdog)
 {
+#ifndef CONFIG_WDOG_TIMER_WHEEL
   FAR struct wdog_s *first;
+#endif
   irqstate_t         flags;
   int                  ret = -EINVAL;
 
@@ -70,12 +105,36 @@ int wd_cancel(FAR struct wdog_s *wdog)
        * cancellation is complete
        */
 
-      flags = enter_critical_section();
+      flags = spin_lock_irqsave(&g_wdspinlock);
+
+#ifdef CONFIG_SMP
+      /* If the callback is executing on another CPU, it may restart the
+       * watchdog.  The callback runs in the global critical section, so
+       * taking that waits until it has returned; then check again.
+       */
+
+      while (wd_running_elsewhere(wdog))
+        {
+          spin_unlock_irqrestore(&g_wdspinlock, flags);
+          flags = enter_critical_section();
+          leave_critical_section(flags);
+          flags = spin_lock_irqsave(&g_wdspinlock);
+        }
+#endif
 
       /* Make sure that the watchdog is valid and still active. */
 
       if (WDOG_ISACTIVE(wdog))
         {
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+          /* Remove the watchdog from its wheel slot.  The interval timer
+           * is left alone: if it was set for this watchdog it will find
+           * nothing to do and be programmed for the next one.
+           */
+
+          list_delete_fast(&wdog->node);
+          wdog->func = NULL;
+#else
           first = list_first_entry(&g_wdactivelist, struct wdog_s, node);
 
           /* Now, remove the watchdog from the timer queue */
@@ -102,11 +161,12 @@ int wd_cancel(FAR struct wdog_s *wdog)
                   wd_timer_cancel();
                 }
             }
+#endif
 
           ret = OK;
         }
 
-      leave_critical_section(flags);
+      spin_unlock_irqrestore(&g_wdspinlock, flags);
       sched_note_wdog(NOTE_WDOG_CANCEL, (FAR void *)wdog->func,
                       (FAR void *)(uintptr_t)wdog->expired);
     }
@@ -61,10 +61,10 @@ sclock_t wd_gettime(FAR struct wdog_s *wdog)
 
   if (wdog != NULL && WDOG_ISACTIVE(wdog))
     {
-      flags     = enter_critical_section();
+      flags     = spin_lock_irqsave(&g_wdspinlock);
       is_active = WDOG_ISACTIVE(wdog);
       expired   = wdog->expired;
-      leave_critical_section(flags);
+      spin_unlock_irqrestore(&g_wdspinlock, flags);
 
       if (is_active)
         {
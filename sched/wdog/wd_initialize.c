@@ -27,6 +27,8 @@
 #include <nuttx/config.h>
 
 #include <nuttx/list.h>
+#include <nuttx/clock.h>
+#include <nuttx/spinlock.h>
 
 #include "wdog/wdog.h"
 
@@ -34,17 +36,36 @@
  * Public Data
  ****************************************************************************/
 
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+/* All active watchdogs are hashed into this timing wheel */
+
+struct wdog_wheel_s g_wdwheel;
+#else
 /* The g_wdactivelist data structure is a singly linked list ordered by
  * watchdog expiration time. When watchdog timers expire,the functions on
  * this linked list are removed and the function is called.
  */
 
 struct list_node g_wdactivelist = LIST_INITIAL_VALUE(g_wdactivelist);
+#endif
 
 #ifdef CONFIG_HRTIMER
 struct hrtimer_s g_wdtimer;
 #endif
 
+/* This spinlock protects the active watchdogs and the timer state above,
+ * so that watchdog activity does not contend for the global critical
+ * section.
+ */
+
+spinlock_t g_wdspinlock = SP_UNLOCKED;
+
+#ifdef CONFIG_SMP
+/* The watchdog whose callback each CPU is executing, or NULL */
+
+FAR struct wdog_s *g_wdrunning[CONFIG_SMP_NCPUS];
+#endif
+
 #if defined(CONFIG_SCHED_TICKLESS) || defined(CONFIG_HRTIMER)
 bool g_wdtimernested;
 clock_t  g_wdexpired;
@@ -53,3 +74,36 @@ clock_t  g_wdexpired;
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
+
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+/****************************************************************************
+ * Name: wd_initialize
+ *
+ * Description:
+ *   Initialize the watchdog timing wheel.  Called once from nx_start()
+ *   after the system clock has been initialized.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void wd_initialize(void)
+{
+  int level;
+  int index;
+
+  for (level = 0; level < WDOG_WHEEL_LEVELS; level++)
+    {
+      for (index = 0; index < WDOG_WHEEL_SLOTS; index++)
+        {
+          list_initialize(&g_wdwheel.slot[level][index]);
+        }
+    }
+
+  g_wdwheel.curr = clock_systime_ticks();
+}
+#endif
@@ -112,12 +112,51 @@ static inline_function clock_t wd_expiration(clock_t ticks)
   wdparm_t           arg;
   clock_t     next_ticks = ticks;
 
+  /* The callbacks run in the global critical section, so it is taken
+   * before g_wdspinlock.
+   */
+
   flags = enter_critical_section();
+  spin_lock(&g_wdspinlock);
 
   wd_update_expire(ticks);
 
   wd_set_nested(true);
 
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+  /* Process all watchdogs that became ready to run at this time */
+
+  while ((wdog = wd_wheel_pop(ticks)) != NULL)
+    {
+      /* Indicate that the watchdog is no longer active. */
+
+      func = wdog->func;
+      arg  = wdog->arg;
+      wdog->func = NULL;
+
+      /* Execute the watchdog function.  The lock is dropped so that
+       * the callback may start or cancel watchdogs, but the critical
+       * section is kept: the callbacks rely on it and wd_cancel() uses
+       * it to wait for a callback running on another CPU.
+       */
+
+      up_setpicbase(wdog->picbase);
+      wd_set_running(wdog);
+      spin_unlock(&g_wdspinlock);
+
+      CALL_FUNC(func, arg);
+
+      spin_lock(&g_wdspinlock);
+      wd_set_running(NULL);
+    }
+
+#  if defined(CONFIG_SCHED_TICKLESS) || defined(CONFIG_HRTIMER)
+  /* Find the next expiration for the interval timer */
+
+  g_wdwheel.armed = wd_wheel_next(&next_ticks) && next_ticks != ticks;
+  g_wdwheel.next  = next_ticks;
+#  endif
+#else
   /* Process the watchdog at the head of the list as well as any
    * other watchdogs that became ready to run at this time
    */
@@ -146,11 +185,22 @@ static inline_function clock_t wd_expiration(clock_t ticks)
       arg  = wdog->arg;
       wdog->func = NULL;
 
-      /* Execute the watchdog function */
+      /* Execute the watchdog function.  The lock is dropped so that
+       * the callback may start or cancel watchdogs, but the critical
+       * section is kept: the callbacks rely on it and wd_cancel() uses
+       * it to wait for a callback running on another CPU.
+       */
 
       up_setpicbase(wdog->picbase);
+      wd_set_running(wdog);
+      spin_unlock(&g_wdspinlock);
+
       CALL_FUNC(func, arg);
+
+      spin_lock(&g_wdspinlock);
+      wd_set_running(NULL);
     }
+#endif
 
   wd_set_nested(false);
 
@@ -159,6 +209,7 @@ static inline_function clock_t wd_expiration(clock_t ticks)
       wd_timer_start(next_ticks, true);
     }
 
+  spin_unlock(&g_wdspinlock);
   leave_critical_section(flags);
 
   return next_ticks;
@@ -170,6 +221,8 @@ static inline_function clock_t wd_expiration(clock_t ticks)
  * Description:
  *   Insert the timer into the global list to ensure that
  *   the list is sorted in increasing order of expiration absolute time.
+ *   With CONFIG_WDOG_TIMER_WHEEL the timer is hashed into the timing wheel
+ *   instead.
  *
  * Input Parameters:
  *   wdog     - Watchdog ID
@@ -181,10 +234,39 @@ static inline_function clock_t wd_expiration(clock_t ticks)
  *   wdog and wdentry is not NULL.
  *
  * Returned Value:
- *   Whether the head of the watchdog list has changed.
+ *   Whether the head of the watchdog list has changed, i.e. whether the
+ *   interval timer has to be programmed for an earlier expiration.
  *
  ****************************************************************************/
 
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+static inline_function
+bool wd_insert(FAR struct wdog_s *wdog, clock_t expired,
+               wdentry_t wdentry, wdparm_t arg)
+{
+  wdog->func = wdentry;
+  up_getpicbase(&wdog->picbase);
+  wdog->arg = arg;
+  wdog->expired = expired;
+
+  wd_wheel_insert(wdog);
+
+#if defined(CONFIG_SCHED_TICKLESS) || defined(CONFIG_HRTIMER)
+  /* Canceled watchdogs never move the timer later, so the timer only
+   * needs to be touched when this watchdog expires before it.
+   */
+
+  if (!g_wdwheel.armed || !clock_compare(g_wdwheel.next, expired))
+    {
+      g_wdwheel.armed = true;
+      g_wdwheel.next  = expired;
+      return true;
+    }
+#endif
+
+  return false;
+}
+#else
 static inline_function
 bool wd_insert(FAR struct wdog_s *wdog, clock_t expired,
                wdentry_t wdentry, wdparm_t arg)
@@ -224,6 +306,7 @@ bool wd_insert(FAR struct wdog_s *wdog, clock_t expired,
 
   return head == curr;
 }
+#endif
 
 /****************************************************************************
  * Public Functions
@@ -278,10 +361,10 @@ int wd_start_abstick(FAR struct wdog_s *wdog, clock_t ticks,
     {
       /* NOTE:  There is a race condition here... the caller may receive
        * the watchdog between the time that wd_start_abstick is called and
-       * the critical section is established.
+       * the watchdog lock is taken.
        */
 
-      flags = enter_critical_section();
+      flags = spin_lock_irqsave(&g_wdspinlock);
 
       /* If the wdog is canceling, restarting the wdog is not allowed. */
 
@@ -292,7 +375,9 @@ int wd_start_abstick(FAR struct wdog_s *wdog, clock_t ticks,
 
       if (WDOG_ISACTIVE(wdog))
         {
+#ifndef CONFIG_WDOG_TIMER_WHEEL
           reassess |= list_is_head(&g_wdactivelist, &wdog->node);
+#endif
           list_delete_fast(&wdog->node);
         }
 
@@ -320,7 +405,7 @@ int wd_start_abstick(FAR struct wdog_s *wdog, clock_t ticks,
 
       wd_insert(wdog, ticks, wdentry, arg);
 #endif
-      leave_critical_section(flags);
+      spin_unlock_irqrestore(&g_wdspinlock, flags);
       sched_note_wdog(NOTE_WDOG_START, wdentry,
                       (FAR void *)(uintptr_t)ticks);
       ret = OK;
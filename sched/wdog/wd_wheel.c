@@ -0,0 +1,398 @@
+/****************************************************************************
+ * sched/wdog/wd_wheel.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <strings.h>
+#include <assert.h>
+
+#include <nuttx/list.h>
+#include <nuttx/wdog.h>
+
+#include "wdog/wdog.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if WDOG_WHEEL_LEVELS * WDOG_WHEEL_BITS >= 32 && !defined(CONFIG_SYSTEM_TIME64)
+#  error CONFIG_WDOG_TIMER_WHEEL_LEVELS too large for a 32-bit clock_t
+#endif
+
+/* Shift of the level 'l' slot index within a tick count */
+
+#define WHEEL_SHIFT(l)     ((l) * WDOG_WHEEL_BITS)
+
+/* Number of ticks covered by a whole level 'l' (one rotation) */
+
+#define WHEEL_RANGE(l)     ((clock_t)1 << WHEEL_SHIFT((l) + 1))
+
+/* Largest delay that can be hashed without clamping */
+
+#define WHEEL_MAX_DELTA    (WHEEL_RANGE(WDOG_WHEEL_LEVELS - 1) - 1)
+
+#define WHEEL_SLOT(t, l)   (((t) >> WHEEL_SHIFT(l)) & WDOG_WHEEL_MASK)
+#define WHEEL_BIT(s)       ((uint32_t)1 << (s))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_find
+ *
+ * Description:
+ *   Return the distance in slots from 'index' to the first slot at or
+ *   after 'index' (wrapping around) whose pending bit is set, or -1 if no
+ *   bit is set.
+ *
+ ****************************************************************************/
+
+static inline_function int wd_wheel_find(uint32_t pending, int index)
+{
+  uint32_t upper = pending & ~(WHEEL_BIT(index) - 1);
+
+  if (upper != 0)
+    {
+      return ffs(upper) - 1 - index;
+    }
+  else if (pending != 0)
+    {
+      return ffs(pending) - 1 + WDOG_WHEEL_SLOTS - index;
+    }
+
+  return -1;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_cascade
+ *
+ * Description:
+ *   Called when g_wdwheel.curr has just reached 'curr'.  For every upper
+ *   level whose slot range starts at 'curr', move the watchdogs of that
+ *   slot down to the lower levels.  Higher levels are handled first so
+ *   that watchdogs can move down several levels at once.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_cascade(clock_t curr)
+{
+  FAR struct list_node *slot;
+  FAR struct wdog_s *wdog;
+  int index;
+  int level;
+
+  for (level = WDOG_WHEEL_LEVELS - 1; level > 0; level--)
+    {
+      if ((curr & (((clock_t)1 << WHEEL_SHIFT(level)) - 1)) != 0)
+        {
+          continue;
+        }
+
+      index = WHEEL_SLOT(curr, level);
+      if ((g_wdwheel.pending[level] & WHEEL_BIT(index)) == 0)
+        {
+          continue;
+        }
+
+      g_wdwheel.pending[level] &= ~WHEEL_BIT(index);
+      slot = &g_wdwheel.slot[level][index];
+
+      while (!list_is_empty(slot))
+        {
+          wdog = list_first_entry(slot, struct wdog_s, node);
+          list_delete_fast(&wdog->node);
+          wd_wheel_insert(wdog);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: wd_wheel_nextstop
+ *
+ * Description:
+ *   Return the first tick after g_wdwheel.curr at which the wheel has
+ *   work to do: a level 0 slot to expire or an upper level slot to
+ *   cascade.  All ticks before it can be skipped.
+ *
+ * Returned Value:
+ *   True if such a tick exists, the tick is returned in 'stop'.
+ *
+ ****************************************************************************/
+
+static bool wd_wheel_nextstop(FAR clock_t *stop)
+{
+  clock_t curr = g_wdwheel.curr;
+  clock_t when;
+  bool found = false;
+  int distance;
+  int index;
+  int level;
+
+  for (level = 0; level < WDOG_WHEEL_LEVELS; level++)
+    {
+      /* The slot holding 'curr' at level 0 was expired by the caller and
+       * at upper levels it has already been cascaded (or belongs to the
+       * next rotation), so start the search just after it.
+       */
+
+      index    = WHEEL_SLOT(curr, level);
+      distance = wd_wheel_find(g_wdwheel.pending[level],
+                               (index + 1) & WDOG_WHEEL_MASK);
+      if (distance < 0)
+        {
+          continue;
+        }
+
+      when = ((curr >> WHEEL_SHIFT(level)) + distance + 1) <<
+             WHEEL_SHIFT(level);
+
+      if (!found || !clock_compare(*stop, when))
+        {
+          *stop = when;
+          found = true;
+        }
+    }
+
+  return found;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_insert
+ *
+ * Description:
+ *   Hash an initialized watchdog into the timing wheel according to
+ *   wdog->expired.
+ *
+ * Input Parameters:
+ *   wdog - The watchdog to be inserted
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with g_wdspinlock held.
+ *
+ ****************************************************************************/
+
+void wd_wheel_insert(FAR struct wdog_s *wdog)
+{
+  clock_t  curr  = g_wdwheel.curr;
+  sclock_t delta = (sclock_t)(wdog->expired - curr);
+  clock_t  when  = wdog->expired;
+  int      index;
+  int      level;
+
+  /* Already expired watchdogs are run with the tick being processed;
+   * watchdogs beyond the range of the wheel are parked at its far end
+   * and hashed again when their slot is cascaded.
+   */
+
+  if (delta < 0)
+    {
+      delta = 0;
+      when  = curr;
+    }
+  else if (delta > (sclock_t)WHEEL_MAX_DELTA)
+    {
+      delta = WHEEL_MAX_DELTA;
+      when  = curr + WHEEL_MAX_DELTA;
+    }
+
+  for (level = 0; level < WDOG_WHEEL_LEVELS - 1; level++)
+    {
+      if ((clock_t)delta < WHEEL_RANGE(level))
+        {
+          break;
+        }
+    }
+
+  index = WHEEL_SLOT(when, level);
+  list_add_tail(&g_wdwheel.slot[level][index], &wdog->node);
+  g_wdwheel.pending[level] |= WHEEL_BIT(index);
+}
+
+/****************************************************************************
+ * Name: wd_wheel_pop
+ *
+ * Description:
+ *   Advance the timing wheel up to 'ticks' and remove the next watchdog
+ *   that has expired.  All watchdogs expiring on the same tick share a
+ *   level 0 slot and are returned one after the other without searching.
+ *   A watchdog restarted with an expiration time that has already passed
+ *   is returned again in the same pass, like with the sorted list.
+ *
+ * Input Parameters:
+ *   ticks - Current time in clock ticks
+ *
+ * Returned Value:
+ *   The expired watchdog or NULL if no watchdog expires at or before
+ *   'ticks'.
+ *
+ * Assumptions:
+ *   Called with g_wdspinlock held.
+ *
+ ****************************************************************************/
+
+FAR struct wdog_s *wd_wheel_pop(clock_t ticks)
+{
+  FAR struct list_node *slot;
+  FAR struct wdog_s *wdog;
+  clock_t stop;
+  int index;
+
+  if (!clock_compare(g_wdwheel.curr, ticks))
+    {
+      return NULL;
+    }
+
+  for (; ; )
+    {
+      index = WHEEL_SLOT(g_wdwheel.curr, 0);
+      slot  = &g_wdwheel.slot[0][index];
+
+      if (!list_is_empty(slot))
+        {
+          wdog = list_first_entry(slot, struct wdog_s, node);
+          list_delete_fast(&wdog->node);
+          return wdog;
+        }
+
+      g_wdwheel.pending[0] &= ~WHEEL_BIT(index);
+
+      if (g_wdwheel.curr == ticks)
+        {
+          return NULL;
+        }
+
+      /* Skip directly to the next tick with something to do.  If that is
+       * past 'ticks', no slot is crossed on the way and 'curr' can simply
+       * be moved to 'ticks'.
+       */
+
+      if (!wd_wheel_nextstop(&stop) || !clock_compare(stop, ticks))
+        {
+          g_wdwheel.curr = ticks;
+          return NULL;
+        }
+
+      g_wdwheel.curr = stop;
+      wd_wheel_cascade(stop);
+    }
+}
+
+/****************************************************************************
+ * Name: wd_wheel_next
+ *
+ * Description:
+ *   Find the earliest expiration time of all active watchdogs.  Slots are
+ *   visited in time order and a level is left as soon as the next slot
+ *   starts after the best expiration found so far, so normally only the
+ *   first non-empty slot of each level is examined.  Watchdogs parked at
+ *   the far end of the wheel expire after the range of their slot, which
+ *   is why the first non-empty slot is not always sufficient.
+ *
+ * Input Parameters:
+ *   next - Location to return the earliest expiration time
+ *
+ * Returned Value:
+ *   True if any watchdog is active.
+ *
+ * Assumptions:
+ *   Called with g_wdspinlock held.
+ *
+ ****************************************************************************/
+
+bool wd_wheel_next(FAR clock_t *next)
+{
+  FAR struct list_node *slot;
+  FAR struct wdog_s *wdog;
+  clock_t curr = g_wdwheel.curr;
+  clock_t base;
+  clock_t when;
+  bool found = false;
+  int distance;
+  int offset;
+  int first;
+  int index;
+  int level;
+
+  for (level = 0; level < WDOG_WHEEL_LEVELS; level++)
+    {
+      /* At level 0 the slot of 'curr' holds watchdogs that expire now.
+       * At upper levels that slot belongs to the next rotation and is
+       * searched last.
+       */
+
+      base  = curr >> WHEEL_SHIFT(level);
+      first = level > 0 ? 1 : 0;
+
+      for (offset = first; offset < first + WDOG_WHEEL_SLOTS; offset++)
+        {
+          index    = (base + offset) & WDOG_WHEEL_MASK;
+          distance = wd_wheel_find(g_wdwheel.pending[level], index);
+          if (distance < 0 || offset + distance >= first + WDOG_WHEEL_SLOTS)
+            {
+              break;
+            }
+
+          offset += distance;
+          index   = (index + distance) & WDOG_WHEEL_MASK;
+          when    = (base + offset) << WHEEL_SHIFT(level);
+
+          if (found && clock_compare(*next, when))
+            {
+              break;
+            }
+
+          slot = &g_wdwheel.slot[level][index];
+          if (list_is_empty(slot))
+            {
+              /* Canceled watchdogs leave stale pending bits behind */
+
+              g_wdwheel.pending[level] &= ~WHEEL_BIT(index);
+              continue;
+            }
+
+          list_for_every_entry(slot, wdog, struct wdog_s, node)
+            {
+              if (!found || !clock_compare(*next, wdog->expired))
+                {
+                  *next = wdog->expired;
+                  found = true;
+                }
+            }
+        }
+    }
+
+  return found;
+}
@@ -37,6 +37,7 @@
 #include <nuttx/queue.h>
 #include <nuttx/wdog.h>
 #include <nuttx/arch.h>
+#include <nuttx/spinlock.h>
 
 #ifdef CONFIG_HRTIMER
 #  include <nuttx/hrtimer.h> 
@@ -46,6 +47,39 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+#  define WDOG_WHEEL_BITS    5
+#  define WDOG_WHEEL_SLOTS   (1 << WDOG_WHEEL_BITS)
+#  define WDOG_WHEEL_MASK    (WDOG_WHEEL_SLOTS - 1)
+#  define WDOG_WHEEL_LEVELS  CONFIG_WDOG_TIMER_WHEEL_LEVELS
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+/* Hierarchical timing wheel.  A watchdog that expires 'delta' ticks after
+ * 'curr' is hashed into the lowest level L with delta < 32^(L + 1), in the
+ * slot selected by bits [5 * L, 5 * L + 4] of its expiration time.  When
+ * 'curr' reaches the start of the time range covered by an upper level
+ * slot, that slot is cascaded: its watchdogs are hashed again relative to
+ * the new 'curr' and so move to a lower level.  Level 0 slots hold
+ * watchdogs expiring on exactly one tick.
+ */
+
+struct wdog_wheel_s
+{
+  clock_t          curr;                       /* Tick being processed */
+#if defined(CONFIG_SCHED_TICKLESS) || defined(CONFIG_HRTIMER)
+  clock_t          next;                       /* Expiration set in timer */
+  bool             armed;                      /* True: next is valid */
+#endif
+  uint32_t         pending[WDOG_WHEEL_LEVELS]; /* Bit set: slot in use */
+  struct list_node slot[WDOG_WHEEL_LEVELS][WDOG_WHEEL_SLOTS];
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -58,17 +92,35 @@ extern "C"
 #define EXTERN extern
 #endif
 
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+/* All active watchdogs are held in the g_wdwheel timing wheel */
+
+extern struct wdog_wheel_s g_wdwheel;
+#else
 /* The g_wdactivelist data structure is a singly linked list ordered by
  * watchdog expiration time. When watchdog timers expire,the functions on
  * this linked list are removed and the function is called.
  */
 
 extern struct list_node g_wdactivelist;
+#endif
 
 #ifdef CONFIG_HRTIMER
 extern struct hrtimer_s g_wdtimer;
 #endif
 
+/* Protects the active watchdogs and the watchdog timer state */
+
+extern spinlock_t g_wdspinlock;
+
+#ifdef CONFIG_SMP
+/* The watchdog whose callback each CPU is executing.  Set and cleared
+ * with both the global critical section and g_wdspinlock held.
+ */
+
+extern FAR struct wdog_s *g_wdrunning[CONFIG_SMP_NCPUS];
+#endif
+
 #if defined(CONFIG_SCHED_TICKLESS) || defined(CONFIG_HRTIMER)
 extern bool g_wdtimernested;
 extern clock_t  g_wdexpired;
@@ -110,6 +162,71 @@ void wd_timer(clock_t ticks);
 uint64_t wd_timer(const hrtimer_t *timer, uint64_t expired);
 #endif
 
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+
+/****************************************************************************
+ * Name: wd_initialize
+ *
+ * Description:
+ *   Initialize the watchdog timing wheel.  Called once from nx_start()
+ *   after the system clock has been initialized.
+ *
+ ****************************************************************************/
+
+void wd_initialize(void);
+
+/****************************************************************************
+ * Name: wd_wheel_insert
+ *
+ * Description:
+ *   Hash an initialized watchdog into the timing wheel according to
+ *   wdog->expired.
+ *
+ * Assumptions:
+ *   Called with g_wdspinlock held.
+ *
+ ****************************************************************************/
+
+void wd_wheel_insert(FAR struct wdog_s *wdog);
+
+/****************************************************************************
+ * Name: wd_wheel_pop
+ *
+ * Description:
+ *   Advance the timing wheel up to 'ticks' and remove the next watchdog
+ *   that has expired.
+ *
+ * Returned Value:
+ *   The expired watchdog or NULL if no watchdog expires at or before
+ *   'ticks'.
+ *
+ * Assumptions:
+ *   Called with g_wdspinlock held.
+ *
+ ****************************************************************************/
+
+FAR struct wdog_s *wd_wheel_pop(clock_t ticks);
+
+/****************************************************************************
+ * Name: wd_wheel_next
+ *
+ * Description:
+ *   Find the earliest expiration time of all active watchdogs.
+ *
+ * Returned Value:
+ *   True is returned and the time is stored in 'next' if any watchdog is
+ *   active.
+ *
+ * Assumptions:
+ *   Called with g_wdspinlock held.
+ *
+ ****************************************************************************/
+
+bool wd_wheel_next(FAR clock_t *next);
+#else
+#  define wd_initialize()
+#endif
+
 /****************************************************************************
  * Inline functions
  ****************************************************************************/
@@ -124,6 +241,12 @@ uint64_t wd_timer(const hrtimer_t *timer, uint64_t expired);
 #  define wd_update_expire(expired)
 #endif
 
+#ifdef CONFIG_SMP
+#  define wd_set_running(wdog)      (g_wdrunning[this_cpu()] = (wdog))
+#else
+#  define wd_set_running(wdog)
+#endif
+
 #ifdef CONFIG_HRTIMER
 static inline_function void wd_timer_start(clock_t tick, bool in_expiration)
 {
@@ -194,10 +317,18 @@ static inline_function void wd_timer_cancel(void)
 #  define wd_timer_cancel()
 #endif
 
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+/* With the timing wheel this is the expiration currently programmed into
+ * the timer, see wd_insert().
+ */
+
+#  define wd_next_expire() (g_wdwheel.next)
+#else
 static inline_function clock_t wd_next_expire(void)
 {
   return list_first_entry(&g_wdactivelist, struct wdog_s, node)->expired;
 }
+#endif
 
 /****************************************************************************
  * Public Function Prototypes
@@ -206,14 +337,18 @@ static inline_function clock_t wd_next_expire(void)
 static inline_function clock_t wd_get_next_expire(clock_t curr)
 {
   clock_t     next = curr;
-  irqstate_t flags = enter_critical_section();
+  irqstate_t flags = spin_lock_irqsave(&g_wdspinlock);
 
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+  wd_wheel_next(&next);
+#else
   if (!list_is_empty(&g_wdactivelist))
     {
       next = wd_next_expire();
     }
+#endif
 
-  leave_critical_section(flags);
+  spin_unlock_irqrestore(&g_wdspinlock, flags);
   return (sclock_t)(next - curr) <= 0 ? 0u : next;
 }
 
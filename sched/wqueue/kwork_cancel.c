@@ -58,6 +58,33 @@ static int work_qcancel(FAR struct kwork_wqueue_s *wqueue, bool sync,
    * new work is typically added to the work queue from interrupt handlers.
    */
 
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  work_percpu_remove(wqueue, work);
+
+  /* A worker marks itself busy before the work leaves its queue, so a work
+   * that is no longer queued is either running or done.
+   */
+
+  if (sync)
+    {
+      int wndx;
+      pid_t pid = nxsched_gettid();
+      FAR struct kworker_s *worker = wq_get_worker(wqueue);
+
+      for (wndx = 0; wndx < wqueue->nthreads && sync_wait == NULL; wndx++)
+        {
+          flags = spin_lock_irqsave(&worker[wndx].lock);
+
+          if (worker[wndx].work == work && worker[wndx].pid != pid)
+            {
+              worker[wndx].wait_count++;
+              sync_wait = &worker[wndx].wait;
+            }
+
+          spin_unlock_irqrestore(&worker[wndx].lock, flags);
+        }
+    }
+#else
   flags = spin_lock_irqsave(&wqueue->lock);
 
   if (!work_available(work))
@@ -96,6 +123,7 @@ static int work_qcancel(FAR struct kwork_wqueue_s *wqueue, bool sync,
     }
 
   spin_unlock_irqrestore(&wqueue->lock, flags);
+#endif
 
   if (sync_wait)
     {
@@ -0,0 +1,620 @@
+/****************************************************************************
+ * sched/wqueue/kwork_percpu.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/list.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wdog.h>
+#include <nuttx/wqueue.h>
+
+#include "wqueue/wqueue.h"
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define WORK_WHEEL_BIT(s)   ((uint32_t)1 << (s))
+
+/* No second queue to lock in work_lock() */
+
+#define WORK_NONE           -1
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: work_lockof
+ *
+ * Description:
+ *   Return the lock protecting the queue 'index': a CPU number or
+ *   WORK_PENDING for the delayed work wheel.
+ *
+ ****************************************************************************/
+
+static inline_function FAR spinlock_t *
+work_lockof(FAR struct kwork_wqueue_s *wqueue, int index)
+{
+  return index == WORK_PENDING ? &wqueue->lock : &wqueue->cpuq[index].lock;
+}
+
+/****************************************************************************
+ * Name: work_unlock
+ ****************************************************************************/
+
+static void work_unlock(FAR struct kwork_wqueue_s *wqueue, int src, int dst)
+{
+  spin_unlock(work_lockof(wqueue, src));
+  if (dst != WORK_NONE && dst != src)
+    {
+      spin_unlock(work_lockof(wqueue, dst));
+    }
+}
+
+/****************************************************************************
+ * Name: work_lock
+ *
+ * Description:
+ *   Lock the queue 'work' was last put on and the queue 'dst'.  work->cpu
+ *   only changes with the lock of its current queue held, so it is stable
+ *   once that lock is taken and matches the value read before.  The wheel
+ *   lock is always taken before the per-CPU locks and these in ascending
+ *   CPU order.  A work that was never queued may hold any value in
+ *   work->cpu; it is not on any queue and is claimed for 'dst' (or the
+ *   wheel if there is no 'dst').
+ *
+ * Returned Value:
+ *   The queue 'work' is on (if it is queued at all).
+ *
+ * Assumptions:
+ *   Local interrupts are disabled.
+ *
+ ****************************************************************************/
+
+static int work_lock(FAR struct kwork_wqueue_s *wqueue,
+                     FAR struct work_s *work, int dst)
+{
+  int src;
+
+  for (; ; )
+    {
+      src = work->cpu;
+
+      if (src > WORK_PENDING)
+        {
+          src = dst == WORK_NONE ? WORK_PENDING : dst;
+          spin_lock(work_lockof(wqueue, src));
+          work->cpu = src;
+          return src;
+        }
+
+      if (dst == WORK_NONE || dst == src)
+        {
+          spin_lock(work_lockof(wqueue, src));
+        }
+      else if (dst == WORK_PENDING || (src != WORK_PENDING && dst < src))
+        {
+          spin_lock(work_lockof(wqueue, dst));
+          spin_lock(work_lockof(wqueue, src));
+        }
+      else
+        {
+          spin_lock(work_lockof(wqueue, src));
+          spin_lock(work_lockof(wqueue, dst));
+        }
+
+      if (work->cpu == src)
+        {
+          return src;
+        }
+
+      work_unlock(wqueue, src, dst);
+    }
+}
+
+/****************************************************************************
+ * Name: work_dequeue
+ *
+ * Description:
+ *   Remove a queued work from its queue.
+ *
+ * Assumptions:
+ *   The lock of the queue of the work is held.
+ *
+ ****************************************************************************/
+
+static void work_dequeue(FAR struct kwork_wqueue_s *wqueue,
+                         FAR struct work_s *work)
+{
+  int slot;
+
+  /* Seize the ownership from the work thread. */
+
+  work->worker = NULL;
+  list_delete(&work->node);
+
+  /* The timer is not re-armed when the earliest work goes away, it will
+   * just find nothing to do.
+   */
+
+  if (work->cpu == WORK_PENDING)
+    {
+      slot = work->qtime & WORK_WHEEL_MASK;
+      if (list_is_empty(&wqueue->wheel[slot]))
+        {
+          wqueue->wheelmap &= ~WORK_WHEEL_BIT(slot);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: work_wheel_insert
+ *
+ * Description:
+ *   Hash the delayed work into the wheel by its expiration tick.
+ *
+ * Returned Value:
+ *   True if the wqueue timer has to be re-armed for the work.
+ *
+ * Assumptions:
+ *   wqueue->lock is held.
+ *
+ ****************************************************************************/
+
+static bool work_wheel_insert(FAR struct kwork_wqueue_s *wqueue,
+                              FAR struct work_s *work)
+{
+  int slot = work->qtime & WORK_WHEEL_MASK;
+  bool empty = wqueue->wheelmap == 0;
+
+  /* Nothing is hashed relative to an old base, move it to now so that it
+   * stays close to the expiration times.  The base must never pass the
+   * work, or work_percpu_dispatch() would not look at its slot until the
+   * wheel wraps.
+   */
+
+  if (empty)
+    {
+      wqueue->wheelbase = clock_systime_ticks();
+      if ((sclock_t)(work->qtime - wqueue->wheelbase) < 0)
+        {
+          wqueue->wheelbase = work->qtime;
+        }
+    }
+
+  list_add_tail(&wqueue->wheel[slot], &work->node);
+  wqueue->wheelmap |= WORK_WHEEL_BIT(slot);
+  work->cpu = WORK_PENDING;
+
+  /* An inactive timer with a non-empty wheel means that the timer has
+   * just expired and a worker is about to dispatch (and re-arm).
+   */
+
+  if (WDOG_ISACTIVE(&wqueue->timer))
+    {
+      return !clock_compare(wqueue->timer.expired, work->qtime);
+    }
+
+  return empty;
+}
+
+/****************************************************************************
+ * Name: work_wheel_next
+ *
+ * Description:
+ *   Find the earliest expiration time in the wheel.  All delayed work
+ *   expires at or after wheelbase, so the first slot from wheelbase on
+ *   that holds work of the current rotation gives the answer.  Only if no
+ *   work expires within one rotation are all entries compared.
+ *
+ * Returned Value:
+ *   True if the wheel is not empty.
+ *
+ * Assumptions:
+ *   wqueue->lock is held.
+ *
+ ****************************************************************************/
+
+static bool work_wheel_next(FAR struct kwork_wqueue_s *wqueue,
+                            FAR clock_t *next)
+{
+  FAR struct work_s *work;
+  clock_t base = wqueue->wheelbase;
+  bool found = false;
+  int slot;
+  int i;
+
+  for (i = 0; i < WORK_WHEEL_SLOTS; i++)
+    {
+      slot = (base + i) & WORK_WHEEL_MASK;
+      if ((wqueue->wheelmap & WORK_WHEEL_BIT(slot)) == 0)
+        {
+          continue;
+        }
+
+      list_for_every_entry(&wqueue->wheel[slot], work, struct work_s, node)
+        {
+          if (work->qtime == base + i)
+            {
+              *next = work->qtime;
+              return true;
+            }
+        }
+    }
+
+  for (slot = 0; slot < WORK_WHEEL_SLOTS; slot++)
+    {
+      if ((wqueue->wheelmap & WORK_WHEEL_BIT(slot)) == 0)
+        {
+          continue;
+        }
+
+      list_for_every_entry(&wqueue->wheel[slot], work, struct work_s, node)
+        {
+          if (!found || !clock_compare(*next, work->qtime))
+            {
+              *next = work->qtime;
+              found = true;
+            }
+        }
+    }
+
+  return found;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: work_percpu_init
+ *
+ * Description:
+ *   Initialize the delayed work wheel and the per-CPU queues of a work
+ *   queue.
+ *
+ * Input Parameters:
+ *   wqueue - The work queue.
+ *
+ ****************************************************************************/
+
+void work_percpu_init(FAR struct kwork_wqueue_s *wqueue)
+{
+  int i;
+
+  for (i = 0; i < WORK_WHEEL_SLOTS; i++)
+    {
+      list_initialize(&wqueue->wheel[i]);
+    }
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      list_initialize(&wqueue->cpuq[i].expired);
+      spin_lock_init(&wqueue->cpuq[i].lock);
+    }
+
+  wqueue->wheelmap  = 0;
+  wqueue->wheelbase = clock_systime_ticks();
+}
+
+/****************************************************************************
+ * Name: work_percpu_queue
+ *
+ * Description:
+ *   Queue the work on the delayed work wheel if 'qtime' is in the future
+ *   and on the expired queue of the calling CPU otherwise.  The work is
+ *   first removed from the queue it may already be on.
+ *
+ * Input Parameters:
+ *   wqueue - The work queue.
+ *   work   - The work structure to queue
+ *   worker - The worker callback to be invoked.
+ *   arg    - The argument of the worker callback.
+ *   qtime  - The absolute expiration time.
+ *   delay  - Whether the work was queued with a delay.
+ *
+ ****************************************************************************/
+
+void work_percpu_queue(FAR struct kwork_wqueue_s *wqueue,
+                       FAR struct work_s *work, worker_t worker,
+                       FAR void *arg, clock_t qtime, bool delay)
+{
+  irqstate_t flags;
+  bool retimer = false;
+  int dst;
+  int src;
+
+  /* Work queued by work_queue_next() may already be due */
+
+  if (delay && clock_compare(qtime, clock_systime_ticks()))
+    {
+      delay = false;
+    }
+
+  flags = up_irq_save();
+
+  for (; ; )
+    {
+      dst = delay ? WORK_PENDING : this_cpu();
+      src = work_lock(wqueue, work, dst);
+
+      /* The wheel may have been dispatched up to or past qtime since the
+       * check above.  The work would then sit in a slot behind wheelbase
+       * until the wheel wraps, so queue it as expired instead.
+       */
+
+      if (delay && (clock_compare(qtime, clock_systime_ticks()) ||
+                    (sclock_t)(qtime - wqueue->wheelbase) < 0))
+        {
+          work_unlock(wqueue, src, dst);
+          delay = false;
+          continue;
+        }
+
+      break;
+    }
+
+  /* Ensure the work has been removed. */
+
+  if (!work_available(work))
+    {
+      work_dequeue(wqueue, work);
+    }
+
+  /* Initialize the work structure. */
+
+  work->worker = worker; /* Work callback. non-NULL means queued */
+  work->arg    = arg;    /* Callback argument */
+  work->qtime  = qtime;  /* Expected time */
+
+  if (delay)
+    {
+      retimer = work_wheel_insert(wqueue, work);
+    }
+  else
+    {
+      list_add_tail(&wqueue->cpuq[dst].expired, &work->node);
+      work->cpu = dst;
+    }
+
+  if (retimer)
+    {
+      wd_start_abstick(&wqueue->timer, qtime,
+                       work_timer_expired, (wdparm_t)wqueue);
+    }
+
+  work_unlock(wqueue, src, dst);
+  up_irq_restore(flags);
+
+  if (!delay)
+    {
+      /* Immediately wake up a worker thread. */
+
+      nxsem_post(&wqueue->sem);
+    }
+}
+
+/****************************************************************************
+ * Name: work_percpu_remove
+ *
+ * Description:
+ *   Remove the work from the queue it is on, if any.
+ *
+ ****************************************************************************/
+
+void work_percpu_remove(FAR struct kwork_wqueue_s *wqueue,
+                        FAR struct work_s *work)
+{
+  irqstate_t flags;
+  int src;
+
+  flags = up_irq_save();
+  src   = work_lock(wqueue, work, WORK_NONE);
+
+  if (!work_available(work))
+    {
+      work_dequeue(wqueue, work);
+    }
+
+  work_unlock(wqueue, src, WORK_NONE);
+  up_irq_restore(flags);
+}
+
+/****************************************************************************
+ * Name: work_percpu_dispatch
+ *
+ * Description:
+ *   Move the expired delayed work to the queue of the calling CPU, wake up
+ *   enough workers for it and re-arm the wqueue timer.  Only the slots
+ *   between wheelbase and now can hold expired work.
+ *
+ ****************************************************************************/
+
+void work_percpu_dispatch(FAR struct kwork_wqueue_s *wqueue)
+{
+  FAR struct kwork_cpuq_s *cpuq;
+  FAR struct work_s *work;
+  FAR struct work_s *next;
+  unsigned int count = 0;
+  irqstate_t flags;
+  clock_t ticks;
+  clock_t when;
+  sclock_t elapsed;
+  int nslots;
+  int slot;
+  int cpu;
+  int i;
+
+  flags   = spin_lock_irqsave(&wqueue->lock);
+  cpu     = this_cpu();
+  cpuq    = &wqueue->cpuq[cpu];
+  ticks   = clock_systime_ticks();
+  elapsed = (sclock_t)(ticks - wqueue->wheelbase);
+
+  if (elapsed < 0)
+    {
+      nslots = 0;
+    }
+  else if (elapsed >= WORK_WHEEL_SLOTS)
+    {
+      nslots = WORK_WHEEL_SLOTS;
+    }
+  else
+    {
+      nslots = elapsed + 1;
+    }
+
+  spin_lock(&cpuq->lock);
+
+  for (i = 0; i < nslots; i++)
+    {
+      slot = (wqueue->wheelbase + i) & WORK_WHEEL_MASK;
+      if ((wqueue->wheelmap & WORK_WHEEL_BIT(slot)) == 0)
+        {
+          continue;
+        }
+
+      list_for_every_entry_safe(&wqueue->wheel[slot], work, next,
+                                struct work_s, node)
+        {
+          if (clock_compare(work->qtime, ticks))
+            {
+              list_delete(&work->node);
+              list_add_tail(&cpuq->expired, &work->node);
+              work->cpu = cpu;
+              count++;
+            }
+        }
+
+      if (list_is_empty(&wqueue->wheel[slot]))
+        {
+          wqueue->wheelmap &= ~WORK_WHEEL_BIT(slot);
+        }
+    }
+
+  spin_unlock(&cpuq->lock);
+
+  if (nslots > 0)
+    {
+      wqueue->wheelbase = ticks + 1;
+    }
+
+  if (work_wheel_next(wqueue, &when))
+    {
+      wd_start_abstick(&wqueue->timer, when,
+                       work_timer_expired, (wdparm_t)wqueue);
+    }
+
+  spin_unlock_irqrestore(&wqueue->lock, flags);
+
+  /* The calling worker has already been woken up by the timer, so only
+   * `count - 1` semaphore will be posted.
+   */
+
+  while (count-- > 1)
+    {
+      nxsem_post(&wqueue->sem);
+    }
+}
+
+/****************************************************************************
+ * Name: work_percpu_take
+ *
+ * Description:
+ *   Take the oldest work of the calling CPU's queue or, if that is empty,
+ *   steal it from another CPU, and mark the worker busy with it.
+ *
+ * Returned Value:
+ *   The work taken with its callback and argument, or NULL if all queues
+ *   are empty.
+ *
+ ****************************************************************************/
+
+FAR struct work_s *work_percpu_take(FAR struct kwork_wqueue_s *wqueue,
+                                    FAR struct kworker_s *kworker,
+                                    FAR worker_t *worker, FAR void **arg)
+{
+  FAR struct kwork_cpuq_s *cpuq;
+  FAR struct work_s *work = NULL;
+  irqstate_t flags;
+  int cpu;
+  int i;
+
+  flags = up_irq_save();
+  cpu   = this_cpu();
+
+  for (i = 0; i < CONFIG_SMP_NCPUS && work == NULL; i++)
+    {
+      cpuq = &wqueue->cpuq[(cpu + i) % CONFIG_SMP_NCPUS];
+
+      /* Peek without the lock to skip empty queues cheaply */
+
+      if (list_is_empty(&cpuq->expired))
+        {
+          continue;
+        }
+
+      spin_lock(&cpuq->lock);
+
+      if (!list_is_empty(&cpuq->expired))
+        {
+          work = list_first_entry(&cpuq->expired, struct work_s, node);
+          list_delete(&work->node);
+
+          /* Extract the work description and return the work structure
+           * ownership to the work owner.
+           */
+
+          *worker      = work->worker;
+          *arg         = work->arg;
+          work->worker = NULL;
+
+          /* Mark the thread busy before the work can be seen as idle */
+
+          spin_lock(&kworker->lock);
+          kworker->work = work;
+          spin_unlock(&kworker->lock);
+        }
+
+      spin_unlock(&cpuq->lock);
+    }
+
+  up_irq_restore(flags);
+  return work;
+}
+
+#endif /* CONFIG_SCHED_WORKQUEUE_PERCPU */
@@ -71,7 +71,9 @@ int work_queue_next_wq(FAR struct kwork_wqueue_s *wqueue,
                        FAR struct work_s *work, worker_t worker,
                        FAR void *arg, clock_t delay)
 {
+#ifndef CONFIG_SCHED_WORKQUEUE_PERCPU
   irqstate_t flags;
+#endif
 
   if (wqueue == NULL || work == NULL || worker == NULL ||
       delay > WDOG_MAX_DELAY)
@@ -79,6 +81,11 @@ int work_queue_next_wq(FAR struct kwork_wqueue_s *wqueue,
       return -EINVAL;
     }
 
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  work_percpu_queue(wqueue, work, worker, arg, work->qtime + delay,
+                    delay != 0);
+  return 0;
+#else
   /* Initialize the work structure. */
 
   work->worker = worker; /* Work callback. non-NULL means queued */
@@ -116,6 +123,7 @@ int work_queue_next_wq(FAR struct kwork_wqueue_s *wqueue,
     }
 
   return 0;
+#endif
 }
 
 int work_queue_next(int qid, FAR struct work_s *work, worker_t worker,
@@ -158,9 +166,11 @@ int work_queue_wq(FAR struct kwork_wqueue_s *wqueue,
                   FAR struct work_s *work, worker_t worker,
                   FAR void *arg, clock_t delay)
 {
+#ifndef CONFIG_SCHED_WORKQUEUE_PERCPU
   irqstate_t flags;
-  clock_t expected;
   bool retimer;
+#endif
+  clock_t expected;
 
   if (wqueue == NULL || work == NULL || worker == NULL ||
       delay > WDOG_MAX_DELAY)
@@ -170,6 +180,10 @@ int work_queue_wq(FAR struct kwork_wqueue_s *wqueue,
 
   expected = clock_delay2abstick(delay);
 
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  work_percpu_queue(wqueue, work, worker, arg, expected, delay != 0);
+  return 0;
+#else
   /* Interrupts are disabled so that this logic can be called from with
    * task logic or from interrupt handling logic.
    */
@@ -221,6 +235,7 @@ int work_queue_wq(FAR struct kwork_wqueue_s *wqueue,
     }
 
   return 0;
+#endif
 }
 
 int work_queue(int qid, FAR struct work_s *work, worker_t worker,
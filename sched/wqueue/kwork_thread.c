@@ -84,8 +84,10 @@
 struct hp_wqueue_s g_hpwork =
 {
   {
+#ifndef CONFIG_SCHED_WORKQUEUE_PERCPU
     LIST_INITIAL_VALUE(g_hpwork.wq.expired),
     LIST_INITIAL_VALUE(g_hpwork.wq.pending),
+#endif
     SEM_INITIALIZER(0),
     SEM_INITIALIZER(0),
     SP_UNLOCKED,
@@ -101,8 +103,10 @@ struct hp_wqueue_s g_hpwork =
 struct lp_wqueue_s g_lpwork =
 {
   {
+#ifndef CONFIG_SCHED_WORKQUEUE_PERCPU
     LIST_INITIAL_VALUE(g_lpwork.wq.expired),
     LIST_INITIAL_VALUE(g_lpwork.wq.pending),
+#endif
     SEM_INITIALIZER(0),
     SEM_INITIALIZER(0),
     SP_UNLOCKED,
@@ -116,6 +120,7 @@ struct lp_wqueue_s g_lpwork =
  * Private Functions
  ****************************************************************************/
 
+#ifndef CONFIG_SCHED_WORKQUEUE_PERCPU
 static inline_function
 void work_dispatch(FAR struct kwork_wqueue_s *wq)
 {
@@ -160,6 +165,7 @@ void work_dispatch(FAR struct kwork_wqueue_s *wq)
         }
     }
 }
+#endif
 
 /****************************************************************************
  * Name: work_thread
@@ -204,6 +210,44 @@ static int work_thread(int argc, FAR char *argv[])
    * there is no need for entering the critical section.
    */
 
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  while (!wqueue->exit)
+    {
+      /* If the wqueue timer is expired and non-active, there might be
+       * expired work in the delayed work wheel.
+       */
+
+      if (!WDOG_ISACTIVE(&wqueue->timer) && wqueue->wheelmap != 0)
+        {
+          work_percpu_dispatch(wqueue);
+        }
+
+      /* Serve the queue of this CPU first, then steal from the others */
+
+      work = work_percpu_take(wqueue, kworker, &worker, &arg);
+      if (work != NULL)
+        {
+          CALL_WORKER(worker, arg);
+
+          /* Mark the thread un-busy and wakeup anyone waiting for it */
+
+          flags = spin_lock_irqsave(&kworker->lock);
+
+          kworker->work = NULL;
+          while (kworker->wait_count > 0)
+            {
+              kworker->wait_count--;
+              nxsem_post(&kworker->wait);
+            }
+
+          spin_unlock_irqrestore(&kworker->lock, flags);
+        }
+
+      /* Wait for the semaphore to be posted by the wqueue timer. */
+
+      nxsem_wait_uninterruptible(&wqueue->sem);
+    }
+#else
   while (!wqueue->exit)
     {
       /* And check first entry in the work queue. Since we have disabled
@@ -274,6 +318,7 @@ static int work_thread(int argc, FAR char *argv[])
 
       nxsem_wait_uninterruptible(&wqueue->sem);
     }
+#endif
 
   nxsem_post(&wqueue->exsem);
   return OK;
@@ -319,6 +364,9 @@ static int work_thread_create(FAR const char *name, int priority,
   for (wndx = 0; wndx < wqueue->nthreads; wndx++)
     {
       nxsem_init(&worker[wndx].wait, 0, 0);
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+      spin_lock_init(&worker[wndx].lock);
+#endif
 
       snprintf(arg0, sizeof(arg0), "%p", wqueue);
       snprintf(arg1, sizeof(arg1), "%p", &worker[wndx]);
@@ -422,8 +470,12 @@ FAR struct kwork_wqueue_s *work_queue_create(FAR const char *name,
 
   /* Initialize the work queue structure */
 
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  work_percpu_init(wqueue);
+#else
   list_initialize(&wqueue->expired);
   list_initialize(&wqueue->pending);
+#endif
   wqueue->timer.func = NULL;
   nxsem_init(&wqueue->sem, 0, 0);
   nxsem_init(&wqueue->exsem, 0, 0);
@@ -536,6 +588,28 @@ int work_queue_priority(int qid)
   return work_queue_priority_wq(work_qid2wq(qid));
 }
 
+/****************************************************************************
+ * Name: work_initialize
+ *
+ * Description:
+ *   Initialize the per-CPU queues of the kernel work queues.  This must be
+ *   done before any work can be queued, long before the worker threads are
+ *   started.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+void work_initialize(void)
+{
+#ifdef CONFIG_SCHED_HPWORK
+  work_percpu_init(&g_hpwork.wq);
+#endif
+#ifdef CONFIG_SCHED_LPWORK
+  work_percpu_init(&g_lpwork.wq);
+#endif
+}
+#endif
+
 /****************************************************************************
  * Name: work_start_highpri
  *
@@ -55,6 +55,17 @@
 #define wq_get_worker(wq) \
   (FAR struct kworker_s *)((FAR char *)(wq) + sizeof(struct kwork_wqueue_s))
 
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+/* Delayed work is hashed by expiration tick into a wheel of this size */
+
+#  define WORK_WHEEL_SLOTS   32
+#  define WORK_WHEEL_MASK    (WORK_WHEEL_SLOTS - 1)
+
+/* work->cpu of delayed work, the wheel is protected by wqueue->lock */
+
+#  define WORK_PENDING       CONFIG_SMP_NCPUS
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -67,20 +78,44 @@ struct kworker_s
   FAR struct work_s *work;     /* The work structure */
   sem_t             wait;      /* Sync waiting for worker done */
   int16_t           wait_count;
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  spinlock_t        lock;      /* Protects work and wait_count */
+#endif
 };
 
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+/* The expired work queued on one CPU.  Workers serve the queue of the CPU
+ * they are running on first and steal from the other CPUs when it is
+ * empty.
+ */
+
+struct kwork_cpuq_s
+{
+  struct list_node expired;   /* The queue of expired work */
+  spinlock_t       lock;      /* Protects expired */
+};
+#endif
+
 /* This structure defines the state of one kernel-mode work queue */
 
 struct kwork_wqueue_s
 {
+#ifndef CONFIG_SCHED_WORKQUEUE_PERCPU
   struct list_node expired;   /* The queue of expired work. */
   struct list_node pending;   /* The queue of pending work. */
+#endif
   sem_t            sem;       /* The counting semaphore of the wqueue */
   sem_t            exsem;     /* Sync waiting for thread exit */
   spinlock_t       lock;      /* Spinlock */
   uint8_t          nthreads;  /* Number of worker threads */
   bool             exit;      /* A flag to request the thread to exit */
   struct wdog_s    timer;     /* Timer to pending. */
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  uint32_t         wheelmap;  /* Bit n set: wheel[n] is not empty */
+  clock_t          wheelbase; /* All delayed work before it has expired */
+  struct list_node wheel[WORK_WHEEL_SLOTS];        /* Delayed work */
+  struct kwork_cpuq_s cpuq[CONFIG_SMP_NCPUS];      /* Expired work */
+#endif
 };
 
 /* This structure defines the state of one high-priority work queue.  This
@@ -170,6 +205,7 @@ static inline_function FAR struct kwork_wqueue_s *work_qid2wq(int qid)
  *
  ****************************************************************************/
 
+#ifndef CONFIG_SCHED_WORKQUEUE_PERCPU
 static inline_function
 bool work_insert_pending(FAR struct kwork_wqueue_s *wqueue,
                          FAR struct work_s         *work)
@@ -241,6 +277,7 @@ bool work_remove(FAR struct kwork_wqueue_s *wqueue,
 
   return head == work;
 }
+#endif
 
 /****************************************************************************
  * Name: work_timer_expired
@@ -270,6 +307,7 @@ void work_timer_expired(wdparm_t arg);
  *
  ****************************************************************************/
 
+#ifndef CONFIG_SCHED_WORKQUEUE_PERCPU
 static inline_function
 void work_timer_reset(FAR struct kwork_wqueue_s *wqueue)
 {
@@ -287,6 +325,84 @@ void work_timer_reset(FAR struct kwork_wqueue_s *wqueue)
       wd_cancel(&wqueue->timer);
     }
 }
+#endif
+
+/****************************************************************************
+ * Name: work_percpu_init
+ *
+ * Description:
+ *   Initialize the delayed work wheel and the per-CPU queues of a work
+ *   queue.
+ *
+ * Input Parameters:
+ *   wqueue - The work queue.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+void work_percpu_init(FAR struct kwork_wqueue_s *wqueue);
+
+/****************************************************************************
+ * Name: work_percpu_queue
+ *
+ * Description:
+ *   Queue the work on the delayed work wheel if 'qtime' is in the future
+ *   and on the expired queue of the calling CPU otherwise.  The work is
+ *   first removed from the queue it may already be on.
+ *
+ * Input Parameters:
+ *   wqueue - The work queue.
+ *   work   - The work structure to queue
+ *   worker - The worker callback to be invoked.
+ *   arg    - The argument of the worker callback.
+ *   qtime  - The absolute expiration time.
+ *   delay  - Whether the work was queued with a delay.
+ *
+ ****************************************************************************/
+
+void work_percpu_queue(FAR struct kwork_wqueue_s *wqueue,
+                       FAR struct work_s *work, worker_t worker,
+                       FAR void *arg, clock_t qtime, bool delay);
+
+/****************************************************************************
+ * Name: work_percpu_remove
+ *
+ * Description:
+ *   Remove the work from the queue it is on, if any.
+ *
+ ****************************************************************************/
+
+void work_percpu_remove(FAR struct kwork_wqueue_s *wqueue,
+                        FAR struct work_s *work);
+
+/****************************************************************************
+ * Name: work_percpu_dispatch
+ *
+ * Description:
+ *   Move the expired delayed work to the queue of the calling CPU, wake up
+ *   enough workers for it and re-arm the wqueue timer.
+ *
+ ****************************************************************************/
+
+void work_percpu_dispatch(FAR struct kwork_wqueue_s *wqueue);
+
+/****************************************************************************
+ * Name: work_percpu_take
+ *
+ * Description:
+ *   Take the oldest work of the calling CPU's queue or, if that is empty,
+ *   steal it from another CPU, and mark the worker busy with it.
+ *
+ * Returned Value:
+ *   The work taken with its callback and argument, or NULL if all queues
+ *   are empty.
+ *
+ ****************************************************************************/
+
+FAR struct work_s *work_percpu_take(FAR struct kwork_wqueue_s *wqueue,
+                                    FAR struct kworker_s *kworker,
+                                    FAR worker_t *worker, FAR void **arg);
+#endif
 
 /****************************************************************************
  * Name: work_start_highpri
@@ -338,5 +454,19 @@ int work_start_lowpri(void);
 void work_initialize_notifier(void);
 #endif
 
+/****************************************************************************
+ * Name: work_initialize
+ *
+ * Description:
+ *   Initialize the per-CPU queues of the kernel work queues.  This must be
+ *   done before any work can be queued, long before the worker threads are
+ *   started.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+void work_initialize(void);
+#endif
+
 #endif /* CONFIG_SCHED_WORKQUEUE */
 #endif /* __SCHED_WQUEUE_WQUEUE_H */